@@ -0,0 +1,937 @@
+/**
+ * @file bench-game.c
+ * @brief Benchmarks of the game logic.
+ *
+ * Every benchmark cycles through a fixed set of random scenarios, so the
+ * branches depend on the data as they do in a real game, while the
+ * results stay reproducible.
+ */
+
+#include "bench.h"
+
+#include <cruceGame.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The number of scenarios of a benchmark. It is a power of 2.
+ */
+#define SCENARIOS 256
+
+/**
+ * @brief The seed of the random scenarios.
+ */
+#define SEED 20141
+
+/**
+ * @brief The number of cards of every player at a table of 4 players.
+ */
+#define TABLE_CARDS (DECK_SIZE / MAX_GAME_PLAYERS)
+
+/**
+ * @brief Helper to fill an array with the card ids in random order.
+ */
+static void shuffleIds(int ids[DECK_SIZE])
+{
+    for (int i = 0; i < DECK_SIZE; i++)
+        ids[i] = i;
+    for (int i = DECK_SIZE - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int id = ids[i];
+        ids[i] = ids[j];
+        ids[j] = id;
+    }
+}
+
+/**
+ * @brief Helper to fill an array with one card of every id.
+ */
+static void fillCards(struct Card cards[DECK_SIZE])
+{
+    for (int i = 0; i < DECK_SIZE; i++) {
+        cards[i].suit = i / SUIT_SIZE;
+        cards[i].value = VALUES[i % SUIT_SIZE];
+    }
+}
+
+/**
+ * @brief Helper to create the players of a table.
+ */
+static void createPlayers(struct Player *players[MAX_GAME_PLAYERS])
+{
+    static const char *NAMES[MAX_GAME_PLAYERS] = {"North", "East", "South",
+                                                  "West"};
+
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        players[i] = team_createPlayer(NAMES[i], 0);
+}
+
+/**
+ * @brief State of the deck_compareCards benchmark.
+ */
+struct CompareState {
+    struct Card cards[DECK_SIZE];
+    unsigned char first[SCENARIOS];
+    unsigned char second[SCENARIOS];
+    unsigned char trumps[SCENARIOS];
+};
+
+static void *setupCompare(void)
+{
+    struct CompareState *state = malloc(sizeof(struct CompareState));
+    if (state == NULL)
+        return NULL;
+
+    srand(SEED);
+    fillCards(state->cards);
+    for (int i = 0; i < SCENARIOS; i++) {
+        int ids[DECK_SIZE];
+        shuffleIds(ids);
+        state->first[i] = ids[0];
+        state->second[i] = ids[1];
+        state->trumps[i] = rand() % SuitEnd;
+    }
+
+    return state;
+}
+
+static long runCompare(void *argument, long operations)
+{
+    struct CompareState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        int scenario = i & (SCENARIOS - 1);
+        sum += deck_compareCards(&state->cards[state->first[scenario]],
+                                 &state->cards[state->second[scenario]],
+                                 state->trumps[scenario]);
+    }
+
+    return sum;
+}
+
+/**
+ * @brief State of the round_handWinner benchmark. The hands have 2, 3 or
+ *        4 cards.
+ */
+struct HandState {
+    struct Round *round;
+    struct Player *players[MAX_GAME_PLAYERS];
+    struct Card cards[DECK_SIZE];
+    struct Hand hands[SCENARIOS];
+    unsigned char trumps[SCENARIOS];
+};
+
+static void teardownHand(void *argument);
+
+static void *setupHand(void)
+{
+    struct HandState *state = calloc(1, sizeof(struct HandState));
+    if (state == NULL)
+        return NULL;
+
+    srand(SEED);
+    fillCards(state->cards);
+    createPlayers(state->players);
+    state->round = round_createRound();
+    if (state->round == NULL) {
+        teardownHand(state);
+        return NULL;
+    }
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (round_addPlayer(state->players[i], state->round) != NO_ERROR) {
+            teardownHand(state);
+            return NULL;
+        }
+
+    for (int i = 0; i < SCENARIOS; i++) {
+        int ids[DECK_SIZE];
+        int playersNumber = 2 + i % 3;
+        int leader = rand() % MAX_GAME_PLAYERS;
+        shuffleIds(ids);
+        for (int j = 0; j < playersNumber; j++) {
+            state->hands[i].cards[j] = &state->cards[ids[j]];
+            state->hands[i].players[j] =
+                state->players[(leader + j) % MAX_GAME_PLAYERS];
+        }
+        state->trumps[i] = rand() % SuitEnd;
+    }
+
+    return state;
+}
+
+static long runHand(void *argument, long operations)
+{
+    struct HandState *state = argument;
+    struct Round *round = state->round;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        int scenario = i & (SCENARIOS - 1);
+        round->trump = state->trumps[scenario];
+        sum += round_handWinner(&state->hands[scenario], round) ==
+               state->players[0];
+        if (scenario == SCENARIOS - 1)
+            memset(round->pointsNumber, 0, sizeof(round->pointsNumber));
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Hook of the round_handWinner benchmark with hooks.
+ */
+static void countTrick(void *context, const struct TrickEvent *event)
+{
+    *(long *)context += event->points;
+}
+
+static void *setupHookedHand(void)
+{
+    static long points;
+    static const struct GameHooks hooks = {&points, NULL, NULL, NULL,
+                                           countTrick, NULL};
+
+    struct HandState *state = setupHand();
+    if (state != NULL)
+        state->round->hooks = &hooks;
+
+    return state;
+}
+
+static void teardownHand(void *argument)
+{
+    struct HandState *state = argument;
+
+    if (state->round != NULL)
+        round_deleteRound(&state->round);
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (state->players[i] != NULL)
+            team_deletePlayer(&state->players[i]);
+    free(state);
+}
+
+/**
+ * @brief State of the game_checkCard and game_findNextAllowedCard
+ *        benchmarks: a dealt table of 4 players and hands with 0 to 3
+ *        cards already put down by the other players.
+ */
+struct TableState {
+    struct Game *game;
+    struct Card cards[DECK_SIZE];
+    struct Hand hands[SCENARIOS];
+    unsigned char seats[SCENARIOS];
+    unsigned char trumps[SCENARIOS];
+};
+
+static void teardownTable(void *argument);
+
+static void *setupTable(void)
+{
+    struct TableState *state = calloc(1, sizeof(struct TableState));
+    if (state == NULL)
+        return NULL;
+
+    srand(SEED);
+    fillCards(state->cards);
+    state->game = game_createGame(11);
+    if (state->game == NULL) {
+        teardownTable(state);
+        return NULL;
+    }
+
+    struct Game *game = state->game;
+    struct Player *players[MAX_GAME_PLAYERS];
+    createPlayers(players);
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (game_addPlayer(players[i], game) != NO_ERROR) {
+            for (int j = i; j < MAX_GAME_PLAYERS; j++)
+                if (players[j] != NULL)
+                    team_deletePlayer(&players[j]);
+            teardownTable(state);
+            return NULL;
+        }
+    }
+    game_arrangePlayersRound(game, 0);
+
+    int ids[DECK_SIZE];
+    shuffleIds(ids);
+    for (int i = 0; i < DECK_SIZE; i++)
+        team_addCard(game->players[i % MAX_GAME_PLAYERS],
+                     &state->cards[ids[i]]);
+
+    for (int i = 0; i < SCENARIOS; i++) {
+        int seat = i % MAX_GAME_PLAYERS;
+        int played = (i / MAX_GAME_PLAYERS) % MAX_GAME_PLAYERS;
+        for (int j = 0; j < played; j++) {
+            int other = (seat + MAX_GAME_PLAYERS - played + j) %
+                        MAX_GAME_PLAYERS;
+            state->hands[i].players[j] = game->players[other];
+            state->hands[i].cards[j] =
+                game->players[other]->hand[rand() % TABLE_CARDS];
+        }
+        state->seats[i] = seat;
+        state->trumps[i] = rand() % SuitEnd;
+    }
+
+    return state;
+}
+
+static long runCheckCard(void *argument, long operations)
+{
+    struct TableState *state = argument;
+    struct Game *game = state->game;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        int scenario = (i / TABLE_CARDS) & (SCENARIOS - 1);
+        game->round->trump = state->trumps[scenario];
+        sum += game_checkCard(game->players[state->seats[scenario]], game,
+                              &state->hands[scenario], i % TABLE_CARDS);
+    }
+
+    return sum;
+}
+
+static long runFindNextAllowedCard(void *argument, long operations)
+{
+    struct TableState *state = argument;
+    struct Game *game = state->game;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        int scenario = i & (SCENARIOS - 1);
+        game->round->trump = state->trumps[scenario];
+        sum += game_findNextAllowedCard(game->players[state->seats[scenario]],
+                                        game, &state->hands[scenario],
+                                        TABLE_CARDS - 1);
+    }
+
+    return sum;
+}
+
+static void teardownTable(void *argument)
+{
+    struct TableState *state = argument;
+    struct Game *game = state->game;
+
+    if (game != NULL) {
+        if (game->round != NULL)
+            round_deleteRound(&game->round);
+        for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+            if (game->players[i] != NULL)
+                team_deletePlayer(&game->players[i]);
+        game_deleteGame(&state->game);
+    }
+    free(state);
+}
+
+/**
+ * @brief State of the notation_parseRound benchmark.
+ */
+struct NotationState {
+    char texts[SCENARIOS][NOTATION_MAX_ROUND_LENGTH];
+    int lengths[SCENARIOS];
+};
+
+static void *setupNotation(void)
+{
+    struct NotationState *state = malloc(sizeof(struct NotationState));
+    if (state == NULL)
+        return NULL;
+
+    srand(SEED);
+    for (int i = 0; i < SCENARIOS; i++) {
+        struct RoundRecord record;
+        int ids[DECK_SIZE];
+        memset(&record, 0, sizeof(record));
+        record.playersNumber = 2 + i % 3;
+        shuffleIds(ids);
+        for (int j = 0; j < DECK_SIZE; j++)
+            record.deck[j] = ids[j];
+        for (int j = 0; j < record.playersNumber; j++) {
+            strcpy(record.names[j], "Player");
+            record.names[j][6] = '0' + j;
+            record.teams[j] = j % 2;
+            record.bids[j] = rand() % 7;
+            record.pointsNumber[j] = rand() % 100;
+            record.scores[j] = rand() % 21;
+        }
+        record.trump = rand() % SuitEnd;
+        state->lengths[i] = notation_writeRound(&record, state->texts[i],
+                                                NOTATION_MAX_ROUND_LENGTH);
+    }
+
+    return state;
+}
+
+static long runParseRound(void *argument, long operations)
+{
+    struct NotationState *state = argument;
+    struct RoundRecord record;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        int scenario = i & (SCENARIOS - 1);
+        sum += notation_parseRound(&record, state->texts[scenario],
+                                   state->lengths[scenario]);
+    }
+
+    return sum;
+}
+
+/**
+ * @brief State of the locations_computeProbabilities benchmark: what a
+ *        player knows at random points of random rounds of 2 to 4 players.
+ */
+struct LocationsState {
+    struct Locations locations[SCENARIOS];
+};
+
+static void *setupLocations(void)
+{
+    struct LocationsState *state = malloc(sizeof(struct LocationsState));
+    if (state == NULL)
+        return NULL;
+
+    srand(SEED);
+    for (int i = 0; i < SCENARIOS; i++) {
+        struct RoundRecord record;
+        int playersNumber = 2 + i % 3;
+        simulation_playRound(&record, playersNumber, SEED, i);
+        struct Game *game = replay_createGame(&record, rand() %
+                                              (record.handsNumber *
+                                               playersNumber));
+        if (game == NULL) {
+            free(state);
+            return NULL;
+        }
+        locations_fromGame(&state->locations[i], game,
+                           game->round->players[rand() % playersNumber]);
+        replay_deleteGame(&game);
+    }
+
+    return state;
+}
+
+static long runLocations(void *argument, long operations)
+{
+    struct LocationsState *state = argument;
+    double probabilities[LOCATIONS_HOLDERS][DECK_SIZE];
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        int scenario = i & (SCENARIOS - 1);
+        sum += locations_computeProbabilities(&state->locations[scenario],
+                                              probabilities, NULL);
+    }
+
+    return sum;
+}
+
+/**
+ * @brief The number of worlds of the world pool benchmarks.
+ */
+#define WORLDS 64
+
+/**
+ * @brief State of the world pool benchmarks: what a player knows before
+ *        every card of a round of 4 players, and a pool of worlds.
+ */
+struct WorldsState {
+    struct Locations locations[DECK_SIZE];
+    struct WorldPool *pool;
+    uint32_t deals[WORLDS][LOCATIONS_HOLDERS];
+};
+
+static void *setupWorlds(void)
+{
+    struct WorldsState *state = malloc(sizeof(struct WorldsState));
+    if (state == NULL)
+        return NULL;
+
+    struct RoundRecord record;
+    simulation_playRound(&record, MAX_GAME_PLAYERS, SEED, 0);
+    for (int i = 0; i < DECK_SIZE; i++) {
+        struct Game *game = replay_createGame(&record, i);
+        if (game == NULL) {
+            free(state);
+            return NULL;
+        }
+        locations_fromGame(&state->locations[i], game,
+                           game->round->players[0]);
+        replay_deleteGame(&game);
+    }
+
+    state->pool = worlds_createPool(WORLDS, SEED);
+    if (state->pool == NULL) {
+        free(state);
+        return NULL;
+    }
+
+    return state;
+}
+
+static long runUpdatePool(void *argument, long operations)
+{
+    struct WorldsState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        int card = i % DECK_SIZE;
+        if (card == 0)
+            state->pool->worldsNumber = 0;
+        worlds_updatePool(state->pool, &state->locations[card]);
+        sum += state->pool->sampledNumber;
+    }
+
+    return sum;
+}
+
+static long runSampleDeals(void *argument, long operations)
+{
+    struct WorldsState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        locations_sampleDeals(&state->locations[i % DECK_SIZE], state->deals,
+                              WORLDS, &state->pool->random);
+        sum += state->deals[0][1];
+    }
+
+    return sum;
+}
+
+static void teardownWorlds(void *argument)
+{
+    struct WorldsState *state = argument;
+
+    worlds_deletePool(&state->pool);
+    free(state);
+}
+
+/**
+ * @brief The number of players met by the bot of the opponent store
+ *        benchmarks.
+ */
+#define OPPONENTS 1024
+
+/**
+ * @brief State of the opponent store benchmarks: random rounds of 2 to 4
+ *        players, taken from a set of opponents, and a store which has
+ *        already seen them all.
+ */
+struct OpponentsState {
+    struct RoundRecord records[SCENARIOS];
+    struct OpponentStore *store;
+};
+
+static void *setupOpponents(void)
+{
+    struct OpponentsState *state = malloc(sizeof(struct OpponentsState));
+    if (state == NULL)
+        return NULL;
+
+    state->store = opponents_createStore();
+    if (state->store == NULL) {
+        free(state);
+        return NULL;
+    }
+
+    srand(SEED);
+    for (int i = 0; i < SCENARIOS; i++) {
+        struct RoundRecord *record = &state->records[i];
+        simulation_playRound(record, 2 + i % 3, SEED, i);
+        for (int j = 0; j < record->playersNumber; j++)
+            sprintf(record->names[j], "Player %d", rand() % OPPONENTS);
+    }
+    for (int i = 0; i < OPPONENTS; i++) {
+        struct RoundRecord record = state->records[0];
+        sprintf(record.names[0], "Player %d", i);
+        opponents_addRound(state->store, &record);
+    }
+
+    return state;
+}
+
+static long runAddRound(void *argument, long operations)
+{
+    struct OpponentsState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        int scenario = i & (SCENARIOS - 1);
+        sum += opponents_addRound(state->store, &state->records[scenario]);
+    }
+
+    return sum;
+}
+
+static long runFind(void *argument, long operations)
+{
+    struct OpponentsState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        int scenario = i & (SCENARIOS - 1);
+        const struct OpponentStats *stats =
+            opponents_find(state->store,
+                           state->records[scenario].names[i % 2]);
+        sum += stats->overtrumpsNumber;
+    }
+
+    return sum;
+}
+
+static void teardownOpponents(void *argument)
+{
+    struct OpponentsState *state = argument;
+
+    opponents_deleteStore(&state->store);
+    free(state);
+}
+
+/**
+ * @brief State of the network benchmarks: the positions of a round of 4
+ *        players, a network of the default size of cruceTrain and its
+ *        gradients.
+ */
+struct NetworkState {
+    struct NetworkExample examples[DECK_SIZE];
+    struct Network *network;
+    float *gradients;
+};
+
+static void *setupNetwork(void)
+{
+    struct NetworkState *state = malloc(sizeof(struct NetworkState));
+    if (state == NULL)
+        return NULL;
+
+    struct RoundRecord record;
+    simulation_playRound(&record, MAX_GAME_PLAYERS, SEED, 0);
+    for (int i = 0; i < DECK_SIZE; i++) {
+        struct Game *game = replay_createGame(&record, i);
+        int handId, position;
+        if (game == NULL || replay_findTurn(game, &handId, &position) != 0) {
+            replay_deleteGame(&game);
+            free(state);
+            return NULL;
+        }
+        struct Hand *hand = game->round->hands[handId];
+        struct NetworkExample *example = &state->examples[i];
+        network_encodePosition(example->features, &example->allowed, game,
+                               hand->players[position], hand);
+        example->card = record.cards[handId][position];
+        example->value = 0.25f;
+        replay_deleteGame(&game);
+    }
+
+    int hiddenSizes[] = {128, 64};
+    state->network = network_createNetwork(hiddenSizes, 2, SEED);
+    state->gradients = state->network == NULL ? NULL :
+                       calloc(state->network->parametersNumber,
+                              sizeof(float));
+    if (state->gradients == NULL) {
+        network_deleteNetwork(&state->network);
+        free(state);
+        return NULL;
+    }
+
+    return state;
+}
+
+static long runEvaluate(void *argument, long operations)
+{
+    struct NetworkState *state = argument;
+    float outputs[NETWORK_OUTPUTS];
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        const struct NetworkExample *example = &state->examples[i % DECK_SIZE];
+        network_evaluate(state->network, example->features,
+                         example->allowed, outputs);
+        sum += outputs[DECK_SIZE] > 0;
+    }
+
+    return sum;
+}
+
+static long runAddGradients(void *argument, long operations)
+{
+    struct NetworkState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++)
+        sum += network_addGradients(state->network,
+                                    &state->examples[i % DECK_SIZE],
+                                    state->gradients) > 1;
+
+    return sum;
+}
+
+static void teardownNetwork(void *argument)
+{
+    struct NetworkState *state = argument;
+
+    free(state->gradients);
+    network_deleteNetwork(&state->network);
+    free(state);
+}
+
+static void *setupSampler(void)
+{
+    struct DealSampler *sampler = sampling_createSampler(MAX_GAME_PLAYERS);
+    if (sampler != NULL && sampling_tiltProposal(sampler, 3) != NO_ERROR)
+        sampling_deleteSampler(&sampler);
+
+    return sampler;
+}
+
+static long runDrawDeal(void *argument, long operations)
+{
+    const struct DealSampler *sampler = argument;
+    uint64_t state = SEED;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        struct RoundRecord record;
+        double weight;
+        int stratum = sampling_drawStratum(sampler, &state, &weight);
+        sampling_drawDeal(sampler, &record, stratum, 5, &state);
+        sum += record.deck[0];
+    }
+
+    return sum;
+}
+
+static void teardownSampler(void *argument)
+{
+    struct DealSampler *sampler = argument;
+
+    sampling_deleteSampler(&sampler);
+}
+
+/**
+ * @brief The number of rounds dealt by a call of dealer_dealBatch.
+ */
+#define DEALER_BATCH 256
+
+/**
+ * @brief State of the round_distributeDeck benchmark: a deck shuffled and
+ *        distributed to a table of 4 players, the scalar way of dealing.
+ */
+struct DistributeState {
+    struct Deck *deck;
+    struct Round *round;
+    struct Player *players[MAX_GAME_PLAYERS];
+};
+
+static void teardownDistribute(void *argument);
+
+static void *setupDistribute(void)
+{
+    struct DistributeState *state = calloc(1, sizeof(struct DistributeState));
+    if (state == NULL)
+        return NULL;
+
+    createPlayers(state->players);
+    state->deck = deck_createDeck();
+    state->round = round_createRound();
+    if (state->deck == NULL || state->round == NULL) {
+        teardownDistribute(state);
+        return NULL;
+    }
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (round_addPlayer(state->players[i], state->round) != NO_ERROR) {
+            teardownDistribute(state);
+            return NULL;
+        }
+
+    return state;
+}
+
+/**
+ * @brief Helper to give the cards of the players back to the deck.
+ */
+static void collectCards(struct DistributeState *state)
+{
+    int position = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        for (int j = 0; j < MAX_CARDS; j++)
+            if (state->players[i]->hand[j] != NULL) {
+                while (state->deck->cards[position] != NULL)
+                    position++;
+                state->deck->cards[position] = state->players[i]->hand[j];
+                state->players[i]->hand[j] = NULL;
+            }
+}
+
+static long runDistribute(void *argument, long operations)
+{
+    struct DistributeState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        deck_deckShuffle(state->deck);
+        round_distributeDeck(state->deck, state->round);
+        sum += deck_cardId(state->players[0]->hand[0]);
+        collectCards(state);
+    }
+
+    return sum;
+}
+
+static void teardownDistribute(void *argument)
+{
+    struct DistributeState *state = argument;
+
+    if (state->round != NULL)
+        round_deleteRound(&state->round);
+    if (state->deck != NULL)
+        deck_deleteDeck(&state->deck);
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (state->players[i] != NULL)
+            team_deletePlayer(&state->players[i]);
+    free(state);
+}
+
+/**
+ * @brief State of the dealer_dealBatch benchmark.
+ */
+struct DealerState {
+    struct Dealer dealer;
+    struct DealMasks deals[DEALER_BATCH];
+};
+
+static void *setupDealer(void)
+{
+    struct DealerState *state = malloc(sizeof(struct DealerState));
+    if (state != NULL)
+        dealer_initDealer(&state->dealer, SEED);
+
+    return state;
+}
+
+static long runDealBatch(void *argument, long operations)
+{
+    struct DealerState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i += DEALER_BATCH) {
+        long deals = operations - i < DEALER_BATCH ? operations - i :
+                     DEALER_BATCH;
+        dealer_dealBatch(&state->dealer, MAX_GAME_PLAYERS, state->deals,
+                         deals);
+        sum += state->deals[0].hands[0];
+    }
+
+    return sum;
+}
+
+/**
+ * @brief The number of deals the Bloom filter of the dedup_addDeal
+ *        benchmark is sized for.
+ */
+#define DEDUP_DEALS (1 << 22)
+
+/**
+ * @brief The number of deals kept by the dedup_addDeal benchmark.
+ */
+#define DEDUP_KEPT (1 << 20)
+
+/**
+ * @brief State of the dedup_addDeal benchmark: batches of new deals coming
+ *        out of a dealer, as fast as a generator makes them.
+ */
+struct DedupState {
+    struct Dealer dealer;
+    struct Deduplicator *deduplicator;
+    struct DealMasks deals[DEALER_BATCH];
+};
+
+static void *setupDedup(void)
+{
+    struct DedupState *state = malloc(sizeof(struct DedupState));
+    if (state == NULL)
+        return NULL;
+
+    dealer_initDealer(&state->dealer, SEED);
+    state->deduplicator = dedup_createDeduplicator(DEDUP_DEALS, DEDUP_KEPT);
+    if (state->deduplicator == NULL) {
+        free(state);
+        return NULL;
+    }
+
+    return state;
+}
+
+static long runAddDeal(void *argument, long operations)
+{
+    struct DedupState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i += DEALER_BATCH) {
+        long deals = operations - i < DEALER_BATCH ? operations - i :
+                     DEALER_BATCH;
+        dealer_dealBatch(&state->dealer, MAX_GAME_PLAYERS, state->deals,
+                         deals);
+        for (long j = 0; j < deals; j++)
+            sum += dedup_addDeal(state->deduplicator, &state->deals[j],
+                                 SuitEnd);
+    }
+
+    return sum;
+}
+
+static long runAddDeals(void *argument, long operations)
+{
+    struct DedupState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i += DEALER_BATCH) {
+        long deals = operations - i < DEALER_BATCH ? operations - i :
+                     DEALER_BATCH;
+        dealer_dealBatch(&state->dealer, MAX_GAME_PLAYERS, state->deals,
+                         deals);
+        sum += dedup_addDeals(state->deduplicator, state->deals, deals,
+                              SuitEnd, NULL);
+    }
+
+    return sum;
+}
+
+static void teardownDedup(void *argument)
+{
+    struct DedupState *state = argument;
+
+    dedup_deleteDeduplicator(&state->deduplicator);
+    free(state);
+}
+
+const struct Benchmark GAME_BENCHMARKS[] = {
+    {"deck_compareCards", setupCompare, runCompare, free},
+    {"round_handWinner", setupHand, runHand, teardownHand},
+    {"round_handWinner_hooks", setupHookedHand, runHand, teardownHand},
+    {"game_checkCard", setupTable, runCheckCard, teardownTable},
+    {"game_findNextAllowedCard", setupTable, runFindNextAllowedCard,
+     teardownTable},
+    {"notation_parseRound", setupNotation, runParseRound, free},
+    {"locations_computeProbabilities", setupLocations, runLocations, free},
+    {"locations_sampleDeals", setupWorlds, runSampleDeals, teardownWorlds},
+    {"worlds_updatePool", setupWorlds, runUpdatePool, teardownWorlds},
+    {"opponents_addRound", setupOpponents, runAddRound, teardownOpponents},
+    {"opponents_find", setupOpponents, runFind, teardownOpponents},
+    {"network_evaluate", setupNetwork, runEvaluate, teardownNetwork},
+    {"network_addGradients", setupNetwork, runAddGradients, teardownNetwork},
+    {"sampling_drawDeal", setupSampler, runDrawDeal, teardownSampler},
+    {"round_distributeDeck", setupDistribute, runDistribute,
+     teardownDistribute},
+    {"dealer_dealBatch", setupDealer, runDealBatch, free},
+    {"dedup_addDeal", setupDedup, runAddDeal, teardownDedup},
+    {"dedup_addDeals", setupDedup, runAddDeals, teardownDedup},
+    {NULL, NULL, NULL, NULL}
+};
+
@@ -0,0 +1,260 @@
+/**
+ * @file bench-server.c
+ * @brief Benchmarks of the table service.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+
+#include <cruceGame.h>
+#include <connection.h>
+#include <migration.h>
+#include <accounting.h>
+
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief The seed of the migrated game.
+ */
+#define SEED 20141
+
+/**
+ * @brief State of the migration_sendTable benchmark: a table of 4 players
+ *        in the middle of a round, each with an event and a view queued.
+ */
+struct MigrationState {
+    struct Game *game;
+    struct Connection *connections[MAX_GAME_PLAYERS];
+    int players[MAX_GAME_PLAYERS][2];
+    int hosts[2];
+};
+
+static void teardownMigration(void *argument)
+{
+    struct MigrationState *state = argument;
+
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (state->connections[i] != NULL)
+            connection_deleteConnection(&state->connections[i]);
+        for (int j = 0; j < 2; j++)
+            if (state->players[i][j] >= 0)
+                close(state->players[i][j]);
+    }
+    for (int i = 0; i < 2; i++)
+        if (state->hosts[i] >= 0)
+            close(state->hosts[i]);
+    if (state->game != NULL)
+        replay_deleteGame(&state->game);
+    free(state);
+}
+
+static void *setupMigration(void)
+{
+    struct MigrationState *state = calloc(1, sizeof(struct MigrationState));
+    if (state == NULL)
+        return NULL;
+
+    state->hosts[0] = state->hosts[1] = -1;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        state->players[i][0] = state->players[i][1] = -1;
+
+    struct RoundRecord record;
+    if (simulation_playRound(&record, MAX_GAME_PLAYERS, SEED, 0) != NO_ERROR ||
+        (state->game = replay_createGame(&record, 10)) == NULL ||
+        socketpair(AF_UNIX, SOCK_STREAM, 0, state->hosts) < 0) {
+        teardownMigration(state);
+        return NULL;
+    }
+
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, state->players[i]) < 0 ||
+            (state->connections[i] =
+                 connection_createConnection(state->players[i][0])) == NULL) {
+            teardownMigration(state);
+            return NULL;
+        }
+        connection_queueEvent(state->connections[i], "card AH\n", 8);
+        connection_queueView(state->connections[i], "view 10\n", 8);
+    }
+
+    return state;
+}
+
+/**
+ * @brief Moves the table to the same process, as a restart would, and
+ *        lets the copy go.
+ */
+static long runMigration(void *argument, long operations)
+{
+    struct MigrationState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        struct Game *game = NULL;
+        struct Connection *connections[MAX_GAME_PLAYERS] = {NULL};
+
+        if (migration_sendTable(state->hosts[0], state->game,
+                                state->connections) != NO_ERROR ||
+            migration_receiveTable(state->hosts[1], &game,
+                                   connections) != NO_ERROR)
+            return -1;
+
+        sum += game->numberPlayers;
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++) {
+            close(connections[j]->fd);
+            connection_deleteConnection(&connections[j]);
+        }
+        replay_deleteGame(&game);
+    }
+
+    return sum;
+}
+
+/**
+ * @brief The number of tables of the migration_sendHost benchmark. The
+ *        received player sockets stay under the usual limit of 1024 open
+ *        files.
+ */
+#define HOST_TABLES 200
+
+/**
+ * @brief State of the migration_sendHost benchmark: a host with
+ *        HOST_TABLES tables like the one of migration_sendTable, whose
+ *        players share a socket, and a listener.
+ */
+struct HostBenchState {
+    struct HostState host;
+    struct Game *games[HOST_TABLES];
+    struct Connection *connections[HOST_TABLES][MAX_GAME_PLAYERS];
+    int players[2];
+    int hosts[2];
+};
+
+static void teardownHost(void *argument)
+{
+    struct HostBenchState *state = argument;
+
+    for (int i = 0; i < HOST_TABLES; i++) {
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++)
+            if (state->connections[i][j] != NULL)
+                connection_deleteConnection(&state->connections[i][j]);
+        if (state->games[i] != NULL)
+            replay_deleteGame(&state->games[i]);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (state->players[i] >= 0)
+            close(state->players[i]);
+        if (state->hosts[i] >= 0)
+            close(state->hosts[i]);
+    }
+    free(state);
+}
+
+static void *setupHost(void)
+{
+    struct HostBenchState *state = calloc(1, sizeof(struct HostBenchState));
+    if (state == NULL)
+        return NULL;
+
+    state->players[0] = state->players[1] = -1;
+    state->hosts[0] = state->hosts[1] = -1;
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, state->players) < 0 ||
+        socketpair(AF_UNIX, SOCK_STREAM, 0, state->hosts) < 0) {
+        teardownHost(state);
+        return NULL;
+    }
+
+    for (int i = 0; i < HOST_TABLES; i++) {
+        struct RoundRecord record;
+        if (simulation_playRound(&record, MAX_GAME_PLAYERS, SEED, i) !=
+            NO_ERROR ||
+            (state->games[i] = replay_createGame(&record, i % 24)) == NULL) {
+            teardownHost(state);
+            return NULL;
+        }
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++) {
+            state->connections[i][j] =
+                connection_createConnection(state->players[0]);
+            if (state->connections[i][j] == NULL) {
+                teardownHost(state);
+                return NULL;
+            }
+            connection_queueEvent(state->connections[i][j], "card AH\n", 8);
+            connection_queueView(state->connections[i][j], "view 10\n", 8);
+        }
+    }
+
+    state->host.listeners[0] = state->players[1];
+    state->host.listenersNumber = 1;
+    state->host.games = state->games;
+    state->host.connections = state->connections;
+    state->host.tablesNumber = HOST_TABLES;
+
+    return state;
+}
+
+/**
+ * @brief Restarts the host in the same process and lets the copy go.
+ */
+static long runHost(void *argument, long operations)
+{
+    struct HostBenchState *state = argument;
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++) {
+        struct HostState host;
+
+        if (migration_sendHost(state->hosts[0], &state->host) != NO_ERROR ||
+            migration_receiveHost(state->hosts[1], &host) != NO_ERROR)
+            return -1;
+
+        sum += host.tablesNumber;
+        migration_clearHost(&host);
+    }
+
+    return sum;
+}
+
+/**
+ * @brief The number of tables of the accounting_chargeAction benchmark.
+ */
+#define ACCOUNTING_TABLES 1024
+
+static void *setupAccounting(void)
+{
+    return accounting_createAccounting(ACCOUNTING_TABLES);
+}
+
+/**
+ * @brief Charges empty actions dispatched in a row to the tables in turn.
+ */
+static long runAccounting(void *argument, long operations)
+{
+    struct Accounting *accounting = argument;
+    int64_t start = accounting_threadTime();
+    long sum = 0;
+
+    for (long i = 0; i < operations; i++)
+        sum += accounting_chargeAction(accounting, i % ACCOUNTING_TABLES,
+                                       i % MAX_GAME_PLAYERS, BOT_ACTION,
+                                       &start);
+
+    return sum;
+}
+
+static void teardownAccounting(void *argument)
+{
+    struct Accounting *accounting = argument;
+    accounting_deleteAccounting(&accounting);
+}
+
+const struct Benchmark SERVER_BENCHMARKS[] = {
+    {"migration_sendTable", setupMigration, runMigration, teardownMigration},
+    {"migration_sendHost", setupHost, runHost, teardownHost},
+    {"accounting_chargeAction", setupAccounting, runAccounting,
+     teardownAccounting},
+    {NULL, NULL, NULL, NULL}
+};
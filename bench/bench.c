@@ -0,0 +1,128 @@
+/**
+ * @file bench.c
+ * @brief Contains implementations of the functions used to run benchmarks
+ *        and report their results.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "bench.h"
+
+#include <errors.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * @brief The maximum number of measured repetitions.
+ */
+#define MAX_REPETITIONS 101
+
+volatile long benchSink;
+
+double bench_now(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return time.tv_sec + time.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Helper to compare durations, for qsort.
+ */
+static int compareDurations(const void *first, const void *second)
+{
+    double a = *(const double *)first;
+    double b = *(const double *)second;
+
+    return (a > b) - (a < b);
+}
+
+int bench_run(const struct Benchmark *benchmark,
+              const struct BenchOptions *options, struct BenchResult *result)
+{
+    if (benchmark == NULL || options == NULL || result == NULL)
+        return POINTER_NULL;
+    if (options->repetitions < 1 || options->repetitions > MAX_REPETITIONS)
+        return ILLEGAL_VALUE;
+
+    void *state = benchmark->setup != NULL ? benchmark->setup() : NULL;
+    if (benchmark->setup != NULL && state == NULL)
+        return MALLOC_ERROR;
+
+    long operations = 1;
+    while (1) {
+        double start = bench_now();
+        benchSink += benchmark->run(state, operations);
+        if (bench_now() - start >= options->minimumTime ||
+            operations > (1L << 40))
+            break;
+        operations *= 2;
+    }
+
+    double durations[MAX_REPETITIONS];
+    if (options->counters != NULL)
+        counters_start(options->counters);
+    for (int i = 0; i < options->repetitions; i++) {
+        double start = bench_now();
+        benchSink += benchmark->run(state, operations);
+        durations[i] = bench_now() - start;
+    }
+    if (options->counters != NULL)
+        counters_stop(options->counters, result->counters);
+    else
+        for (int i = 0; i < CounterEnd; i++)
+            result->counters[i] = -1;
+
+    if (benchmark->teardown != NULL)
+        benchmark->teardown(state);
+
+    qsort(durations, options->repetitions, sizeof(double), compareDurations);
+    result->operations = operations;
+    result->nanoseconds = durations[options->repetitions / 2] * 1e9 /
+                          operations;
+
+    double total = (double)operations * options->repetitions;
+    for (int i = 0; i < CounterEnd; i++)
+        if (result->counters[i] >= 0)
+            result->counters[i] /= total;
+
+    return NO_ERROR;
+}
+
+void bench_printHeader(const int counters)
+{
+    printf("%-32s %12s %10s", "benchmark", "operations", "ns/op");
+    if (counters) {
+        for (int i = 0; i < CounterEnd; i++)
+            printf(" %10s", COUNTER_NAMES[i]);
+        printf(" %6s", "IPC");
+    }
+    printf("\n");
+}
+
+void bench_printResult(const char *name, const struct BenchResult *result,
+                       const int counters)
+{
+    printf("%-32s %12ld %10.2f", name, result->operations,
+           result->nanoseconds);
+    if (counters) {
+        for (int i = 0; i < CounterEnd; i++) {
+            if (result->counters[i] >= 0)
+                printf(" %10.3f", result->counters[i]);
+            else
+                printf(" %10s", "-");
+        }
+
+        double cycles = result->counters[COUNTER_CYCLES];
+        double instructions = result->counters[COUNTER_INSTRUCTIONS];
+        if (cycles > 0 && instructions >= 0)
+            printf(" %6.2f", instructions / cycles);
+        else
+            printf(" %6s", "-");
+    }
+    printf("\n");
+}
+
@@ -0,0 +1,125 @@
+/**
+ * @file bench.h
+ * @brief Benchmark structure and the functions used to run benchmarks and
+ *        report their results.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "counters.h"
+
+/**
+ * @struct Benchmark
+ * @brief An operation measured by the benchmark runner.
+ *
+ * @var Benchmark::name
+ *     The name of the benchmark, usually the name of the function measured.
+ * @var Benchmark::setup
+ *     Builds the state used by run. It is not measured.
+ * @var Benchmark::run
+ *     Does the operation a number of times on the state. Returns a value
+ *     computed from the results, so the operations are not optimized away.
+ * @var Benchmark::teardown
+ *     Frees the state.
+ */
+struct Benchmark {
+    const char *name;
+    void *(*setup)(void);
+    long (*run)(void *state, long operations);
+    void (*teardown)(void *state);
+};
+
+/**
+ * @struct BenchOptions
+ * @brief Options of the benchmark runner.
+ *
+ * @var BenchOptions::minimumTime
+ *     The minimum duration of a repetition, in seconds.
+ * @var BenchOptions::repetitions
+ *     The number of measured repetitions.
+ * @var BenchOptions::counters
+ *     Counters read around the measured repetitions, NULL for none.
+ */
+struct BenchOptions {
+    double minimumTime;
+    int repetitions;
+    struct Counters *counters;
+};
+
+/**
+ * @struct BenchResult
+ * @brief Result of a benchmark.
+ *
+ * @var BenchResult::operations
+ *     The number of operations of a repetition.
+ * @var BenchResult::nanoseconds
+ *     The median duration of an operation, in nanoseconds.
+ * @var BenchResult::counters
+ *     The value of every counter per operation, negative if the counter is
+ *     not available.
+ */
+struct BenchResult {
+    long operations;
+    double nanoseconds;
+    double counters[CounterEnd];
+};
+
+/**
+ * @brief Benchmarks of the game logic (deck, round, game modules).
+ */
+extern const struct Benchmark GAME_BENCHMARKS[];
+
+/**
+ * @brief Benchmarks of the table service (cruceGameServer).
+ */
+extern const struct Benchmark SERVER_BENCHMARKS[];
+
+/**
+ * @brief Receives the values computed by the benchmarks, so the compiler
+ *        can not drop the operations.
+ */
+extern volatile long benchSink;
+
+/**
+ * @brief Returns the time of a monotonic clock.
+ *
+ * @return The time, in seconds.
+ */
+double bench_now(void);
+
+/**
+ * @brief Runs a benchmark.
+ *
+ * The number of operations of a repetition is doubled until a repetition
+ * lasts at least BenchOptions::minimumTime, then the repetitions are
+ * measured.
+ *
+ * @param benchmark The benchmark.
+ * @param options The options of the runner.
+ * @param result Where the result is stored.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+int bench_run(const struct Benchmark *benchmark,
+              const struct BenchOptions *options, struct BenchResult *result);
+
+/**
+ * @brief Prints the header of the results table.
+ *
+ * @param counters 1 if counter columns are printed, 0 otherwise.
+ */
+void bench_printHeader(const int counters);
+
+/**
+ * @brief Prints the result of a benchmark as a line of the results table.
+ *
+ * @param name The name of the benchmark.
+ * @param result The result.
+ * @param counters 1 if counter columns are printed, 0 otherwise.
+ */
+void bench_printResult(const char *name, const struct BenchResult *result,
+                       const int counters);
+
+#endif
+
@@ -0,0 +1,138 @@
+/**
+ * @file counters.c
+ * @brief Contains implementations of the functions used to read hardware
+ *        performance counters.
+ */
+
+#define _GNU_SOURCE
+
+#include "counters.h"
+
+#include <config.h>
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+const char *COUNTER_NAMES[CounterEnd] = {"cycles", "instr", "L1D-miss",
+                                         "LLC-miss", "br-miss"};
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+
+/**
+ * @brief Helper to open one counter of the calling thread.
+ *
+ * @return The file descriptor of the counter, -1 on failure.
+ */
+static int openCounter(const uint32_t type, const uint64_t config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+int counters_open(struct Counters *counters)
+{
+    static const uint32_t types[CounterEnd] = {
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+        PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE
+    };
+    static const uint64_t configs[CounterEnd] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    int available = 0;
+    for (int i = 0; i < CounterEnd; i++) {
+        counters->fds[i] = openCounter(types[i], configs[i]);
+        if (counters->fds[i] >= 0)
+            available++;
+    }
+
+    return available;
+}
+
+void counters_start(struct Counters *counters)
+{
+    for (int i = 0; i < CounterEnd; i++) {
+        if (counters->fds[i] < 0)
+            continue;
+        ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void counters_stop(struct Counters *counters, double values[CounterEnd])
+{
+    for (int i = 0; i < CounterEnd; i++)
+        if (counters->fds[i] >= 0)
+            ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+    for (int i = 0; i < CounterEnd; i++) {
+        uint64_t data[3];
+        values[i] = -1;
+        if (counters->fds[i] < 0 ||
+            read(counters->fds[i], data, sizeof(data)) != sizeof(data))
+            continue;
+
+        /* data holds the value, the time enabled and the time running. */
+        if (data[2] == 0)
+            values[i] = 0;
+        else
+            values[i] = (double)data[0] * data[1] / data[2];
+    }
+}
+
+void counters_close(struct Counters *counters)
+{
+    for (int i = 0; i < CounterEnd; i++) {
+        if (counters->fds[i] >= 0)
+            close(counters->fds[i]);
+        counters->fds[i] = -1;
+    }
+}
+
+#else
+
+int counters_open(struct Counters *counters)
+{
+    for (int i = 0; i < CounterEnd; i++)
+        counters->fds[i] = -1;
+
+    return 0;
+}
+
+void counters_start(struct Counters *counters)
+{
+}
+
+void counters_stop(struct Counters *counters, double values[CounterEnd])
+{
+    for (int i = 0; i < CounterEnd; i++)
+        values[i] = -1;
+}
+
+void counters_close(struct Counters *counters)
+{
+}
+
+#endif
+
@@ -0,0 +1,79 @@
+/**
+ * @file counters.h
+ * @brief Hardware performance counters read around benchmarks, through
+ *        perf_event_open on Linux. On other systems no counter is
+ *        available.
+ */
+
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+/**
+ * @brief The counters measured.
+ *
+ * CounterEnd is a flag used when iterating.
+ */
+enum Counter {
+    COUNTER_CYCLES = 0,    //!< CPU cycles.
+    COUNTER_INSTRUCTIONS,  //!< Instructions retired.
+    COUNTER_L1D_MISSES,    //!< Level 1 data cache read misses.
+    COUNTER_LLC_MISSES,    //!< Last level cache misses.
+    COUNTER_BRANCH_MISSES, //!< Mispredicted branches.
+    CounterEnd
+};
+
+/**
+ * @brief Short names of the counters, indexed by enum Counter.
+ */
+extern const char *COUNTER_NAMES[CounterEnd];
+
+/**
+ * @struct Counters
+ * @brief The counters of the calling thread.
+ *
+ * @var Counters::fds
+ *     The file descriptor of every counter, -1 if it is not available.
+ */
+struct Counters {
+    int fds[CounterEnd];
+};
+
+/**
+ * @brief Opens the counters of the calling thread, stopped.
+ *
+ * Counters which are not supported by the processor or not allowed by the
+ * system are marked unavailable.
+ *
+ * @param counters The counters.
+ *
+ * @return The number of counters available.
+ */
+int counters_open(struct Counters *counters);
+
+/**
+ * @brief Resets and starts the available counters.
+ *
+ * @param counters The counters.
+ */
+void counters_start(struct Counters *counters);
+
+/**
+ * @brief Stops the counters and reads them.
+ *
+ * Counters which were not counting all the time (because the processor
+ * has fewer registers than counters) are scaled to the whole time.
+ *
+ * @param counters The counters.
+ * @param values The value of every counter, -1 if it is not available.
+ */
+void counters_stop(struct Counters *counters, double values[CounterEnd]);
+
+/**
+ * @brief Closes the counters.
+ *
+ * @param counters The counters.
+ */
+void counters_close(struct Counters *counters);
+
+#endif
+
@@ -0,0 +1,855 @@
+/**
+ * @file latency.c
+ * @brief Measures the latency of move selection routines over a fixed
+ *        corpus of positions, and reports its percentiles.
+ *
+ * The corpus is a file of rounds in notation, each with a Decision tag
+ * holding the number of cards put down before the position:
+ *
+ *     [Decision "9"]
+ *
+ * A position is rebuilt with replay_createGame. The phase of a position
+ * (early, mid or late) is the third of the round in which it is. The
+ * random generator of a routine starts from the same state every time it
+ * decides in a position.
+ *
+ * With a budget, the decisions which take longer are captured with a
+ * ReproRecorder and written to a file, and the decisions of such a file
+ * (see repro.h), also captured by a host, are measured again with
+ * --repro, so a slow decision stays as a benchmark.
+ */
+
+#define _GNU_SOURCE
+
+#include "bench.h"
+
+#include <cruceGame.h>
+
+#include <getopt.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The path of the corpus, when it is not given.
+ */
+#ifndef CORPUS_PATH
+#define CORPUS_PATH "positions.txt"
+#endif
+
+/**
+ * @brief The maximum number of positions of a corpus.
+ */
+#define MAX_POSITIONS 4096
+
+/**
+ * @brief The number of positions generated for every number of players,
+ *        trump and phase.
+ */
+#define GENERATED_POSITIONS 4
+
+/**
+ * @brief The minimum duration of a sample, in seconds. Faster routines
+ *        are called several times for every sample.
+ */
+#define MIN_SAMPLE_TIME 2e-6
+
+/**
+ * @brief The maximum number of decisions captured or replayed in a run.
+ */
+#define MAX_REPROS 256
+
+enum Phase {EARLY = 0, MID, LATE, PhaseEnd};
+
+static const char *PHASE_NAMES[PhaseEnd] = {"early", "mid", "late"};
+
+/**
+ * @struct Position
+ * @brief A position of the corpus.
+ *
+ * @var Position::record
+ *     The round.
+ * @var Position::cardsNumber
+ *     The number of cards put down before the position.
+ * @var Position::phase
+ *     The phase of the round.
+ */
+struct Position {
+    struct RoundRecord record;
+    int cardsNumber;
+    enum Phase phase;
+};
+
+/**
+ * @struct Decider
+ * @brief A move selection routine.
+ *
+ * @var Decider::name
+ *     The name of the routine.
+ * @var Decider::decide
+ *     Chooses the card put down by a player, without changing the game,
+ *     with a random generator starting from state. Returns the index of
+ *     the card in Player::hand.
+ */
+struct Decider {
+    const char *name;
+    int (*decide)(struct Game *game, struct Hand *hand,
+                  struct Player *player, uint64_t *state);
+};
+
+/**
+ * @brief Helper to find the index of the last card a player can hold.
+ */
+static int lastCard(const struct Game *game)
+{
+    int last = DECK_SIZE / game->numberPlayers - 1;
+
+    return last < MAX_CARDS ? last : MAX_CARDS - 1;
+}
+
+static int decideFirstAllowed(struct Game *game, struct Hand *hand,
+                              struct Player *player, uint64_t *state)
+{
+    (void)state;
+
+    return game_findNextAllowedCard(player, game, hand, lastCard(game));
+}
+
+static int decideLegalMoves(struct Game *game, struct Hand *hand,
+                            struct Player *player, uint64_t *state)
+{
+    (void)state;
+    int first = NOT_FOUND;
+    int count = 0;
+
+    for (int i = 0; i < MAX_CARDS; i++) {
+        if (player->hand[i] == NULL)
+            continue;
+        if (game_checkCard(player, game, hand, i) == 1) {
+            if (first < 0)
+                first = i;
+            count++;
+        }
+    }
+
+    return count > 0 ? first : NOT_FOUND;
+}
+
+static int decideRandomAllowed(struct Game *game, struct Hand *hand,
+                               struct Player *player, uint64_t *state)
+{
+    int allowed[MAX_CARDS];
+    int count = 0;
+
+    for (int i = 0; i < MAX_CARDS; i++)
+        if (player->hand[i] != NULL &&
+            game_checkCard(player, game, hand, i) == 1)
+            allowed[count++] = i;
+
+    return count > 0 ? allowed[simulation_random(state) % count] : NOT_FOUND;
+}
+
+/**
+ * @brief The routines measured.
+ */
+static const struct Decider DECIDERS[] = {
+    {"game_findNextAllowedCard", decideFirstAllowed},
+    {"legalMoves", decideLegalMoves},
+    {"randomAllowed", decideRandomAllowed},
+    {NULL, NULL}
+};
+
+/**
+ * @brief Helper to find the phase of a position.
+ */
+static enum Phase findPhase(const struct RoundRecord *record,
+                            const int cardsNumber)
+{
+    int total = DECK_SIZE / record->playersNumber * record->playersNumber;
+    if (total > MAX_CARDS * record->playersNumber)
+        total = DECK_SIZE;
+
+    int phase = cardsNumber * PhaseEnd / total;
+
+    return phase < PhaseEnd ? phase : LATE;
+}
+
+/**
+ * @brief Reads a whole file.
+ *
+ * @param length Where the length of the file is stored.
+ *
+ * @return The text of the file, to be freed, or NULL on failure.
+ */
+static char *readText(const char *path, size_t *length)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+
+    size_t capacity = 1 << 16;
+    char *text = malloc(capacity);
+    *length = 0;
+    while (text != NULL) {
+        *length += fread(text + *length, 1, capacity - *length, file);
+        if (*length < capacity)
+            break;
+        capacity *= 2;
+        char *bigger = realloc(text, capacity);
+        if (bigger == NULL)
+            free(text);
+        text = bigger;
+    }
+    fclose(file);
+
+    return text;
+}
+
+/**
+ * @brief Reads the positions of a corpus.
+ *
+ * @return The number of positions read on success, negative value on
+ *         failure.
+ */
+static int readCorpus(const char *path, struct Position *positions,
+                      const int size)
+{
+    size_t length;
+    char *text = readText(path, &length);
+    if (text == NULL)
+        return NOT_FOUND;
+
+    int count = 0;
+    size_t start = 0;
+    while (start < length && count < size) {
+        size_t roundLength = notation_roundLength(text + start,
+                                                  length - start);
+        if (roundLength == 0)
+            roundLength = length - start;
+
+        struct Position *position = &positions[count];
+        const char *round = text + start;
+        int consumed = notation_parseRound(&position->record, round,
+                                           roundLength);
+        start += roundLength;
+        if (consumed < 0) {
+            free(text);
+            return consumed;
+        }
+        if (consumed == 0)
+            continue;
+
+        static const char TAG[] = "[Decision \"";
+        const char *tag = NULL;
+        for (size_t i = 0; i + sizeof(TAG) - 1 < roundLength; i++)
+            if (memcmp(round + i, TAG, sizeof(TAG) - 1) == 0)
+                tag = round + i + sizeof(TAG) - 1;
+        if (tag == NULL) {
+            free(text);
+            return SYNTAX_ERROR;
+        }
+
+        struct RoundRecord *record = &position->record;
+        position->cardsNumber = atoi(tag);
+        if (position->cardsNumber < 0 || position->cardsNumber >=
+            record->handsNumber * record->playersNumber) {
+            free(text);
+            return SYNTAX_ERROR;
+        }
+        position->phase = findPhase(record, position->cardsNumber);
+        count++;
+    }
+
+    free(text);
+
+    return count;
+}
+
+/**
+ * @brief Plays a round with random allowed cards, from a random deal.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int playRandomRound(struct RoundRecord *record, const int playersNumber,
+                           const enum Suit trump)
+{
+    static const char *NAMES[MAX_GAME_PLAYERS] = {"North", "East", "South",
+                                                  "West"};
+
+    memset(record, 0, sizeof(struct RoundRecord));
+    record->playersNumber = playersNumber;
+    record->trump = trump;
+    for (int i = 0; i < playersNumber; i++) {
+        strcpy(record->names[i], NAMES[i]);
+        record->teams[i] = playersNumber == MAX_GAME_PLAYERS ? i % 2 : i;
+        record->bids[i] = rand() % 2 == 0 ? 0 : 1 + rand() % 4;
+    }
+    for (int i = 0; i < DECK_SIZE; i++)
+        record->deck[i] = i;
+    for (int i = DECK_SIZE - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int id = record->deck[i];
+        record->deck[i] = record->deck[j];
+        record->deck[j] = id;
+    }
+
+    struct Game *game = replay_createGame(record, 0);
+    if (game == NULL)
+        return MALLOC_ERROR;
+
+    int handId;
+    int position;
+    while (replay_findTurn(game, &handId, &position) == NO_ERROR) {
+        struct Hand *hand = game->round->hands[handId];
+        struct Player *player = hand->players[position];
+        int allowed[MAX_CARDS];
+        int allowedNumber = 0;
+        for (int i = 0; i < MAX_CARDS; i++)
+            if (player->hand[i] != NULL &&
+                game_checkCard(player, game, hand, i) == 1)
+                allowed[allowedNumber++] = i;
+        if (allowedNumber == 0)
+            break;
+        round_putCard(player, allowed[rand() % allowedNumber], handId,
+                      game->round);
+
+        if (position < playersNumber - 1)
+            continue;
+        struct Player *winner = round_handWinner(hand, game->round);
+        if (deck_cardsNumber(game->deck) > 0)
+            round_distributeCard(game->deck, game->round);
+        if (winner != NULL && team_hasCards(winner))
+            round_arrangePlayersHand(game->round,
+                                     round_findPlayerIndexRound(winner,
+                                                                game->round));
+    }
+
+    game_updateScore(game, round_getBidWinner(game->round));
+
+    struct Deck *deck = record_createDeck(record);
+    int error = deck != NULL ? record_captureDeal(record, deck) : MALLOC_ERROR;
+    if (error == NO_ERROR)
+        error = record_captureRound(record, game);
+    if (deck != NULL)
+        deck_deleteDeck(&deck);
+    replay_deleteGame(&game);
+
+    return error;
+}
+
+/**
+ * @brief Writes a generated corpus, with positions of every number of
+ *        players, trump and phase.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int generateCorpus(FILE *file, const unsigned int seed)
+{
+    char text[NOTATION_MAX_ROUND_LENGTH];
+
+    srand(seed);
+    fprintf(file, "%% Positions of the decision latency benchmark, "
+            "generated with seed %u.\n"
+            "%% Decision is the number of cards put down before the "
+            "position.\n\n", seed);
+
+    for (int players = 2; players <= MAX_GAME_PLAYERS; players++) {
+        for (int trump = 0; trump < SuitEnd; trump++) {
+            for (int phase = 0; phase < PhaseEnd; phase++) {
+                for (int i = 0; i < GENERATED_POSITIONS; i++) {
+                    struct RoundRecord record;
+                    int error = playRandomRound(&record, players, trump);
+                    if (error != NO_ERROR)
+                        return error;
+
+                    int total = record.handsNumber * players;
+                    int cardsNumber;
+                    do {
+                        cardsNumber = rand() % total;
+                    } while (findPhase(&record, cardsNumber) != phase);
+
+                    int length = notation_writeRound(&record, text,
+                                                     sizeof(text));
+                    if (length < 0)
+                        return length;
+                    fwrite(text, 1, length - 1, file);
+                    fprintf(file, "[Decision \"%d\"]\n\n", cardsNumber);
+                }
+            }
+        }
+    }
+
+    return ferror(file) ? FULL : NO_ERROR;
+}
+
+/**
+ * @brief Helper to compare samples, for qsort.
+ */
+static int compareSamples(const void *first, const void *second)
+{
+    double a = *(const double *)first;
+    double b = *(const double *)second;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Prints the percentiles of a set of samples, in nanoseconds.
+ */
+static void printPercentiles(const char *name, const char *phase,
+                             double *samples, const int count)
+{
+    if (count == 0)
+        return;
+
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+        sum += samples[i];
+    qsort(samples, count, sizeof(double), compareSamples);
+
+    printf("%-26s %-6s %8d %9.1f %9.1f %9.1f %9.1f %9.1f\n", name, phase,
+           count, sum / count * 1e9, samples[count / 2] * 1e9,
+           samples[count * 90 / 100] * 1e9, samples[count * 99 / 100] * 1e9,
+           samples[count - 1] * 1e9);
+}
+
+/**
+ * @brief Helper to time a decision in a position.
+ *
+ * @param batch The number of calls of the routine.
+ * @param turnTime Where the time taken to find the player is stored.
+ *
+ * @return The time of a call, in seconds.
+ */
+static double timeDecision(const struct Decider *decider, struct Game *game,
+                           const uint64_t state, const int batch,
+                           double *turnTime)
+{
+    int handId;
+    int position;
+
+    double start = bench_now();
+    replay_findTurn(game, &handId, &position);
+    struct Hand *hand = game->round->hands[handId];
+    struct Player *player = hand->players[position];
+    double decideStart = bench_now();
+    *turnTime = decideStart - start;
+
+    for (int k = 0; k < batch; k++) {
+        uint64_t callState = state;
+        benchSink += decider->decide(game, hand, player, &callState);
+    }
+
+    return (bench_now() - decideStart) / batch;
+}
+
+/**
+ * @brief Warms up the caches and the branch predictors on the positions,
+ *        and finds how many calls a sample needs.
+ *
+ * @return The number of calls of a sample.
+ */
+static int warmUpDecider(const struct Decider *decider, struct Game **games,
+                         const uint64_t *states, const int count,
+                         const double warmUp)
+{
+    double turnTime;
+    long calls = 0;
+    double start = bench_now();
+    while (bench_now() - start < warmUp || calls < count) {
+        timeDecision(decider, games[calls % count], states[calls % count], 1,
+                     &turnTime);
+        calls++;
+    }
+    double callTime = (bench_now() - start) / calls;
+
+    return callTime > 0 && callTime < MIN_SAMPLE_TIME ?
+           MIN_SAMPLE_TIME / callTime + 1 : 1;
+}
+
+/**
+ * @brief Measures a routine over the positions.
+ *
+ * @param recorder If it is not NULL, where the samples which take longer
+ *                 than budget are captured.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int measure(const struct Decider *decider, struct Game **games,
+                   const uint64_t *states, const struct Position *positions,
+                   const int count, const int samplesNumber,
+                   const double warmUp, struct ReproRecorder *recorder,
+                   const double budget)
+{
+    int batch = warmUpDecider(decider, games, states, count, warmUp);
+
+    double *samples[PhaseEnd + 1];
+    int sampled[PhaseEnd + 1] = {0};
+    for (int i = 0; i <= PhaseEnd; i++) {
+        samples[i] = malloc(sizeof(double) * count * samplesNumber);
+        if (samples[i] == NULL) {
+            for (int j = 0; j < i; j++)
+                free(samples[j]);
+            return MALLOC_ERROR;
+        }
+    }
+
+    int error = NO_ERROR;
+    for (int i = 0; i < samplesNumber; i++) {
+        for (int j = 0; j < count; j++) {
+            double turnTime;
+            double sample = timeDecision(decider, games[j], states[j], batch,
+                                         &turnTime);
+
+            enum Phase phase = positions[j].phase;
+            samples[phase][sampled[phase]++] = sample;
+            samples[PhaseEnd][sampled[PhaseEnd]++] = sample;
+
+            if (recorder == NULL || error < 0)
+                continue;
+            repro_startDecision(recorder, decider->name, states[j], budget);
+            repro_addPhase(recorder, "turn", turnTime);
+            repro_addPhase(recorder, "decide", sample);
+            error = repro_finishDecision(recorder, games[j],
+                                         turnTime + sample);
+        }
+    }
+
+    printPercentiles(decider->name, "all", samples[PhaseEnd],
+                     sampled[PhaseEnd]);
+    for (int i = 0; i < PhaseEnd; i++)
+        printPercentiles("", PHASE_NAMES[i], samples[i], sampled[i]);
+    for (int i = 0; i <= PhaseEnd; i++)
+        free(samples[i]);
+
+    return error < 0 ? error : NO_ERROR;
+}
+
+/**
+ * @brief Writes the decisions captured by a recorder, and empties it.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int writeRepros(struct ReproRecorder *recorder, FILE *file)
+{
+    char text[REPRO_MAX_LENGTH];
+
+    for (int i = 0; i < recorder->reprosNumber; i++) {
+        int length = repro_writeRepro(&recorder->repros[i], text,
+                                      sizeof(text));
+        if (length < 0)
+            return length;
+        if (fwrite(text, 1, length, file) != (size_t)length)
+            return FULL;
+    }
+
+    return repro_clearRecorder(recorder);
+}
+
+/**
+ * @brief Measures again the decisions of a file of captured decisions,
+ *        every one with the routine, the position and the state of the
+ *        random generator it was captured with.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int measureRepros(const char *path, const int samplesNumber,
+                         const double warmUp)
+{
+    size_t length;
+    char *text = readText(path, &length);
+    if (text == NULL)
+        return NOT_FOUND;
+
+    struct Repro *repro = malloc(sizeof(struct Repro));
+    double *samples = malloc(sizeof(double) * samplesNumber);
+    int error = repro != NULL && samples != NULL ? NO_ERROR : MALLOC_ERROR;
+
+    printf("%-26s %-6s %11s %11s %11s %11s\n", "repro (ns)", "", "budget",
+           "captured", "p50", "max");
+    size_t start = 0;
+    for (int count = 1; error == NO_ERROR && start < length; count++) {
+        int consumed = repro_parseRepro(repro, text + start, length - start);
+        if (consumed <= 0) {
+            error = consumed;
+            break;
+        }
+        start += consumed;
+
+        const struct Decider *decider = DECIDERS;
+        while (decider->name != NULL &&
+               strcmp(decider->name, repro->routine) != 0)
+            decider++;
+        struct Game *game = snapshot_readGame(repro->snapshot,
+                                              repro->snapshotLength);
+        int handId;
+        int position;
+        if (decider->name == NULL || game == NULL ||
+            replay_findTurn(game, &handId, &position) != NO_ERROR) {
+            fprintf(stderr, "%s: decision %d can not be replayed\n", path,
+                    count);
+            if (game != NULL)
+                replay_deleteGame(&game);
+            continue;
+        }
+
+        int batch = warmUpDecider(decider, &game, &repro->state, 1, warmUp);
+        for (int i = 0; i < samplesNumber; i++) {
+            double turnTime;
+            samples[i] = timeDecision(decider, game, repro->state, batch,
+                                      &turnTime);
+        }
+        replay_deleteGame(&game);
+
+        qsort(samples, samplesNumber, sizeof(double), compareSamples);
+        char number[16];
+        sprintf(number, "#%d", count);
+        printf("%-26s %-6s %11.1f %11.1f %11.1f %11.1f\n", repro->routine,
+               number, repro->budget * 1e9, repro->elapsed * 1e9,
+               samples[samplesNumber / 2] * 1e9,
+               samples[samplesNumber - 1] * 1e9);
+    }
+
+    free(samples);
+    free(repro);
+    free(text);
+
+    return error;
+}
+
+/**
+ * @brief Prints the usage of the program.
+ */
+static void printUsage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTION]... [ROUTINE]...\n"
+            "Measures the latency of move selection routines over a corpus "
+            "of positions.\n\n"
+            "  -f, --corpus=FILE     the corpus (default %s)\n"
+            "  -g, --generate=FILE   write a new corpus to FILE and exit\n"
+            "  -s, --seed=N          the seed of a generated corpus and of "
+            "the random\n"
+            "                        routines (default 1)\n"
+            "  -n, --samples=N       samples of every position (default 50)\n"
+            "  -w, --warm-up=SECONDS warm-up of every routine (default 0.2)\n"
+            "  -c, --cpu=N           pin the process to a CPU (default: the "
+            "current one)\n"
+            "  -b, --budget=NS       the time of a decision, for --outliers "
+            "(default 10000)\n"
+            "  -o, --outliers=FILE   write the decisions longer than the "
+            "budget to FILE\n"
+            "  -R, --repro=FILE      measure the decisions of FILE, instead "
+            "of the corpus\n"
+            "  -l, --list            list the routines\n"
+            "  -h, --help            print this help\n",
+            name, CORPUS_PATH);
+}
+
+/**
+ * @brief Pins the process to a CPU.
+ */
+static void pinProcess(const char *name, int cpu)
+{
+    cpu = cpu >= 0 ? cpu : sched_getcpu();
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    if (cpu < 0 || sched_setaffinity(0, sizeof(cpus), &cpus) != 0)
+        fprintf(stderr, "%s: the process can not be pinned to CPU %d\n",
+                name, cpu);
+    else
+        printf("pinned to CPU %d\n", cpu);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *corpusPath = CORPUS_PATH;
+    const char *generatePath = NULL;
+    unsigned int seed = 1;
+    int samplesNumber = 50;
+    double warmUp = 0.2;
+    int cpu = -1;
+    int list = 0;
+    double budget = 1e-5;
+    const char *outliersPath = NULL;
+    const char *reproPath = NULL;
+    struct option longOptions[] = {
+        {"corpus", required_argument, 0, 'f'},
+        {"generate", required_argument, 0, 'g'},
+        {"seed", required_argument, 0, 's'},
+        {"samples", required_argument, 0, 'n'},
+        {"warm-up", required_argument, 0, 'w'},
+        {"cpu", required_argument, 0, 'c'},
+        {"budget", required_argument, 0, 'b'},
+        {"outliers", required_argument, 0, 'o'},
+        {"repro", required_argument, 0, 'R'},
+        {"list", no_argument, 0, 'l'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "f:g:s:n:w:c:b:o:R:lh",
+                                 longOptions, NULL)) != -1) {
+        switch (option) {
+        case 'f':
+            corpusPath = optarg;
+            break;
+        case 'g':
+            generatePath = optarg;
+            break;
+        case 's':
+            seed = strtoul(optarg, NULL, 10);
+            break;
+        case 'n':
+            samplesNumber = atoi(optarg);
+            break;
+        case 'w':
+            warmUp = atof(optarg);
+            break;
+        case 'c':
+            cpu = atoi(optarg);
+            break;
+        case 'b':
+            budget = atof(optarg) * 1e-9;
+            break;
+        case 'o':
+            outliersPath = optarg;
+            break;
+        case 'R':
+            reproPath = optarg;
+            break;
+        case 'l':
+            list = 1;
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (samplesNumber < 1 || !(budget >= 0)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (list) {
+        for (int i = 0; DECIDERS[i].name != NULL; i++)
+            printf("%s\n", DECIDERS[i].name);
+        return EXIT_SUCCESS;
+    }
+
+    if (generatePath != NULL) {
+        FILE *file = fopen(generatePath, "w");
+        if (file == NULL) {
+            perror(generatePath);
+            return EXIT_FAILURE;
+        }
+        int error = generateCorpus(file, seed);
+        if (fclose(file) != 0 || error != NO_ERROR) {
+            fprintf(stderr, "%s: generating the corpus failed (%d)\n",
+                    argv[0], error);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (reproPath != NULL) {
+        pinProcess(argv[0], cpu);
+        int error = measureRepros(reproPath, samplesNumber, warmUp);
+        if (error != NO_ERROR) {
+            fprintf(stderr, "%s: %s: the decisions can not be read (%d)\n",
+                    argv[0], reproPath, error);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    struct Position *positions = malloc(sizeof(struct Position) *
+                                        MAX_POSITIONS);
+    struct Game **games = malloc(sizeof(struct Game *) * MAX_POSITIONS);
+    uint64_t *states = malloc(sizeof(uint64_t) * MAX_POSITIONS);
+    int count = positions != NULL && games != NULL && states != NULL ?
+                readCorpus(corpusPath, positions, MAX_POSITIONS) :
+                MALLOC_ERROR;
+    if (count <= 0) {
+        fprintf(stderr, "%s: %s: no position read (%d)\n", argv[0],
+                corpusPath, count);
+        free(positions);
+        free(games);
+        free(states);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < count; i++) {
+        states[i] = simulation_seed(seed, i);
+        games[i] = replay_createGame(&positions[i].record,
+                                     positions[i].cardsNumber);
+        if (games[i] == NULL) {
+            fprintf(stderr, "%s: position %d can not be rebuilt\n", argv[0],
+                    i + 1);
+            for (int j = 0; j < i; j++)
+                replay_deleteGame(&games[j]);
+            free(positions);
+            free(games);
+            free(states);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%d positions, ", count);
+    pinProcess(argv[0], cpu);
+
+    int status = EXIT_SUCCESS;
+    FILE *outliers = NULL;
+    struct ReproRecorder *recorder = NULL;
+    if (outliersPath != NULL) {
+        outliers = fopen(outliersPath, "w");
+        recorder = repro_createRecorder(MAX_REPROS);
+        if (outliers == NULL || recorder == NULL) {
+            perror(outliersPath);
+            status = EXIT_FAILURE;
+        }
+    }
+
+    printf("%-26s %-6s %8s %9s %9s %9s %9s %9s\n", "routine (ns)", "phase",
+           "samples", "mean", "p50", "p90", "p99", "max");
+    for (int i = 0; status == EXIT_SUCCESS && DECIDERS[i].name != NULL;
+         i++) {
+        int selected = optind == argc;
+        for (int j = optind; j < argc; j++)
+            if (strstr(DECIDERS[i].name, argv[j]) != NULL)
+                selected = 1;
+        if (selected && measure(&DECIDERS[i], games, states, positions,
+                                count, samplesNumber, warmUp, recorder,
+                                budget) != NO_ERROR)
+            status = EXIT_FAILURE;
+        if (selected && recorder != NULL &&
+            writeRepros(recorder, outliers) != NO_ERROR)
+            status = EXIT_FAILURE;
+    }
+
+    if (recorder != NULL) {
+        printf("%ld of %ld decisions longer than %.1f ns captured in %s, "
+               "%ld dropped\n", recorder->capturedNumber,
+               recorder->decisionsNumber, budget * 1e9, outliersPath,
+               recorder->droppedNumber);
+        repro_deleteRecorder(&recorder);
+    }
+    if (outliers != NULL && fclose(outliers) != 0) {
+        perror(outliersPath);
+        status = EXIT_FAILURE;
+    }
+    for (int i = 0; i < count; i++)
+        replay_deleteGame(&games[i]);
+    free(positions);
+    free(games);
+    free(states);
+
+    return status;
+}
+
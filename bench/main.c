@@ -0,0 +1,142 @@
+/**
+ * @file main.c
+ * @brief Runs the benchmarks and prints their results.
+ */
+
+#include "bench.h"
+#include "counters.h"
+
+#include <errors.h>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The benchmark suites, ended by NULL.
+ */
+static const struct Benchmark *SUITES[] = {GAME_BENCHMARKS, SERVER_BENCHMARKS,
+                                           NULL};
+
+/**
+ * @brief Prints the usage of the program.
+ */
+static void printUsage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTION]... [FILTER]...\n"
+            "Runs the benchmarks whose names contain one of the filters.\n\n"
+            "  -c, --counters        read hardware performance counters\n"
+            "  -t, --time=SECONDS    minimum duration of a repetition "
+            "(default 0.1)\n"
+            "  -r, --repetitions=N   measured repetitions (default 5)\n"
+            "  -l, --list            list the benchmarks\n"
+            "  -h, --help            print this help\n",
+            name);
+}
+
+/**
+ * @brief Checks if the name of a benchmark matches the filters.
+ */
+static int matches(const char *name, char *filters[], const int count)
+{
+    if (count == 0)
+        return 1;
+    for (int i = 0; i < count; i++)
+        if (strstr(name, filters[i]) != NULL)
+            return 1;
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    struct BenchOptions options = {0.1, 5, NULL};
+    int useCounters = 0;
+    int list = 0;
+    struct option longOptions[] = {
+        {"counters", no_argument, 0, 'c'},
+        {"time", required_argument, 0, 't'},
+        {"repetitions", required_argument, 0, 'r'},
+        {"list", no_argument, 0, 'l'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "ct:r:lh", longOptions,
+                                 NULL)) != -1) {
+        switch (option) {
+        case 'c':
+            useCounters = 1;
+            break;
+        case 't':
+            options.minimumTime = atof(optarg);
+            break;
+        case 'r':
+            options.repetitions = atoi(optarg);
+            break;
+        case 'l':
+            list = 1;
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    char **filters = argv + optind;
+    int filtersNumber = argc - optind;
+    if (list) {
+        for (int i = 0; SUITES[i] != NULL; i++)
+            for (const struct Benchmark *benchmark = SUITES[i];
+                 benchmark->name != NULL; benchmark++)
+                if (matches(benchmark->name, filters, filtersNumber))
+                    printf("%s\n", benchmark->name);
+        return EXIT_SUCCESS;
+    }
+
+    struct Counters counters;
+    if (useCounters) {
+        int available = counters_open(&counters);
+        if (available == 0)
+            fprintf(stderr, "%s: no hardware counter is available "
+                    "(check /proc/sys/kernel/perf_event_paranoid)\n",
+                    argv[0]);
+        else
+            options.counters = &counters;
+    }
+
+    int status = EXIT_SUCCESS;
+    bench_printHeader(options.counters != NULL);
+    for (int i = 0; SUITES[i] != NULL; i++) {
+        for (const struct Benchmark *benchmark = SUITES[i];
+             benchmark->name != NULL; benchmark++) {
+            if (!matches(benchmark->name, filters, filtersNumber))
+                continue;
+
+            struct BenchResult result;
+            int error = bench_run(benchmark, &options, &result);
+            if (error != NO_ERROR) {
+                fprintf(stderr, "%s: %s failed (%d)\n", argv[0],
+                        benchmark->name, error);
+                status = EXIT_FAILURE;
+                continue;
+            }
+            bench_printResult(benchmark->name, &result,
+                              options.counters != NULL);
+        }
+    }
+    if (options.counters != NULL)
+        printf("Counters are per operation.\n");
+
+    if (useCounters)
+        counters_close(&counters);
+
+    return status;
+}
+
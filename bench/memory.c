@@ -0,0 +1,355 @@
+/**
+ * @file memory.c
+ * @brief Measures the memory used by live tables, for every number of
+ *        players and for every representation of a table.
+ *
+ * The allocation functions are wrapped at link time (see Makefile.am), and
+ * the library is linked statically, so every allocation of the library is
+ * counted. The resident set size is read from /proc/self/statm, and the
+ * freed memory is returned to the system after every measure, so it is not
+ * reused by the next one.
+ */
+
+#define _GNU_SOURCE
+
+#include <cruceGame.h>
+
+#include <getopt.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @struct HeapUsage
+ * @brief Counters of the wrapped allocation functions.
+ *
+ * @var HeapUsage::bytes
+ *     The usable size of the live blocks.
+ * @var HeapUsage::blocks
+ *     The number of live blocks.
+ * @var HeapUsage::calls
+ *     The number of successful malloc, calloc and realloc calls.
+ */
+struct HeapUsage {
+    long bytes;
+    long blocks;
+    long calls;
+};
+
+static struct HeapUsage heapUsage;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+void __real_free(void *pointer);
+
+void *__wrap_malloc(size_t size)
+{
+    void *pointer = __real_malloc(size);
+    if (pointer != NULL) {
+        heapUsage.bytes += malloc_usable_size(pointer);
+        heapUsage.blocks++;
+        heapUsage.calls++;
+    }
+
+    return pointer;
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    void *pointer = __real_calloc(count, size);
+    if (pointer != NULL) {
+        heapUsage.bytes += malloc_usable_size(pointer);
+        heapUsage.blocks++;
+        heapUsage.calls++;
+    }
+
+    return pointer;
+}
+
+void *__wrap_realloc(void *pointer, size_t size)
+{
+    size_t oldSize = pointer != NULL ? malloc_usable_size(pointer) : 0;
+    void *newPointer = __real_realloc(pointer, size);
+    if (newPointer == NULL)
+        return NULL;
+
+    heapUsage.bytes += (long)malloc_usable_size(newPointer) - (long)oldSize;
+    heapUsage.blocks += pointer == NULL;
+    heapUsage.calls++;
+
+    return newPointer;
+}
+
+void __wrap_free(void *pointer)
+{
+    if (pointer != NULL) {
+        heapUsage.bytes -= malloc_usable_size(pointer);
+        heapUsage.blocks--;
+    }
+    __real_free(pointer);
+}
+
+/**
+ * @brief Reads the resident set size of the process.
+ *
+ * @return The resident set size in bytes, 0 if it can not be read.
+ */
+static long residentSize(void)
+{
+    FILE *file = fopen("/proc/self/statm", "r");
+    long pages = 0;
+    long resident = 0;
+
+    if (file == NULL)
+        return 0;
+    if (fscanf(file, "%ld %ld", &pages, &resident) != 2)
+        resident = 0;
+    fclose(file);
+
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * @struct Representation
+ * @brief A way of keeping a live table in memory.
+ *
+ * @var Representation::name
+ *     The name of the representation.
+ * @var Representation::create
+ *     Builds a dealt table with a number of players. Returns NULL on
+ *     failure.
+ * @var Representation::destroy
+ *     Frees a table.
+ */
+struct Representation {
+    const char *name;
+    void *(*create)(const int playersNumber);
+    void (*destroy)(void *table);
+};
+
+static void destroyGame(void *table);
+
+/**
+ * @brief Builds a live table: the players and their teams, the round and
+ *        the dealt deck, as the curses game does.
+ */
+static void *createGame(const int playersNumber)
+{
+    static const char *NAMES[MAX_GAME_PLAYERS] = {"North", "East", "South",
+                                                  "West"};
+
+    struct Game *game = game_createGame(11);
+    if (game == NULL)
+        return NULL;
+
+    for (int i = 0; i < playersNumber; i++) {
+        struct Player *player = team_createPlayer(NAMES[i], 1);
+        if (player == NULL || game_addPlayer(player, game) != NO_ERROR) {
+            if (player != NULL)
+                team_deletePlayer(&player);
+            destroyGame(game);
+            return NULL;
+        }
+    }
+
+    int teamSize = playersNumber == MAX_GAME_PLAYERS ? 2 : 1;
+    for (int i = 0; i < playersNumber; i += teamSize) {
+        struct Team *team = team_createTeam();
+        if (team == NULL || game_addTeam(team, game) != NO_ERROR) {
+            if (team != NULL)
+                team_deleteTeam(&team);
+            destroyGame(game);
+            return NULL;
+        }
+        for (int j = i; j < i + teamSize; j++)
+            team_addPlayer(team, game->players[j]);
+    }
+
+    game->deck = deck_createDeck();
+    if (game->deck == NULL || game_arrangePlayersRound(game, 0) != NO_ERROR) {
+        destroyGame(game);
+        return NULL;
+    }
+    deck_deckShuffle(game->deck);
+    round_distributeDeck(game->deck, game->round);
+
+    return game;
+}
+
+static void destroyGame(void *table)
+{
+    struct Game *game = table;
+
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (game->players[i] == NULL)
+            continue;
+        for (int j = 0; j < MAX_CARDS; j++)
+            if (game->players[i]->hand[j] != NULL)
+                deck_deleteCard(&game->players[i]->hand[j]);
+        team_deletePlayer(&game->players[i]);
+    }
+    for (int i = 0; i < MAX_GAME_TEAMS; i++)
+        if (game->teams[i] != NULL)
+            team_deleteTeam(&game->teams[i]);
+    if (game->round != NULL)
+        round_deleteRound(&game->round);
+    if (game->deck != NULL)
+        deck_deleteDeck(&game->deck);
+    game_deleteGame(&game);
+}
+
+/**
+ * @brief Builds a live table, then keeps only the record of its deal.
+ */
+static void *createRecord(const int playersNumber)
+{
+    struct Game *game = createGame(playersNumber);
+    if (game == NULL)
+        return NULL;
+
+    struct RoundRecord *record = malloc(sizeof(struct RoundRecord));
+    struct Deck deck;
+    for (int i = 0; i < DECK_SIZE; i++) {
+        struct Player *player = game->round->players[i % playersNumber];
+        if (i / playersNumber < MAX_CARDS)
+            deck.cards[i] = player->hand[i / playersNumber];
+        else
+            deck.cards[i] = game->deck->cards[i];
+    }
+
+    if (record != NULL && (record_captureDeal(record, &deck) != NO_ERROR ||
+                           record_captureRound(record, game) != NO_ERROR)) {
+        free(record);
+        record = NULL;
+    }
+    destroyGame(game);
+
+    return record;
+}
+
+/**
+ * @brief Builds a live table, then keeps only the first variation of its
+ *        round.
+ */
+static void *createVariation(const int playersNumber)
+{
+    struct RoundRecord *record = createRecord(playersNumber);
+    if (record == NULL)
+        return NULL;
+
+    struct Variation *variation = variation_createVariation(record);
+    free(record);
+
+    return variation;
+}
+
+static void destroyVariation(void *table)
+{
+    struct Variation *variation = table;
+
+    variation_deleteVariation(&variation);
+}
+
+/**
+ * @brief The representations measured.
+ */
+static const struct Representation REPRESENTATIONS[] = {
+    {"game", createGame, destroyGame},
+    {"record", createRecord, free},
+    {"variation", createVariation, destroyVariation},
+    {NULL, NULL, NULL}
+};
+
+/**
+ * @brief Prints the usage of the program.
+ */
+static void printUsage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTION]...\n"
+            "Measures the memory used by live tables.\n\n"
+            "  -n, --tables=N        tables built for every measure "
+            "(default 10000)\n"
+            "  -h, --help            print this help\n",
+            name);
+}
+
+int main(int argc, char *argv[])
+{
+    int tablesNumber = 10000;
+    struct option longOptions[] = {
+        {"tables", required_argument, 0, 'n'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "n:h", longOptions,
+                                 NULL)) != -1) {
+        switch (option) {
+        case 'n':
+            tablesNumber = atoi(optarg);
+            if (tablesNumber < 1) {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    void **tables = malloc(tablesNumber * sizeof(void *));
+    if (tables == NULL) {
+        perror(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%-12s %8s %12s %12s %12s %12s\n", "table", "players",
+           "bytes/table", "blocks/table", "allocs/table", "RSS/table");
+    for (int i = 0; REPRESENTATIONS[i].name != NULL; i++) {
+        const struct Representation *representation = &REPRESENTATIONS[i];
+        for (int players = 2; players <= MAX_GAME_PLAYERS; players++) {
+            struct HeapUsage before = heapUsage;
+            long residentBefore = residentSize();
+
+            int built = 0;
+            for (; built < tablesNumber; built++) {
+                tables[built] = representation->create(players);
+                if (tables[built] == NULL)
+                    break;
+            }
+
+            struct HeapUsage after = heapUsage;
+            long residentAfter = residentSize();
+            for (int j = 0; j < built; j++)
+                representation->destroy(tables[j]);
+            malloc_trim(0);
+            if (built < tablesNumber) {
+                fprintf(stderr, "%s: building a %s table failed\n",
+                        argv[0], representation->name);
+                free(tables);
+                return EXIT_FAILURE;
+            }
+
+            printf("%-12s %8d %12.1f %12.2f %12.2f %12.1f\n",
+                   representation->name, players,
+                   (double)(after.bytes - before.bytes) / built,
+                   (double)(after.blocks - before.blocks) / built,
+                   (double)(after.calls - before.calls) / built,
+                   (double)(residentAfter - residentBefore) / built);
+        }
+    }
+
+    free(tables);
+
+    return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,134 @@
+/**
+ * @file accounting.c
+ * @brief Contains implementations of the functions used to count the CPU
+ *        time of the tables of a table service.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "accounting.h"
+#include "errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+struct Accounting *accounting_createAccounting(const int tablesNumber)
+{
+    if (tablesNumber < 1)
+        return NULL;
+
+    struct Accounting *accounting = malloc(sizeof(struct Accounting));
+    if (accounting == NULL)
+        return NULL;
+
+    accounting->usages = calloc(tablesNumber, sizeof(struct TableUsage));
+    if (accounting->usages == NULL) {
+        free(accounting);
+        return NULL;
+    }
+    accounting->tablesNumber = tablesNumber;
+
+    return accounting;
+}
+
+int accounting_deleteAccounting(struct Accounting **accounting)
+{
+    if (accounting == NULL)
+        return POINTER_NULL;
+    if (*accounting == NULL)
+        return ACCOUNTING_NULL;
+
+    free((*accounting)->usages);
+    free(*accounting);
+    *accounting = NULL;
+
+    return NO_ERROR;
+}
+
+int64_t accounting_threadTime(void)
+{
+    struct timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0)
+        return ILLEGAL_VALUE;
+
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+int accounting_chargeAction(struct Accounting *accounting, const int table,
+                            const int seat, const enum ActionKind kind,
+                            int64_t *start)
+{
+    if (accounting == NULL)
+        return ACCOUNTING_NULL;
+    if (start == NULL)
+        return POINTER_NULL;
+    if (table < 0 || table >= accounting->tablesNumber || seat < -1 ||
+        seat >= MAX_GAME_PLAYERS || kind < 0 || kind >= ActionKindEnd ||
+        *start < 0)
+        return ILLEGAL_VALUE;
+
+    int64_t end = accounting_threadTime();
+    int64_t time = end - *start;
+    if (time < 0)
+        return ILLEGAL_VALUE;
+    *start = end;
+
+    struct TableUsage *usage = &accounting->usages[table];
+    __sync_fetch_and_add(&usage->time, time);
+    __sync_fetch_and_add(&usage->kindTimes[kind], time);
+    if (seat >= 0)
+        __sync_fetch_and_add(&usage->seatTimes[seat], time);
+    __sync_fetch_and_add(&usage->actionsNumber, 1);
+
+    return NO_ERROR;
+}
+
+int accounting_clearTable(struct Accounting *accounting, const int table)
+{
+    if (accounting == NULL)
+        return ACCOUNTING_NULL;
+    if (table < 0 || table >= accounting->tablesNumber)
+        return ILLEGAL_VALUE;
+
+    memset(&accounting->usages[table], 0, sizeof(struct TableUsage));
+
+    return NO_ERROR;
+}
+
+int accounting_topTables(const struct Accounting *accounting, int *tables,
+                         const int size)
+{
+    if (accounting == NULL)
+        return ACCOUNTING_NULL;
+    if (tables == NULL)
+        return POINTER_NULL;
+    if (size < 0)
+        return ILLEGAL_VALUE;
+    if (size == 0)
+        return 0;
+
+    int64_t *times = malloc(sizeof(int64_t) * size);
+    if (times == NULL)
+        return MALLOC_ERROR;
+
+    // The time of every table is read once, as the threads may still add
+    // to it, and the top tables are kept sorted.
+    int count = 0;
+    for (int i = 0; i < accounting->tablesNumber; i++) {
+        int64_t time = accounting->usages[i].time;
+        if (time == 0 || (count == size && time <= times[count - 1]))
+            continue;
+
+        int position = count < size ? count++ : count - 1;
+        for (; position > 0 && times[position - 1] < time; position--) {
+            times[position] = times[position - 1];
+            tables[position] = tables[position - 1];
+        }
+        times[position] = time;
+        tables[position] = i;
+    }
+    free(times);
+
+    return count;
+}
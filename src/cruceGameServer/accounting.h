@@ -0,0 +1,149 @@
+/**
+ * @file accounting.h
+ * @brief Accounting structure, which counts the CPU time every table of a
+ *        table service uses, as well as the functions used to find the
+ *        tables which use the most.
+ *
+ * The service reads the CPU clock of the thread before and after every
+ * action it dispatches for a table (a rules call like round_putCard, the
+ * decision of a bot, the serialization of a view or a snapshot) and
+ * charges the difference to the table, to the kind of the action and to
+ * the seat which acted. Reading the clock may cost a system call, so the
+ * end of an action is the start of the next one dispatched by the same
+ * thread. The usage of every table is a fixed slot of counters updated
+ * with atomic additions, so the threads of the service charge their
+ * tables without a lock, and finding the tables which use the most CPU
+ * time only reads the slots, so a runaway bot or a pathological position
+ * shows up at the top.
+ */
+
+#ifndef ACCOUNTING_H
+#define ACCOUNTING_H
+
+#include "platform.h"
+#include "constants.h"
+
+#include <stdint.h>
+
+/**
+ * @brief The kinds of actions dispatched for a table.
+ */
+enum ActionKind {RULES_ACTION = 0, BOT_ACTION, SERIALIZATION_ACTION,
+                 ActionKindEnd};
+
+/**
+ * @struct TableUsage
+ * @brief The CPU time used by a table.
+ *
+ * @var TableUsage::time
+ *     The CPU time of all the actions of the table, in nanoseconds.
+ * @var TableUsage::kindTimes
+ *     The CPU time of the actions of every kind, in nanoseconds.
+ * @var TableUsage::seatTimes
+ *     The CPU time of the actions of every seat, by index in
+ *     Game::players, in nanoseconds.
+ * @var TableUsage::actionsNumber
+ *     The number of actions of the table.
+ */
+struct TableUsage {
+    int64_t time;
+    int64_t kindTimes[ActionKindEnd];
+    int64_t seatTimes[MAX_GAME_PLAYERS];
+    int64_t actionsNumber;
+};
+
+/**
+ * @struct Accounting
+ * @brief The CPU time used by the tables of a table service.
+ *
+ * @var Accounting::usages
+ *     The usage of every table, by index of the table.
+ * @var Accounting::tablesNumber
+ *     The number of tables.
+ */
+struct Accounting {
+    struct TableUsage *usages;
+    int tablesNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates an accounting with all the usages at 0.
+ *
+ * @param tablesNumber The number of tables.
+ *
+ * @return Pointer to the new accounting on success or NULL on failure.
+ */
+EXPORT struct Accounting *accounting_createAccounting(const int tablesNumber);
+
+/**
+ * @brief Frees the memory of an accounting and sets the pointer to NULL.
+ *
+ * @param accounting Pointer to the pointer to the accounting.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int accounting_deleteAccounting(struct Accounting **accounting);
+
+/**
+ * @brief Reads the CPU clock of the calling thread.
+ *
+ * @return The CPU time of the thread, in nanoseconds, negative value on
+ *         failure.
+ */
+EXPORT int64_t accounting_threadTime(void);
+
+/**
+ * @brief Charges the CPU time of an action to a table.
+ *
+ * @param accounting The accounting.
+ * @param table The index of the table.
+ * @param seat The index in Game::players of the player who acted, -1 if
+ *             the action is not done for a player.
+ * @param kind The kind of the action.
+ * @param start The CPU time of the thread when the action started, read
+ *              with accounting_threadTime. The action ends now, and the
+ *              time it ended is stored there, so the next action
+ *              dispatched by the thread starts from it without reading
+ *              the clock again.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int accounting_chargeAction(struct Accounting *accounting,
+                                   const int table, const int seat,
+                                   const enum ActionKind kind,
+                                   int64_t *start);
+
+/**
+ * @brief Sets the usage of a table to 0, when a new table takes its index.
+ *
+ * @param accounting The accounting.
+ * @param table The index of the table.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int accounting_clearTable(struct Accounting *accounting,
+                                 const int table);
+
+/**
+ * @brief Finds the tables which used the most CPU time.
+ *
+ * @param accounting The accounting.
+ * @param tables Where the indexes of the tables are stored, from the one
+ *               which used the most.
+ * @param size The number of tables wanted.
+ *
+ * @return The number of tables stored, at most size and leaving out the
+ *         tables which used no time, negative value on failure.
+ */
+EXPORT int accounting_topTables(const struct Accounting *accounting,
+                                int *tables, const int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
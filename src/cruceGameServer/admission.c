@@ -0,0 +1,208 @@
+/**
+ * @file admission.c
+ * @brief Contains implementations of the functions used to decide when a
+ *        table service starts new tables.
+ */
+
+#include "admission.h"
+#include "errors.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Admission *admission_createAdmission(const double target)
+{
+    if (!(target > 0))
+        return NULL;
+
+    struct Admission *admission = calloc(1, sizeof(struct Admission));
+    if (admission == NULL)
+        return NULL;
+
+    admission->target = target;
+
+    return admission;
+}
+
+int admission_deleteAdmission(struct Admission **admission)
+{
+    if (admission == NULL)
+        return POINTER_NULL;
+    if (*admission == NULL)
+        return ADMISSION_NULL;
+
+    free(*admission);
+    *admission = NULL;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to add a sample to a window, replacing the oldest one.
+ */
+static void addSample(struct LatencyWindow *window, const double seconds)
+{
+    window->samples[window->next] = seconds;
+    window->next = (window->next + 1) % ADMISSION_WINDOW;
+    if (window->samplesNumber < ADMISSION_WINDOW)
+        window->samplesNumber++;
+}
+
+int admission_recordMove(struct Admission *admission, const double seconds)
+{
+    if (admission == NULL)
+        return ADMISSION_NULL;
+    if (!(seconds >= 0))
+        return ILLEGAL_VALUE;
+
+    addSample(&admission->moves, seconds);
+
+    return NO_ERROR;
+}
+
+int admission_recordLag(struct Admission *admission, const double seconds)
+{
+    if (admission == NULL)
+        return ADMISSION_NULL;
+    if (!(seconds >= 0))
+        return ILLEGAL_VALUE;
+
+    addSample(&admission->lags, seconds);
+
+    return NO_ERROR;
+}
+
+static int compareSamples(const void *first, const void *second)
+{
+    double a = *(const double *)first;
+    double b = *(const double *)second;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Helper to compute a percentile of a window.
+ */
+static double percentile(const struct LatencyWindow *window,
+                         const double fraction)
+{
+    double sorted[ADMISSION_WINDOW];
+    int count = window->samplesNumber;
+
+    if (count == 0)
+        return 0;
+
+    memcpy(sorted, window->samples, sizeof(double) * count);
+    qsort(sorted, count, sizeof(double), compareSamples);
+
+    int rank = (int)ceil(fraction * count) - 1;
+    if (rank < 0)
+        rank = 0;
+
+    return sorted[rank];
+}
+
+double admission_moveLatency(const struct Admission *admission,
+                             const double fraction)
+{
+    if (admission == NULL)
+        return ADMISSION_NULL;
+    if (!(fraction >= 0 && fraction <= 1))
+        return ILLEGAL_VALUE;
+
+    return percentile(&admission->moves, fraction);
+}
+
+/**
+ * @brief Helper to compute the highest of the percentiles of the latency
+ *        of the moves and of the lag of the event loop.
+ */
+static double load(const struct Admission *admission)
+{
+    double moves = percentile(&admission->moves, ADMISSION_PERCENTILE);
+    double lags = percentile(&admission->lags, ADMISSION_PERCENTILE);
+
+    return moves > lags ? moves : lags;
+}
+
+/**
+ * @brief Helper to count the bots and the humans of a game.
+ */
+static void countPlayers(const struct Game *game, int *bots, int *humans)
+{
+    *bots = 0;
+    *humans = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (game->players[i] == NULL)
+            continue;
+        if (game->players[i]->isHuman)
+            (*humans)++;
+        else
+            (*bots)++;
+    }
+}
+
+int admission_isOverloaded(const struct Admission *admission)
+{
+    if (admission == NULL)
+        return ADMISSION_NULL;
+
+    return load(admission) > admission->target;
+}
+
+int admission_admitTable(struct Admission *admission,
+                         const struct Game *game)
+{
+    if (admission == NULL)
+        return ADMISSION_NULL;
+    if (game == NULL)
+        return GAME_NULL;
+
+    int bots, humans;
+    countPlayers(game, &bots, &humans);
+    double limit = admission->target;
+    if (bots + humans > 0)
+        limit *= 1 + (ADMISSION_HUMAN_SLACK - 1) * humans / (bots + humans);
+
+    if (load(admission) > limit) {
+        admission->deferred++;
+        return 0;
+    }
+    admission->admitted++;
+
+    return 1;
+}
+
+int admission_chooseShed(const struct Admission *admission,
+                         struct Game *const *games, const int tablesNumber)
+{
+    if (admission == NULL)
+        return ADMISSION_NULL;
+    if (games == NULL && tablesNumber > 0)
+        return POINTER_NULL;
+    if (tablesNumber < 0)
+        return ILLEGAL_VALUE;
+    if (!admission_isOverloaded(admission))
+        return tablesNumber;
+
+    int chosen = tablesNumber;
+    int chosenBots = 0;
+    int chosenHumans = 0;
+    for (int i = 0; i < tablesNumber; i++) {
+        if (games[i] == NULL)
+            continue;
+
+        int bots, humans;
+        countPlayers(games[i], &bots, &humans);
+        if (bots > chosenBots ||
+            (bots == chosenBots && bots > 0 && humans < chosenHumans)) {
+            chosen = i;
+            chosenBots = bots;
+            chosenHumans = humans;
+        }
+    }
+
+    return chosen;
+}
+
@@ -0,0 +1,184 @@
+/**
+ * @file admission.h
+ * @brief Admission structure, which decides when a table service starts
+ *        new tables, as well as helper functions.
+ *
+ * The service times the processing of every move (round_putCard,
+ * round_handWinner, the decision of a bot) and the lag of its event loop,
+ * and records them. New tables are started only while the 99th percentile
+ * of both, over the latest ADMISSION_WINDOW samples, stays under the
+ * target; otherwise they wait, so the tables already running keep their
+ * latency. Tables with humans are given some slack over the target, more
+ * the more humans they have, so under pressure the tables with the most
+ * bots are deferred first, both when they start and while they run.
+ */
+
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "platform.h"
+#include "game.h"
+
+/**
+ * @brief The number of latest samples the percentiles are computed on.
+ */
+#define ADMISSION_WINDOW 512
+
+/**
+ * @brief The percentile kept under the target.
+ */
+#define ADMISSION_PERCENTILE 0.99
+
+/**
+ * @brief How many times the target the percentiles may reach before a new
+ *        table of humans only waits. A table with bots and humans gets a
+ *        share of this slack, in proportion to its humans.
+ */
+#define ADMISSION_HUMAN_SLACK 2.0
+
+/**
+ * @struct LatencyWindow
+ * @brief The latest samples of a latency.
+ *
+ * @var LatencyWindow::samples
+ *     The samples, in seconds, in a ring.
+ * @var LatencyWindow::samplesNumber
+ *     The number of samples, at most ADMISSION_WINDOW.
+ * @var LatencyWindow::next
+ *     The position of the next sample in LatencyWindow::samples.
+ */
+struct LatencyWindow {
+    double samples[ADMISSION_WINDOW];
+    int samplesNumber;
+    int next;
+};
+
+/**
+ * @struct Admission
+ * @brief The state of the admission control of a table service.
+ *
+ * @var Admission::target
+ *     The latency the percentiles are kept under, in seconds.
+ * @var Admission::moves
+ *     The processing latency of the latest moves.
+ * @var Admission::lags
+ *     The latest lags of the event loop.
+ * @var Admission::admitted
+ *     The number of tables admitted.
+ * @var Admission::deferred
+ *     The number of times a table was told to wait.
+ */
+struct Admission {
+    double target;
+    struct LatencyWindow moves;
+    struct LatencyWindow lags;
+    long admitted;
+    long deferred;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates and initializes an admission control.
+ *
+ * @param target The latency the percentiles are kept under, in seconds.
+ *
+ * @return Pointer to the new admission control on success or NULL on
+ *         failure.
+ */
+EXPORT struct Admission *admission_createAdmission(const double target);
+
+/**
+ * @brief Frees an admission control.
+ *
+ * @param admission Pointer to the pointer to the admission control.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int admission_deleteAdmission(struct Admission **admission);
+
+/**
+ * @brief Records the processing latency of a move.
+ *
+ * @param admission The admission control.
+ * @param seconds The latency.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int admission_recordMove(struct Admission *admission,
+                                const double seconds);
+
+/**
+ * @brief Records the lag of the event loop: the time between the moment a
+ *        timer or a socket was due and the moment it was handled.
+ *
+ * @param admission The admission control.
+ * @param seconds The lag.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int admission_recordLag(struct Admission *admission,
+                               const double seconds);
+
+/**
+ * @brief Computes a percentile of the processing latency of the latest
+ *        moves.
+ *
+ * @param admission The admission control.
+ * @param fraction The percentile, between 0 and 1.
+ *
+ * @return The latency in seconds, 0 if no move was recorded, negative
+ *         value on failure.
+ */
+EXPORT double admission_moveLatency(const struct Admission *admission,
+                                    const double fraction);
+
+/**
+ * @brief Checks if the latency of the moves or the lag of the event loop
+ *        is over the target.
+ *
+ * @param admission The admission control.
+ *
+ * @return 1 if the service is overloaded, 0 if it is not, negative value on
+ *         failure.
+ */
+EXPORT int admission_isOverloaded(const struct Admission *admission);
+
+/**
+ * @brief Decides if a new table can start now. A table of bots only waits
+ *        as soon as the service is overloaded; a table with humans waits
+ *        later, see \ref ADMISSION_HUMAN_SLACK.
+ *
+ * @param admission The admission control.
+ * @param game The game of the table, with its players.
+ *
+ * @return 1 if the table can start, 0 if it waits and asks again later,
+ *         negative value on failure.
+ */
+EXPORT int admission_admitTable(struct Admission *admission,
+                                const struct Game *game);
+
+/**
+ * @brief Chooses the table to defer while the service is overloaded: the
+ *        one with the most bots and, among them, the fewest humans. Tables
+ *        without bots are never chosen.
+ *
+ * @param admission The admission control.
+ * @param games The games of the tables.
+ * @param tablesNumber The number of tables.
+ *
+ * @return The index of the table in games, tablesNumber if no table has
+ *         to be deferred, negative value on failure.
+ */
+EXPORT int admission_chooseShed(const struct Admission *admission,
+                                struct Game *const *games,
+                                const int tablesNumber);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
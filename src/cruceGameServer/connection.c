@@ -0,0 +1,329 @@
+/**
+ * @file connection.c
+ * @brief Contains implementations of the functions used to queue the
+ *        output of the clients of a table service.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "connection.h"
+#include "errors.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+struct Connection *connection_createConnection(const int fd)
+{
+    if (fd < 0)
+        return NULL;
+
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+        return NULL;
+
+    struct Connection *connection = malloc(sizeof(struct Connection));
+    if (connection == NULL)
+        return NULL;
+
+    connection->fd = fd;
+    connection->ringStart = 0;
+    connection->ringUsed = 0;
+    connection->messagesNumber = 0;
+    connection->written = 0;
+    connection->overBudgetSince = -1;
+    connection->shed = 0;
+
+    return connection;
+}
+
+int connection_deleteConnection(struct Connection **connection)
+{
+    if (connection == NULL)
+        return POINTER_NULL;
+    if (*connection == NULL)
+        return CONNECTION_NULL;
+
+    free(*connection);
+    *connection = NULL;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to remove a message from the queue, merging the events
+ *        around it.
+ */
+static void removeMessage(struct Connection *connection, const int index)
+{
+    struct OutputMessage *messages = connection->messages;
+
+    connection->messagesNumber--;
+    memmove(&messages[index], &messages[index + 1],
+            (connection->messagesNumber - index) *
+            sizeof(struct OutputMessage));
+
+    if (index > 0 && index < connection->messagesNumber &&
+        messages[index - 1].view < 0 && messages[index].view < 0) {
+        messages[index - 1].length += messages[index].length;
+        removeMessage(connection, index);
+    }
+}
+
+int connection_queueEvent(struct Connection *connection, const char *text,
+                          const size_t length)
+{
+    if (connection == NULL)
+        return CONNECTION_NULL;
+    if (text == NULL)
+        return POINTER_NULL;
+    if (connection->shed)
+        return CONNECTION_CLOSED;
+    if (length == 0)
+        return NO_ERROR;
+
+    int last = connection->messagesNumber - 1;
+    int merged = last >= 0 && connection->messages[last].view < 0;
+    if (length > CONNECTION_BUFFER_SIZE - connection->ringUsed ||
+        (!merged && connection->messagesNumber == CONNECTION_MAX_MESSAGES)) {
+        connection->shed = 1;
+        return FULL;
+    }
+
+    size_t end = (connection->ringStart + connection->ringUsed) %
+                 CONNECTION_BUFFER_SIZE;
+    size_t first = CONNECTION_BUFFER_SIZE - end;
+    if (first > length)
+        first = length;
+    memcpy(connection->ring + end, text, first);
+    memcpy(connection->ring, text + first, length - first);
+    connection->ringUsed += length;
+
+    if (merged) {
+        connection->messages[last].length += length;
+    } else {
+        connection->messages[last + 1].length = length;
+        connection->messages[last + 1].view = -1;
+        connection->messagesNumber++;
+    }
+
+    return NO_ERROR;
+}
+
+int connection_queueView(struct Connection *connection, const char *text,
+                         const size_t length)
+{
+    if (connection == NULL)
+        return CONNECTION_NULL;
+    if (text == NULL)
+        return POINTER_NULL;
+    if (connection->shed)
+        return CONNECTION_CLOSED;
+    if (length == 0 || length > CONNECTION_VIEW_SIZE)
+        return ILLEGAL_VALUE;
+
+    /* The view being written keeps its slot; a view still waiting is
+     * superseded. */
+    int usedSlot = -1;
+    for (int i = connection->messagesNumber - 1; i >= 0; i--) {
+        if (connection->messages[i].view < 0)
+            continue;
+        if (i == 0 && connection->written > 0)
+            usedSlot = connection->messages[i].view;
+        else
+            removeMessage(connection, i);
+    }
+    if (connection->messagesNumber == CONNECTION_MAX_MESSAGES) {
+        connection->shed = 1;
+        return FULL;
+    }
+
+    int slot = usedSlot == 0 ? 1 : 0;
+    memcpy(connection->views[slot], text, length);
+    connection->messages[connection->messagesNumber].length = length;
+    connection->messages[connection->messagesNumber].view = slot;
+    connection->messagesNumber++;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to remove the written bytes from the queue.
+ */
+static void consume(struct Connection *connection, size_t bytes)
+{
+    while (bytes > 0 && connection->messagesNumber > 0) {
+        struct OutputMessage *message = &connection->messages[0];
+        size_t left = message->length - connection->written;
+        size_t taken = bytes < left ? bytes : left;
+
+        if (message->view < 0) {
+            connection->ringStart = (connection->ringStart + taken) %
+                                    CONNECTION_BUFFER_SIZE;
+            connection->ringUsed -= taken;
+        }
+        bytes -= taken;
+        connection->written += taken;
+        if (connection->written == message->length) {
+            connection->written = 0;
+            removeMessage(connection, 0);
+        }
+    }
+}
+
+long connection_flush(struct Connection *connection)
+{
+    if (connection == NULL)
+        return CONNECTION_NULL;
+    if (connection->shed)
+        return CONNECTION_CLOSED;
+    if (connection->messagesNumber == 0)
+        return 0;
+
+    /* An event may wrap around the end of the ring. */
+    struct iovec vectors[2 * CONNECTION_MAX_MESSAGES];
+    int vectorsNumber = 0;
+    size_t ringPosition = connection->ringStart;
+    for (int i = 0; i < connection->messagesNumber; i++) {
+        struct OutputMessage *message = &connection->messages[i];
+        size_t skipped = i == 0 ? connection->written : 0;
+        size_t length = message->length - skipped;
+
+        if (message->view >= 0) {
+            vectors[vectorsNumber].iov_base =
+                connection->views[message->view] + skipped;
+            vectors[vectorsNumber++].iov_len = length;
+            continue;
+        }
+
+        size_t first = CONNECTION_BUFFER_SIZE - ringPosition;
+        if (first > length)
+            first = length;
+        vectors[vectorsNumber].iov_base = connection->ring + ringPosition;
+        vectors[vectorsNumber++].iov_len = first;
+        if (length > first) {
+            vectors[vectorsNumber].iov_base = connection->ring;
+            vectors[vectorsNumber++].iov_len = length - first;
+        }
+        ringPosition = (ringPosition + length) % CONNECTION_BUFFER_SIZE;
+    }
+
+    ssize_t written = writev(connection->fd, vectors, vectorsNumber);
+    if (written < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            return 0;
+        connection->shed = 1;
+        return CONNECTION_CLOSED;
+    }
+    consume(connection, written);
+
+    return written;
+}
+
+long connection_queuedBytes(const struct Connection *connection)
+{
+    if (connection == NULL)
+        return CONNECTION_NULL;
+
+    long bytes = connection->ringUsed;
+    for (int i = 0; i < connection->messagesNumber; i++)
+        if (connection->messages[i].view >= 0)
+            bytes += connection->messages[i].length;
+
+    return connection->messagesNumber > 0 &&
+           connection->messages[0].view >= 0 ?
+           bytes - connection->written : bytes;
+}
+
+int connection_checkBudget(struct Connection *connection, const double now,
+                           const double grace)
+{
+    if (connection == NULL)
+        return CONNECTION_NULL;
+    if (connection->shed)
+        return 1;
+
+    if (connection_queuedBytes(connection) <= CONNECTION_HIGH_WATER)
+        connection->overBudgetSince = -1;
+    else if (connection->overBudgetSince < 0)
+        connection->overBudgetSince = now;
+    else if (now - connection->overBudgetSince > grace)
+        connection->shed = 1;
+
+    return connection->shed;
+}
+
+long connection_saveQueue(const struct Connection *connection,
+                          unsigned char *buffer, const size_t size)
+{
+    if (connection == NULL)
+        return CONNECTION_NULL;
+    if (buffer == NULL)
+        return POINTER_NULL;
+
+    size_t position = 0;
+    size_t ringPosition = connection->ringStart;
+    for (int i = 0; i < connection->messagesNumber; i++) {
+        const struct OutputMessage *message = &connection->messages[i];
+        size_t skipped = i == 0 ? connection->written : 0;
+        size_t length = message->length - skipped;
+        if (size - position < length + 5)
+            return FULL;
+
+        buffer[position++] = message->view >= 0 && skipped == 0;
+        for (int j = 0; j < 4; j++)
+            buffer[position++] = (length >> (8 * j)) & 0xFF;
+
+        if (message->view >= 0) {
+            memcpy(buffer + position,
+                   connection->views[message->view] + skipped, length);
+        } else {
+            size_t first = CONNECTION_BUFFER_SIZE - ringPosition;
+            if (first > length)
+                first = length;
+            memcpy(buffer + position, connection->ring + ringPosition, first);
+            memcpy(buffer + position + first, connection->ring,
+                   length - first);
+            ringPosition = (ringPosition + length) % CONNECTION_BUFFER_SIZE;
+        }
+        position += length;
+    }
+
+    return position;
+}
+
+int connection_restoreQueue(struct Connection *connection,
+                            const unsigned char *buffer, const size_t length)
+{
+    if (connection == NULL)
+        return CONNECTION_NULL;
+    if (buffer == NULL)
+        return POINTER_NULL;
+
+    size_t position = 0;
+    while (position < length) {
+        if (length - position < 5)
+            return ILLEGAL_VALUE;
+
+        int view = buffer[position++];
+        size_t messageLength = 0;
+        for (int j = 0; j < 4; j++)
+            messageLength |= (size_t)buffer[position++] << (8 * j);
+        if (messageLength > length - position)
+            return ILLEGAL_VALUE;
+
+        const char *text = (const char *)buffer + position;
+        int error = view ?
+                    connection_queueView(connection, text, messageLength) :
+                    connection_queueEvent(connection, text, messageLength);
+        if (error != NO_ERROR)
+            return error;
+        position += messageLength;
+    }
+
+    return NO_ERROR;
+}
+
@@ -0,0 +1,226 @@
+/**
+ * @file connection.h
+ * @brief Connection structure, the bounded output queue of a client of a
+ *        table service, as well as helper functions.
+ *
+ * A client receives two kinds of messages. Events (a card put down, a bid,
+ * a chat line) are all delivered, in order. Views (the whole table as seen
+ * by the client) supersede each other, so a view which is not sent yet is
+ * replaced by a newer one. The memory of a connection is fixed: events are
+ * kept in a ring of CONNECTION_BUFFER_SIZE bytes and views in two slots.
+ * A client which stays over its budget is shed.
+ */
+
+#ifndef CONNECTION_H
+#define CONNECTION_H
+
+#include "platform.h"
+
+#include <stddef.h>
+
+/**
+ * @brief The size of the ring where the events of a connection are queued.
+ */
+#define CONNECTION_BUFFER_SIZE 65536
+
+/**
+ * @brief The maximum size of a view.
+ */
+#define CONNECTION_VIEW_SIZE 4096
+
+/**
+ * @brief The maximum number of messages queued on a connection. Events
+ *        queued one after the other are merged and at most two views are
+ *        queued (one being written and the latest one), so the queue holds
+ *        at most event, view, event, view, event.
+ */
+#define CONNECTION_MAX_MESSAGES 5
+
+/**
+ * @brief The number of queued bytes over which a connection is over its
+ *        budget.
+ */
+#define CONNECTION_HIGH_WATER (CONNECTION_BUFFER_SIZE / 4 * 3)
+
+/**
+ * @brief The maximum size of a saved queue: every message is saved with a
+ *        byte for its kind and four bytes for its length.
+ */
+#define CONNECTION_MAX_SAVED_SIZE (CONNECTION_BUFFER_SIZE + \
+                                   2 * CONNECTION_VIEW_SIZE + \
+                                   5 * CONNECTION_MAX_MESSAGES)
+
+/**
+ * @struct OutputMessage
+ * @brief A message queued on a connection.
+ *
+ * @var OutputMessage::length
+ *     The length of the message.
+ * @var OutputMessage::view
+ *     The slot of the view, or -1 if the message is an event, whose bytes
+ *     follow the bytes of the previous event in Connection::ring.
+ */
+struct OutputMessage {
+    size_t length;
+    int view;
+};
+
+/**
+ * @struct Connection
+ * @brief The output queue of a client.
+ *
+ * @var Connection::fd
+ *     The socket of the client, in non blocking mode.
+ * @var Connection::ring
+ *     The bytes of the queued events.
+ * @var Connection::ringStart
+ *     The position in Connection::ring of the first byte not written.
+ * @var Connection::ringUsed
+ *     The number of bytes of the queued events.
+ * @var Connection::views
+ *     The slots of the views.
+ * @var Connection::messages
+ *     The queued messages, in order.
+ * @var Connection::messagesNumber
+ *     The number of queued messages.
+ * @var Connection::written
+ *     The number of bytes of the first message already written.
+ * @var Connection::overBudgetSince
+ *     The time since when the connection is over its budget, or a negative
+ *     value if it is not.
+ * @var Connection::shed
+ *     1 if the connection must be closed, 0 otherwise.
+ */
+struct Connection {
+    int fd;
+    char ring[CONNECTION_BUFFER_SIZE];
+    size_t ringStart;
+    size_t ringUsed;
+    char views[2][CONNECTION_VIEW_SIZE];
+    struct OutputMessage messages[CONNECTION_MAX_MESSAGES];
+    int messagesNumber;
+    size_t written;
+    double overBudgetSince;
+    int shed;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates and initializes a connection.
+ *
+ * @param fd The socket of the client. It is set in non blocking mode.
+ *
+ * @return Pointer to the new connection on success or NULL on failure.
+ */
+EXPORT struct Connection *connection_createConnection(const int fd);
+
+/**
+ * @brief Frees the memory of a connection and makes the pointer NULL. The
+ *        socket is not closed.
+ *
+ * @param connection Pointer to the pointer to the connection.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int connection_deleteConnection(struct Connection **connection);
+
+/**
+ * @brief Queues an event. If the event does not fit, the connection is
+ *        shed, because events can not be dropped.
+ *
+ * @param connection The connection.
+ * @param text The event.
+ * @param length The length of the event.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int connection_queueEvent(struct Connection *connection,
+                                 const char *text, const size_t length);
+
+/**
+ * @brief Queues a view, which replaces the queued view whose writing did
+ *        not start yet.
+ *
+ * @param connection The connection.
+ * @param text The view.
+ * @param length The length of the view, at most CONNECTION_VIEW_SIZE.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int connection_queueView(struct Connection *connection,
+                                const char *text, const size_t length);
+
+/**
+ * @brief Writes as many queued messages as possible with one writev call.
+ *
+ * The service must ignore SIGPIPE, so writing to a client which closed its
+ * socket fails instead of stopping the process.
+ *
+ * @param connection The connection.
+ *
+ * @return The number of bytes written on success (0 if the socket can not
+ *         take more), other value on failure.
+ */
+EXPORT long connection_flush(struct Connection *connection);
+
+/**
+ * @brief Returns the number of bytes queued on a connection.
+ *
+ * @param connection The connection.
+ *
+ * @return The number of bytes on success, other value on failure.
+ */
+EXPORT long connection_queuedBytes(const struct Connection *connection);
+
+/**
+ * @brief Checks the budget of a connection, and sheds it if it has been
+ *        over its budget for too long.
+ *
+ * @param connection The connection.
+ * @param now The current time, in seconds.
+ * @param grace How long a connection may stay over its budget, in seconds.
+ *
+ * @return 1 if the connection must be closed, 0 if it must not, other
+ *         value on failure.
+ */
+EXPORT int connection_checkBudget(struct Connection *connection,
+                                  const double now, const double grace);
+
+/**
+ * @brief Saves the messages queued on a connection, so they can be queued
+ *        again on a connection of another process.
+ *
+ * The part of a message not written yet is saved as an event, so the
+ * client receives it whole.
+ *
+ * @param connection The connection.
+ * @param buffer Buffer where the messages are saved.
+ * @param size The size of the buffer.
+ *
+ * @return The number of bytes saved on success, negative value on failure.
+ */
+EXPORT long connection_saveQueue(const struct Connection *connection,
+                                 unsigned char *buffer, const size_t size);
+
+/**
+ * @brief Queues messages saved by connection_saveQueue.
+ *
+ * @param connection The connection.
+ * @param buffer The saved messages.
+ * @param length The length of the saved messages.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int connection_restoreQueue(struct Connection *connection,
+                                   const unsigned char *buffer,
+                                   const size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
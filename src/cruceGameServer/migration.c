@@ -0,0 +1,648 @@
+/**
+ * @file migration.c
+ * @brief Contains implementations of the functions used to move a live
+ *        table, or all the tables of a host, to another process.
+ *
+ * A table is sent as one message: its length on four bytes, a byte with
+ * bit i set if the player i is connected, the length of the snapshot on two
+ * bytes, the snapshot, then for every connected player the length of its
+ * saved queue on four bytes and the queue. Lengths are little endian. The
+ * sockets of the connected players travel with the first byte.
+ *
+ * A host is handed off through a memfd holding the bytes 'C', 'G', 'H',
+ * the version of the format, the number of tables on four bytes, then the
+ * message of every table. A header with the number of listeners, the number
+ * of player sockets and the size of the memfd is sent with the memfd and
+ * the listeners attached, then the player sockets follow in batches, one
+ * byte each.
+ */
+
+#define _GNU_SOURCE
+
+#include "migration.h"
+#include "snapshot.h"
+#include "replay.h"
+#include "errors.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief The size of the length of a message.
+ */
+#define HEADER_SIZE 4
+
+/**
+ * @brief The maximum size of a message.
+ */
+#define MAX_MESSAGE_SIZE (HEADER_SIZE + 3 + SNAPSHOT_MAX_SIZE + \
+                          MAX_GAME_PLAYERS * (4 + CONNECTION_MAX_SAVED_SIZE))
+
+/**
+ * @brief The size of the header of a host handoff.
+ */
+#define HOST_HEADER_SIZE 16
+
+/**
+ * @brief The number of player sockets sent with every batch. The kernel
+ *        accepts at most 253 sockets per message.
+ */
+#define FDS_BATCH 64
+
+static const unsigned char HOST_MAGIC[] = {'C', 'G', 'H', 1};
+
+/**
+ * @brief Control buffer big enough for a batch of sockets.
+ */
+union Control {
+    struct cmsghdr header;
+    char space[CMSG_SPACE(sizeof(int) * FDS_BATCH)];
+};
+
+/**
+ * @brief Helpers to write and read little endian lengths.
+ */
+static void putLength(unsigned char *buffer, const size_t length,
+                      const int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+        buffer[i] = (length >> (8 * i)) & 0xFF;
+}
+
+static size_t getLength(const unsigned char *buffer, const int bytes)
+{
+    size_t length = 0;
+    for (int i = 0; i < bytes; i++)
+        length |= (size_t)buffer[i] << (8 * i);
+
+    return length;
+}
+
+/**
+ * @brief Helper to count the players connected to a table.
+ */
+static int countSeats(const int mask)
+{
+    int count = 0;
+    for (int i = 0; i < 8; i++)
+        count += (mask >> i) & 1;
+
+    return count;
+}
+
+/**
+ * @brief Helper to send a buffer, with sockets attached to its first byte.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int sendAll(const int socket, unsigned char *buffer,
+                   const size_t length, const int *fds, const int fdsNumber)
+{
+    union Control control;
+    struct iovec vector = {buffer, length};
+    struct msghdr header;
+
+    memset(&header, 0, sizeof(header));
+    header.msg_iov = &vector;
+    header.msg_iovlen = 1;
+    if (fdsNumber > 0) {
+        header.msg_control = control.space;
+        header.msg_controllen = CMSG_SPACE(sizeof(int) * fdsNumber);
+        struct cmsghdr *message = CMSG_FIRSTHDR(&header);
+        message->cmsg_level = SOL_SOCKET;
+        message->cmsg_type = SCM_RIGHTS;
+        message->cmsg_len = CMSG_LEN(sizeof(int) * fdsNumber);
+        memcpy(CMSG_DATA(message), fds, sizeof(int) * fdsNumber);
+    }
+
+    size_t sent = 0;
+    while (sent < length) {
+        ssize_t n = sendmsg(socket, &header, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return CONNECTION_CLOSED;
+
+        sent += n;
+        vector.iov_base = buffer + sent;
+        vector.iov_len = length - sent;
+        header.msg_control = NULL;
+        header.msg_controllen = 0;
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to receive a buffer and the sockets attached to it.
+ *
+ * @param fds Where the sockets are stored.
+ * @param capacity The number of sockets which fit in fds. The sockets
+ *                 after them are closed.
+ * @param fdsNumber Where the number of sockets is stored.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int receiveAll(const int socket, unsigned char *buffer,
+                      const size_t length, int *fds, const int capacity,
+                      int *fdsNumber)
+{
+    union Control control;
+    struct iovec vector = {buffer, length};
+    struct msghdr header;
+    size_t received = 0;
+
+    while (received < length) {
+        memset(&header, 0, sizeof(header));
+        header.msg_iov = &vector;
+        header.msg_iovlen = 1;
+        header.msg_control = control.space;
+        header.msg_controllen = sizeof(control.space);
+
+        ssize_t n = recvmsg(socket, &header, MSG_CMSG_CLOEXEC);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return CONNECTION_CLOSED;
+
+        struct cmsghdr *message = CMSG_FIRSTHDR(&header);
+        for (; message != NULL; message = CMSG_NXTHDR(&header, message)) {
+            if (message->cmsg_level != SOL_SOCKET ||
+                message->cmsg_type != SCM_RIGHTS)
+                continue;
+            int count = (message->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            int *received = (int *)CMSG_DATA(message);
+            for (int i = 0; i < count; i++) {
+                if (*fdsNumber < capacity)
+                    fds[(*fdsNumber)++] = received[i];
+                else
+                    close(received[i]);
+            }
+        }
+        if (header.msg_flags & MSG_CTRUNC)
+            return ILLEGAL_VALUE;
+
+        received += n;
+        vector.iov_base = buffer + received;
+        vector.iov_len = length - received;
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to write the message of a table, without its length.
+ *
+ * @param buffer Where the message is written. It holds at least
+ *               MAX_MESSAGE_SIZE - HEADER_SIZE bytes.
+ * @param fds Where the sockets of the connected players are added.
+ * @param fdsNumber The number of sockets in fds, updated.
+ *
+ * @return The length of the message on success, negative value on failure.
+ */
+static long writeTable(const struct Game *game,
+                       struct Connection *const connections[MAX_GAME_PLAYERS],
+                       unsigned char *buffer, int *fds, int *fdsNumber)
+{
+    if (game == NULL)
+        return GAME_NULL;
+    if (connections == NULL)
+        return POINTER_NULL;
+
+    int length = snapshot_writeGame(game, buffer + 3, SNAPSHOT_MAX_SIZE);
+    if (length < 0)
+        return length;
+    putLength(buffer + 1, length, 2);
+
+    size_t position = 3 + length;
+    int mask = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (connections[i] == NULL)
+            continue;
+        if (game->players[i] == NULL)
+            return ILLEGAL_VALUE;
+
+        long saved = connection_saveQueue(connections[i],
+                                          buffer + position + 4,
+                                          CONNECTION_MAX_SAVED_SIZE);
+        if (saved < 0)
+            return saved;
+        putLength(buffer + position, saved, 4);
+        position += 4 + saved;
+        mask |= 1 << i;
+        fds[(*fdsNumber)++] = connections[i]->fd;
+    }
+    buffer[0] = mask;
+
+    return position;
+}
+
+int migration_sendTable(const int socket, const struct Game *game,
+                        struct Connection *const connections[MAX_GAME_PLAYERS])
+{
+    if (game == NULL)
+        return GAME_NULL;
+    if (connections == NULL)
+        return POINTER_NULL;
+
+    unsigned char *message = malloc(MAX_MESSAGE_SIZE);
+    if (message == NULL)
+        return MALLOC_ERROR;
+
+    int fds[MAX_GAME_PLAYERS];
+    int fdsNumber = 0;
+    long length = writeTable(game, connections, message + HEADER_SIZE, fds,
+                             &fdsNumber);
+    int error = length;
+    if (length >= 0) {
+        putLength(message, length, HEADER_SIZE);
+        error = sendAll(socket, message, HEADER_SIZE + length, fds,
+                        fdsNumber);
+    }
+    free(message);
+
+    return error;
+}
+
+/**
+ * @brief Helper to rebuild a table from a message.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int readTable(const unsigned char *message, const size_t length,
+                     const int *fds, const int fdsNumber, struct Game **game,
+                     struct Connection *connections[MAX_GAME_PLAYERS])
+{
+    int mask = message[0];
+    size_t snapshotLength = getLength(message + 1, 2);
+    if (snapshotLength > length - 3 || countSeats(mask) != fdsNumber ||
+        mask >> MAX_GAME_PLAYERS != 0)
+        return ILLEGAL_VALUE;
+
+    struct Game *newGame = snapshot_readGame(message + 3, snapshotLength);
+    if (newGame == NULL)
+        return ILLEGAL_VALUE;
+
+    struct Connection *newConnections[MAX_GAME_PLAYERS] = {NULL};
+    size_t position = 3 + snapshotLength;
+    int error = NO_ERROR;
+    for (int i = 0, next = 0; i < MAX_GAME_PLAYERS && error == NO_ERROR;
+         i++) {
+        if (!(mask & (1 << i)))
+            continue;
+        if (newGame->players[i] == NULL || length - position < 4) {
+            error = ILLEGAL_VALUE;
+            break;
+        }
+
+        size_t queueLength = getLength(message + position, 4);
+        position += 4;
+        if (queueLength > length - position) {
+            error = ILLEGAL_VALUE;
+            break;
+        }
+        newConnections[i] = connection_createConnection(fds[next++]);
+        if (newConnections[i] == NULL)
+            error = MALLOC_ERROR;
+        else
+            error = connection_restoreQueue(newConnections[i],
+                                            message + position, queueLength);
+        position += queueLength;
+    }
+    if (error == NO_ERROR && position != length)
+        error = ILLEGAL_VALUE;
+
+    if (error != NO_ERROR) {
+        for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+            if (newConnections[i] != NULL)
+                connection_deleteConnection(&newConnections[i]);
+        replay_deleteGame(&newGame);
+        return error;
+    }
+
+    *game = newGame;
+    memcpy(connections, newConnections, sizeof(newConnections));
+
+    return NO_ERROR;
+}
+
+int migration_receiveTable(const int socket, struct Game **game,
+                           struct Connection *connections[MAX_GAME_PLAYERS])
+{
+    if (game == NULL || connections == NULL)
+        return POINTER_NULL;
+
+    unsigned char header[HEADER_SIZE] = {0};
+    int fds[MAX_GAME_PLAYERS];
+    int fdsNumber = 0;
+    unsigned char *message = NULL;
+
+    int error = receiveAll(socket, header, HEADER_SIZE, fds,
+                           MAX_GAME_PLAYERS, &fdsNumber);
+    size_t length = getLength(header, HEADER_SIZE);
+    if (error == NO_ERROR &&
+        (length < 3 || length > MAX_MESSAGE_SIZE - HEADER_SIZE))
+        error = ILLEGAL_VALUE;
+    if (error == NO_ERROR && (message = malloc(length)) == NULL)
+        error = MALLOC_ERROR;
+    if (error == NO_ERROR)
+        error = receiveAll(socket, message, length, fds, MAX_GAME_PLAYERS,
+                           &fdsNumber);
+    if (error == NO_ERROR)
+        error = readTable(message, length, fds, fdsNumber, game,
+                          connections);
+
+    free(message);
+    if (error != NO_ERROR)
+        for (int i = 0; i < fdsNumber; i++)
+            close(fds[i]);
+
+    return error;
+}
+
+/**
+ * @brief Helper to write a buffer in a file.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int writeAll(const int fd, const unsigned char *buffer,
+                    const size_t length)
+{
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = write(fd, buffer + written, length - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return FULL;
+        written += n;
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to write the tables of a host in a new memfd.
+ *
+ * @param fds Where the sockets of the connected players are stored.
+ * @param fdsNumber Where the number of sockets is stored.
+ * @param size Where the size of the memfd is stored.
+ *
+ * @return The memfd on success, negative value on failure.
+ */
+static int writeTables(const struct HostState *host, int *fds,
+                       int *fdsNumber, size_t *size)
+{
+    unsigned char *buffer = malloc(MAX_MESSAGE_SIZE);
+    if (buffer == NULL)
+        return MALLOC_ERROR;
+
+    int memfd = memfd_create("cruce-tables", MFD_CLOEXEC);
+    if (memfd < 0) {
+        free(buffer);
+        return MALLOC_ERROR;
+    }
+
+    memcpy(buffer, HOST_MAGIC, sizeof(HOST_MAGIC));
+    putLength(buffer + sizeof(HOST_MAGIC), host->tablesNumber, 4);
+    int error = writeAll(memfd, buffer, sizeof(HOST_MAGIC) + 4);
+    *size = sizeof(HOST_MAGIC) + 4;
+
+    for (int i = 0; i < host->tablesNumber && error == NO_ERROR; i++) {
+        long length = writeTable(host->games[i], host->connections[i],
+                                 buffer + HEADER_SIZE, fds, fdsNumber);
+        if (length < 0) {
+            error = length;
+            break;
+        }
+        putLength(buffer, length, HEADER_SIZE);
+        error = writeAll(memfd, buffer, HEADER_SIZE + length);
+        *size += HEADER_SIZE + length;
+        if (*size > UINT32_MAX)
+            error = FULL;
+    }
+    free(buffer);
+
+    if (error != NO_ERROR) {
+        close(memfd);
+        return error;
+    }
+
+    return memfd;
+}
+
+int migration_sendHost(const int socket, const struct HostState *host)
+{
+    if (host == NULL)
+        return POINTER_NULL;
+    if (host->listenersNumber < 0 ||
+        host->listenersNumber > MIGRATION_MAX_LISTENERS ||
+        host->tablesNumber < 0)
+        return ILLEGAL_VALUE;
+    if (host->tablesNumber > 0 &&
+        (host->games == NULL || host->connections == NULL))
+        return POINTER_NULL;
+
+    int *fds = malloc(sizeof(int) * MAX_GAME_PLAYERS *
+                      (host->tablesNumber + 1));
+    if (fds == NULL)
+        return MALLOC_ERROR;
+
+    int fdsNumber = 0;
+    size_t size;
+    int memfd = writeTables(host, fds, &fdsNumber, &size);
+    if (memfd < 0) {
+        free(fds);
+        return memfd;
+    }
+
+    unsigned char header[HOST_HEADER_SIZE];
+    int attached[1 + MIGRATION_MAX_LISTENERS];
+    memcpy(header, HOST_MAGIC, sizeof(HOST_MAGIC));
+    putLength(header + 4, host->listenersNumber, 4);
+    putLength(header + 8, fdsNumber, 4);
+    putLength(header + 12, size, 4);
+    attached[0] = memfd;
+    memcpy(attached + 1, host->listeners,
+           sizeof(int) * host->listenersNumber);
+
+    int error = sendAll(socket, header, HOST_HEADER_SIZE, attached,
+                        1 + host->listenersNumber);
+    for (int i = 0; i < fdsNumber && error == NO_ERROR; i += FDS_BATCH) {
+        unsigned char batch = 0;
+        int count = fdsNumber - i < FDS_BATCH ? fdsNumber - i : FDS_BATCH;
+        error = sendAll(socket, &batch, 1, fds + i, count);
+    }
+
+    close(memfd);
+    free(fds);
+
+    return error;
+}
+
+/**
+ * @brief Helper to delete the tables of a host.
+ *
+ * @param closeSockets 1 if the sockets of the players are closed, 0
+ *                     otherwise.
+ */
+static void deleteTables(struct HostState *host, const int closeSockets)
+{
+    for (int i = 0; i < host->tablesNumber; i++) {
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++) {
+            if (host->connections[i][j] == NULL)
+                continue;
+            if (closeSockets)
+                close(host->connections[i][j]->fd);
+            connection_deleteConnection(&host->connections[i][j]);
+        }
+        replay_deleteGame(&host->games[i]);
+    }
+    free(host->games);
+    free(host->connections);
+    host->games = NULL;
+    host->connections = NULL;
+    host->tablesNumber = 0;
+}
+
+/**
+ * @brief Helper to rebuild the tables of a host from its memfd.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int readTables(const unsigned char *data, const size_t size,
+                      const int *fds, const int fdsNumber,
+                      struct HostState *host)
+{
+    if (size < sizeof(HOST_MAGIC) + 4 ||
+        memcmp(data, HOST_MAGIC, sizeof(HOST_MAGIC)) != 0)
+        return ILLEGAL_VALUE;
+
+    size_t tablesNumber = getLength(data + sizeof(HOST_MAGIC), 4);
+    if (tablesNumber > size / (HEADER_SIZE + 3))
+        return ILLEGAL_VALUE;
+
+    host->games = calloc(tablesNumber + 1, sizeof(struct Game *));
+    host->connections = calloc(tablesNumber + 1,
+                               sizeof(*host->connections));
+    if (host->games == NULL || host->connections == NULL)
+        return MALLOC_ERROR;
+
+    size_t position = sizeof(HOST_MAGIC) + 4;
+    int next = 0;
+    for (size_t i = 0; i < tablesNumber; i++) {
+        if (size - position < HEADER_SIZE)
+            return ILLEGAL_VALUE;
+        size_t length = getLength(data + position, HEADER_SIZE);
+        position += HEADER_SIZE;
+        if (length < 3 || length > size - position)
+            return ILLEGAL_VALUE;
+
+        int seats = countSeats(data[position]);
+        if (seats > fdsNumber - next)
+            return ILLEGAL_VALUE;
+        int error = readTable(data + position, length, fds + next, seats,
+                              &host->games[i], host->connections[i]);
+        if (error != NO_ERROR)
+            return error;
+        host->tablesNumber++;
+        next += seats;
+        position += length;
+    }
+    if (position != size || next != fdsNumber)
+        return ILLEGAL_VALUE;
+
+    return NO_ERROR;
+}
+
+int migration_receiveHost(const int socket, struct HostState *host)
+{
+    if (host == NULL)
+        return POINTER_NULL;
+
+    memset(host, 0, sizeof(struct HostState));
+
+    unsigned char header[HOST_HEADER_SIZE] = {0};
+    int attached[1 + MIGRATION_MAX_LISTENERS];
+    int attachedNumber = 0;
+    int *fds = NULL;
+    int fdsNumber = 0;
+    unsigned char *batches = NULL;
+    void *data = MAP_FAILED;
+
+    int error = receiveAll(socket, header, HOST_HEADER_SIZE, attached,
+                           1 + MIGRATION_MAX_LISTENERS, &attachedNumber);
+    size_t listenersNumber = getLength(header + 4, 4);
+    size_t expected = getLength(header + 8, 4);
+    size_t size = getLength(header + 12, 4);
+    size_t batchesNumber = (expected + FDS_BATCH - 1) / FDS_BATCH;
+    if (error == NO_ERROR &&
+        (memcmp(header, HOST_MAGIC, sizeof(HOST_MAGIC)) != 0 ||
+         listenersNumber > MIGRATION_MAX_LISTENERS ||
+         attachedNumber != 1 + (int)listenersNumber ||
+         expected > INT32_MAX / sizeof(int)))
+        error = ILLEGAL_VALUE;
+
+    if (error == NO_ERROR &&
+        ((fds = malloc(sizeof(int) * (expected + 1))) == NULL ||
+         (batches = malloc(batchesNumber + 1)) == NULL))
+        error = MALLOC_ERROR;
+    if (error == NO_ERROR)
+        error = receiveAll(socket, batches, batchesNumber, fds, expected,
+                           &fdsNumber);
+    if (error == NO_ERROR && (size_t)fdsNumber != expected)
+        error = ILLEGAL_VALUE;
+
+    /* The tables are read in place, from the pages of the old process. */
+    struct stat status;
+    if (error == NO_ERROR &&
+        (fstat(attached[0], &status) < 0 || (size_t)status.st_size != size))
+        error = ILLEGAL_VALUE;
+    if (error == NO_ERROR &&
+        (data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, attached[0],
+                     0)) == MAP_FAILED)
+        error = MALLOC_ERROR;
+    if (error == NO_ERROR)
+        error = readTables(data, size, fds, fdsNumber, host);
+
+    if (data != MAP_FAILED)
+        munmap(data, size);
+    free(batches);
+    if (attachedNumber > 0)
+        close(attached[0]);
+
+    if (error != NO_ERROR) {
+        deleteTables(host, 0);
+        for (int i = 0; i < fdsNumber; i++)
+            close(fds[i]);
+        for (int i = 1; i < attachedNumber; i++)
+            close(attached[i]);
+        free(fds);
+        return error;
+    }
+
+    host->listenersNumber = listenersNumber;
+    memcpy(host->listeners, attached + 1, sizeof(int) * listenersNumber);
+    free(fds);
+
+    return NO_ERROR;
+}
+
+int migration_clearHost(struct HostState *host)
+{
+    if (host == NULL)
+        return POINTER_NULL;
+
+    for (int i = 0; i < host->listenersNumber; i++)
+        close(host->listeners[i]);
+    host->listenersNumber = 0;
+    deleteTables(host, 1);
+
+    return NO_ERROR;
+}
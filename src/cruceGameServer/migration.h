@@ -0,0 +1,133 @@
+/**
+ * @file migration.h
+ * @brief Functions used to move a live table, with the connections of its
+ *        players, or all the tables of a host to another process of the
+ *        same machine.
+ *
+ * The table is sent over a UNIX socket as a snapshot (see snapshot.h),
+ * followed by the messages queued on the connections of its players. The
+ * sockets of the players are passed with SCM_RIGHTS, so the players stay
+ * connected and receive every message, in order, while the table moves.
+ *
+ * To restart a host, the old process starts the new binary with one end of
+ * a socketpair, stops accepting players and calls migration_sendHost. The
+ * tables are written in a memfd which the new process maps and reads in
+ * place; the listening sockets are passed too, so no connection is refused
+ * while the binary changes.
+ */
+
+#ifndef MIGRATION_H
+#define MIGRATION_H
+
+#include "platform.h"
+#include "constants.h"
+#include "connection.h"
+#include "game.h"
+
+/**
+ * @brief The maximum number of listening sockets of a host.
+ */
+#define MIGRATION_MAX_LISTENERS 8
+
+/**
+ * @struct HostState
+ * @brief Everything a host hands off when it restarts.
+ *
+ * @var HostState::listeners
+ *     The listening sockets of the host.
+ * @var HostState::listenersNumber
+ *     The number of listening sockets.
+ * @var HostState::games
+ *     The game of every table.
+ * @var HostState::connections
+ *     The connections of the players of every table, by index in
+ *     Game::players, NULL for a player who is not connected.
+ * @var HostState::tablesNumber
+ *     The number of tables.
+ */
+struct HostState {
+    int listeners[MIGRATION_MAX_LISTENERS];
+    int listenersNumber;
+    struct Game **games;
+    struct Connection *(*connections)[MAX_GAME_PLAYERS];
+    int tablesNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sends a table to another process.
+ *
+ * On success the table belongs to the receiving process: the caller
+ * deletes its game and connections and closes the sockets of the players.
+ *
+ * @param socket The UNIX socket connected to the receiving process.
+ * @param game The game of the table.
+ * @param connections The connection of every player, by index in
+ *                    Game::players, NULL for a player who is not
+ *                    connected.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int migration_sendTable(const int socket, const struct Game *game,
+                               struct Connection *const
+                               connections[MAX_GAME_PLAYERS]);
+
+/**
+ * @brief Receives a table sent by migration_sendTable.
+ *
+ * @param socket The UNIX socket connected to the sending process.
+ * @param game Where the new game is stored. It is freed with
+ *             replay_deleteGame.
+ * @param connections Where the new connections are stored, by index in
+ *                    Game::players.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int migration_receiveTable(const int socket, struct Game **game,
+                                  struct Connection *
+                                  connections[MAX_GAME_PLAYERS]);
+
+/**
+ * @brief Sends the listening sockets and all the tables of a host to
+ *        another process.
+ *
+ * On success the host belongs to the receiving process, as with
+ * migration_sendTable.
+ *
+ * @param socket The UNIX socket connected to the receiving process.
+ * @param host The state of the host.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int migration_sendHost(const int socket, const struct HostState *host);
+
+/**
+ * @brief Receives a host sent by migration_sendHost.
+ *
+ * @param socket The UNIX socket connected to the sending process.
+ * @param host Where the state of the host is stored. It is freed with
+ *             migration_clearHost.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int migration_receiveHost(const int socket, struct HostState *host);
+
+/**
+ * @brief Frees a host received by migration_receiveHost, closing its
+ *        listening sockets and the sockets of its players.
+ *
+ * @param host The state of the host.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int migration_clearHost(struct HostState *host);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
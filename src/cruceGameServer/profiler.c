@@ -0,0 +1,686 @@
+/**
+ * @file profiler.c
+ * @brief Contains implementations of the functions used to sample the CPU
+ *        time of a process and to write pprof profiles.
+ */
+
+#define _GNU_SOURCE
+
+#include "profiler.h"
+#include "errors.h"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+/**
+ * @brief The frames of a stack taken in the handler which belong to the
+ *        profiler: the handler and the return from the signal.
+ */
+#define SKIPPED_FRAMES 2
+
+/**
+ * @brief The maximum number of executable mappings of a profile.
+ */
+#define MAX_MAPPINGS 256
+
+/**
+ * @brief The profiler the samples are taken for, NULL if there is none.
+ */
+static struct Profiler *activeProfiler;
+
+/**
+ * @brief The number of handlers which may use activeProfiler.
+ */
+static volatile int runningHandlers;
+
+/**
+ * @brief Protects activeProfiler and the installation of the handler.
+ */
+static pthread_mutex_t activeLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief 1 once the handler of SIGPROF is installed. It stays installed,
+ *        as a signal sent by a timer just before it was deleted may still
+ *        arrive, and the default action would end the process.
+ */
+static int handlerInstalled;
+
+/**
+ * @brief The handler of SIGPROF, which keeps the stack of the interrupted
+ *        thread in the next sample slot.
+ */
+static void takeSample(int signal, siginfo_t *info, void *context)
+{
+    (void)signal;
+    (void)info;
+    (void)context;
+    int savedErrno = errno;
+
+    __sync_fetch_and_add(&runningHandlers, 1);
+    struct Profiler *profiler = activeProfiler;
+    if (profiler != NULL) {
+        long slot = __sync_fetch_and_add(&profiler->samplesNumber, 1);
+        if (slot < profiler->capacity) {
+            void *frames[PROFILER_MAX_DEPTH + SKIPPED_FRAMES];
+            int depth = backtrace(frames, PROFILER_MAX_DEPTH +
+                                          SKIPPED_FRAMES) - SKIPPED_FRAMES;
+            if (depth > 0) {
+                struct ProfileSample *sample = &profiler->samples[slot];
+                memcpy(sample->frames, frames + SKIPPED_FRAMES,
+                       sizeof(void *) * depth);
+                __sync_synchronize();
+                sample->depth = depth;
+            }
+        }
+    }
+    __sync_fetch_and_sub(&runningHandlers, 1);
+
+    errno = savedErrno;
+}
+
+/**
+ * @brief Helper to give the id of the calling thread.
+ */
+static pid_t threadId(void)
+{
+    return (pid_t)syscall(SYS_gettid);
+}
+
+struct Profiler *profiler_createProfiler(const long capacity,
+                                         const long frequency)
+{
+    if (capacity < 1 || frequency < 1 || frequency > 1000000000L)
+        return NULL;
+
+    struct Profiler *profiler = calloc(1, sizeof(struct Profiler));
+    if (profiler == NULL)
+        return NULL;
+    profiler->samples = calloc(capacity, sizeof(struct ProfileSample));
+    if (profiler->samples == NULL) {
+        free(profiler);
+        return NULL;
+    }
+    profiler->capacity = capacity;
+    profiler->period = 1000000000L / frequency;
+    clock_gettime(CLOCK_REALTIME, &profiler->start);
+    pthread_mutex_init(&profiler->lock, NULL);
+
+    // The first call of backtrace loads the unwinder, which allocates.
+    void *frames[1];
+    backtrace(frames, 1);
+
+    pthread_mutex_lock(&activeLock);
+    int error = activeProfiler != NULL;
+    if (!error && !handlerInstalled) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = takeSample;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        error = sigaction(SIGPROF, &action, NULL) != 0;
+        handlerInstalled = !error;
+    }
+    if (!error) {
+        __sync_synchronize();
+        activeProfiler = profiler;
+    }
+    pthread_mutex_unlock(&activeLock);
+
+    if (error) {
+        pthread_mutex_destroy(&profiler->lock);
+        free(profiler->samples);
+        free(profiler);
+        return NULL;
+    }
+
+    return profiler;
+}
+
+int profiler_deleteProfiler(struct Profiler **profiler)
+{
+    if (profiler == NULL)
+        return POINTER_NULL;
+    if (*profiler == NULL)
+        return PROFILER_NULL;
+
+    pthread_mutex_lock(&(*profiler)->lock);
+    for (int i = 0; i < (*profiler)->threadsNumber; i++)
+        timer_delete((*profiler)->timers[i]);
+    (*profiler)->threadsNumber = 0;
+    pthread_mutex_unlock(&(*profiler)->lock);
+
+    pthread_mutex_lock(&activeLock);
+    if (activeProfiler == *profiler) {
+        activeProfiler = NULL;
+        __sync_synchronize();
+        while (runningHandlers > 0)
+            sched_yield();
+    }
+    pthread_mutex_unlock(&activeLock);
+
+    pthread_mutex_destroy(&(*profiler)->lock);
+    free((*profiler)->samples);
+    free(*profiler);
+    *profiler = NULL;
+
+    return NO_ERROR;
+}
+
+int profiler_addThread(struct Profiler *profiler)
+{
+    if (profiler == NULL)
+        return PROFILER_NULL;
+
+    pid_t thread = threadId();
+    int error = NO_ERROR;
+    pthread_mutex_lock(&profiler->lock);
+    for (int i = 0; i < profiler->threadsNumber; i++)
+        if (profiler->threads[i] == thread)
+            error = DUPLICATE;
+    if (error == NO_ERROR && profiler->threadsNumber == PROFILER_MAX_THREADS)
+        error = FULL;
+
+    if (error == NO_ERROR) {
+        struct sigevent event;
+        memset(&event, 0, sizeof(event));
+        event.sigev_notify = SIGEV_THREAD_ID;
+        event.sigev_signo = SIGPROF;
+        event.sigev_notify_thread_id = thread;
+
+        struct itimerspec interval;
+        interval.it_interval.tv_sec = profiler->period / 1000000000L;
+        interval.it_interval.tv_nsec = profiler->period % 1000000000L;
+        interval.it_value = interval.it_interval;
+
+        timer_t timer;
+        if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &timer) != 0) {
+            error = FULL;
+        } else if (timer_settime(timer, 0, &interval, NULL) != 0) {
+            timer_delete(timer);
+            error = FULL;
+        } else {
+            profiler->threads[profiler->threadsNumber] = thread;
+            profiler->timers[profiler->threadsNumber++] = timer;
+        }
+    }
+    pthread_mutex_unlock(&profiler->lock);
+
+    return error;
+}
+
+int profiler_removeThread(struct Profiler *profiler)
+{
+    if (profiler == NULL)
+        return PROFILER_NULL;
+
+    pid_t thread = threadId();
+    int error = NOT_FOUND;
+    pthread_mutex_lock(&profiler->lock);
+    for (int i = 0; i < profiler->threadsNumber; i++)
+        if (profiler->threads[i] == thread) {
+            timer_delete(profiler->timers[i]);
+            profiler->threadsNumber--;
+            profiler->threads[i] = profiler->threads[profiler->threadsNumber];
+            profiler->timers[i] = profiler->timers[profiler->threadsNumber];
+            error = NO_ERROR;
+            break;
+        }
+    pthread_mutex_unlock(&profiler->lock);
+
+    return error;
+}
+
+/**
+ * @struct Output
+ * @brief A growing buffer where a protocol buffer message is encoded.
+ *
+ * @var Output::bytes
+ *     The encoded bytes.
+ * @var Output::length
+ *     The number of encoded bytes.
+ * @var Output::capacity
+ *     The size of Output::bytes.
+ * @var Output::failed
+ *     1 if an allocation failed, in which case nothing more is encoded.
+ */
+struct Output {
+    unsigned char *bytes;
+    size_t length;
+    size_t capacity;
+    int failed;
+};
+
+/**
+ * @brief Helper to encode bytes.
+ */
+static void putRaw(struct Output *output, const void *data,
+                   const size_t length)
+{
+    if (output->failed)
+        return;
+    if (output->length + length > output->capacity) {
+        size_t capacity = output->capacity * 2 + length + 64;
+        unsigned char *bytes = realloc(output->bytes, capacity);
+        if (bytes == NULL) {
+            output->failed = 1;
+            return;
+        }
+        output->bytes = bytes;
+        output->capacity = capacity;
+    }
+    memcpy(output->bytes + output->length, data, length);
+    output->length += length;
+}
+
+/**
+ * @brief Helper to encode a variable length integer.
+ */
+static void putVarint(struct Output *output, uint64_t value)
+{
+    unsigned char bytes[10];
+    int length = 0;
+    while (value >= 0x80) {
+        bytes[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = (unsigned char)value;
+    putRaw(output, bytes, length);
+}
+
+/**
+ * @brief Helper to encode an integer field.
+ */
+static void putInteger(struct Output *output, const int field,
+                       const uint64_t value)
+{
+    putVarint(output, (uint64_t)field << 3);
+    putVarint(output, value);
+}
+
+/**
+ * @brief Helper to encode a field of bytes: a string, a nested message or
+ *        packed integers.
+ */
+static void putBytes(struct Output *output, const int field,
+                     const void *data, const size_t length)
+{
+    putVarint(output, (uint64_t)field << 3 | 2);
+    putVarint(output, length);
+    putRaw(output, data, length);
+}
+
+/**
+ * @brief Helper to encode a nested message, which is cleared.
+ */
+static void putMessage(struct Output *output, const int field,
+                       struct Output *message)
+{
+    if (message->failed)
+        output->failed = 1;
+    putBytes(output, field, message->bytes, message->length);
+    message->length = 0;
+}
+
+/**
+ * @struct StringTable
+ * @brief The strings of a profile, which its messages refer to by index.
+ *
+ * @var StringTable::strings
+ *     The strings, the first one being empty.
+ * @var StringTable::stringsNumber
+ *     The number of strings.
+ * @var StringTable::capacity
+ *     The size of StringTable::strings.
+ */
+struct StringTable {
+    char **strings;
+    int stringsNumber;
+    int capacity;
+};
+
+/**
+ * @brief Helper to find the index of a string, adding it to the table if
+ *        it is not there.
+ *
+ * @return The index, negative value on failure.
+ */
+static int findString(struct StringTable *table, const char *string)
+{
+    for (int i = 0; i < table->stringsNumber; i++)
+        if (strcmp(table->strings[i], string) == 0)
+            return i;
+
+    if (table->stringsNumber == table->capacity) {
+        int capacity = table->capacity * 2 + 16;
+        char **strings = realloc(table->strings, sizeof(char *) * capacity);
+        if (strings == NULL)
+            return MALLOC_ERROR;
+        table->strings = strings;
+        table->capacity = capacity;
+    }
+    char *copy = malloc(strlen(string) + 1);
+    if (copy == NULL)
+        return MALLOC_ERROR;
+    strcpy(copy, string);
+    table->strings[table->stringsNumber] = copy;
+
+    return table->stringsNumber++;
+}
+
+/**
+ * @struct Mapping
+ * @brief An executable mapping of the process.
+ *
+ * @var Mapping::start
+ *     The first address.
+ * @var Mapping::limit
+ *     The address after the last one.
+ * @var Mapping::offset
+ *     The offset of the mapping in its file.
+ * @var Mapping::file
+ *     The index of the name of the file in the string table.
+ */
+struct Mapping {
+    uintptr_t start;
+    uintptr_t limit;
+    uintptr_t offset;
+    int file;
+};
+
+/**
+ * @brief Helper to read the executable mappings of the process.
+ *
+ * @return The number of mappings, negative value on failure.
+ */
+static int readMappings(struct Mapping *mappings, struct StringTable *table)
+{
+    FILE *maps = fopen("/proc/self/maps", "r");
+    if (maps == NULL)
+        return 0;
+
+    int mappingsNumber = 0;
+    char line[4096];
+    while (mappingsNumber < MAX_MAPPINGS &&
+           fgets(line, sizeof(line), maps) != NULL) {
+        unsigned long start, limit, offset;
+        char permissions[8];
+        int nameStart = 0;
+        if (sscanf(line, "%lx-%lx %7s %lx %*s %*s %n", &start, &limit,
+                   permissions, &offset, &nameStart) < 4 ||
+            strchr(permissions, 'x') == NULL)
+            continue;
+
+        line[strcspn(line, "\n")] = '\0';
+        int file = findString(table, nameStart > 0 ? line + nameStart : "");
+        if (file < 0) {
+            fclose(maps);
+            return file;
+        }
+        mappings[mappingsNumber].start = start;
+        mappings[mappingsNumber].limit = limit;
+        mappings[mappingsNumber].offset = offset;
+        mappings[mappingsNumber++].file = file;
+    }
+    fclose(maps);
+
+    return mappingsNumber;
+}
+
+/**
+ * @brief Helper to give the address of a frame of a sample. The frames
+ *        after the interrupted one are return addresses, which are moved
+ *        back into the call.
+ */
+static uintptr_t frameAddress(const struct ProfileSample *sample,
+                              const int frame)
+{
+    return (uintptr_t)sample->frames[frame] - (frame > 0);
+}
+
+/**
+ * @brief Helper to compare two addresses for qsort.
+ */
+static int compareAddresses(const void *a, const void *b)
+{
+    uintptr_t first = *(const uintptr_t *)a;
+    uintptr_t second = *(const uintptr_t *)b;
+
+    return (first > second) - (first < second);
+}
+
+/**
+ * @brief Helper to find the id of the location of an address, which is its
+ *        position in the sorted addresses plus 1.
+ */
+static uint64_t findLocation(const uintptr_t *addresses,
+                             const size_t addressesNumber,
+                             const uintptr_t address)
+{
+    size_t low = 0;
+    size_t high = addressesNumber;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (addresses[middle] < address)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low + 1;
+}
+
+/**
+ * @brief Helper to encode the locations of the addresses and their
+ *        functions.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int putLocations(struct Output *profile, const uintptr_t *addresses,
+                        const size_t addressesNumber,
+                        const struct Mapping *mappings,
+                        const int mappingsNumber, struct StringTable *table)
+{
+    struct Output location = {NULL, 0, 0, 0};
+    struct Output line = {NULL, 0, 0, 0};
+    struct Output function = {NULL, 0, 0, 0};
+    int *functions = NULL;
+    int functionsNumber = 0;
+    int error = NO_ERROR;
+
+    for (size_t i = 0; i < addressesNumber && error == NO_ERROR; i++) {
+        putInteger(&location, 1, i + 1);
+        for (int j = 0; j < mappingsNumber; j++)
+            if (addresses[i] >= mappings[j].start &&
+                addresses[i] < mappings[j].limit) {
+                putInteger(&location, 2, j + 1);
+                break;
+            }
+        putInteger(&location, 3, addresses[i]);
+
+        Dl_info info;
+        if (dladdr((void *)addresses[i], &info) != 0 &&
+            info.dli_sname != NULL) {
+            int name = findString(table, info.dli_sname);
+            if (name < 0) {
+                error = name;
+                break;
+            }
+            int id = 0;
+            while (id < functionsNumber && functions[id] != name)
+                id++;
+            if (id == functionsNumber) {
+                int *grown = realloc(functions,
+                                     sizeof(int) * (functionsNumber + 1));
+                if (grown == NULL) {
+                    error = MALLOC_ERROR;
+                    break;
+                }
+                functions = grown;
+                functions[functionsNumber++] = name;
+                putInteger(&function, 1, id + 1);
+                putInteger(&function, 2, name);
+                putInteger(&function, 3, name);
+                putMessage(profile, 5, &function);
+            }
+            putInteger(&line, 1, id + 1);
+            putMessage(&location, 4, &line);
+        }
+        putMessage(profile, 4, &location);
+    }
+
+    free(location.bytes);
+    free(line.bytes);
+    free(function.bytes);
+    free(functions);
+
+    return error;
+}
+
+/**
+ * @brief Helper to encode a profile.
+ *
+ * @param samplesNumber The number of sample slots to encode. The threads
+ *                      still sampled keep taking samples after it.
+ * @param depths Room for the depths of the slots, read once so a slot
+ *               filled while the profile is encoded is left out.
+ * @param addresses Room for PROFILER_MAX_DEPTH addresses for every slot.
+ *
+ * @return The number of samples on success, negative value on failure.
+ */
+static long encodeProfile(const struct Profiler *profiler,
+                          const long samplesNumber, int *depths,
+                          struct Output *profile, struct StringTable *table,
+                          uintptr_t *addresses)
+{
+    struct Output message = {NULL, 0, 0, 0};
+    struct Output packed = {NULL, 0, 0, 0};
+    struct Mapping mappings[MAX_MAPPINGS];
+    long written = 0;
+    size_t addressesNumber = 0;
+
+    const char *names[] = {"", "samples", "count", "cpu", "nanoseconds"};
+    for (int i = 0; i < 5; i++)
+        if (findString(table, names[i]) < 0)
+            return MALLOC_ERROR;
+    for (int i = 1; i < 5; i += 2) {
+        putInteger(&message, 1, i);
+        putInteger(&message, 2, i + 1);
+        putMessage(profile, 1, &message);
+    }
+
+    for (long i = 0; i < samplesNumber; i++) {
+        const struct ProfileSample *sample = &profiler->samples[i];
+        depths[i] = sample->depth;
+        __sync_synchronize();
+        for (int j = 0; j < depths[i]; j++)
+            addresses[addressesNumber++] = frameAddress(sample, j);
+    }
+    qsort(addresses, addressesNumber, sizeof(uintptr_t), compareAddresses);
+    size_t unique = 0;
+    for (size_t i = 0; i < addressesNumber; i++)
+        if (unique == 0 || addresses[i] != addresses[unique - 1])
+            addresses[unique++] = addresses[i];
+
+    for (long i = 0; i < samplesNumber; i++) {
+        const struct ProfileSample *sample = &profiler->samples[i];
+        if (depths[i] == 0)
+            continue;
+        for (int j = 0; j < depths[i]; j++)
+            putVarint(&packed, findLocation(addresses, unique,
+                                            frameAddress(sample, j)));
+        putMessage(&message, 1, &packed);
+        putVarint(&packed, 1);
+        putVarint(&packed, profiler->period);
+        putMessage(&message, 2, &packed);
+        putMessage(profile, 2, &message);
+        written++;
+    }
+
+    int mappingsNumber = readMappings(mappings, table);
+    int error = mappingsNumber < 0 ? mappingsNumber : NO_ERROR;
+    for (int i = 0; i < mappingsNumber; i++) {
+        putInteger(&message, 1, i + 1);
+        putInteger(&message, 2, mappings[i].start);
+        putInteger(&message, 3, mappings[i].limit);
+        putInteger(&message, 4, mappings[i].offset);
+        putInteger(&message, 5, mappings[i].file);
+        putMessage(profile, 3, &message);
+    }
+    if (error == NO_ERROR)
+        error = putLocations(profile, addresses, unique, mappings,
+                             mappingsNumber, table);
+
+    if (error == NO_ERROR) {
+        for (int i = 0; i < table->stringsNumber; i++)
+            putBytes(profile, 6, table->strings[i],
+                     strlen(table->strings[i]));
+
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        int64_t start = (int64_t)profiler->start.tv_sec * 1000000000 +
+                        profiler->start.tv_nsec;
+        putInteger(profile, 9, start);
+        putInteger(profile, 10, (int64_t)now.tv_sec * 1000000000 +
+                                now.tv_nsec - start);
+        putInteger(&message, 1, 3);
+        putInteger(&message, 2, 4);
+        putMessage(profile, 11, &message);
+        putInteger(profile, 12, profiler->period);
+    }
+
+    free(message.bytes);
+    free(packed.bytes);
+    if (error == NO_ERROR && profile->failed)
+        error = MALLOC_ERROR;
+
+    return error == NO_ERROR ? written : error;
+}
+
+long profiler_writeProfile(const struct Profiler *profiler, FILE *file)
+{
+    if (profiler == NULL)
+        return PROFILER_NULL;
+    if (file == NULL)
+        return POINTER_NULL;
+
+    long samplesNumber = profiler->samplesNumber;
+    if (samplesNumber > profiler->capacity)
+        samplesNumber = profiler->capacity;
+    uintptr_t *addresses = malloc(sizeof(uintptr_t) * PROFILER_MAX_DEPTH *
+                                  (samplesNumber + 1));
+    int *depths = malloc(sizeof(int) * (samplesNumber + 1));
+    if (addresses == NULL || depths == NULL) {
+        free(addresses);
+        free(depths);
+        return MALLOC_ERROR;
+    }
+
+    struct Output profile = {NULL, 0, 0, 0};
+    struct StringTable table = {NULL, 0, 0};
+    long written = encodeProfile(profiler, samplesNumber, depths, &profile,
+                                 &table, addresses);
+    if (written >= 0 &&
+        fwrite(profile.bytes, 1, profile.length, file) != profile.length)
+        written = FULL;
+
+    for (int i = 0; i < table.stringsNumber; i++)
+        free(table.strings[i]);
+    free(table.strings);
+    free(profile.bytes);
+    free(addresses);
+    free(depths);
+
+    return written;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file profiler.h
+ * @brief Profiler structure, an opt-in sampling profiler of the CPU time
+ *        of a process, as well as the functions used to write its samples
+ *        as a pprof profile.
+ *
+ * Every thread which takes part starts a timer of its own CPU time, which
+ * sends it SIGPROF once per period. The handler of the signal keeps the
+ * stack of the thread in a sample slot allocated with the profiler, so it
+ * does not allocate, lock or call anything but backtrace, which is called
+ * once before the handler is installed so its library is already loaded.
+ * When the slots are full, the next samples are only counted.
+ *
+ * The profile is written, at any time, as an uncompressed protocol buffer
+ * of the pprof format: every sample has a count and a CPU time, the stack
+ * frames are described by their address and the executable mapping
+ * holding them, and by their function when the dynamic linker knows its
+ * name, so `pprof -top` shows whether the time goes to rules checks,
+ * search or rendering.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "platform.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <time.h>
+
+/**
+ * @brief The maximum number of frames of a sample.
+ */
+#define PROFILER_MAX_DEPTH 48
+
+/**
+ * @brief The maximum number of threads profiled at the same time.
+ */
+#define PROFILER_MAX_THREADS 64
+
+/**
+ * @struct ProfileSample
+ * @brief The stack of a thread when it was interrupted.
+ *
+ * @var ProfileSample::depth
+ *     The number of frames, 0 while the sample is being taken.
+ * @var ProfileSample::frames
+ *     The frames, from the interrupted one to the outermost one.
+ */
+struct ProfileSample {
+    volatile int depth;
+    void *frames[PROFILER_MAX_DEPTH];
+};
+
+/**
+ * @struct Profiler
+ * @brief The state of the profiler of a process.
+ *
+ * @var Profiler::samples
+ *     The sample slots.
+ * @var Profiler::capacity
+ *     The number of sample slots.
+ * @var Profiler::samplesNumber
+ *     The number of samples taken, which is more than
+ *     Profiler::capacity when samples were dropped.
+ * @var Profiler::period
+ *     The CPU time between two samples of a thread, in nanoseconds.
+ * @var Profiler::start
+ *     The time the profiler was created.
+ * @var Profiler::lock
+ *     Protects the threads and their timers.
+ * @var Profiler::threads
+ *     The ids of the threads taking part.
+ * @var Profiler::timers
+ *     The timer of every thread taking part.
+ * @var Profiler::threadsNumber
+ *     The number of threads taking part.
+ */
+struct Profiler {
+    struct ProfileSample *samples;
+    long capacity;
+    volatile long samplesNumber;
+    long period;
+    struct timespec start;
+    pthread_mutex_t lock;
+    pid_t threads[PROFILER_MAX_THREADS];
+    timer_t timers[PROFILER_MAX_THREADS];
+    int threadsNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates a profiler and installs the handler of SIGPROF. Only
+ *        one profiler exists at a time.
+ *
+ * @param capacity The number of sample slots.
+ * @param frequency The number of samples per second of CPU time of a
+ *                  thread.
+ *
+ * @return Pointer to the new profiler on success or NULL on failure.
+ */
+EXPORT struct Profiler *profiler_createProfiler(const long capacity,
+                                                const long frequency);
+
+/**
+ * @brief Stops the timers of all the threads, waits for the handlers which
+ *        are taking a sample, frees the memory of a profiler and sets the
+ *        pointer to NULL. The handler of SIGPROF stays installed and
+ *        ignores the signals sent by the deleted timers.
+ *
+ * @param profiler Pointer to the pointer to be freed.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int profiler_deleteProfiler(struct Profiler **profiler);
+
+/**
+ * @brief Starts sampling the calling thread.
+ *
+ * @param profiler The profiler.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int profiler_addThread(struct Profiler *profiler);
+
+/**
+ * @brief Stops sampling the calling thread.
+ *
+ * @param profiler The profiler.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int profiler_removeThread(struct Profiler *profiler);
+
+/**
+ * @brief Writes the samples taken so far as a pprof profile.
+ *
+ * @param profiler The profiler.
+ * @param file The file where the profile is written.
+ *
+ * @return The number of samples written on success, negative value on
+ *         failure.
+ */
+EXPORT long profiler_writeProfile(const struct Profiler *profiler,
+                                  FILE *file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,228 @@
+/**
+ * @file dedup.c
+ * @brief Copies rounds written in notation, leaving out the rounds whose
+ *        deal was seen before, up to a renaming of the suits.
+ *
+ * The input is read in large blocks and every round is parsed only to find
+ * its deal and its trump, which are added to a Deduplicator. The text of a
+ * new round is copied as it is, with its comments and unknown tags, so the
+ * first round of every deal is kept.
+ */
+
+#define _GNU_SOURCE
+
+#include <cruceGame.h>
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The size of the blocks read from the input.
+ */
+#define BLOCK_SIZE (8 << 20)
+
+/**
+ * @brief Copies the rounds of a block whose deals are new.
+ *
+ * @param last 1 if the block is the end of the input, 0 otherwise.
+ * @param skipped Incremented for every round which can not be parsed.
+ *
+ * @return The number of bytes consumed on success, negative value on
+ *         failure.
+ */
+static long dedupBlock(const char *text, const size_t length, const int last,
+                       struct Deduplicator *deduplicator, long *skipped,
+                       FILE *output)
+{
+    const char *start = text;
+    const char *end = text + length;
+    struct RoundRecord record;
+
+    while (text < end) {
+        size_t roundLength = notation_roundLength(text, end - text);
+        if (roundLength == 0 && !last)
+            break;
+        if (roundLength == 0)
+            roundLength = end - text;
+
+        int consumed = notation_parseRound(&record, text, roundLength);
+        if (consumed > 0)
+            consumed = dedup_addRound(deduplicator, &record);
+        if (consumed < 0)
+            (*skipped)++;
+        if (consumed == 1 &&
+            fwrite(text, 1, roundLength, output) != roundLength)
+            return FULL;
+        text += roundLength;
+    }
+
+    return text - start;
+}
+
+/**
+ * @brief Copies the rounds of a file whose deals are new.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int dedupFile(FILE *input, char *block,
+                     struct Deduplicator *deduplicator, long *skipped,
+                     FILE *output)
+{
+    size_t end = 0;
+
+    while (1) {
+        end += fread(block + end, 1, BLOCK_SIZE - end, input);
+        if (ferror(input))
+            return NOT_FOUND;
+
+        int last = feof(input) != 0;
+        long consumed = dedupBlock(block, end, last, deduplicator, skipped,
+                                   output);
+        if (consumed < 0)
+            return consumed;
+        if (last)
+            return NO_ERROR;
+        if (consumed == 0)
+            return FULL;
+
+        memmove(block, block + consumed, end - consumed);
+        end -= consumed;
+    }
+}
+
+/**
+ * @brief Prints the usage of the program.
+ */
+static void printUsage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTION]... [FILE]...\n"
+            "Copies rounds written in notation, leaving out the rounds "
+            "whose deal was seen\nbefore, up to a renaming of the suits.\n\n"
+            "  -n, --deals=N         number of different deals expected "
+            "(default\n"
+            "                        100000000), which sizes the Bloom "
+            "filter\n"
+            "  -m, --memory=MB       memory of the deals kept to verify "
+            "duplicates\n"
+            "                        (default 256)\n"
+            "  -o, --output=FILE     write to FILE instead of the standard "
+            "output\n"
+            "  -v, --verbose         print the number of rounds, duplicates "
+            "and\n"
+            "                        duplicates which could not be "
+            "verified\n"
+            "  -h, --help            print this help\n",
+            name);
+}
+
+int main(int argc, char *argv[])
+{
+    long dealsNumber = 100000000;
+    long memoryNumber = 256;
+    int verbose = 0;
+    const char *outputName = NULL;
+    struct option longOptions[] = {
+        {"deals", required_argument, 0, 'n'},
+        {"memory", required_argument, 0, 'm'},
+        {"output", required_argument, 0, 'o'},
+        {"verbose", no_argument, 0, 'v'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "n:m:o:vh", longOptions,
+                                 NULL)) != -1) {
+        switch (option) {
+        case 'n':
+            dealsNumber = atol(optarg);
+            if (dealsNumber < 1) {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'm':
+            memoryNumber = atol(optarg);
+            if (memoryNumber < 1) {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'o':
+            outputName = optarg;
+            break;
+        case 'v':
+            verbose = 1;
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The hash table is kept at most 3/4 full.
+    long capacity = ((size_t)memoryNumber << 20) /
+                    sizeof(struct DedupSlot) * 3 / 4;
+    struct Deduplicator *deduplicator =
+        dedup_createDeduplicator(dealsNumber, capacity);
+    char *block = malloc(BLOCK_SIZE);
+    if (deduplicator == NULL || block == NULL) {
+        perror(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE *output = stdout;
+    if (outputName != NULL && (output = fopen(outputName, "wb")) == NULL) {
+        perror(outputName);
+        return EXIT_FAILURE;
+    }
+
+    int status = EXIT_SUCCESS;
+    long skipped = 0;
+    int inputsNumber = optind < argc ? argc - optind : 1;
+    for (int i = 0; i < inputsNumber; i++) {
+        const char *inputName = optind < argc ? argv[optind + i] : "-";
+        FILE *input = stdin;
+        if (strcmp(inputName, "-") != 0 &&
+            (input = fopen(inputName, "rb")) == NULL) {
+            perror(inputName);
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        int error = dedupFile(input, block, deduplicator, &skipped, output);
+        if (error != NO_ERROR) {
+            const char *message = "read failed";
+            if (ferror(output))
+                message = "write failed";
+            else if (error == FULL)
+                message = "round longer than the read buffer";
+            fprintf(stderr, "%s: %s: %s\n", argv[0], inputName, message);
+            status = EXIT_FAILURE;
+        }
+        if (input != stdin)
+            fclose(input);
+    }
+
+    if (verbose || skipped > 0)
+        fprintf(stderr, "%s: %ld rounds, %ld duplicates (%ld not verified), "
+                "%ld rounds skipped\n",
+                argv[0], deduplicator->dealsNumber,
+                deduplicator->duplicatesNumber,
+                deduplicator->unverifiedNumber, skipped);
+
+    dedup_deleteDeduplicator(&deduplicator);
+    free(block);
+    if (fclose(output) != 0) {
+        perror(outputName != NULL ? outputName : argv[0]);
+        status = EXIT_FAILURE;
+    }
+
+    return status;
+}
@@ -0,0 +1,353 @@
+/**
+ * @file export.c
+ * @brief Exports rounds written in notation as NDJSON or CSV.
+ *
+ * The input is read in large blocks. Every block is cut at round
+ * boundaries into one chunk for every thread, the chunks are parsed and
+ * formatted in parallel, then written in order, so the output does not
+ * depend on the number of threads.
+ */
+
+#define _GNU_SOURCE
+
+#include <cruceGame.h>
+
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The size of the blocks read from the input.
+ */
+#define BLOCK_SIZE (8 << 20)
+
+/**
+ * @brief The maximum number of formatting threads.
+ */
+#define MAX_THREADS 64
+
+/**
+ * @struct Chunk
+ * @brief A part of a block, formatted by one thread.
+ *
+ * @var Chunk::text
+ *     The rounds in notation.
+ * @var Chunk::length
+ *     The length of text. After formatting, the number of bytes consumed.
+ * @var Chunk::output
+ *     Buffer with the formatted rounds, kept between blocks.
+ * @var Chunk::capacity
+ *     The size of output.
+ * @var Chunk::used
+ *     The number of bytes formatted in output.
+ * @var Chunk::rounds
+ *     The number of rounds formatted.
+ * @var Chunk::skipped
+ *     The number of rounds which could not be parsed.
+ * @var Chunk::error
+ *     \ref NO_ERROR, or the error which stopped the formatting.
+ * @var Chunk::last
+ *     1 if the chunk ends the input, so an incomplete round at its end is
+ *     still parsed.
+ * @var Chunk::format
+ *     The format of the output.
+ */
+struct Chunk {
+    const char *text;
+    size_t length;
+    char *output;
+    size_t capacity;
+    size_t used;
+    long rounds;
+    long skipped;
+    int error;
+    int last;
+    enum ExportFormat format;
+};
+
+/**
+ * @brief Parses and formats the rounds of a chunk.
+ *
+ * Unless the chunk is the end of the input, an incomplete round at its end
+ * is left for the next block.
+ */
+static void *formatChunk(void *argument)
+{
+    struct Chunk *chunk = argument;
+    const char *text = chunk->text;
+    const char *end = text + chunk->length;
+    struct RoundRecord record;
+
+    chunk->used = 0;
+    chunk->error = NO_ERROR;
+    while (text < end) {
+        size_t length = notation_roundLength(text, end - text);
+        if (length == 0 && !chunk->last)
+            break;
+        if (length == 0)
+            length = end - text;
+
+        int consumed = notation_parseRound(&record, text, length);
+        text += length;
+        if (consumed < 0)
+            chunk->skipped++;
+        if (consumed <= 0)
+            continue;
+
+        if (chunk->capacity - chunk->used < EXPORT_MAX_ROUND_LENGTH) {
+            size_t capacity = 2 * chunk->capacity + EXPORT_MAX_ROUND_LENGTH;
+            char *output = realloc(chunk->output, capacity);
+            if (output == NULL) {
+                chunk->error = MALLOC_ERROR;
+                break;
+            }
+            chunk->output = output;
+            chunk->capacity = capacity;
+        }
+
+        chunk->used += export_writeRound(&record, chunk->format,
+                                         chunk->output + chunk->used,
+                                         chunk->capacity - chunk->used);
+        chunk->rounds++;
+    }
+    chunk->length = text - chunk->text;
+
+    return NULL;
+}
+
+/**
+ * @brief Finds the end of the round which contains a position of a text.
+ *
+ * @return The position after the round, or the length of the text if the
+ *         round is not complete.
+ */
+static size_t roundBoundary(const char *text, const size_t length,
+                            size_t position)
+{
+    while (position > 0 && text[position - 1] != '\n')
+        position--;
+
+    size_t roundLength = notation_roundLength(text + position,
+                                              length - position);
+
+    return roundLength > 0 ? position + roundLength : length;
+}
+
+/**
+ * @brief Formats the rounds of a block and writes them.
+ *
+ * @param last 1 if the block is the end of the input, 0 otherwise.
+ *
+ * @return The number of bytes consumed on success, negative value on
+ *         failure.
+ */
+static long exportBlock(const char *text, const size_t length,
+                        const int last, struct Chunk *chunks,
+                        const int threadsNumber, FILE *output)
+{
+    pthread_t threads[MAX_THREADS];
+    size_t start = 0;
+
+    for (int i = 0; i < threadsNumber; i++) {
+        size_t end = length;
+        if (i < threadsNumber - 1)
+            end = roundBoundary(text, length,
+                                length / threadsNumber * (i + 1));
+        if (end < start)
+            end = start;
+
+        chunks[i].text = text + start;
+        chunks[i].length = end - start;
+        chunks[i].last = last;
+        start = end;
+    }
+
+    int started = 1;
+    for (; started < threadsNumber; started++)
+        if (pthread_create(&threads[started], NULL, formatChunk,
+                           &chunks[started]) != 0)
+            break;
+    formatChunk(&chunks[0]);
+    for (int i = 1; i < threadsNumber; i++) {
+        if (i < started)
+            pthread_join(threads[i], NULL);
+        else
+            formatChunk(&chunks[i]);
+    }
+
+    size_t consumed = 0;
+    for (int i = 0; i < threadsNumber; i++) {
+        if (chunks[i].error != NO_ERROR)
+            return chunks[i].error;
+        if (fwrite(chunks[i].output, 1, chunks[i].used, output) !=
+            chunks[i].used)
+            return FULL;
+        consumed += chunks[i].length;
+    }
+
+    return consumed;
+}
+
+/**
+ * @brief Exports all the rounds of a file.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int exportFile(FILE *input, char *block, struct Chunk *chunks,
+                      const int threadsNumber, FILE *output)
+{
+    size_t end = 0;
+
+    while (1) {
+        end += fread(block + end, 1, BLOCK_SIZE - end, input);
+        if (ferror(input))
+            return NOT_FOUND;
+
+        int last = feof(input) != 0;
+        long consumed = exportBlock(block, end, last, chunks, threadsNumber,
+                                    output);
+        if (consumed < 0)
+            return consumed;
+        if (last)
+            return NO_ERROR;
+        if (consumed == 0)
+            return FULL;
+
+        memmove(block, block + consumed, end - consumed);
+        end -= consumed;
+    }
+}
+
+/**
+ * @brief Prints the usage of the program.
+ */
+static void printUsage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTION]... [FILE]...\n"
+            "Exports rounds written in notation as NDJSON or CSV.\n\n"
+            "  -f, --format=FORMAT   ndjson (default) or csv\n"
+            "  -j, --threads=N       number of formatting threads (1 - %d)\n"
+            "  -o, --output=FILE     write to FILE instead of the standard "
+            "output\n"
+            "  -h, --help            print this help\n",
+            name, MAX_THREADS);
+}
+
+int main(int argc, char *argv[])
+{
+    enum ExportFormat format = EXPORT_NDJSON;
+    int threadsNumber = 1;
+    const char *outputName = NULL;
+    struct option longOptions[] = {
+        {"format", required_argument, 0, 'f'},
+        {"threads", required_argument, 0, 'j'},
+        {"output", required_argument, 0, 'o'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "f:j:o:h", longOptions,
+                                 NULL)) != -1) {
+        switch (option) {
+        case 'f':
+            if (strcmp(optarg, "ndjson") == 0) {
+                format = EXPORT_NDJSON;
+            } else if (strcmp(optarg, "csv") == 0) {
+                format = EXPORT_CSV;
+            } else {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'j':
+            threadsNumber = atoi(optarg);
+            if (threadsNumber < 1 || threadsNumber > MAX_THREADS) {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'o':
+            outputName = optarg;
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE *output = stdout;
+    if (outputName != NULL && (output = fopen(outputName, "wb")) == NULL) {
+        perror(outputName);
+        return EXIT_FAILURE;
+    }
+
+    char *block = malloc(BLOCK_SIZE);
+    if (block == NULL) {
+        perror(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    struct Chunk chunks[MAX_THREADS];
+    memset(chunks, 0, sizeof(chunks));
+    for (int i = 0; i < threadsNumber; i++)
+        chunks[i].format = format;
+
+    char header[EXPORT_MAX_ROUND_LENGTH];
+    int headerLength = export_writeHeader(format, header, sizeof(header));
+    fwrite(header, 1, headerLength, output);
+
+    int status = EXIT_SUCCESS;
+    int inputsNumber = optind < argc ? argc - optind : 1;
+    for (int i = 0; i < inputsNumber; i++) {
+        const char *inputName = optind < argc ? argv[optind + i] : "-";
+        FILE *input = stdin;
+        if (strcmp(inputName, "-") != 0 &&
+            (input = fopen(inputName, "rb")) == NULL) {
+            perror(inputName);
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        int error = exportFile(input, block, chunks, threadsNumber, output);
+        if (error != NO_ERROR) {
+            const char *message = "read failed";
+            if (ferror(output))
+                message = "write failed";
+            else if (error == FULL)
+                message = "round longer than the read buffer";
+            else if (error == MALLOC_ERROR)
+                message = "out of memory";
+            fprintf(stderr, "%s: %s: %s\n", argv[0], inputName, message);
+            status = EXIT_FAILURE;
+        }
+        if (input != stdin)
+            fclose(input);
+    }
+
+    long rounds = 0;
+    long skipped = 0;
+    for (int i = 0; i < threadsNumber; i++) {
+        rounds += chunks[i].rounds;
+        skipped += chunks[i].skipped;
+        free(chunks[i].output);
+    }
+    if (skipped > 0)
+        fprintf(stderr, "%s: %ld rounds exported, %ld rounds skipped\n",
+                argv[0], rounds, skipped);
+
+    free(block);
+    if (fclose(output) != 0) {
+        perror(outputName != NULL ? outputName : argv[0]);
+        status = EXIT_FAILURE;
+    }
+
+    return status;
+}
+
@@ -0,0 +1,601 @@
+/**
+ * @file simulate.c
+ * @brief Simulates random rounds and prints their statistics.
+ *
+ * The rounds are simulated in blocks of SIMULATION_BLOCK_SIZE, which the
+ * threads take in any order. Every round depends only on the seed and on
+ * its index, the statistics of the blocks are merged in a fixed tree and
+ * the rounds are written in order, so the output does not depend on the
+ * number of threads.
+ *
+ * With a bid, seat 0 makes the bid in every round and its hand is drawn by
+ * a DealSampler, from strata tilted toward strong hands: the weighted
+ * estimate of the probability the bid is made needs far fewer rounds than
+ * waiting for such hands in uniform deals. Stratified, the rounds are
+ * shared between the strata in proportion to the tilted probabilities,
+ * round i always going to the same stratum, and the probability is the sum
+ * of the share of the bids made in every stratum times the probability of
+ * the stratum.
+ *
+ * With a profile, the CPU time of the threads is sampled and written as a
+ * pprof profile at the end, and after the current batch whenever the
+ * process receives SIGUSR2.
+ */
+
+#define _GNU_SOURCE
+
+#include <cruceGame.h>
+#include <profiler.h>
+
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The maximum number of simulation threads.
+ */
+#define MAX_THREADS 64
+
+/**
+ * @brief The number of blocks simulated before the rounds are written.
+ */
+#define BATCH_BLOCKS 256
+
+/**
+ * @brief The number of samples kept by the profiler.
+ */
+#define PROFILE_SAMPLES 1000000
+
+/**
+ * @brief The number of samples per second of CPU time of a thread.
+ */
+#define PROFILE_FREQUENCY 100
+
+/**
+ * @brief Set when SIGUSR2 asks for the profile to be written.
+ */
+static volatile sig_atomic_t profileRequested;
+
+/**
+ * @struct Batch
+ * @brief Blocks simulated by the threads between two writes of the rounds.
+ *
+ * @var Batch::lock
+ *     Protects Batch::nextBlock and Batch::error.
+ * @var Batch::nextBlock
+ *     The first block not taken by a thread yet.
+ * @var Batch::endBlock
+ *     The block after the last block of the batch.
+ * @var Batch::gamesNumber
+ *     The number of rounds of the simulation.
+ * @var Batch::playersNumber
+ *     The number of players of every round.
+ * @var Batch::seed
+ *     The seed of the simulation.
+ * @var Batch::sampler
+ *     If seat 0 makes a bid in every round, the sampler of its hands, NULL
+ *     otherwise.
+ * @var Batch::bid
+ *     The bid of seat 0, if Batch::sampler is not NULL.
+ * @var Batch::stratified
+ *     1 if the rounds are shared between the strata, 0 if the strata are
+ *     drawn.
+ * @var Batch::strataEnds
+ *     If stratified, the index after the last round of every stratum.
+ * @var Batch::strataMade
+ *     If stratified, the number of bids made in every stratum.
+ * @var Batch::stats
+ *     The statistics of every block of the batch.
+ * @var Batch::reducer
+ *     Merges the statistics of the blocks of the batches done.
+ * @var Batch::total
+ *     The statistics of the whole simulation, once it is done.
+ * @var Batch::texts
+ *     If the rounds are written, the rounds of every block of the batch
+ *     in notation, NULL otherwise.
+ * @var Batch::lengths
+ *     The length of every text.
+ * @var Batch::error
+ *     \ref NO_ERROR, or the first error of a thread.
+ * @var Batch::profiler
+ *     The profiler of the threads, NULL if there is no profile.
+ * @var Batch::profileName
+ *     The file where the profile is written.
+ */
+struct Batch {
+    pthread_mutex_t lock;
+    long nextBlock;
+    long endBlock;
+    long gamesNumber;
+    int playersNumber;
+    uint64_t seed;
+    struct DealSampler *sampler;
+    int bid;
+    int stratified;
+    long strataEnds[SAMPLING_STRATA];
+    long strataMade[SAMPLING_STRATA];
+    struct SimulationStats *stats;
+    struct StatsReducer reducer;
+    struct SimulationStats total;
+    char **texts;
+    size_t *lengths;
+    int error;
+    struct Profiler *profiler;
+    const char *profileName;
+};
+
+/**
+ * @brief Shares the rounds between the strata in proportion to the
+ *        proposal of the sampler.
+ */
+static void shareStrata(struct Batch *batch)
+{
+    double cumulated = 0;
+
+    for (int i = 0; i < SAMPLING_STRATA; i++) {
+        cumulated += batch->sampler->proposal[i];
+        batch->strataEnds[i] = (long)floor(cumulated * batch->gamesNumber +
+                                           0.5);
+        if (batch->strataEnds[i] > batch->gamesNumber)
+            batch->strataEnds[i] = batch->gamesNumber;
+    }
+
+    // Rounding errors are given to the last stratum which can be drawn.
+    int last = SAMPLING_STRATA - 1;
+    while (last > 0 && batch->sampler->proposal[last] == 0)
+        batch->strataEnds[last--] = batch->gamesNumber;
+    batch->strataEnds[last] = batch->gamesNumber;
+}
+
+/**
+ * @brief Finds the stratum of a round: the first one whose end is after
+ *        it.
+ */
+static int findStratum(const struct Batch *batch, const long index)
+{
+    int low = 0;
+    int high = SAMPLING_STRATA - 1;
+
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (batch->strataEnds[middle] > index)
+            high = middle;
+        else
+            low = middle + 1;
+    }
+
+    return low;
+}
+
+/**
+ * @brief Deals a round to seat 0 from the sampler and plays it.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int playSampledRound(struct Batch *batch, struct RoundRecord *record,
+                            const long index, double *weight)
+{
+    uint64_t state = simulation_seed(batch->seed, index);
+    int stratum;
+    if (batch->stratified) {
+        stratum = findStratum(batch, index);
+        long first = stratum > 0 ? batch->strataEnds[stratum - 1] : 0;
+        *weight = batch->sampler->probabilities[stratum] *
+                  batch->gamesNumber / (batch->strataEnds[stratum] - first);
+    } else {
+        stratum = sampling_drawStratum(batch->sampler, &state, weight);
+        if (stratum < 0)
+            return stratum;
+    }
+
+    int error = sampling_drawDeal(batch->sampler, record, stratum,
+                                  batch->bid, &state);
+    if (error == NO_ERROR)
+        error = simulation_playDeal(record, &state);
+    if (error == NO_ERROR && batch->stratified && record_bidMade(record))
+        __sync_fetch_and_add(&batch->strataMade[stratum], 1);
+
+    return error;
+}
+
+/**
+ * @brief Simulates the rounds of a block.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int simulateBlock(struct Batch *batch, const long block, char *text,
+                         size_t *length)
+{
+    struct SimulationStats *stats = &batch->stats[block % BATCH_BLOCKS];
+    long first = block * SIMULATION_BLOCK_SIZE;
+    long end = first + SIMULATION_BLOCK_SIZE;
+    if (end > batch->gamesNumber)
+        end = batch->gamesNumber;
+
+    simulation_initStats(stats);
+    *length = 0;
+    for (long i = first; i < end; i++) {
+        struct RoundRecord record;
+        double weight = 1;
+        int error = batch->sampler != NULL ?
+                    playSampledRound(batch, &record, i, &weight) :
+                    simulation_playRound(&record, batch->playersNumber,
+                                         batch->seed, i);
+        if (error == NO_ERROR)
+            error = simulation_addWeightedRound(stats, &record, weight);
+        if (error != NO_ERROR)
+            return error;
+
+        if (text != NULL) {
+            int written = notation_writeRound(&record, text + *length,
+                                              NOTATION_MAX_ROUND_LENGTH);
+            if (written < 0)
+                return written;
+            *length += written;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Takes blocks of a batch and simulates them, until none is left.
+ */
+static void *simulateBlocks(void *argument)
+{
+    struct Batch *batch = argument;
+
+    while (1) {
+        pthread_mutex_lock(&batch->lock);
+        long block = batch->error == NO_ERROR ? batch->nextBlock++ :
+                     batch->endBlock;
+        pthread_mutex_unlock(&batch->lock);
+        if (block >= batch->endBlock)
+            return NULL;
+
+        int slot = block % BATCH_BLOCKS;
+        int error = simulateBlock(batch, block,
+                                  batch->texts ? batch->texts[slot] : NULL,
+                                  &batch->lengths[slot]);
+        if (error != NO_ERROR) {
+            pthread_mutex_lock(&batch->lock);
+            if (batch->error == NO_ERROR)
+                batch->error = error;
+            pthread_mutex_unlock(&batch->lock);
+        }
+    }
+}
+
+/**
+ * @brief Runs a thread which takes blocks, sampled by the profiler.
+ */
+static void *runThread(void *argument)
+{
+    struct Batch *batch = argument;
+
+    if (batch->profiler != NULL)
+        profiler_addThread(batch->profiler);
+    simulateBlocks(batch);
+    if (batch->profiler != NULL)
+        profiler_removeThread(batch->profiler);
+
+    return NULL;
+}
+
+/**
+ * @brief Records that the profile is asked for.
+ */
+static void requestProfile(int signal)
+{
+    (void)signal;
+    profileRequested = 1;
+}
+
+/**
+ * @brief Writes the samples taken so far to the profile file.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int writeProfile(const struct Batch *batch)
+{
+    FILE *file = fopen(batch->profileName, "wb");
+    if (file == NULL)
+        return FULL;
+
+    long written = profiler_writeProfile(batch->profiler, file);
+    if (fclose(file) != 0 && written >= 0)
+        written = FULL;
+
+    return written < 0 ? (int)written : NO_ERROR;
+}
+
+/**
+ * @brief Simulates all the rounds and writes them if they are asked for.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int simulate(struct Batch *batch, const int threadsNumber,
+                    FILE *rounds)
+{
+    long blocksNumber = (batch->gamesNumber + SIMULATION_BLOCK_SIZE - 1) /
+                        SIMULATION_BLOCK_SIZE;
+    pthread_t threads[MAX_THREADS];
+
+    for (long first = 0; first < blocksNumber; first += BATCH_BLOCKS) {
+        batch->nextBlock = first;
+        batch->endBlock = first + BATCH_BLOCKS < blocksNumber ?
+                          first + BATCH_BLOCKS : blocksNumber;
+
+        int started = 1;
+        for (; started < threadsNumber; started++)
+            if (pthread_create(&threads[started], NULL, runThread,
+                               batch) != 0)
+                break;
+        simulateBlocks(batch);
+        for (int i = 1; i < started; i++)
+            pthread_join(threads[i], NULL);
+        if (batch->error != NO_ERROR)
+            return batch->error;
+
+        // The blocks are merged in order, whichever thread did them.
+        for (long i = first; i < batch->endBlock; i++)
+            simulation_pushStats(&batch->reducer,
+                                 &batch->stats[i % BATCH_BLOCKS]);
+
+        if (profileRequested && batch->profiler != NULL) {
+            profileRequested = 0;
+            int error = writeProfile(batch);
+            if (error != NO_ERROR)
+                return error;
+        }
+
+        if (rounds == NULL)
+            continue;
+        for (long i = first; i < batch->endBlock; i++) {
+            int slot = i % BATCH_BLOCKS;
+            if (fwrite(batch->texts[slot], 1, batch->lengths[slot],
+                       rounds) != batch->lengths[slot])
+                return FULL;
+        }
+    }
+
+    return simulation_finishStats(&batch->reducer, &batch->total);
+}
+
+/**
+ * @brief Prints the statistics of a simulation.
+ */
+static void printStats(const struct Batch *batch)
+{
+    const struct SimulationStats *stats = &batch->total;
+
+    printf("rounds %ld\n", stats->roundsNumber);
+    printf("players %d\n", batch->playersNumber);
+    printf("seed %" PRIu64 "\n", batch->seed);
+    if (batch->stratified) {
+        // Every stratum with rounds adds its share of bids made, and its
+        // variance, times its probability.
+        double made = 0, variance = 0, covered = 0;
+        for (int i = 0; i < SAMPLING_STRATA; i++) {
+            long first = i > 0 ? batch->strataEnds[i - 1] : 0;
+            long rounds = batch->strataEnds[i] - first;
+            double probability = batch->sampler->probabilities[i];
+            if (rounds == 0)
+                continue;
+            double share = (double)batch->strataMade[i] / rounds;
+            made += probability * share;
+            covered += probability;
+            if (rounds > 1)
+                variance += probability * probability * share *
+                            (1 - share) / (rounds - 1);
+        }
+        printf("bid %d made %.6f\n", batch->bid, made);
+        printf("standard error %.6f\n", sqrt(variance));
+        printf("strata covered %.6f\n", covered);
+    } else if (batch->sampler != NULL) {
+        double variance = stats->roundsNumber > 1 ?
+                          stats->weightedDeviations /
+                          (stats->roundsNumber - 1) : 0;
+        printf("bid %d made %.6f\n", batch->bid, stats->weightedBidsMade);
+        printf("standard error %.6f\n",
+               sqrt(variance / stats->roundsNumber));
+    } else {
+        printf("bids made %.6f\n",
+               (double)stats->bidsMade / stats->roundsNumber);
+    }
+    printf("%-6s %12s %12s %12s\n", "seat", "points", "deviation", "score");
+    for (int i = 0; i < batch->playersNumber; i++) {
+        double variance = stats->roundsNumber > 1 ?
+                          stats->squaredDeviations[i] /
+                          (stats->roundsNumber - 1) : 0;
+        printf("%-6d %12.6f %12.6f %12.6f\n", i, stats->meanPoints[i],
+               sqrt(variance), stats->meanScores[i]);
+    }
+}
+
+/**
+ * @brief Prints the usage of the program.
+ */
+static void printUsage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTION]...\n"
+            "Simulates random rounds and prints their statistics. The "
+            "output depends only on\nthe seed, not on the number of "
+            "threads.\n\n"
+            "  -n, --rounds=N        number of rounds (default 10000)\n"
+            "  -p, --players=N       number of players (2 - 4, default 4)\n"
+            "  -s, --seed=N          the seed (default 1)\n"
+            "  -j, --threads=N       number of simulation threads (1 - %d)\n"
+            "  -r, --record=FILE     write the rounds to FILE in notation\n"
+            "  -b, --bid=N           seat 0 bids N (1 - 6) in every round\n"
+            "  -t, --tilt=X          with a bid, make hands X times more "
+            "likely for every\n"
+            "                        trump, ace and marriage, then weight "
+            "them back\n"
+            "                        (default 1)\n"
+            "  -S, --stratified      with a bid, share the rounds between "
+            "the strata of\n"
+            "                        hands instead of drawing them\n"
+            "  -P, --profile=FILE    sample the CPU time and write a pprof "
+            "profile to FILE,\n"
+            "                        also whenever SIGUSR2 is received\n"
+            "  -h, --help            print this help\n",
+            name, MAX_THREADS);
+}
+
+int main(int argc, char *argv[])
+{
+    struct Batch batch;
+    int threadsNumber = 1;
+    const char *recordName = NULL;
+    double tilt = 1;
+    struct option longOptions[] = {
+        {"rounds", required_argument, 0, 'n'},
+        {"players", required_argument, 0, 'p'},
+        {"seed", required_argument, 0, 's'},
+        {"threads", required_argument, 0, 'j'},
+        {"record", required_argument, 0, 'r'},
+        {"bid", required_argument, 0, 'b'},
+        {"tilt", required_argument, 0, 't'},
+        {"stratified", no_argument, 0, 'S'},
+        {"profile", required_argument, 0, 'P'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    memset(&batch, 0, sizeof(batch));
+    batch.gamesNumber = 10000;
+    batch.playersNumber = MAX_GAME_PLAYERS;
+    batch.seed = 1;
+
+    int option;
+    while ((option = getopt_long(argc, argv, "n:p:s:j:r:b:t:SP:h", longOptions,
+                                 NULL)) != -1) {
+        switch (option) {
+        case 'n':
+            batch.gamesNumber = atol(optarg);
+            break;
+        case 'p':
+            batch.playersNumber = atoi(optarg);
+            break;
+        case 's':
+            batch.seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'j':
+            threadsNumber = atoi(optarg);
+            break;
+        case 'r':
+            recordName = optarg;
+            break;
+        case 'b':
+            batch.bid = atoi(optarg);
+            break;
+        case 't':
+            tilt = atof(optarg);
+            break;
+        case 'S':
+            batch.stratified = 1;
+            break;
+        case 'P':
+            batch.profileName = optarg;
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (batch.gamesNumber < 1 || batch.playersNumber < 2 ||
+        batch.playersNumber > MAX_GAME_PLAYERS || threadsNumber < 1 ||
+        threadsNumber > MAX_THREADS || batch.bid < 0 || batch.bid > 6 ||
+        !(tilt > 0) || (batch.stratified && batch.bid == 0)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE *rounds = NULL;
+    if (recordName != NULL && (rounds = fopen(recordName, "wb")) == NULL) {
+        perror(recordName);
+        return EXIT_FAILURE;
+    }
+
+    if (batch.bid > 0 &&
+        ((batch.sampler = sampling_createSampler(batch.playersNumber)) ==
+         NULL || sampling_tiltProposal(batch.sampler, tilt) != NO_ERROR)) {
+        fprintf(stderr, "%s: the tilt %g can not be used\n", argv[0], tilt);
+        sampling_deleteSampler(&batch.sampler);
+        if (rounds != NULL)
+            fclose(rounds);
+        return EXIT_FAILURE;
+    }
+    if (batch.stratified)
+        shareStrata(&batch);
+
+    simulation_initReducer(&batch.reducer);
+    batch.stats = malloc(sizeof(struct SimulationStats) * BATCH_BLOCKS);
+    batch.lengths = malloc(sizeof(size_t) * BATCH_BLOCKS);
+    int error = batch.stats != NULL && batch.lengths != NULL ? NO_ERROR :
+                MALLOC_ERROR;
+    if (error == NO_ERROR && rounds != NULL) {
+        batch.texts = calloc(BATCH_BLOCKS, sizeof(char *));
+        for (int i = 0; batch.texts != NULL && i < BATCH_BLOCKS; i++)
+            if ((batch.texts[i] = malloc(SIMULATION_BLOCK_SIZE *
+                                         NOTATION_MAX_ROUND_LENGTH)) == NULL)
+                break;
+        if (batch.texts == NULL || batch.texts[BATCH_BLOCKS - 1] == NULL)
+            error = MALLOC_ERROR;
+    }
+
+    if (error == NO_ERROR && batch.profileName != NULL) {
+        batch.profiler = profiler_createProfiler(PROFILE_SAMPLES,
+                                                 PROFILE_FREQUENCY);
+        if (batch.profiler == NULL ||
+            profiler_addThread(batch.profiler) != NO_ERROR)
+            error = MALLOC_ERROR;
+        signal(SIGUSR2, requestProfile);
+    }
+
+    pthread_mutex_init(&batch.lock, NULL);
+    if (error == NO_ERROR)
+        error = simulate(&batch, threadsNumber, rounds);
+    pthread_mutex_destroy(&batch.lock);
+
+    if (batch.profiler != NULL) {
+        profiler_removeThread(batch.profiler);
+        if (error == NO_ERROR)
+            error = writeProfile(&batch);
+        profiler_deleteProfiler(&batch.profiler);
+    }
+
+    int status = EXIT_SUCCESS;
+    if (error == NO_ERROR) {
+        printStats(&batch);
+    } else {
+        fprintf(stderr, "%s: the simulation failed (%d)\n", argv[0], error);
+        status = EXIT_FAILURE;
+    }
+    if (rounds != NULL && fclose(rounds) != 0) {
+        perror(recordName);
+        status = EXIT_FAILURE;
+    }
+
+    if (batch.texts != NULL)
+        for (int i = 0; i < BATCH_BLOCKS; i++)
+            free(batch.texts[i]);
+    free(batch.texts);
+    free(batch.lengths);
+    free(batch.stats);
+    if (batch.sampler != NULL)
+        sampling_deleteSampler(&batch.sampler);
+
+    return status;
+}
+
@@ -0,0 +1,740 @@
+/**
+ * @file sort.c
+ * @brief Sorts archives of rounds written in notation which do not fit in
+ *        memory, by player or by deal.
+ *
+ * The input is read in large blocks, cut at round boundaries into one
+ * chunk for every thread, like in cruceExport. Every thread parses its
+ * chunks into its own part of the memory and, when that part is full,
+ * sorts it and writes it to a run file in the temporary directory, so the
+ * runs are made in parallel. The runs are then merged with an
+ * ArchiveMerger, with the memory split into one large read buffer for
+ * every run, so the disk sees long sequential reads. When there are more
+ * runs than can be merged at once, the oldest ones are merged into new
+ * runs first. Rounds with the same key keep the order of the input, so the
+ * output does not depend on the number of threads or on the memory.
+ */
+
+#define _GNU_SOURCE
+
+#include <cruceGame.h>
+
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief The size of the blocks read from the input.
+ */
+#define BLOCK_SIZE (8 << 20)
+
+/**
+ * @brief The maximum number of sorting threads.
+ */
+#define MAX_THREADS 64
+
+/**
+ * @brief The size of the write buffer of a run.
+ */
+#define RUN_BUFFER_SIZE (1 << 20)
+
+/**
+ * @brief The smallest read buffer of a run while merging.
+ */
+#define MIN_MERGE_BUFFER_SIZE (256 << 10)
+
+/**
+ * @brief The maximum number of runs merged at once.
+ */
+#define MAX_FAN_IN 512
+
+/**
+ * @struct Runs
+ * @brief The run files written so far, oldest first.
+ *
+ * @var Runs::names
+ *     The names of the files.
+ * @var Runs::runsNumber
+ *     The number of runs.
+ * @var Runs::capacity
+ *     The size of names.
+ * @var Runs::directory
+ *     The directory where the files are made.
+ * @var Runs::packed
+ *     1 if the entries of the runs are packed.
+ * @var Runs::lock
+ *     Taken by the threads to add a run.
+ */
+struct Runs {
+    char **names;
+    int runsNumber;
+    int capacity;
+    const char *directory;
+    int packed;
+    pthread_mutex_t lock;
+};
+
+/**
+ * @struct Worker
+ * @brief The part of the memory of a thread and the chunk it parses.
+ *
+ * @var Worker::text
+ *     The rounds in notation.
+ * @var Worker::length
+ *     The length of text. After parsing, the number of bytes consumed.
+ * @var Worker::position
+ *     The position of text in the input.
+ * @var Worker::last
+ *     1 if the chunk ends the input, so an incomplete round at its end is
+ *     still parsed.
+ * @var Worker::entries
+ *     The entries parsed since the last run.
+ * @var Worker::order
+ *     The entries, in the order they are sorted in.
+ * @var Worker::capacity
+ *     The size of entries.
+ * @var Worker::used
+ *     The number of entries parsed since the last run.
+ * @var Worker::buffer
+ *     The write buffer of the runs.
+ * @var Worker::rounds
+ *     The number of rounds parsed.
+ * @var Worker::skipped
+ *     The number of rounds which could not be parsed.
+ * @var Worker::error
+ *     \ref NO_ERROR, or the error which stopped the thread.
+ * @var Worker::key
+ *     The key of the sort.
+ * @var Worker::runs
+ *     Where the runs of the thread are added.
+ */
+struct Worker {
+    const char *text;
+    size_t length;
+    uint64_t position;
+    int last;
+    struct ArchiveEntry *entries;
+    struct ArchiveEntry **order;
+    long capacity;
+    long used;
+    char *buffer;
+    long rounds;
+    long skipped;
+    int error;
+    enum ArchiveKey key;
+    struct Runs *runs;
+};
+
+/**
+ * @brief Makes a new empty run file.
+ *
+ * @return The file, opened for writing, or NULL on failure.
+ */
+static FILE *createRun(struct Runs *runs, char **name)
+{
+    size_t length = strlen(runs->directory) + sizeof("/cruceSort-XXXXXX");
+    *name = malloc(length);
+    if (*name == NULL)
+        return NULL;
+    snprintf(*name, length, "%s/cruceSort-XXXXXX", runs->directory);
+
+    int descriptor = mkstemp(*name);
+    FILE *file = descriptor >= 0 ? fdopen(descriptor, "wb") : NULL;
+    if (file == NULL) {
+        if (descriptor >= 0) {
+            close(descriptor);
+            unlink(*name);
+        }
+        free(*name);
+        *name = NULL;
+    }
+
+    return file;
+}
+
+/**
+ * @brief Adds a written run file at the end of the runs.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int addRun(struct Runs *runs, char *name)
+{
+    int error = NO_ERROR;
+
+    pthread_mutex_lock(&runs->lock);
+    if (runs->runsNumber == runs->capacity) {
+        int capacity = 2 * runs->capacity + 16;
+        char **names = realloc(runs->names, sizeof(char *) * capacity);
+        if (names != NULL) {
+            runs->names = names;
+            runs->capacity = capacity;
+        }
+    }
+    if (runs->runsNumber < runs->capacity)
+        runs->names[runs->runsNumber++] = name;
+    else
+        error = MALLOC_ERROR;
+    pthread_mutex_unlock(&runs->lock);
+
+    return error;
+}
+
+/**
+ * @brief Compares two entries given by pointers, for qsort.
+ */
+static int compareOrder(const void *first, const void *second)
+{
+    return archive_compareEntries(*(struct ArchiveEntry * const *)first,
+                                  *(struct ArchiveEntry * const *)second);
+}
+
+/**
+ * @brief Sorts the entries of a worker and writes them to a new run.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int writeRun(struct Worker *worker)
+{
+    if (worker->used == 0)
+        return NO_ERROR;
+
+    // The pointers are sorted instead of the entries, which are large.
+    for (long i = 0; i < worker->used; i++)
+        worker->order[i] = &worker->entries[i];
+    qsort(worker->order, worker->used, sizeof(struct ArchiveEntry *),
+          compareOrder);
+
+    char *name;
+    FILE *file = createRun(worker->runs, &name);
+    if (file == NULL)
+        return NOT_FOUND;
+    setvbuf(file, worker->buffer, _IOFBF, RUN_BUFFER_SIZE);
+
+    struct ArchiveWriter writer;
+    int error = archive_initWriter(&writer, file, worker->runs->packed);
+    for (long i = 0; i < worker->used && error == NO_ERROR; i++)
+        error = archive_writeEntry(&writer, worker->order[i]);
+    if (fclose(file) != 0 && error == NO_ERROR)
+        error = FULL;
+    if (error == NO_ERROR)
+        error = addRun(worker->runs, name);
+    if (error != NO_ERROR) {
+        unlink(name);
+        free(name);
+        return error;
+    }
+    worker->used = 0;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Parses the rounds of a chunk into the entries of a worker,
+ *        writing a run whenever they are full.
+ *
+ * Unless the chunk is the end of the input, an incomplete round at its end
+ * is left for the next block.
+ */
+static void *parseChunk(void *argument)
+{
+    struct Worker *worker = argument;
+    const char *text = worker->text;
+    const char *end = text + worker->length;
+    struct RoundRecord record;
+
+    worker->error = NO_ERROR;
+    while (text < end) {
+        size_t length = notation_roundLength(text, end - text);
+        if (length == 0 && !worker->last)
+            break;
+        if (length == 0)
+            length = end - text;
+
+        if (worker->capacity - worker->used < MAX_GAME_PLAYERS) {
+            worker->error = writeRun(worker);
+            if (worker->error != NO_ERROR)
+                break;
+        }
+
+        int consumed = notation_parseRound(&record, text, length);
+        uint64_t position = worker->position + (text - worker->text);
+        text += length;
+        if (consumed > 0)
+            consumed = archive_makeEntries(&record, worker->key, position,
+                                           &worker->entries[worker->used]);
+        if (consumed < 0)
+            worker->skipped++;
+        if (consumed <= 0)
+            continue;
+
+        worker->used += consumed;
+        worker->rounds++;
+    }
+    worker->length = text - worker->text;
+
+    return NULL;
+}
+
+/**
+ * @brief Writes the last run of a worker.
+ */
+static void *finishWorker(void *argument)
+{
+    struct Worker *worker = argument;
+
+    worker->error = writeRun(worker);
+
+    return NULL;
+}
+
+/**
+ * @brief Runs a function for every worker, each in its own thread.
+ *
+ * @return \ref NO_ERROR if all the workers succeeded, the error of the
+ *         first one which failed otherwise.
+ */
+static int runWorkers(void *(*function)(void *), struct Worker *workers,
+                      const int threadsNumber)
+{
+    pthread_t threads[MAX_THREADS];
+
+    int started = 1;
+    for (; started < threadsNumber; started++)
+        if (pthread_create(&threads[started], NULL, function,
+                           &workers[started]) != 0)
+            break;
+    function(&workers[0]);
+    for (int i = 1; i < threadsNumber; i++) {
+        if (i < started)
+            pthread_join(threads[i], NULL);
+        else
+            function(&workers[i]);
+    }
+
+    for (int i = 0; i < threadsNumber; i++)
+        if (workers[i].error != NO_ERROR)
+            return workers[i].error;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Finds the end of the round which contains a position of a text.
+ *
+ * @return The position after the round, or the length of the text if the
+ *         round is not complete.
+ */
+static size_t roundBoundary(const char *text, const size_t length,
+                            size_t position)
+{
+    while (position > 0 && text[position - 1] != '\n')
+        position--;
+
+    size_t roundLength = notation_roundLength(text + position,
+                                              length - position);
+
+    return roundLength > 0 ? position + roundLength : length;
+}
+
+/**
+ * @brief Parses the rounds of a block in parallel.
+ *
+ * @param last 1 if the block is the end of the input, 0 otherwise.
+ *
+ * @return The number of bytes consumed on success, negative value on
+ *         failure.
+ */
+static long sortBlock(const char *text, const size_t length,
+                      const uint64_t position, const int last,
+                      struct Worker *workers, const int threadsNumber)
+{
+    size_t start = 0;
+
+    for (int i = 0; i < threadsNumber; i++) {
+        size_t end = length;
+        if (i < threadsNumber - 1)
+            end = roundBoundary(text, length,
+                                length / threadsNumber * (i + 1));
+        if (end < start)
+            end = start;
+
+        workers[i].text = text + start;
+        workers[i].length = end - start;
+        workers[i].position = position + start;
+        workers[i].last = last;
+        start = end;
+    }
+
+    int error = runWorkers(parseChunk, workers, threadsNumber);
+    if (error != NO_ERROR)
+        return error;
+
+    size_t consumed = 0;
+    for (int i = 0; i < threadsNumber; i++)
+        consumed += workers[i].length;
+
+    return consumed;
+}
+
+/**
+ * @brief Parses all the rounds of a file into runs.
+ *
+ * @param position The position of the file in the input, updated to the
+ *                 position after it.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int sortFile(FILE *input, char *block, uint64_t *position,
+                    struct Worker *workers, const int threadsNumber)
+{
+    size_t end = 0;
+
+    while (1) {
+        end += fread(block + end, 1, BLOCK_SIZE - end, input);
+        if (ferror(input))
+            return NOT_FOUND;
+
+        int last = feof(input) != 0;
+        long consumed = sortBlock(block, end, *position, last, workers,
+                                  threadsNumber);
+        if (consumed < 0)
+            return consumed;
+        *position += consumed;
+        if (last)
+            return NO_ERROR;
+        if (consumed == 0)
+            return FULL;
+
+        memmove(block, block + consumed, end - consumed);
+        end -= consumed;
+    }
+}
+
+/**
+ * @brief Merges the oldest runs, into a new run or into the output.
+ *
+ * @param runsNumber The number of runs merged.
+ * @param memory The memory of the read buffers of the runs, and of the
+ *               write buffer of the new run.
+ * @param output The file where the rounds are written in notation, or NULL
+ *               to merge into a new run. Sorted by player, the output has
+ *               every round once for every player.
+ *
+ * @return The number of entries merged on success, negative value on
+ *         failure.
+ */
+static long mergeRuns(struct Runs *runs, const int runsNumber,
+                      const size_t memory, FILE *output)
+{
+    FILE *files[MAX_FAN_IN];
+    char *name = NULL;
+    FILE *merged = NULL;
+    size_t bufferSize = memory / (runsNumber + 1);
+    char *buffers = malloc(bufferSize * (runsNumber + 1));
+    long written = buffers != NULL ? 0 : MALLOC_ERROR;
+
+    int opened = 0;
+    for (; opened < runsNumber && written == 0; opened++) {
+        files[opened] = fopen(runs->names[opened], "rb");
+        if (files[opened] == NULL)
+            written = NOT_FOUND;
+        else
+            setvbuf(files[opened], buffers + bufferSize * opened, _IOFBF,
+                    bufferSize);
+    }
+
+    struct ArchiveWriter writer;
+    if (written == 0 && output == NULL) {
+        merged = createRun(runs, &name);
+        if (merged == NULL)
+            written = NOT_FOUND;
+        else
+            setvbuf(merged, buffers + bufferSize * runsNumber, _IOFBF,
+                    bufferSize);
+        archive_initWriter(&writer, merged, runs->packed);
+    }
+
+    struct ArchiveMerger *merger = NULL;
+    if (written == 0 &&
+        (merger = archive_createMerger(files, runsNumber,
+                                       runs->packed)) == NULL)
+        written = NOT_FOUND;
+
+    struct ArchiveEntry entry;
+    char text[NOTATION_MAX_ROUND_LENGTH];
+    while (written >= 0) {
+        int error = archive_mergeEntry(merger, &entry);
+        if (error == 0)
+            break;
+        if (error == 1 && output == NULL) {
+            error = archive_writeEntry(&writer, &entry);
+        } else if (error == 1) {
+            error = notation_writeRound(&entry.record, text, sizeof(text));
+            if (error > 0 && fwrite(text, 1, error, output) != (size_t)error)
+                error = FULL;
+        }
+        written = error < 0 ? error : written + 1;
+    }
+
+    if (merger != NULL)
+        archive_deleteMerger(&merger);
+    for (int i = 0; i < opened; i++)
+        if (files[i] != NULL)
+            fclose(files[i]);
+    if (merged != NULL) {
+        if (fclose(merged) != 0 && written >= 0)
+            written = FULL;
+        if (written >= 0 && addRun(runs, name) != NO_ERROR)
+            written = MALLOC_ERROR;
+        if (written < 0) {
+            unlink(name);
+            free(name);
+        }
+    }
+    free(buffers);
+    if (written < 0)
+        return written;
+
+    // The merged runs are removed, the new one is already at the end.
+    for (int i = 0; i < runsNumber; i++) {
+        unlink(runs->names[i]);
+        free(runs->names[i]);
+    }
+    runs->runsNumber -= runsNumber;
+    memmove(runs->names, runs->names + runsNumber,
+            sizeof(char *) * runs->runsNumber);
+
+    return written;
+}
+
+/**
+ * @brief Prints the usage of the program.
+ */
+static void printUsage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTION]... [FILE]...\n"
+            "Sorts rounds written in notation, using temporary files for "
+            "the rounds\nwhich do not fit in memory.\n\n"
+            "  -k, --key=KEY         deal (default) or player; sorted by "
+            "player, every\n"
+            "                        round is written once for every "
+            "player\n"
+            "  -j, --threads=N       number of sorting threads (1 - %d)\n"
+            "  -m, --memory=MB       memory used for sorting (default "
+            "512)\n"
+            "  -T, --temporary=DIR   directory of the temporary files "
+            "(default $TMPDIR\n"
+            "                        or /tmp)\n"
+            "  -z, --compress        pack the temporary files\n"
+            "  -o, --output=FILE     write to FILE instead of the standard "
+            "output\n"
+            "  -v, --verbose         print the number of rounds, runs and "
+            "merges\n"
+            "  -h, --help            print this help\n",
+            name, MAX_THREADS);
+}
+
+int main(int argc, char *argv[])
+{
+    enum ArchiveKey key = ARCHIVE_DEAL;
+    int threadsNumber = 1;
+    long memoryNumber = 512;
+    int verbose = 0;
+    const char *outputName = NULL;
+    struct Runs runs = {NULL, 0, 0, getenv("TMPDIR"), 0,
+                        PTHREAD_MUTEX_INITIALIZER};
+    struct option longOptions[] = {
+        {"key", required_argument, 0, 'k'},
+        {"threads", required_argument, 0, 'j'},
+        {"memory", required_argument, 0, 'm'},
+        {"temporary", required_argument, 0, 'T'},
+        {"compress", no_argument, 0, 'z'},
+        {"output", required_argument, 0, 'o'},
+        {"verbose", no_argument, 0, 'v'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "k:j:m:T:zo:vh", longOptions,
+                                 NULL)) != -1) {
+        switch (option) {
+        case 'k':
+            if (strcmp(optarg, "deal") == 0) {
+                key = ARCHIVE_DEAL;
+            } else if (strcmp(optarg, "player") == 0) {
+                key = ARCHIVE_PLAYER;
+            } else {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'j':
+            threadsNumber = atoi(optarg);
+            if (threadsNumber < 1 || threadsNumber > MAX_THREADS) {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'm':
+            memoryNumber = atol(optarg);
+            if (memoryNumber < 1) {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'T':
+            runs.directory = optarg;
+            break;
+        case 'z':
+            runs.packed = 1;
+            break;
+        case 'o':
+            outputName = optarg;
+            break;
+        case 'v':
+            verbose = 1;
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (runs.directory == NULL || runs.directory[0] == '\0')
+        runs.directory = "/tmp";
+
+    // The block and the write buffers of the runs are taken out of the
+    // memory, the rest is split between the threads.
+    size_t memory = (size_t)memoryNumber << 20;
+    size_t reserved = BLOCK_SIZE + (size_t)threadsNumber * RUN_BUFFER_SIZE;
+    size_t entrySize = sizeof(struct ArchiveEntry) +
+                       sizeof(struct ArchiveEntry *);
+    long capacity = memory > reserved ?
+                    (memory - reserved) / threadsNumber / entrySize : 0;
+    if (capacity < 64 * MAX_GAME_PLAYERS) {
+        fprintf(stderr, "%s: at least %zu MB are needed for %d threads\n",
+                argv[0], (reserved >> 20) + 1, threadsNumber);
+        return EXIT_FAILURE;
+    }
+
+    FILE *output = stdout;
+    if (outputName != NULL && (output = fopen(outputName, "wb")) == NULL) {
+        perror(outputName);
+        return EXIT_FAILURE;
+    }
+
+    char *block = malloc(BLOCK_SIZE);
+    struct Worker workers[MAX_THREADS];
+    memset(workers, 0, sizeof(workers));
+    int status = block != NULL ? EXIT_SUCCESS : EXIT_FAILURE;
+    for (int i = 0; i < threadsNumber && status == EXIT_SUCCESS; i++) {
+        workers[i].entries = malloc(sizeof(struct ArchiveEntry) * capacity);
+        workers[i].order = malloc(sizeof(struct ArchiveEntry *) * capacity);
+        workers[i].buffer = malloc(RUN_BUFFER_SIZE);
+        workers[i].capacity = capacity;
+        workers[i].key = key;
+        workers[i].runs = &runs;
+        if (workers[i].entries == NULL || workers[i].order == NULL ||
+            workers[i].buffer == NULL)
+            status = EXIT_FAILURE;
+    }
+    if (status != EXIT_SUCCESS)
+        perror(argv[0]);
+
+    uint64_t position = 0;
+    int inputsNumber = optind < argc ? argc - optind : 1;
+    for (int i = 0; i < inputsNumber && status == EXIT_SUCCESS; i++) {
+        const char *inputName = optind < argc ? argv[optind + i] : "-";
+        FILE *input = stdin;
+        if (strcmp(inputName, "-") != 0 &&
+            (input = fopen(inputName, "rb")) == NULL) {
+            perror(inputName);
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        int error = sortFile(input, block, &position, workers,
+                             threadsNumber);
+        if (error != NO_ERROR) {
+            const char *message = "read failed";
+            if (error == FULL)
+                message = "round longer than the read buffer or temporary "
+                          "file write failed";
+            else if (error == MALLOC_ERROR)
+                message = "out of memory";
+            fprintf(stderr, "%s: %s: %s\n", argv[0], inputName, message);
+            status = EXIT_FAILURE;
+        }
+        if (input != stdin)
+            fclose(input);
+    }
+
+    if (status == EXIT_SUCCESS &&
+        runWorkers(finishWorker, workers, threadsNumber) != NO_ERROR) {
+        fprintf(stderr, "%s: %s: temporary file write failed\n", argv[0],
+                runs.directory);
+        status = EXIT_FAILURE;
+    }
+
+    // The memory of the threads is given to the read buffers of the merge.
+    long rounds = 0;
+    long skipped = 0;
+    for (int i = 0; i < threadsNumber; i++) {
+        rounds += workers[i].rounds;
+        skipped += workers[i].skipped;
+        free(workers[i].entries);
+        free(workers[i].order);
+        free(workers[i].buffer);
+    }
+
+    int fanIn = memory / MIN_MERGE_BUFFER_SIZE - 1;
+    if (fanIn > MAX_FAN_IN)
+        fanIn = MAX_FAN_IN;
+    if (fanIn < 2)
+        fanIn = 2;
+    int runsNumber = runs.runsNumber;
+    int mergesNumber = 0;
+    while (status == EXIT_SUCCESS && runs.runsNumber > fanIn) {
+        if (mergeRuns(&runs, fanIn, memory, NULL) < 0) {
+            fprintf(stderr, "%s: %s: temporary file merge failed\n",
+                    argv[0], runs.directory);
+            status = EXIT_FAILURE;
+        }
+        mergesNumber++;
+    }
+
+    // The block is the write buffer of the output.
+    if (status == EXIT_SUCCESS) {
+        setvbuf(output, block, _IOFBF, BLOCK_SIZE);
+        if (mergeRuns(&runs, runs.runsNumber, memory, output) < 0 ||
+            fflush(output) != 0) {
+            fprintf(stderr, "%s: merge failed\n", argv[0]);
+            status = EXIT_FAILURE;
+        }
+    }
+
+    if (verbose || skipped > 0)
+        fprintf(stderr, "%s: %ld rounds sorted, %ld rounds skipped, "
+                "%d runs, %d intermediate merges\n",
+                argv[0], rounds, skipped, runsNumber, mergesNumber);
+
+    for (int i = 0; i < runs.runsNumber; i++) {
+        unlink(runs.names[i]);
+        free(runs.names[i]);
+    }
+    free(runs.names);
+    if (fclose(output) != 0) {
+        perror(outputName != NULL ? outputName : argv[0]);
+        status = EXIT_FAILURE;
+    }
+    free(block);
+
+    return status;
+}
@@ -0,0 +1,764 @@
+/**
+ * @file train.c
+ * @brief Trains a policy and value network on rounds written in notation,
+ *        like the rounds of cruceSimulate, and saves it in the format read
+ *        by network_readNetwork.
+ *
+ * The files of rounds, the shards, are mapped in memory and read again
+ * and again. Every thread reads the rounds whose index modulo the number
+ * of threads is its own, turns every card of them into an example, and
+ * keeps the examples in a pool from which they are drawn at random, so a
+ * minibatch does not come from a few rounds only. For every minibatch, the
+ * threads compute the gradients of their share of the examples, the first
+ * thread adds them up in the order of the threads and takes a step of
+ * Adam, and the threads start the next minibatch.
+ */
+
+#define _GNU_SOURCE
+
+#include <cruceGame.h>
+
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief The maximum number of training threads.
+ */
+#define MAX_THREADS 64
+
+/**
+ * @brief The number of examples in the pool of every thread.
+ */
+#define POOL_SIZE 1024
+
+/**
+ * @brief The number of steps between two reports of the loss.
+ */
+#define REPORT_STEPS 100
+
+/**
+ * @struct Shard
+ * @brief A file of rounds mapped in memory.
+ *
+ * @var Shard::text
+ *     The rounds.
+ * @var Shard::length
+ *     The length of the file.
+ */
+struct Shard {
+    const char *text;
+    size_t length;
+};
+
+/**
+ * @struct Stream
+ * @brief The examples of the rounds of a thread.
+ *
+ * @var Stream::shards
+ *     The shards.
+ * @var Stream::shardsNumber
+ *     The number of shards.
+ * @var Stream::shard
+ *     The shard being read.
+ * @var Stream::offset
+ *     The position of the next round in the shard.
+ * @var Stream::roundIndex
+ *     The index of the next round, counted over all the shards.
+ * @var Stream::thread
+ *     The rounds of the stream are the ones whose index modulo
+ *     Stream::threadsNumber is equal to it.
+ * @var Stream::threadsNumber
+ *     The number of threads.
+ * @var Stream::record
+ *     The round being read.
+ * @var Stream::cardsNumber
+ *     The number of cards of the round already read.
+ * @var Stream::passExamples
+ *     The number of examples read since the stream last went back to the
+ *     first shard.
+ */
+struct Stream {
+    const struct Shard *shards;
+    int shardsNumber;
+    int shard;
+    size_t offset;
+    long roundIndex;
+    int thread;
+    int threadsNumber;
+    struct RoundRecord record;
+    int cardsNumber;
+    long passExamples;
+};
+
+/**
+ * @struct Worker
+ * @brief A training thread.
+ *
+ * @var Worker::thread
+ *     The thread.
+ * @var Worker::index
+ *     The index of the worker.
+ * @var Worker::trainer
+ *     The trainer.
+ * @var Worker::stream
+ *     The examples of the worker.
+ * @var Worker::pool
+ *     The examples drawn from.
+ * @var Worker::poolNumber
+ *     The number of examples in the pool.
+ * @var Worker::random
+ *     The generator of the worker.
+ * @var Worker::gradients
+ *     The sum of the gradients of the share of the minibatch.
+ * @var Worker::loss
+ *     The sum of the losses of the share of the minibatch.
+ * @var Worker::error
+ *     \ref NO_ERROR, or the first error of the worker.
+ */
+struct Worker {
+    pthread_t thread;
+    int index;
+    struct Trainer *trainer;
+    struct Stream stream;
+    struct NetworkExample *pool;
+    int poolNumber;
+    uint64_t random;
+    float *gradients;
+    double loss;
+    int error;
+};
+
+/**
+ * @struct Trainer
+ * @brief The state shared by the training threads.
+ *
+ * @var Trainer::network
+ *     The network being trained.
+ * @var Trainer::moments
+ *     The moments of Adam.
+ * @var Trainer::workers
+ *     The workers.
+ * @var Trainer::threadsNumber
+ *     The number of workers.
+ * @var Trainer::batchSize
+ *     The number of examples of a minibatch.
+ * @var Trainer::stepsNumber
+ *     The number of minibatches.
+ * @var Trainer::rate
+ *     The learning rate.
+ * @var Trainer::startedNumber
+ *     The number of threads started, the first one included. The first
+ *     thread takes the shares of the others.
+ * @var Trainer::startLock
+ *     Held while the threads are started, so they wait for the barrier.
+ * @var Trainer::barrier
+ *     The started threads wait for one another at it, before and after the
+ *     update of the network.
+ * @var Trainer::error
+ *     \ref NO_ERROR, or the first error of a worker. It is only written by
+ *     the first thread while the others wait.
+ */
+struct Trainer {
+    struct Network *network;
+    float *moments;
+    struct Worker workers[MAX_THREADS];
+    int threadsNumber;
+    int batchSize;
+    long stepsNumber;
+    double rate;
+    int startedNumber;
+    pthread_mutex_t startLock;
+    pthread_barrier_t barrier;
+    int error;
+};
+
+/**
+ * @brief Maps a file in memory.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int mapShard(const char *name, struct Shard *shard)
+{
+    int file = open(name, O_RDONLY);
+    if (file < 0)
+        return NOT_FOUND;
+
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        close(file);
+        return NOT_FOUND;
+    }
+
+    shard->text = NULL;
+    shard->length = status.st_size;
+    if (shard->length > 0) {
+        void *text = mmap(NULL, shard->length, PROT_READ, MAP_PRIVATE, file,
+                          0);
+        if (text == MAP_FAILED) {
+            close(file);
+            return NOT_FOUND;
+        }
+        madvise(text, shard->length, MADV_SEQUENTIAL);
+        shard->text = text;
+    }
+    close(file);
+
+    return NO_ERROR;
+}
+
+static void unmapShard(struct Shard *shard)
+{
+    if (shard->text != NULL)
+        munmap((void *)shard->text, shard->length);
+    shard->text = NULL;
+}
+
+/**
+ * @brief Reads the next round of a shard, skipping the rounds which can
+ *        not be parsed.
+ *
+ * @return 1 if a round was read, 0 at the end of the shard.
+ */
+static int nextRound(const struct Shard *shard, size_t *offset,
+                     struct RoundRecord *record)
+{
+    while (*offset < shard->length) {
+        const char *text = shard->text + *offset;
+        size_t length = shard->length - *offset;
+        int consumed = notation_parseRound(record, text, length);
+        if (consumed > 0) {
+            *offset += consumed;
+            return 1;
+        }
+
+        size_t roundLength = notation_roundLength(text, length);
+        *offset += roundLength > 0 ? roundLength : length;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Turns a card of a round into an example.
+ *
+ * @param record The round.
+ * @param cardsNumber The number of cards put down before the card.
+ * @param example Where the example is stored.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int encodeCard(const struct RoundRecord *record, const int cardsNumber,
+                      struct NetworkExample *example)
+{
+    struct Game *game = replay_createGame(record, cardsNumber);
+    if (game == NULL)
+        return MALLOC_ERROR;
+
+    int handId, position;
+    int error = replay_findTurn(game, &handId, &position);
+    if (error == NO_ERROR) {
+        struct Hand *hand = game->round->hands[handId];
+        error = network_encodePosition(example->features, &example->allowed,
+                                       game, hand->players[position], hand);
+    }
+    replay_deleteGame(&game);
+    if (error != NO_ERROR)
+        return error;
+
+    int seat = (record->leaders[handId] + position) % record->playersNumber;
+    int points = 0;
+    for (int i = 0; i < record->playersNumber; i++)
+        points += record->pointsNumber[i];
+    example->card = record->cards[handId][position];
+    example->value = points > 0 ?
+                     (float)record->pointsNumber[seat] / points : 0;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Turns the next card of a stream into an example, going back to
+ *        the first shard after the last one.
+ *
+ * @return \ref NO_ERROR on success, \ref NOT_FOUND if the stream has no
+ *         examples.
+ */
+static int readExample(struct Stream *stream, struct NetworkExample *example)
+{
+    while (1) {
+        const struct RoundRecord *record = &stream->record;
+        if (stream->cardsNumber < record->handsNumber *
+                                  record->playersNumber) {
+            if (encodeCard(record, stream->cardsNumber++, example) ==
+                NO_ERROR) {
+                stream->passExamples++;
+                return NO_ERROR;
+            }
+            // The rest of a round which can not be replayed is skipped.
+            stream->cardsNumber = record->handsNumber *
+                                  record->playersNumber;
+            continue;
+        }
+
+        if (nextRound(&stream->shards[stream->shard], &stream->offset,
+                      &stream->record)) {
+            // The rounds of the other threads are skipped.
+            if (stream->roundIndex++ % stream->threadsNumber !=
+                stream->thread)
+                stream->record.handsNumber = 0;
+            stream->cardsNumber = 0;
+            continue;
+        }
+
+        stream->offset = 0;
+        if (++stream->shard < stream->shardsNumber)
+            continue;
+        stream->shard = 0;
+        if (stream->passExamples == 0)
+            return NOT_FOUND;
+        stream->passExamples = 0;
+    }
+}
+
+/**
+ * @brief Draws an example at random from the pool of a worker, and puts a
+ *        new one in its place.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int drawExample(struct Worker *worker, struct NetworkExample *example)
+{
+    while (worker->poolNumber < POOL_SIZE) {
+        int error = readExample(&worker->stream,
+                                &worker->pool[worker->poolNumber]);
+        if (error != NO_ERROR)
+            return error;
+        worker->poolNumber++;
+    }
+
+    int slot = simulation_random(&worker->random) % POOL_SIZE;
+    *example = worker->pool[slot];
+
+    return readExample(&worker->stream, &worker->pool[slot]);
+}
+
+/**
+ * @brief Adds up the gradients of the workers and updates the network.
+ *        Called by the first thread while the others wait.
+ */
+static void updateNetwork(struct Trainer *trainer, const long step)
+{
+    struct Network *network = trainer->network;
+    float *gradients = trainer->workers[0].gradients;
+    double loss = trainer->workers[0].loss;
+
+    for (int i = 0; i < trainer->threadsNumber; i++)
+        if (trainer->error == NO_ERROR)
+            trainer->error = trainer->workers[i].error;
+    if (trainer->error != NO_ERROR)
+        return;
+
+    for (int i = 1; i < trainer->threadsNumber; i++) {
+        const float *workerGradients = trainer->workers[i].gradients;
+        for (size_t j = 0; j < network->parametersNumber; j++)
+            gradients[j] += workerGradients[j];
+        loss += trainer->workers[i].loss;
+    }
+    for (size_t j = 0; j < network->parametersNumber; j++)
+        gradients[j] /= trainer->batchSize;
+
+    trainer->error = network_adamStep(network, gradients, trainer->moments,
+                                      step, trainer->rate);
+    if (step % REPORT_STEPS == 0 || step == trainer->stepsNumber)
+        fprintf(stderr, "step %ld loss %.6f\n", step,
+                loss / trainer->batchSize);
+}
+
+/**
+ * @brief Adds up the gradients of the share of a worker of a minibatch.
+ */
+static void addShare(struct Worker *worker)
+{
+    struct Trainer *trainer = worker->trainer;
+    size_t parametersNumber = trainer->network->parametersNumber;
+
+    int first = trainer->batchSize * worker->index / trainer->threadsNumber;
+    int end = trainer->batchSize * (worker->index + 1) /
+              trainer->threadsNumber;
+
+    memset(worker->gradients, 0, sizeof(float) * parametersNumber);
+    worker->loss = 0;
+    for (int i = first; i < end && worker->error == NO_ERROR; i++) {
+        struct NetworkExample example;
+        worker->error = drawExample(worker, &example);
+        if (worker->error != NO_ERROR)
+            break;
+        double loss = network_addGradients(trainer->network, &example,
+                                           worker->gradients);
+        if (loss < 0)
+            worker->error = (int)loss;
+        else
+            worker->loss += loss;
+    }
+}
+
+/**
+ * @brief Trains the network with a share of every minibatch. The first
+ *        thread also takes the shares of the workers whose threads could
+ *        not be started.
+ */
+static void *train(void *argument)
+{
+    struct Worker *worker = argument;
+    struct Trainer *trainer = worker->trainer;
+
+    // The barrier is set up once all the threads are started.
+    pthread_mutex_lock(&trainer->startLock);
+    pthread_mutex_unlock(&trainer->startLock);
+
+    for (long step = 1; step <= trainer->stepsNumber; step++) {
+        addShare(worker);
+        if (worker->index == 0)
+            for (int i = trainer->startedNumber; i < trainer->threadsNumber;
+                 i++)
+                addShare(&trainer->workers[i]);
+
+        pthread_barrier_wait(&trainer->barrier);
+        if (worker->index == 0)
+            updateNetwork(trainer, step);
+        pthread_barrier_wait(&trainer->barrier);
+        if (trainer->error != NO_ERROR)
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Trains a network with all the threads.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int trainNetwork(struct Trainer *trainer, const struct Shard *shards,
+                        const int shardsNumber, const uint64_t seed)
+{
+    size_t parametersNumber = trainer->network->parametersNumber;
+    int error = NO_ERROR;
+
+    trainer->moments = calloc(2 * parametersNumber, sizeof(float));
+    if (trainer->moments == NULL)
+        return MALLOC_ERROR;
+
+    int workersNumber = 0;
+    for (; workersNumber < trainer->threadsNumber; workersNumber++) {
+        struct Worker *worker = &trainer->workers[workersNumber];
+        memset(worker, 0, sizeof(struct Worker));
+        worker->index = workersNumber;
+        worker->trainer = trainer;
+        worker->stream.shards = shards;
+        worker->stream.shardsNumber = shardsNumber;
+        worker->stream.thread = workersNumber;
+        worker->stream.threadsNumber = trainer->threadsNumber;
+        worker->random = simulation_seed(seed, workersNumber);
+        worker->pool = malloc(sizeof(struct NetworkExample) * POOL_SIZE);
+        worker->gradients = malloc(sizeof(float) * parametersNumber);
+        if (worker->pool == NULL || worker->gradients == NULL) {
+            free(worker->pool);
+            free(worker->gradients);
+            error = MALLOC_ERROR;
+            break;
+        }
+    }
+
+    if (error == NO_ERROR) {
+        pthread_mutex_init(&trainer->startLock, NULL);
+        pthread_mutex_lock(&trainer->startLock);
+        int started = 1;
+        for (; started < trainer->threadsNumber; started++)
+            if (pthread_create(&trainer->workers[started].thread, NULL, train,
+                               &trainer->workers[started]) != 0)
+                break;
+        trainer->startedNumber = started;
+        pthread_barrier_init(&trainer->barrier, NULL, started);
+        pthread_mutex_unlock(&trainer->startLock);
+
+        train(&trainer->workers[0]);
+        for (int i = 1; i < started; i++)
+            pthread_join(trainer->workers[i].thread, NULL);
+        pthread_barrier_destroy(&trainer->barrier);
+        pthread_mutex_destroy(&trainer->startLock);
+        error = trainer->error;
+    }
+
+    for (int i = 0; i < workersNumber; i++) {
+        free(trainer->workers[i].pool);
+        free(trainer->workers[i].gradients);
+    }
+    free(trainer->moments);
+
+    return error;
+}
+
+/**
+ * @brief Evaluates a network on every card of the rounds of a shard and
+ *        prints the mean loss, the share of the cards the policy gives
+ *        the highest probability to, and the mean squared error of the
+ *        value.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int validate(const struct Network *network, const struct Shard *shard)
+{
+    float *gradients = calloc(network->parametersNumber, sizeof(float));
+    if (gradients == NULL)
+        return MALLOC_ERROR;
+
+    long examplesNumber = 0, bestNumber = 0;
+    double loss = 0, squaredErrors = 0;
+    size_t offset = 0;
+    struct RoundRecord record;
+    while (nextRound(shard, &offset, &record)) {
+        for (int i = 0; i < record.handsNumber * record.playersNumber; i++) {
+            struct NetworkExample example;
+            if (encodeCard(&record, i, &example) != NO_ERROR)
+                break;
+
+            float outputs[NETWORK_OUTPUTS];
+            network_evaluate(network, example.features, example.allowed,
+                             outputs);
+            int best = example.card;
+            for (int j = 0; j < DECK_SIZE; j++)
+                if (outputs[j] > outputs[best])
+                    best = j;
+            double error = outputs[DECK_SIZE] - example.value;
+
+            examplesNumber++;
+            bestNumber += best == example.card;
+            squaredErrors += error * error;
+            loss += network_addGradients(network, &example, gradients);
+        }
+    }
+    free(gradients);
+
+    if (examplesNumber == 0)
+        return NOT_FOUND;
+
+    printf("examples %ld\n", examplesNumber);
+    printf("loss %.6f\n", loss / examplesNumber);
+    printf("policy accuracy %.6f\n", (double)bestNumber / examplesNumber);
+    printf("value error %.6f\n", squaredErrors / examplesNumber);
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Saves a network in a file.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int saveNetwork(const struct Network *network, const char *name)
+{
+    size_t size = network_savedSize(network);
+    unsigned char *buffer = malloc(size);
+    if (buffer == NULL)
+        return MALLOC_ERROR;
+
+    long length = network_writeNetwork(network, buffer, size);
+    FILE *file = length > 0 ? fopen(name, "wb") : NULL;
+    int error = file == NULL ||
+                fwrite(buffer, 1, length, file) != (size_t)length ? FULL :
+                NO_ERROR;
+    if (file != NULL && fclose(file) != 0)
+        error = FULL;
+    free(buffer);
+
+    return error;
+}
+
+/**
+ * @brief Parses the sizes of the hidden layers, separated by commas.
+ *
+ * @return The number of hidden layers, -1 if the text is not valid.
+ */
+static int parseLayers(const char *text, int sizes[NETWORK_MAX_LAYERS])
+{
+    int layersNumber = 0;
+    while (*text != '\0') {
+        char *end;
+        long size = strtol(text, &end, 10);
+        if (end == text || size < 1 || size > NETWORK_MAX_WIDTH ||
+            layersNumber == NETWORK_MAX_LAYERS - 1 ||
+            (*end != ',' && *end != '\0'))
+            return -1;
+        sizes[layersNumber++] = size;
+        text = *end == ',' ? end + 1 : end;
+    }
+
+    return layersNumber;
+}
+
+/**
+ * @brief Prints the usage of the program.
+ */
+static void printUsage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [OPTION]... FILE...\n"
+            "Trains a policy and value network on the rounds of the files, "
+            "written in\nnotation, and saves it.\n\n"
+            "  -o, --output=FILE     save the network to FILE\n"
+            "  -i, --input=FILE      start from the network saved in FILE\n"
+            "  -l, --layers=N,...    sizes of the hidden layers (default "
+            "128,64)\n"
+            "  -b, --batch=N         examples of a minibatch (default 256)\n"
+            "  -n, --steps=N         number of minibatches (default 1000)\n"
+            "  -r, --rate=X          learning rate (default 0.001)\n"
+            "  -s, --seed=N          the seed (default 1)\n"
+            "  -j, --threads=N       number of training threads (1 - %d)\n"
+            "  -v, --validate=FILE   evaluate the network on the rounds of "
+            "FILE\n"
+            "  -h, --help            print this help\n",
+            name, MAX_THREADS);
+}
+
+int main(int argc, char *argv[])
+{
+    static struct Trainer trainer;
+    int hiddenSizes[NETWORK_MAX_LAYERS] = {128, 64};
+    int hiddenNumber = 2;
+    uint64_t seed = 1;
+    const char *outputName = NULL;
+    const char *inputName = NULL;
+    const char *validateName = NULL;
+    struct option longOptions[] = {
+        {"output", required_argument, 0, 'o'},
+        {"input", required_argument, 0, 'i'},
+        {"layers", required_argument, 0, 'l'},
+        {"batch", required_argument, 0, 'b'},
+        {"steps", required_argument, 0, 'n'},
+        {"rate", required_argument, 0, 'r'},
+        {"seed", required_argument, 0, 's'},
+        {"threads", required_argument, 0, 'j'},
+        {"validate", required_argument, 0, 'v'},
+        {"help", no_argument, 0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    trainer.threadsNumber = 1;
+    trainer.batchSize = 256;
+    trainer.stepsNumber = 1000;
+    trainer.rate = 1e-3;
+
+    int option;
+    while ((option = getopt_long(argc, argv, "o:i:l:b:n:r:s:j:v:h",
+                                 longOptions, NULL)) != -1) {
+        switch (option) {
+        case 'o':
+            outputName = optarg;
+            break;
+        case 'i':
+            inputName = optarg;
+            break;
+        case 'l':
+            hiddenNumber = parseLayers(optarg, hiddenSizes);
+            break;
+        case 'b':
+            trainer.batchSize = atoi(optarg);
+            break;
+        case 'n':
+            trainer.stepsNumber = atol(optarg);
+            break;
+        case 'r':
+            trainer.rate = atof(optarg);
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'j':
+            trainer.threadsNumber = atoi(optarg);
+            break;
+        case 'v':
+            validateName = optarg;
+            break;
+        case 'h':
+            printUsage(argv[0]);
+            return EXIT_SUCCESS;
+        default:
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (outputName == NULL || optind == argc || hiddenNumber < 0 ||
+        trainer.threadsNumber < 1 || trainer.threadsNumber > MAX_THREADS ||
+        trainer.batchSize < trainer.threadsNumber ||
+        trainer.stepsNumber < 0 || !(trainer.rate > 0)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (inputName != NULL) {
+        struct Shard saved;
+        if (mapShard(inputName, &saved) != NO_ERROR) {
+            perror(inputName);
+            return EXIT_FAILURE;
+        }
+        trainer.network = network_readNetwork((const void *)saved.text,
+                                              saved.length);
+        unmapShard(&saved);
+    } else {
+        trainer.network = network_createNetwork(hiddenSizes, hiddenNumber,
+                                                seed);
+    }
+    if (trainer.network == NULL) {
+        fprintf(stderr, "%s: the network can not be %s\n", argv[0],
+                inputName != NULL ? "read" : "created");
+        return EXIT_FAILURE;
+    }
+
+    int shardsNumber = argc - optind;
+    struct Shard *shards = calloc(shardsNumber, sizeof(struct Shard));
+    int status = shards != NULL ? EXIT_SUCCESS : EXIT_FAILURE;
+    for (int i = 0; status == EXIT_SUCCESS && i < shardsNumber; i++)
+        if (mapShard(argv[optind + i], &shards[i]) != NO_ERROR) {
+            perror(argv[optind + i]);
+            status = EXIT_FAILURE;
+        }
+
+    if (status == EXIT_SUCCESS) {
+        int error = trainNetwork(&trainer, shards, shardsNumber, seed);
+        if (error == NO_ERROR)
+            error = saveNetwork(trainer.network, outputName);
+        if (error != NO_ERROR) {
+            fprintf(stderr, "%s: the training failed (%d)\n", argv[0], error);
+            status = EXIT_FAILURE;
+        }
+    }
+
+    if (status == EXIT_SUCCESS && validateName != NULL) {
+        struct Shard shard;
+        int error = mapShard(validateName, &shard);
+        if (error == NO_ERROR) {
+            error = validate(trainer.network, &shard);
+            unmapShard(&shard);
+        }
+        if (error != NO_ERROR) {
+            fprintf(stderr, "%s: %s: no round can be evaluated\n", argv[0],
+                    validateName);
+            status = EXIT_FAILURE;
+        }
+    }
+
+    for (int i = 0; shards != NULL && i < shardsNumber; i++)
+        unmapShard(&shards[i]);
+    free(shards);
+    network_deleteNetwork(&trainer.network);
+
+    return status;
+}
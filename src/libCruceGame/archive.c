@@ -0,0 +1,312 @@
+/**
+ * @file archive.c
+ * @brief Contains implementations of the functions used to sort archives
+ *        of recorded rounds which do not fit in memory.
+ */
+
+#include "archive.h"
+#include "errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The size of an entry, as it is written without packing.
+ */
+#define ENTRY_SIZE sizeof(struct ArchiveEntry)
+
+/**
+ * @brief The maximum number of bytes counted by one byte of a packed entry.
+ */
+#define MAX_COUNT 255
+
+int archive_makeEntries(const struct RoundRecord *record,
+                        const enum ArchiveKey key, const uint64_t position,
+                        struct ArchiveEntry *entries)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (entries == NULL)
+        return POINTER_NULL;
+    int playersNumber = record->playersNumber;
+    if (playersNumber < 2 || playersNumber > MAX_GAME_PLAYERS ||
+        key < 0 || key >= ArchiveKeyEnd)
+        return ILLEGAL_VALUE;
+
+    if (key == ARCHIVE_PLAYER) {
+        memset(entries, 0, sizeof(struct ArchiveEntry) * playersNumber);
+        for (int i = 0; i < playersNumber; i++) {
+            strncpy((char *)entries[i].key, record->names[i],
+                    RECORD_NAME_LENGTH);
+            entries[i].sequence = position * MAX_GAME_PLAYERS + i;
+            memcpy(&entries[i].record, record, sizeof(struct RoundRecord));
+        }
+        return playersNumber;
+    }
+
+    memset(entries, 0, sizeof(struct ArchiveEntry));
+    unsigned char *bytes = entries->key;
+    int handSize = DECK_SIZE / playersNumber < MAX_CARDS ?
+                   DECK_SIZE / playersNumber : MAX_CARDS;
+    int length = 0;
+    bytes[length++] = playersNumber;
+    for (int i = 0; i < playersNumber; i++) {
+        int first = length;
+        for (int j = i; j < handSize * playersNumber; j += playersNumber) {
+            if (record->deck[j] >= DECK_SIZE)
+                return ILLEGAL_VALUE;
+            int k = length++;
+            for (; k > first && bytes[k - 1] > record->deck[j]; k--)
+                bytes[k] = bytes[k - 1];
+            bytes[k] = record->deck[j];
+        }
+    }
+    for (int i = handSize * playersNumber; i < DECK_SIZE; i++) {
+        if (record->deck[i] >= DECK_SIZE)
+            return ILLEGAL_VALUE;
+        bytes[length++] = record->deck[i];
+    }
+    entries->sequence = position * MAX_GAME_PLAYERS;
+    memcpy(&entries->record, record, sizeof(struct RoundRecord));
+
+    return 1;
+}
+
+int archive_compareEntries(const struct ArchiveEntry *first,
+                           const struct ArchiveEntry *second)
+{
+    int result = memcmp(first->key, second->key, ARCHIVE_KEY_LENGTH);
+    if (result != 0)
+        return result;
+
+    return (first->sequence > second->sequence) -
+           (first->sequence < second->sequence);
+}
+
+int archive_initWriter(struct ArchiveWriter *writer, FILE *file,
+                       const int packed)
+{
+    if (writer == NULL || file == NULL)
+        return POINTER_NULL;
+
+    writer->file = file;
+    writer->packed = packed != 0;
+    memset(&writer->previous, 0, sizeof(struct ArchiveEntry));
+    writer->entriesNumber = 0;
+
+    return NO_ERROR;
+}
+
+int archive_writeEntry(struct ArchiveWriter *writer,
+                       const struct ArchiveEntry *entry)
+{
+    if (writer == NULL || entry == NULL)
+        return POINTER_NULL;
+
+    if (!writer->packed) {
+        if (fwrite(entry, ENTRY_SIZE, 1, writer->file) != 1)
+            return FULL;
+        writer->entriesNumber++;
+        return NO_ERROR;
+    }
+
+    // The entry is written as pairs of counts, of zero bytes and of bytes
+    // which follow them as they are, which always cover the whole entry.
+    unsigned char difference[ENTRY_SIZE];
+    unsigned char packed[2 * ENTRY_SIZE];
+    const unsigned char *bytes = (const unsigned char *)entry;
+    unsigned char *previous = (unsigned char *)&writer->previous;
+    for (size_t i = 0; i < ENTRY_SIZE; i++)
+        difference[i] = bytes[i] ^ previous[i];
+
+    size_t length = 0;
+    size_t position = 0;
+    while (position < ENTRY_SIZE) {
+        size_t zeros = 0;
+        while (position + zeros < ENTRY_SIZE && zeros < MAX_COUNT &&
+               difference[position + zeros] == 0)
+            zeros++;
+        position += zeros;
+
+        // A single zero byte between others is cheaper kept as it is.
+        size_t literals = 0;
+        while (position + literals < ENTRY_SIZE && literals < MAX_COUNT &&
+               (difference[position + literals] != 0 ||
+                (position + literals + 1 < ENTRY_SIZE &&
+                 difference[position + literals + 1] != 0)))
+            literals++;
+
+        packed[length++] = zeros;
+        packed[length++] = literals;
+        memcpy(packed + length, difference + position, literals);
+        length += literals;
+        position += literals;
+    }
+
+    if (fwrite(packed, 1, length, writer->file) != length)
+        return FULL;
+    memcpy(previous, bytes, ENTRY_SIZE);
+    writer->entriesNumber++;
+
+    return NO_ERROR;
+}
+
+int archive_initReader(struct ArchiveReader *reader, FILE *file,
+                       const int packed)
+{
+    if (reader == NULL || file == NULL)
+        return POINTER_NULL;
+
+    reader->file = file;
+    reader->packed = packed != 0;
+    memset(&reader->previous, 0, sizeof(struct ArchiveEntry));
+
+    return NO_ERROR;
+}
+
+int archive_readEntry(struct ArchiveReader *reader,
+                      struct ArchiveEntry *entry)
+{
+    if (reader == NULL || entry == NULL)
+        return POINTER_NULL;
+
+    if (!reader->packed) {
+        size_t read = fread(entry, 1, ENTRY_SIZE, reader->file);
+        if (read == ENTRY_SIZE)
+            return 1;
+        if (ferror(reader->file))
+            return NOT_FOUND;
+        return read == 0 ? 0 : SYNTAX_ERROR;
+    }
+
+    unsigned char *bytes = (unsigned char *)&reader->previous;
+    size_t position = 0;
+    while (position < ENTRY_SIZE) {
+        unsigned char counts[2];
+        size_t read = fread(counts, 1, 2, reader->file);
+        if (read != 2) {
+            if (ferror(reader->file))
+                return NOT_FOUND;
+            return read == 0 && position == 0 ? 0 : SYNTAX_ERROR;
+        }
+        if (position + counts[0] + counts[1] > ENTRY_SIZE)
+            return SYNTAX_ERROR;
+        position += counts[0];
+
+        unsigned char literals[MAX_COUNT];
+        if (fread(literals, 1, counts[1], reader->file) != counts[1])
+            return ferror(reader->file) ? NOT_FOUND : SYNTAX_ERROR;
+        for (int i = 0; i < counts[1]; i++)
+            bytes[position + i] ^= literals[i];
+        position += counts[1];
+    }
+    memcpy(entry, bytes, ENTRY_SIZE);
+
+    return 1;
+}
+
+/**
+ * @brief Moves a run down the heap of a merger until its next entry is not
+ *        greater than the next entries of the runs below it.
+ */
+static void siftDown(struct ArchiveMerger *merger, int position)
+{
+    int *heap = merger->heap;
+    int run = heap[position];
+
+    while (1) {
+        int child = 2 * position + 1;
+        if (child >= merger->heapSize)
+            break;
+        if (child + 1 < merger->heapSize &&
+            archive_compareEntries(&merger->heads[heap[child + 1]],
+                                   &merger->heads[heap[child]]) < 0)
+            child++;
+        if (archive_compareEntries(&merger->heads[heap[child]],
+                                   &merger->heads[run]) >= 0)
+            break;
+        heap[position] = heap[child];
+        position = child;
+    }
+    heap[position] = run;
+}
+
+struct ArchiveMerger *archive_createMerger(FILE **files, const int runsNumber,
+                                           const int packed)
+{
+    if (files == NULL || runsNumber < 0)
+        return NULL;
+
+    struct ArchiveMerger *merger = malloc(sizeof(struct ArchiveMerger));
+    if (merger == NULL)
+        return NULL;
+
+    int size = runsNumber > 0 ? runsNumber : 1;
+    merger->readers = malloc(sizeof(struct ArchiveReader) * size);
+    merger->heads = malloc(sizeof(struct ArchiveEntry) * size);
+    merger->heap = malloc(sizeof(int) * size);
+    merger->heapSize = 0;
+    merger->runsNumber = runsNumber;
+    if (merger->readers == NULL || merger->heads == NULL ||
+        merger->heap == NULL) {
+        archive_deleteMerger(&merger);
+        return NULL;
+    }
+
+    for (int i = 0; i < runsNumber; i++) {
+        int read = archive_initReader(&merger->readers[i], files[i], packed);
+        if (read == NO_ERROR)
+            read = archive_readEntry(&merger->readers[i],
+                                     &merger->heads[i]);
+        if (read < 0) {
+            archive_deleteMerger(&merger);
+            return NULL;
+        }
+        if (read == 1)
+            merger->heap[merger->heapSize++] = i;
+    }
+    for (int i = merger->heapSize / 2 - 1; i >= 0; i--)
+        siftDown(merger, i);
+
+    return merger;
+}
+
+int archive_deleteMerger(struct ArchiveMerger **merger)
+{
+    if (merger == NULL)
+        return POINTER_NULL;
+    if (*merger == NULL)
+        return MERGER_NULL;
+
+    free((*merger)->readers);
+    free((*merger)->heads);
+    free((*merger)->heap);
+    free(*merger);
+    *merger = NULL;
+
+    return NO_ERROR;
+}
+
+int archive_mergeEntry(struct ArchiveMerger *merger,
+                       struct ArchiveEntry *entry)
+{
+    if (merger == NULL)
+        return MERGER_NULL;
+    if (entry == NULL)
+        return POINTER_NULL;
+    if (merger->heapSize == 0)
+        return 0;
+
+    int run = merger->heap[0];
+    memcpy(entry, &merger->heads[run], ENTRY_SIZE);
+
+    int read = archive_readEntry(&merger->readers[run], &merger->heads[run]);
+    if (read < 0)
+        return read;
+    if (read == 0)
+        merger->heap[0] = merger->heap[--merger->heapSize];
+    if (merger->heapSize > 0)
+        siftDown(merger, 0);
+
+    return 1;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file archive.h
+ * @brief ArchiveEntry, ArchiveWriter, ArchiveReader and ArchiveMerger
+ *        structures, as well as the functions used to sort archives of
+ *        recorded rounds which do not fit in memory.
+ *
+ * Every round of an archive becomes one or more fixed size entries, with a
+ * key in front, compared with memcmp, and the position of the round in the
+ * archive, which keeps rounds with the same key in the order they were
+ * read. The entries are sorted in memory in parts, every part is written
+ * to a run file, then the runs are merged. The entries of a run can be
+ * written packed: every entry is XORed with the one before it, which
+ * shares most of its key and often the names of the players, and the
+ * zero bytes of the result are written as counts.
+ */
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "platform.h"
+#include "record.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief The length of the key of an entry.
+ */
+#define ARCHIVE_KEY_LENGTH 32
+
+/**
+ * @brief The keys by which an archive can be sorted.
+ */
+enum ArchiveKey {
+    ARCHIVE_PLAYER = 0, //!< One entry for every seat, keyed by its name.
+    ARCHIVE_DEAL,       //!< The number of players, the cards of every seat
+                        //!< from the smallest id, then the cards left in
+                        //!< the deck, in order.
+    ArchiveKeyEnd
+};
+
+/**
+ * @struct ArchiveEntry
+ * @brief A round with its key.
+ *
+ * @var ArchiveEntry::key
+ *     The key of the round, padded with zeros.
+ * @var ArchiveEntry::sequence
+ *     The position of the round in the archive, times MAX_GAME_PLAYERS,
+ *     plus the seat the entry is for.
+ * @var ArchiveEntry::record
+ *     The round.
+ */
+struct ArchiveEntry {
+    unsigned char key[ARCHIVE_KEY_LENGTH];
+    uint64_t sequence;
+    struct RoundRecord record;
+};
+
+/**
+ * @struct ArchiveWriter
+ * @brief State of a writer of entries to a run file.
+ *
+ * @var ArchiveWriter::file
+ *     The file where entries are written.
+ * @var ArchiveWriter::packed
+ *     1 if the entries are packed, 0 if they are written as they are.
+ * @var ArchiveWriter::previous
+ *     The last entry written, which the next one is packed against.
+ * @var ArchiveWriter::entriesNumber
+ *     The number of entries written.
+ */
+struct ArchiveWriter {
+    FILE *file;
+    int packed;
+    struct ArchiveEntry previous;
+    long entriesNumber;
+};
+
+/**
+ * @struct ArchiveReader
+ * @brief State of a reader of entries from a run file.
+ *
+ * @var ArchiveReader::file
+ *     The file from where entries are read.
+ * @var ArchiveReader::packed
+ *     1 if the entries are packed, 0 if they are written as they are.
+ * @var ArchiveReader::previous
+ *     The last entry read, which the next one is unpacked against.
+ */
+struct ArchiveReader {
+    FILE *file;
+    int packed;
+    struct ArchiveEntry previous;
+};
+
+/**
+ * @struct ArchiveMerger
+ * @brief State of a k-way merge of sorted run files.
+ *
+ * @var ArchiveMerger::readers
+ *     The reader of every run.
+ * @var ArchiveMerger::heads
+ *     The next entry of every run.
+ * @var ArchiveMerger::heap
+ *     Binary heap of the indexes of the runs which are not finished, with
+ *     the run of the smallest next entry on top.
+ * @var ArchiveMerger::heapSize
+ *     The number of runs in the heap.
+ * @var ArchiveMerger::runsNumber
+ *     The number of runs.
+ */
+struct ArchiveMerger {
+    struct ArchiveReader *readers;
+    struct ArchiveEntry *heads;
+    int *heap;
+    int heapSize;
+    int runsNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Makes the entries of a round.
+ *
+ * @param record The round.
+ * @param key The key by which the archive is sorted.
+ * @param position The position of the round in the archive.
+ * @param entries Where the entries are stored, MAX_GAME_PLAYERS at most.
+ *
+ * @return The number of entries on success, negative value on failure.
+ */
+EXPORT int archive_makeEntries(const struct RoundRecord *record,
+                               const enum ArchiveKey key,
+                               const uint64_t position,
+                               struct ArchiveEntry *entries);
+
+/**
+ * @brief Compares two entries by key, then by sequence.
+ *
+ * @param first The first entry.
+ * @param second The second entry.
+ *
+ * @return A negative value, 0 or a positive value if the first entry is
+ *         smaller, equal or greater.
+ */
+EXPORT int archive_compareEntries(const struct ArchiveEntry *first,
+                                  const struct ArchiveEntry *second);
+
+/**
+ * @brief Initializes a writer.
+ *
+ * @param writer The writer.
+ * @param file The file where entries are written. Its buffer is set by the
+ *             caller, with setvbuf, to write in large blocks.
+ * @param packed 1 to pack the entries, 0 to write them as they are.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int archive_initWriter(struct ArchiveWriter *writer, FILE *file,
+                              const int packed);
+
+/**
+ * @brief Writes an entry.
+ *
+ * @param writer The writer.
+ * @param entry The entry.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int archive_writeEntry(struct ArchiveWriter *writer,
+                              const struct ArchiveEntry *entry);
+
+/**
+ * @brief Initializes a reader.
+ *
+ * @param reader The reader.
+ * @param file The file from where entries are read, from the start of the
+ *             entries.
+ * @param packed 1 if the entries are packed, 0 if they are not.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int archive_initReader(struct ArchiveReader *reader, FILE *file,
+                              const int packed);
+
+/**
+ * @brief Reads the next entry.
+ *
+ * @param reader The reader.
+ * @param entry Where the entry is stored.
+ *
+ * @return 1 if an entry was read, 0 at the end of the file, negative value
+ *         on failure.
+ */
+EXPORT int archive_readEntry(struct ArchiveReader *reader,
+                             struct ArchiveEntry *entry);
+
+/**
+ * @brief Allocates a merger of sorted run files and reads the first entry
+ *        of every run.
+ *
+ * @param files The run files, from the start of the entries.
+ * @param runsNumber The number of runs.
+ * @param packed 1 if the entries are packed, 0 if they are not.
+ *
+ * @return Pointer to the new merger on success or NULL on failure.
+ */
+EXPORT struct ArchiveMerger *archive_createMerger(FILE **files,
+                                                  const int runsNumber,
+                                                  const int packed);
+
+/**
+ * @brief Frees the memory of a merger and sets the pointer to NULL. The
+ *        files are not closed.
+ *
+ * @param merger Pointer to the pointer to the merger.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int archive_deleteMerger(struct ArchiveMerger **merger);
+
+/**
+ * @brief Takes the smallest entry of all the runs.
+ *
+ * @param merger The merger.
+ * @param entry Where the entry is stored.
+ *
+ * @return 1 if an entry was taken, 0 when all the runs are finished,
+ *         negative value on failure.
+ */
+EXPORT int archive_mergeEntry(struct ArchiveMerger *merger,
+                              struct ArchiveEntry *entry);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,211 @@
+/**
+ * @file budget.c
+ * @brief Contains implementations of the functions used to share the
+ *        thinking time of a bot between its decisions.
+ */
+
+#include "budget.h"
+#include "deck.h"
+#include "errors.h"
+
+#include <stdlib.h>
+
+/**
+ * @brief The largest bid.
+ */
+#define MAX_BID 6
+
+/**
+ * @brief log2 of the numbers of choices of a decision.
+ */
+static const double LOG2[MAX_CARDS + 2] = {0, 0, 1, 1.5849625007,
+                                           2, 2.3219280949, 2.5849625007,
+                                           2.8073549221, 3, 3.1699250014};
+
+/**
+ * @brief Helper to find the highest score of a team, at least 0.
+ */
+static int maxScore(const struct Game *game)
+{
+    int score = 0;
+    for (int i = 0; i < MAX_GAME_TEAMS; i++)
+        if (game->teams[i] != NULL && game->teams[i]->score > score)
+            score = game->teams[i]->score;
+
+    return score;
+}
+
+/**
+ * @brief Helper to count the bids a player may place (see round_placeBid).
+ */
+static int countBids(const struct Round *round)
+{
+    int maxBid = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (round->players[i] != NULL && round->bids[i] > maxBid)
+            maxBid = round->bids[i];
+
+    return maxBid == 0 ? MAX_BID + 1 : MAX_BID - maxBid + 2;
+}
+
+/**
+ * @brief Helper to count the cards a player may put down in a hand.
+ */
+static int countCards(const struct Game *game, struct Player *player,
+                      struct Hand *hand)
+{
+    int cardsNumber = 0;
+    for (int i = 0; i < MAX_CARDS; i++)
+        if (player->hand[i] != NULL &&
+            game_checkCard(player, game, hand, i) == 1)
+            cardsNumber++;
+
+    return cardsNumber;
+}
+
+struct Budget *budget_createBudget(const double gameTime)
+{
+    if (!(gameTime >= 0))
+        return NULL;
+
+    struct Budget *budget = malloc(sizeof(struct Budget));
+    if (budget == NULL)
+        return NULL;
+
+    budget->gameTime = gameTime;
+    budget->roundTime = 0;
+    budget->decisionsNumber = 0;
+    budget->forcedNumber = 0;
+    budget->overrunsNumber = 0;
+    budget->allocatedTime = 0;
+    budget->usedTime = 0;
+
+    return budget;
+}
+
+int budget_deleteBudget(struct Budget **budget)
+{
+    if (budget == NULL)
+        return POINTER_NULL;
+    if (*budget == NULL)
+        return BUDGET_NULL;
+
+    free(*budget);
+    *budget = NULL;
+
+    return NO_ERROR;
+}
+
+double budget_criticality(const struct Game *game)
+{
+    if (game == NULL)
+        return GAME_NULL;
+    if (game->pointsNumber <= 0)
+        return ILLEGAL_VALUE;
+
+    int score = maxScore(game);
+    if (score >= game->pointsNumber)
+        return 1;
+
+    return (double)score / game->pointsNumber;
+}
+
+int budget_startRound(struct Budget *budget, const struct Game *game)
+{
+    if (budget == NULL)
+        return BUDGET_NULL;
+
+    if (game == NULL)
+        return GAME_NULL;
+
+    int pointsLeft = game->pointsNumber - maxScore(game);
+    int roundsNumber = (pointsLeft + BUDGET_ROUND_POINTS - 1) /
+                       BUDGET_ROUND_POINTS;
+    if (roundsNumber < 1)
+        roundsNumber = 1;
+
+    budget->roundTime = budget->gameTime / roundsNumber;
+
+    return NO_ERROR;
+}
+
+double budget_allocate(struct Budget *budget, const struct Game *game,
+                       struct Player *player, struct Hand *hand)
+{
+    if (budget == NULL)
+        return BUDGET_NULL;
+    if (game == NULL)
+        return GAME_NULL;
+    if (player == NULL)
+        return PLAYER_NULL;
+    if (game->round == NULL)
+        return ROUND_NULL;
+
+    double criticality = budget_criticality(game);
+    if (criticality < 0)
+        return criticality;
+
+    int handSize = 0;
+    for (int i = 0; i < MAX_CARDS; i++)
+        if (player->hand[i] != NULL)
+            handSize++;
+
+    int playersNumber = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (game->round->players[i] != NULL)
+            playersNumber++;
+
+    // The cards left to put down, with the ones still in the deck.
+    int cardsNumber = handSize;
+    if (game->deck != NULL && playersNumber > 0)
+        cardsNumber += deck_cardsNumber(game->deck) / playersNumber;
+
+    int choices;
+    double weight;
+    if (hand == NULL) {
+        choices = countBids(game->round);
+        weight = BUDGET_BID_WEIGHT * (1 + criticality);
+    } else {
+        choices = countCards(game, player, hand);
+        weight = LOG2[choices];
+        cardsNumber--;
+    }
+
+    double futureWeight = 0;
+    for (int i = cardsNumber; i > 0; i--) {
+        int size = i < handSize ? i : handSize;
+        futureWeight += LOG2[size + 1] - 1;
+    }
+
+    budget->decisionsNumber++;
+    if (choices <= 1 || budget->roundTime <= 0) {
+        budget->forcedNumber += choices <= 1;
+        return 0;
+    }
+
+    double time = budget->roundTime * weight / (weight + futureWeight);
+    budget->allocatedTime += time;
+
+    return time;
+}
+
+int budget_spend(struct Budget *budget, const double allocated,
+                 const double used)
+{
+    if (budget == NULL)
+        return BUDGET_NULL;
+    if (!(allocated >= 0 && used >= 0))
+        return ILLEGAL_VALUE;
+
+    budget->usedTime += used;
+    budget->gameTime -= used;
+    budget->roundTime -= used;
+    if (budget->gameTime < 0)
+        budget->gameTime = 0;
+    if (budget->roundTime < 0)
+        budget->roundTime = 0;
+    if (used > allocated)
+        budget->overrunsNumber++;
+
+    return NO_ERROR;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file budget.h
+ * @brief Budget structure, which shares the thinking time of a bot between
+ *        the decisions of a game, as well as helper functions.
+ *
+ * The time of the game is shared between the rounds left, estimated from
+ * the scores, so a round near the end of a close game gets more of it. The
+ * time of a round is shared between the decisions left: a decision weighs
+ * log2 of the number of cards or bids allowed, a card played later is
+ * expected to have half of the cards of its hand allowed, and a bid weighs
+ * more the closer a team is to winning. A decision with a single choice,
+ * like the card of the last hand, is played at once. The time allocated and
+ * used is counted in the budget, for the host to report with its other
+ * metrics.
+ */
+
+#ifndef BUDGET_H
+#define BUDGET_H
+
+#include "platform.h"
+#include "game.h"
+
+/**
+ * @brief The number of points a team usually scores in a round, used to
+ *        estimate the number of rounds left in a game.
+ */
+#define BUDGET_ROUND_POINTS 3
+
+/**
+ * @brief The weight of a bid when no team is close to winning, the weight
+ *        of a card with 2 choices being 1.
+ */
+#define BUDGET_BID_WEIGHT 2.0
+
+/**
+ * @struct Budget
+ * @brief The thinking time of a bot for a game.
+ *
+ * @var Budget::gameTime
+ *     The time left for the game, in seconds.
+ * @var Budget::roundTime
+ *     The time left for the current round, in seconds.
+ * @var Budget::decisionsNumber
+ *     The number of decisions a time was allocated to.
+ * @var Budget::forcedNumber
+ *     The number of decisions with a single choice, played at once.
+ * @var Budget::overrunsNumber
+ *     The number of decisions which used more than their time.
+ * @var Budget::allocatedTime
+ *     The total time allocated to the decisions, in seconds.
+ * @var Budget::usedTime
+ *     The total time used by the decisions, in seconds.
+ */
+struct Budget {
+    double gameTime;
+    double roundTime;
+    long decisionsNumber;
+    long forcedNumber;
+    long overrunsNumber;
+    double allocatedTime;
+    double usedTime;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates and initializes a budget.
+ *
+ * @param gameTime The thinking time of the bot for the whole game, in
+ *                 seconds.
+ *
+ * @return Pointer to the new budget on success or NULL on failure.
+ */
+EXPORT struct Budget *budget_createBudget(const double gameTime);
+
+/**
+ * @brief Frees the memory of a budget.
+ *
+ * @param budget Pointer to the pointer to the budget.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int budget_deleteBudget(struct Budget **budget);
+
+/**
+ * @brief Gives its share of the time left for the game to a new round.
+ *        The time the previous round did not use goes back to the game.
+ *
+ * @param budget The budget.
+ * @param game The game, with the scores before the round.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int budget_startRound(struct Budget *budget, const struct Game *game);
+
+/**
+ * @brief Computes how close a team is to winning a game.
+ *
+ * @param game The game.
+ *
+ * @return The highest score of a team divided by the points of the game,
+ *         between 0 and 1, or a negative error code.
+ */
+EXPORT double budget_criticality(const struct Game *game);
+
+/**
+ * @brief Allocates its time to the next decision of a player.
+ *
+ * @param budget The budget.
+ * @param game The game.
+ * @param player The player who decides.
+ * @param hand The hand in which the player puts down a card, NULL if the
+ *             player bids.
+ *
+ * @return The time of the decision, in seconds, 0 if it has a single
+ *         choice, or a negative error code.
+ */
+EXPORT double budget_allocate(struct Budget *budget, const struct Game *game,
+                              struct Player *player, struct Hand *hand);
+
+/**
+ * @brief Counts the time a decision used, and takes it from the time left.
+ *
+ * @param budget The budget.
+ * @param allocated The time allocated to the decision, in seconds.
+ * @param used The time the decision used, in seconds.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int budget_spend(struct Budget *budget, const double allocated,
+                        const double used);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -21,6 +21,11 @@
  */
 #define DECK_SIZE 24
 
+/**
+ * @brief Number of cards of each suit.
+ */
+#define SUIT_SIZE 6
+
 /**
  * @brief Minimum number of swaps performed by deckShuffle.
  */
@@ -46,6 +51,12 @@
  */
 #define MAX_GAME_TEAMS 4
 
+/**
+ * @brief Size of a player name kept in a round record, including the
+ *        terminating null character. Longer names are truncated.
+ */
+#define RECORD_NAME_LENGTH 16
+
 /**
  * @brief Constants for suit.
  *
@@ -7,6 +7,25 @@
 #include "game.h"
 #include "errors.h"
 #include "constants.h"
+#include "record.h"
+#include "index.h"
+#include "notation.h"
+#include "export.h"
+#include "replay.h"
+#include "simulation.h"
+#include "snapshot.h"
+#include "variation.h"
+#include "hooks.h"
+#include "locations.h"
+#include "worlds.h"
+#include "budget.h"
+#include "opponents.h"
+#include "network.h"
+#include "sampling.h"
+#include "dealer.h"
+#include "repro.h"
+#include "archive.h"
+#include "dedup.h"
 
 #endif
 
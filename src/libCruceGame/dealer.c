@@ -0,0 +1,165 @@
+/**
+ * @file dealer.c
+ * @brief Contains implementations of the functions used to deal many
+ *        random rounds at once.
+ */
+
+#include "dealer.h"
+#include "simulation.h"
+#include "errors.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DEALER_SSE2
+#endif
+
+/**
+ * @brief Helper to deal a round in every lane.
+ *
+ * @param sizes The number of cards every holder gets.
+ */
+static void dealLanes(struct Dealer *dealer,
+                      const uint32_t sizes[DEALER_HOLDERS],
+                      struct DealMasks deals[DEALER_LANES])
+{
+#ifdef DEALER_SSE2
+    __m128i x = _mm_loadu_si128((const __m128i *)dealer->state[0]);
+    __m128i y = _mm_loadu_si128((const __m128i *)dealer->state[1]);
+    __m128i z = _mm_loadu_si128((const __m128i *)dealer->state[2]);
+    __m128i w = _mm_loadu_si128((const __m128i *)dealer->state[3]);
+    const __m128i oddWords = _mm_set_epi32(-1, 0, -1, 0);
+    const __m128i all = _mm_set1_epi32(-1);
+    __m128i left[DEALER_HOLDERS];
+    __m128i hands[DEALER_HOLDERS];
+    for (int i = 0; i < DEALER_HOLDERS; i++) {
+        left[i] = _mm_set1_epi32(sizes[i]);
+        hands[i] = _mm_setzero_si128();
+    }
+
+    for (int card = 0; card < DECK_SIZE; card++) {
+        __m128i t = _mm_xor_si128(x, _mm_slli_epi32(x, 11));
+        x = y;
+        y = z;
+        z = w;
+        w = _mm_xor_si128(_mm_xor_si128(w, _mm_srli_epi32(w, 19)),
+                          _mm_xor_si128(t, _mm_srli_epi32(t, 8)));
+
+        // The high words of w * cardsLeft: a number from 0 to cardsLeft - 1.
+        __m128i cardsLeft = _mm_set1_epi32(DECK_SIZE - card);
+        __m128i even = _mm_srli_epi64(_mm_mul_epu32(w, cardsLeft), 32);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(w, 32), cardsLeft);
+        __m128i chosen = _mm_or_si128(even, _mm_and_si128(odd, oddWords));
+
+        __m128i bit = _mm_set1_epi32(1u << card);
+        __m128i limit = _mm_setzero_si128();
+        __m128i before = _mm_setzero_si128();
+        for (int i = 0; i < DEALER_HOLDERS; i++) {
+            __m128i below = all;
+            if (i < DEALER_HOLDERS - 1) {
+                limit = _mm_add_epi32(limit, left[i]);
+                below = _mm_cmplt_epi32(chosen, limit);
+            }
+            __m128i holder = _mm_andnot_si128(before, below);
+            hands[i] = _mm_or_si128(hands[i], _mm_and_si128(holder, bit));
+            left[i] = _mm_add_epi32(left[i], holder);
+            before = below;
+        }
+    }
+
+    _mm_storeu_si128((__m128i *)dealer->state[0], x);
+    _mm_storeu_si128((__m128i *)dealer->state[1], y);
+    _mm_storeu_si128((__m128i *)dealer->state[2], z);
+    _mm_storeu_si128((__m128i *)dealer->state[3], w);
+    for (int i = 0; i < DEALER_HOLDERS; i++) {
+        uint32_t lanes[DEALER_LANES];
+        _mm_storeu_si128((__m128i *)lanes, hands[i]);
+        for (int lane = 0; lane < DEALER_LANES; lane++)
+            deals[lane].hands[i] = lanes[lane];
+    }
+#else
+    for (int lane = 0; lane < DEALER_LANES; lane++) {
+        uint32_t x = dealer->state[0][lane];
+        uint32_t y = dealer->state[1][lane];
+        uint32_t z = dealer->state[2][lane];
+        uint32_t w = dealer->state[3][lane];
+        uint32_t left[DEALER_HOLDERS];
+        memcpy(left, sizes, sizeof(left));
+        memset(&deals[lane], 0, sizeof(struct DealMasks));
+
+        for (int card = 0; card < DECK_SIZE; card++) {
+            uint32_t t = x ^ (x << 11);
+            x = y;
+            y = z;
+            z = w;
+            w = (w ^ (w >> 19)) ^ (t ^ (t >> 8));
+
+            uint32_t chosen = (uint32_t)(((uint64_t)w *
+                                          (DECK_SIZE - card)) >> 32);
+            int i = 0;
+            for (uint32_t limit = left[0]; chosen >= limit;
+                 limit += left[++i])
+                ;
+            deals[lane].hands[i] |= 1u << card;
+            left[i]--;
+        }
+
+        dealer->state[0][lane] = x;
+        dealer->state[1][lane] = y;
+        dealer->state[2][lane] = z;
+        dealer->state[3][lane] = w;
+    }
+#endif
+}
+
+int dealer_initDealer(struct Dealer *dealer, const uint64_t seed)
+{
+    if (dealer == NULL)
+        return DEALER_NULL;
+
+    uint64_t state = seed;
+    for (int lane = 0; lane < DEALER_LANES; lane++) {
+        uint64_t first = simulation_random(&state);
+        uint64_t second = simulation_random(&state);
+        dealer->state[0][lane] = (uint32_t)first;
+        dealer->state[1][lane] = (uint32_t)(first >> 32);
+        dealer->state[2][lane] = (uint32_t)second;
+        dealer->state[3][lane] = (uint32_t)(second >> 32);
+        if (first == 0 && second == 0)
+            dealer->state[3][lane] = 1;
+    }
+
+    return NO_ERROR;
+}
+
+int dealer_dealBatch(struct Dealer *dealer, const int playersNumber,
+                     struct DealMasks *deals, const long dealsNumber)
+{
+    if (dealer == NULL)
+        return DEALER_NULL;
+    if (deals == NULL)
+        return POINTER_NULL;
+    if (playersNumber < 2 || playersNumber > MAX_GAME_PLAYERS ||
+        dealsNumber < 0)
+        return ILLEGAL_VALUE;
+
+    int handSize = DECK_SIZE / playersNumber < MAX_CARDS ?
+                   DECK_SIZE / playersNumber : MAX_CARDS;
+    uint32_t sizes[DEALER_HOLDERS] = {0};
+    for (int i = 0; i < playersNumber; i++)
+        sizes[i] = handSize;
+    sizes[DEALER_HOLDERS - 1] = DECK_SIZE - handSize * playersNumber;
+
+    long dealt = 0;
+    for (; dealt + DEALER_LANES <= dealsNumber; dealt += DEALER_LANES)
+        dealLanes(dealer, sizes, deals + dealt);
+    if (dealt < dealsNumber) {
+        struct DealMasks last[DEALER_LANES];
+        dealLanes(dealer, sizes, last);
+        memcpy(deals + dealt, last,
+               sizeof(struct DealMasks) * (dealsNumber - dealt));
+    }
+
+    return NO_ERROR;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file dealer.h
+ * @brief Dealer structure and the functions used to deal many random rounds
+ *        at once, straight into bit masks of the cards of every seat.
+ *
+ * The dealer runs DEALER_LANES generators side by side (xorshift128, one
+ * per lane) and deals one round in every lane. Instead of shuffling a deck
+ * it gives the cards away in order: card id goes to a holder with a
+ * probability equal to the number of cards the holder still gets divided
+ * by the number of cards left, which makes every deal equally likely. All
+ * the lanes take the same steps, so with SSE2 a vector holds one value of
+ * every lane, and without it the lanes are dealt one after the other with
+ * the same results.
+ */
+
+#ifndef DEALER_H
+#define DEALER_H
+
+#include "platform.h"
+#include "constants.h"
+
+#include <stdint.h>
+
+/**
+ * @brief The number of rounds dealt side by side.
+ */
+#define DEALER_LANES 4
+
+/**
+ * @brief The number of holders of cards: every seat, then the cards which
+ *        are left in the deck after it is distributed.
+ */
+#define DEALER_HOLDERS (MAX_GAME_PLAYERS + 1)
+
+/**
+ * @struct Dealer
+ * @brief The generators of the lanes.
+ *
+ * @var Dealer::state
+ *     state[i][lane] is word i of the state of the generator of a lane.
+ */
+struct Dealer {
+    uint32_t state[4][DEALER_LANES];
+};
+
+/**
+ * @struct DealMasks
+ * @brief A dealt round.
+ *
+ * @var DealMasks::hands
+ *     For every seat, a bit mask with bit id set if the seat gets the card
+ *     id when the deck is distributed (see round_distributeDeck). The last
+ *     mask holds the cards left in the deck, which are drawn in random
+ *     order, and the masks of the seats without a player are 0.
+ */
+struct DealMasks {
+    uint32_t hands[DEALER_HOLDERS];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Seeds the generators of a dealer.
+ *
+ * @param dealer The dealer.
+ * @param seed The seed.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int dealer_initDealer(struct Dealer *dealer, const uint64_t seed);
+
+/**
+ * @brief Deals random rounds.
+ *
+ * @param dealer The dealer, whose generators are updated.
+ * @param playersNumber The number of players, 2 to 4.
+ * @param deals Where the rounds are stored.
+ * @param dealsNumber The number of rounds. The lanes of the last step
+ *                    which are not needed are dealt and dropped.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int dealer_dealBatch(struct Dealer *dealer, const int playersNumber,
+                            struct DealMasks *deals, const long dealsNumber);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
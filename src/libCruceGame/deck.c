@@ -177,4 +177,17 @@ int deck_cardsNumber(const struct Deck *deck)
     return cardsNumber;
 }
 
+int deck_cardId(const struct Card *card)
+{
+    if (card == NULL)
+        return CARD_NULL;
+    if (card->suit < 0 || card->suit >= SuitEnd)
+        return ILLEGAL_VALUE;
+
+    for (int i = 0; VALUES[i] != -1; i++)
+        if (card->value == VALUES[i])
+            return card->suit * SUIT_SIZE + i;
+
+    return ILLEGAL_VALUE;
+}
 
@@ -111,6 +111,19 @@ EXPORT int deck_compareCards(const struct Card *card1,const struct Card *card2,
  */
 EXPORT int deck_cardsNumber(const struct Deck *deck);
 
+/**
+ * @brief Computes the id of a card.
+ *
+ * The id is suit * \ref SUIT_SIZE + the index of the value in VALUES, so
+ * every card of the deck has an unique id between 0 and \ref DECK_SIZE - 1.
+ * A deck returned by deck_createDeck has the card with id i on position i.
+ *
+ * @param card The card.
+ *
+ * @return The id of the card on success, negative value on failure.
+ */
+EXPORT int deck_cardId(const struct Card *card);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,365 @@
+/**
+ * @file dedup.c
+ * @brief Contains implementations of the functions used to find the deals
+ *        seen before in a stream of rounds.
+ */
+
+#include "dedup.h"
+#include "errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DEDUP_PREFETCH
+#endif
+
+/**
+ * @brief The number of words of a block of the Bloom filter, one cache
+ *        line.
+ */
+#define BLOCK_WORDS 8
+
+/**
+ * @brief The number of deals of a batch whose memory is fetched together.
+ */
+#define BATCH_SIZE 16
+
+/**
+ * @brief The mask of the cards of a suit, in the mask of a holder.
+ */
+#define SUIT_MASK ((1u << SUIT_SIZE) - 1)
+
+/**
+ * @brief Helper to find the smallest power of 2 not smaller than a number.
+ */
+static uint64_t powerOfTwo(const uint64_t number)
+{
+    uint64_t power = 1;
+    while (power < number)
+        power *= 2;
+
+    return power;
+}
+
+struct Deduplicator *dedup_createDeduplicator(const long dealsNumber,
+                                              const long capacity)
+{
+    if (dealsNumber < 1 || capacity < 1)
+        return NULL;
+
+    struct Deduplicator *deduplicator = malloc(sizeof(struct Deduplicator));
+    if (deduplicator == NULL)
+        return NULL;
+
+    uint64_t bits = (uint64_t)dealsNumber * DEDUP_BLOOM_BITS;
+    deduplicator->blocksNumber = powerOfTwo((bits + 511) / 512);
+    deduplicator->size = powerOfTwo(capacity + capacity / 3 + 1);
+    deduplicator->capacity = capacity;
+    deduplicator->keptNumber = 0;
+    deduplicator->dealsNumber = 0;
+    deduplicator->duplicatesNumber = 0;
+    deduplicator->unverifiedNumber = 0;
+
+    // One more block is allocated to start the filter on a cache line.
+    deduplicator->bloomMemory = calloc((deduplicator->blocksNumber + 1) *
+                                       BLOCK_WORDS, sizeof(uint64_t));
+    deduplicator->slots = calloc(deduplicator->size,
+                                 sizeof(struct DedupSlot));
+    if (deduplicator->bloomMemory == NULL || deduplicator->slots == NULL) {
+        dedup_deleteDeduplicator(&deduplicator);
+        return NULL;
+    }
+    size_t offset = (uintptr_t)deduplicator->bloomMemory /
+                    sizeof(uint64_t) % BLOCK_WORDS;
+    deduplicator->bloom = deduplicator->bloomMemory +
+                          (BLOCK_WORDS - offset) % BLOCK_WORDS;
+
+    return deduplicator;
+}
+
+int dedup_deleteDeduplicator(struct Deduplicator **deduplicator)
+{
+    if (deduplicator == NULL)
+        return POINTER_NULL;
+    if (*deduplicator == NULL)
+        return DEDUPLICATOR_NULL;
+
+    free((*deduplicator)->bloomMemory);
+    free((*deduplicator)->slots);
+    free(*deduplicator);
+    *deduplicator = NULL;
+
+    return NO_ERROR;
+}
+
+int dedup_recordDeal(const struct RoundRecord *record, struct DealMasks *deal)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (deal == NULL)
+        return POINTER_NULL;
+    int playersNumber = record->playersNumber;
+    if (playersNumber < 2 || playersNumber > MAX_GAME_PLAYERS)
+        return ILLEGAL_VALUE;
+
+    int handSize = DECK_SIZE / playersNumber < MAX_CARDS ?
+                   DECK_SIZE / playersNumber : MAX_CARDS;
+    memset(deal, 0, sizeof(struct DealMasks));
+    for (int i = 0; i < DECK_SIZE; i++) {
+        if (record->deck[i] >= DECK_SIZE)
+            return ILLEGAL_VALUE;
+        int holder = i < handSize * playersNumber ? i % playersNumber
+                                                  : MAX_GAME_PLAYERS;
+        deal->hands[holder] |= 1u << record->deck[i];
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to put two numbers in order, without branches.
+ */
+static void sortPair(uint32_t *first, uint32_t *second)
+{
+    uint32_t smaller = *first < *second ? *first : *second;
+    uint32_t greater = *first < *second ? *second : *first;
+
+    *first = smaller;
+    *second = greater;
+}
+
+int dedup_canonicalDeal(const struct DealMasks *deal, const int trump,
+                        struct DealMasks *canonical)
+{
+    if (deal == NULL || canonical == NULL)
+        return POINTER_NULL;
+    if (trump < 0 || trump > SuitEnd)
+        return ILLEGAL_VALUE;
+
+    // The masks are compared from the first holder, and every mask from its
+    // last suit, so the smallest masks give the last suit to the suit whose
+    // cards have the smallest masks in the first holder, then in the next
+    // ones on ties. With the masks of a suit in all the holders put in one
+    // number, with the suit in the lowest bits, the suits only have to be
+    // sorted by these numbers. The trump is sorted after all the others,
+    // as no suit has all its cards in every holder.
+    uint32_t keys[SuitEnd] = {0};
+    for (int i = 0; i < DEALER_HOLDERS; i++) {
+        if (deal->hands[i] >> DECK_SIZE != 0)
+            return ILLEGAL_VALUE;
+        for (int j = 0; j < SuitEnd; j++)
+            keys[j] = keys[j] << SUIT_SIZE |
+                      (deal->hands[i] >> SUIT_SIZE * j & SUIT_MASK);
+    }
+    for (int i = 0; i < SuitEnd; i++)
+        keys[i] = i == trump ? UINT32_MAX : keys[i] << 2 | i;
+
+    sortPair(&keys[0], &keys[1]);
+    sortPair(&keys[2], &keys[3]);
+    sortPair(&keys[0], &keys[2]);
+    sortPair(&keys[1], &keys[3]);
+    sortPair(&keys[1], &keys[2]);
+
+    int names[SuitEnd];
+    for (int i = 0; i < SuitEnd; i++)
+        names[keys[i] == UINT32_MAX ? trump : keys[i] & 3] = SuitEnd - 1 - i;
+
+    struct DealMasks smallest;
+    for (int i = 0; i < DEALER_HOLDERS; i++) {
+        uint32_t mask = 0;
+        for (int j = 0; j < SuitEnd; j++)
+            mask |= (deal->hands[i] >> SUIT_SIZE * j & SUIT_MASK) <<
+                    SUIT_SIZE * names[j];
+        smallest.hands[i] = mask;
+    }
+    *canonical = smallest;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to hash a canonical deal. The hash is never 0.
+ */
+static uint64_t hashDeal(const struct DealMasks *deal)
+{
+    uint64_t hash = 0;
+    for (int i = 0; i < DEALER_HOLDERS; i++) {
+        hash = (hash + deal->hands[i]) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 32;
+    }
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 32;
+
+    return hash | (1ULL << 63);
+}
+
+/**
+ * @brief Helper to find the block of a hash in the Bloom filter.
+ */
+static uint64_t *bloomBlock(const struct Deduplicator *deduplicator,
+                            const uint64_t hash)
+{
+    return deduplicator->bloom + BLOCK_WORDS *
+           (hash >> 32 & (deduplicator->blocksNumber - 1));
+}
+
+/**
+ * @brief Helper to set the bits of a hash in the Bloom filter.
+ *
+ * @return 1 if all the bits were already set, 0 otherwise.
+ */
+static int setBloomBits(struct Deduplicator *deduplicator,
+                        const uint64_t hash)
+{
+    // The block is chosen by the high half of the hash, the bits in it by
+    // the low half.
+    uint64_t *block = bloomBlock(deduplicator, hash);
+    uint64_t bits = (hash & 0xFFFFFFFFULL) * 0x94D049BB133111EBULL;
+    int seen = 1;
+
+    for (int i = 0; i < DEDUP_HASHES; i++) {
+        int bit = bits & (BLOCK_WORDS * 64 - 1);
+        uint64_t mask = 1ULL << (bit & 63);
+        seen &= (block[bit >> 6] & mask) != 0;
+        block[bit >> 6] |= mask;
+        bits >>= 9;
+    }
+
+    return seen;
+}
+
+/**
+ * @brief Helper to find the slot of a deal in the hash table, or the empty
+ *        slot where it goes.
+ */
+static struct DedupSlot *findSlot(const struct Deduplicator *deduplicator,
+                                  const uint64_t hash,
+                                  const struct DealMasks *deal)
+{
+    uint64_t mask = deduplicator->size - 1;
+    uint64_t index = hash & mask;
+
+    while (deduplicator->slots[index].hash != 0) {
+        struct DedupSlot *slot = &deduplicator->slots[index];
+        if (slot->hash == hash &&
+            memcmp(&slot->deal, deal, sizeof(struct DealMasks)) == 0)
+            return slot;
+        index = (index + 1) & mask;
+    }
+
+    return &deduplicator->slots[index];
+}
+
+/**
+ * @brief Helper to add a canonical deal.
+ *
+ * @return 1 if the deal is new, 0 if it was seen before.
+ */
+static int addCanonical(struct Deduplicator *deduplicator,
+                        const uint64_t hash, const struct DealMasks *deal)
+{
+    int seen = setBloomBits(deduplicator, hash);
+    deduplicator->dealsNumber++;
+    if (!seen && deduplicator->keptNumber == deduplicator->capacity)
+        return 1;
+
+    struct DedupSlot *slot = findSlot(deduplicator, hash, deal);
+    if (slot->hash != 0) {
+        deduplicator->duplicatesNumber++;
+        return 0;
+    }
+
+    // Until the table is full every deal is kept, so a deal the table does
+    // not hold is new.
+    if (deduplicator->keptNumber == deduplicator->capacity) {
+        deduplicator->duplicatesNumber++;
+        deduplicator->unverifiedNumber++;
+        return 0;
+    }
+    slot->hash = hash;
+    slot->deal = *deal;
+    deduplicator->keptNumber++;
+
+    return 1;
+}
+
+int dedup_addDeal(struct Deduplicator *deduplicator,
+                  const struct DealMasks *deal, const int trump)
+{
+    if (deduplicator == NULL)
+        return DEDUPLICATOR_NULL;
+
+    struct DealMasks canonical;
+    int error = dedup_canonicalDeal(deal, trump, &canonical);
+    if (error != NO_ERROR)
+        return error;
+
+    return addCanonical(deduplicator, hashDeal(&canonical), &canonical);
+}
+
+int dedup_addDeals(struct Deduplicator *deduplicator,
+                   const struct DealMasks *deals, const int dealsNumber,
+                   const int trump, unsigned char *news)
+{
+    if (deduplicator == NULL)
+        return DEDUPLICATOR_NULL;
+    if (deals == NULL)
+        return POINTER_NULL;
+    if (dealsNumber < 0)
+        return ILLEGAL_VALUE;
+
+    // The deals of a batch are hashed first and the memory they need is
+    // fetched while the others are hashed, so the cache misses overlap.
+    struct DealMasks canonicals[BATCH_SIZE];
+    uint64_t hashes[BATCH_SIZE];
+    int newNumber = 0;
+    for (int i = 0; i < dealsNumber; i += BATCH_SIZE) {
+        int size = dealsNumber - i < BATCH_SIZE ? dealsNumber - i
+                                                : BATCH_SIZE;
+        for (int j = 0; j < size; j++) {
+            int error = dedup_canonicalDeal(&deals[i + j], trump,
+                                            &canonicals[j]);
+            if (error != NO_ERROR)
+                return error;
+            hashes[j] = hashDeal(&canonicals[j]);
+#ifdef DEDUP_PREFETCH
+            _mm_prefetch((const char *)bloomBlock(deduplicator, hashes[j]),
+                         _MM_HINT_T0);
+            _mm_prefetch((const char *)&deduplicator->slots[
+                             hashes[j] & (deduplicator->size - 1)],
+                         _MM_HINT_T0);
+#endif
+        }
+
+        for (int j = 0; j < size; j++) {
+            int added = addCanonical(deduplicator, hashes[j],
+                                     &canonicals[j]);
+            newNumber += added;
+            if (news != NULL)
+                news[i + j] = added;
+        }
+    }
+
+    return newNumber;
+}
+
+int dedup_addRound(struct Deduplicator *deduplicator,
+                   const struct RoundRecord *record)
+{
+    if (deduplicator == NULL)
+        return DEDUPLICATOR_NULL;
+    if (record == NULL)
+        return RECORD_NULL;
+    if (record->trump >= SuitEnd)
+        return ILLEGAL_VALUE;
+
+    struct DealMasks deal;
+    int error = dedup_recordDeal(record, &deal);
+    if (error != NO_ERROR)
+        return error;
+
+    return dedup_addDeal(deduplicator, &deal, record->trump);
+}
@@ -0,0 +1,194 @@
+/**
+ * @file dedup.h
+ * @brief Deduplicator structure, which finds the deals seen before in a
+ *        stream of rounds, as well as the functions used to feed it.
+ *
+ * Two deals are the same if one becomes the other when the suits are
+ * renamed, with the trump renamed like the other suits: the cards of every
+ * seat and the cards left in the deck are kept as the bit masks of a
+ * DealMasks, the suits are renamed in every way which makes the trump the
+ * first suit, and the smallest masks are the canonical deal. The order of
+ * the cards left in the deck is not part of the deal.
+ *
+ * The hash of the canonical deal is looked up in a Bloom filter whose bits
+ * are all in one cache line, sized for all the deals of the stream. A deal
+ * the filter has not seen is new, which is the common case. A deal it may
+ * have seen is looked up in an open addressing hash table holding the
+ * first deals of the stream, up to a fixed number, so the memory stays
+ * bounded. Once the table is full, a deal the filter may have seen and the
+ * table does not hold is counted as a duplicate which could not be
+ * verified.
+ */
+
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include "platform.h"
+#include "record.h"
+#include "dealer.h"
+
+#include <stdint.h>
+
+/**
+ * @brief The number of bits of the Bloom filter for every deal.
+ */
+#define DEDUP_BLOOM_BITS 16
+
+/**
+ * @brief The number of bits set in the Bloom filter for every deal.
+ */
+#define DEDUP_HASHES 7
+
+/**
+ * @struct DedupSlot
+ * @brief A slot of the hash table of a deduplicator.
+ *
+ * @var DedupSlot::hash
+ *     The hash of the deal. 0 marks an empty slot.
+ * @var DedupSlot::deal
+ *     The canonical deal.
+ */
+struct DedupSlot {
+    uint64_t hash;
+    struct DealMasks deal;
+};
+
+/**
+ * @struct Deduplicator
+ * @brief The deals seen in a stream.
+ *
+ * @var Deduplicator::bloom
+ *     The Bloom filter, in blocks of 8 words, every block on its own cache
+ *     line.
+ * @var Deduplicator::bloomMemory
+ *     The memory allocated for the Bloom filter.
+ * @var Deduplicator::blocksNumber
+ *     The number of blocks of the Bloom filter, always a power of 2.
+ * @var Deduplicator::slots
+ *     Open addressing hash table of the deals kept.
+ * @var Deduplicator::size
+ *     The size of the hash table, always a power of 2.
+ * @var Deduplicator::capacity
+ *     The number of deals kept.
+ * @var Deduplicator::keptNumber
+ *     The number of used slots of the hash table.
+ * @var Deduplicator::dealsNumber
+ *     The number of deals added.
+ * @var Deduplicator::duplicatesNumber
+ *     The number of deals found to be seen before, verified or not.
+ * @var Deduplicator::unverifiedNumber
+ *     The number of duplicates which could not be verified.
+ */
+struct Deduplicator {
+    uint64_t *bloom;
+    uint64_t *bloomMemory;
+    uint64_t blocksNumber;
+    struct DedupSlot *slots;
+    uint64_t size;
+    long capacity;
+    long keptNumber;
+    long dealsNumber;
+    long duplicatesNumber;
+    long unverifiedNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates an empty deduplicator.
+ *
+ * @param dealsNumber The number of different deals expected in the stream,
+ *                    which sizes the Bloom filter.
+ * @param capacity The number of deals kept to verify duplicates.
+ *
+ * @return Pointer to the new deduplicator on success or NULL on failure.
+ */
+EXPORT struct Deduplicator *dedup_createDeduplicator(const long dealsNumber,
+                                                     const long capacity);
+
+/**
+ * @brief Frees the memory of a deduplicator and sets the pointer to NULL.
+ *
+ * @param deduplicator Pointer to the pointer to the deduplicator.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int dedup_deleteDeduplicator(struct Deduplicator **deduplicator);
+
+/**
+ * @brief Finds the deal of a recorded round.
+ *
+ * @param record The round.
+ * @param deal Where the cards of every seat and the cards left in the deck
+ *             are stored.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int dedup_recordDeal(const struct RoundRecord *record,
+                            struct DealMasks *deal);
+
+/**
+ * @brief Renames the suits of a deal to make it canonical.
+ *
+ * @param deal The deal.
+ * @param trump The trump, or SuitEnd if it is not known yet.
+ * @param canonical Where the canonical deal is stored.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int dedup_canonicalDeal(const struct DealMasks *deal, const int trump,
+                               struct DealMasks *canonical);
+
+/**
+ * @brief Adds a deal and checks if it was seen before.
+ *
+ * @param deduplicator The deduplicator.
+ * @param deal The deal.
+ * @param trump The trump, or SuitEnd if it is not known yet.
+ *
+ * @return 1 if the deal is new, 0 if it was seen before, negative value on
+ *         failure.
+ */
+EXPORT int dedup_addDeal(struct Deduplicator *deduplicator,
+                         const struct DealMasks *deal, const int trump);
+
+/**
+ * @brief Adds many deals, like the ones of dealer_dealBatch, and checks
+ *        which were seen before. The memory the deals need is fetched a
+ *        few deals ahead, so it is faster than adding them one by one.
+ *
+ * @param deduplicator The deduplicator.
+ * @param deals The deals, added in order.
+ * @param dealsNumber The number of deals.
+ * @param trump The trump of all the deals, or SuitEnd if it is not known
+ *              yet.
+ * @param news If not NULL, news[i] is set to 1 if deal i is new, to 0 if
+ *             it was seen before.
+ *
+ * @return The number of new deals on success, negative value on failure.
+ */
+EXPORT int dedup_addDeals(struct Deduplicator *deduplicator,
+                          const struct DealMasks *deals,
+                          const int dealsNumber, const int trump,
+                          unsigned char *news);
+
+/**
+ * @brief Adds the deal of a recorded round, with its trump, and checks if
+ *        it was seen before.
+ *
+ * @param deduplicator The deduplicator.
+ * @param record The round.
+ *
+ * @return 1 if the deal is new, 0 if it was seen before, negative value on
+ *         failure.
+ */
+EXPORT int dedup_addRound(struct Deduplicator *deduplicator,
+                          const struct RoundRecord *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -65,6 +65,45 @@ const char *error(const int error_code)
             return "There are not enough players in the round structure to complete the operations in the context given";
         case GAME_EMPTY:
             return "There are no players in the game structure; the minimum to complete the operations is two.";
+
+        case RECORD_NULL:
+            return "The pointer to the round record you passed as parameter is NULL";
+        case INDEX_NULL:
+            return "The pointer to the index you passed as parameter is NULL";
+        case SYNTAX_ERROR:
+            return "The text you are trying to parse is not written in the game notation";
+        case CONNECTION_NULL:
+            return "The pointer to the connection you passed as parameter is NULL";
+        case CONNECTION_CLOSED:
+            return "The connection was closed because its client is too slow or a write failed";
+        case ADMISSION_NULL:
+            return "The pointer to the admission control you passed as parameter is NULL";
+        case VARIATION_NULL:
+            return "The pointer to the variation you passed as parameter is NULL";
+        case WORLD_POOL_NULL:
+            return "The pointer to the pool of worlds you passed as parameter is NULL";
+        case BUDGET_NULL:
+            return "The pointer to the budget you passed as parameter is NULL";
+        case OPPONENTS_NULL:
+            return "The pointer to the store of opponents you passed as parameter is NULL";
+        case NETWORK_NULL:
+            return "The pointer to the network you passed as parameter is NULL";
+        case SAMPLER_NULL:
+            return "The pointer to the deal sampler you passed as parameter is NULL";
+        case DEALER_NULL:
+            return "The pointer to the dealer you passed as parameter is NULL";
+        case PROFILER_NULL:
+            return "The pointer to the profiler you passed as parameter is NULL";
+        case RECORDER_NULL:
+            return "The pointer to the repro recorder you passed as parameter is NULL";
+        case ACCOUNTING_NULL:
+            return "The pointer to the accounting you passed as parameter is NULL";
+        case MERGER_NULL:
+            return "The pointer to the merger you passed as parameter is NULL";
+        case DEDUPLICATOR_NULL:
+            return "The pointer to the deduplicator you passed as parameter is NULL";
+        case READ_ERROR:
+            return "Reading from the file failed";
         
         default:
             return "Unknown error code";
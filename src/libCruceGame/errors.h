@@ -50,7 +50,27 @@ enum ERROR_CODE {
     ROUND_EMPTY   = -21, //!< There are no players in a round.
     GAME_EMPTY    = -22, //!< There are no players in a game.
 
-    DUPLICATE_NAME = -23 //!< There is one more player with this name.
+    DUPLICATE_NAME = -23, //!< There is one more player with this name.
+
+    RECORD_NULL   = -24, //!< The value of the argument that should point to a RoundRecord is equal to NULL.
+    INDEX_NULL    = -25, //!< The value of the argument that should point to an Index is equal to NULL.
+    SYNTAX_ERROR  = -26, //!< The text is not written in the notation of the game.
+    CONNECTION_NULL = -27, //!< The value of the argument that should point to a Connection is equal to NULL.
+    CONNECTION_CLOSED = -28, //!< The connection was shed or writing to it failed.
+    ADMISSION_NULL = -29, //!< The value of the argument that should point to an Admission is equal to NULL.
+    VARIATION_NULL = -30, //!< The value of the argument that should point to a Variation is equal to NULL.
+    WORLD_POOL_NULL = -31, //!< The value of the argument that should point to a WorldPool is equal to NULL.
+    BUDGET_NULL = -32, //!< The value of the argument that should point to a Budget is equal to NULL.
+    OPPONENTS_NULL = -33, //!< The value of the argument that should point to an OpponentStore is equal to NULL.
+    NETWORK_NULL = -34, //!< The value of the argument that should point to a Network is equal to NULL.
+    SAMPLER_NULL = -35, //!< The value of the argument that should point to a DealSampler is equal to NULL.
+    DEALER_NULL = -36, //!< The value of the argument that should point to a Dealer is equal to NULL.
+    PROFILER_NULL = -37, //!< The value of the argument that should point to a Profiler is equal to NULL.
+    RECORDER_NULL = -38, //!< The value of the argument that should point to a ReproRecorder is equal to NULL.
+    ACCOUNTING_NULL = -39, //!< The value of the argument that should point to an Accounting is equal to NULL.
+    MERGER_NULL = -40, //!< The value of the argument that should point to an ArchiveMerger is equal to NULL.
+    DEDUPLICATOR_NULL = -41, //!< The value of the argument that should point to a Deduplicator is equal to NULL.
+    READ_ERROR = -42 //!< Reading from a file failed.
 };
 
 #ifdef __cplusplus
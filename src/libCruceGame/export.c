@@ -0,0 +1,306 @@
+/**
+ * @file export.c
+ * @brief Contains implementations of the functions used to export recorded
+ *        rounds as NDJSON or CSV.
+ */
+
+#include "export.h"
+#include "notation.h"
+#include "errors.h"
+
+#include <string.h>
+
+static const char CSV_HEADER[] = "players,teams,hands,bids,trump,tricks,"
+                                 "leaders,winners,marriages,points,scores,"
+                                 "bid_winner,bid_made\n";
+
+/**
+ * @brief Helper to write a null terminated string.
+ */
+static char *writeString(char *text, const char *string)
+{
+    while (*string != '\0')
+        *text++ = *string++;
+
+    return text;
+}
+
+/**
+ * @brief Helper to write a player name, escaped for the format.
+ *
+ * In CSV the names are written in a quoted field, separated by ';', so
+ * quotes are doubled and ';' is replaced.
+ */
+static char *writeName(char *text, const char *name,
+                       const enum ExportFormat format)
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    for (int i = 0; i < RECORD_NAME_LENGTH && name[i] != '\0'; i++) {
+        unsigned char c = name[i];
+        if (format == EXPORT_CSV) {
+            if (c == '"')
+                *text++ = '"';
+            *text++ = c == ';' ? '_' : c;
+        } else if (c == '"' || c == '\\') {
+            *text++ = '\\';
+            *text++ = c;
+        } else if (c < 0x20) {
+            text = writeString(text, "\\u00");
+            *text++ = HEX_DIGITS[c >> 4];
+            *text++ = HEX_DIGITS[c & 0xF];
+        } else {
+            *text++ = c;
+        }
+    }
+
+    return text;
+}
+
+/**
+ * @brief Helper to write the start of a NDJSON member or of a CSV field.
+ *
+ * @param name The name of the member, NULL for a member of an array.
+ */
+static char *writeFieldStart(char *text, const char *name,
+                             const enum ExportFormat format)
+{
+    if (format == EXPORT_CSV)
+        return text;
+
+    *text++ = '"';
+    text = writeString(text, name);
+    *text++ = '"';
+    *text++ = ':';
+
+    return text;
+}
+
+/**
+ * @brief Helper to write the values of a list, one for every seat or hand.
+ *
+ * Every value is written by the callback, as an array element in NDJSON
+ * or as a space separated value in CSV.
+ */
+static char *writeList(char *text, const char *name,
+                       const struct RoundRecord *record, const int count,
+                       const int quoted, const enum ExportFormat format,
+                       char *(*writeValue)(char *,
+                                           const struct RoundRecord *, int))
+{
+    text = writeFieldStart(text, name, format);
+    if (format == EXPORT_NDJSON)
+        *text++ = '[';
+
+    for (int i = 0; i < count; i++) {
+        if (i > 0)
+            *text++ = format == EXPORT_CSV ? ' ' : ',';
+        if (quoted && format == EXPORT_NDJSON)
+            *text++ = '"';
+        text = writeValue(text, record, i);
+        if (quoted && format == EXPORT_NDJSON)
+            *text++ = '"';
+    }
+
+    if (format == EXPORT_NDJSON)
+        *text++ = ']';
+    *text++ = ',';
+
+    return text;
+}
+
+/**
+ * @brief Callbacks of writeList, writing the value of a seat or hand.
+ */
+static char *writeHand(char *text, const struct RoundRecord *record,
+                       const int seat)
+{
+    for (int i = seat; i < DECK_SIZE; i += record->playersNumber)
+        text = notation_writeCard(text, record->deck[i]);
+
+    return text;
+}
+
+static char *writeBid(char *text, const struct RoundRecord *record,
+                      const int seat)
+{
+    return notation_writeInt(text, record->bids[seat]);
+}
+
+static char *writeTrick(char *text, const struct RoundRecord *record,
+                        const int handId)
+{
+    for (int i = 0; i < record->playersNumber; i++)
+        text = notation_writeCard(text, record->cards[handId][i]);
+
+    return text;
+}
+
+static char *writeLeader(char *text, const struct RoundRecord *record,
+                         const int handId)
+{
+    return notation_writeInt(text, record->leaders[handId]);
+}
+
+static char *writeWinner(char *text, const struct RoundRecord *record,
+                         const int handId)
+{
+    return notation_writeInt(text, record->winners[handId]);
+}
+
+static char *writeMarriage(char *text, const struct RoundRecord *record,
+                           const int seat)
+{
+    for (int i = 0; i < SuitEnd; i++)
+        if (record->marriages[seat] & (1 << i))
+            *text++ = SUIT_LETTERS[i];
+
+    return text;
+}
+
+static char *writePoints(char *text, const struct RoundRecord *record,
+                         const int seat)
+{
+    return notation_writeInt(text, record->pointsNumber[seat]);
+}
+
+static char *writeScore(char *text, const struct RoundRecord *record,
+                        const int seat)
+{
+    return notation_writeInt(text, record->scores[seat]);
+}
+
+/**
+ * @brief Helper for export_writeRound, writing in a buffer big enough
+ *        for any round.
+ */
+static int writeRound(const struct RoundRecord *record,
+                      const enum ExportFormat format, char *text)
+{
+    char *start = text;
+    int playersNumber = record->playersNumber;
+    int csv = format == EXPORT_CSV;
+
+    if (!csv)
+        *text++ = '{';
+
+    text = writeFieldStart(text, "players", format);
+    *text++ = csv ? '"' : '[';
+    for (int i = 0; i < playersNumber; i++) {
+        if (i > 0)
+            *text++ = csv ? ';' : ',';
+        if (!csv)
+            *text++ = '"';
+        text = writeName(text, record->names[i], format);
+        if (!csv)
+            *text++ = '"';
+    }
+    *text++ = csv ? '"' : ']';
+    *text++ = ',';
+
+    text = writeFieldStart(text, "teams", format);
+    if (!csv)
+        *text++ = '[';
+    for (int i = 0; i < playersNumber; i++) {
+        if (i > 0)
+            *text++ = csv ? ' ' : ',';
+        if (record->teams[i] < MAX_GAME_TEAMS)
+            text = notation_writeInt(text, record->teams[i]);
+        else
+            text = writeString(text, csv ? "-" : "null");
+    }
+    if (!csv)
+        *text++ = ']';
+    *text++ = ',';
+
+    text = writeList(text, "hands", record, playersNumber, 1, format,
+                     writeHand);
+    text = writeList(text, "bids", record, playersNumber, 0, format,
+                     writeBid);
+
+    text = writeFieldStart(text, "trump", format);
+    if (record->trump < SuitEnd) {
+        if (!csv)
+            *text++ = '"';
+        *text++ = SUIT_LETTERS[record->trump];
+        if (!csv)
+            *text++ = '"';
+    } else if (!csv) {
+        text = writeString(text, "null");
+    }
+    *text++ = ',';
+
+    int handsNumber = record->handsNumber;
+    text = writeList(text, "tricks", record, handsNumber, 1, format,
+                     writeTrick);
+    text = writeList(text, "leaders", record, handsNumber, 0, format,
+                     writeLeader);
+    text = writeList(text, "winners", record, handsNumber, 0, format,
+                     writeWinner);
+    text = writeList(text, "marriages", record, playersNumber, 1, format,
+                     writeMarriage);
+    text = writeList(text, "points", record, playersNumber, 0, format,
+                     writePoints);
+    text = writeList(text, "scores", record, playersNumber, 0, format,
+                     writeScore);
+
+    text = writeFieldStart(text, "bidWinner", format);
+    text = notation_writeInt(text, record_bidWinner(record));
+    *text++ = ',';
+
+    text = writeFieldStart(text, "bidMade", format);
+    if (csv)
+        *text++ = '0' + record_bidMade(record);
+    else
+        text = writeString(text, record_bidMade(record) ? "true" : "false");
+
+    if (!csv)
+        *text++ = '}';
+    *text++ = '\n';
+
+    return text - start;
+}
+
+int export_writeHeader(const enum ExportFormat format, char *text,
+                       const size_t size)
+{
+    if (text == NULL)
+        return POINTER_NULL;
+    if (format < 0 || format >= ExportFormatEnd)
+        return ILLEGAL_VALUE;
+
+    if (format != EXPORT_CSV)
+        return 0;
+    if (size < sizeof(CSV_HEADER) - 1)
+        return FULL;
+    memcpy(text, CSV_HEADER, sizeof(CSV_HEADER) - 1);
+
+    return sizeof(CSV_HEADER) - 1;
+}
+
+int export_writeRound(const struct RoundRecord *record,
+                      const enum ExportFormat format, char *text,
+                      const size_t size)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (text == NULL)
+        return POINTER_NULL;
+    if (format < 0 || format >= ExportFormatEnd)
+        return ILLEGAL_VALUE;
+    int error = notation_checkRecord(record);
+    if (error != NO_ERROR)
+        return error;
+
+    if (size >= EXPORT_MAX_ROUND_LENGTH)
+        return writeRound(record, format, text);
+
+    char buffer[EXPORT_MAX_ROUND_LENGTH];
+    int length = writeRound(record, format, buffer);
+    if ((size_t)length > size)
+        return FULL;
+    memcpy(text, buffer, length);
+
+    return length;
+}
+
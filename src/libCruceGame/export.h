@@ -0,0 +1,78 @@
+/**
+ * @file export.h
+ * @brief Functions used to export recorded rounds as NDJSON or CSV, for
+ *        processing with external tools.
+ *
+ * In NDJSON every round is an object on one line:
+ *
+ *     {"players":["Ana","Bob"],"teams":[0,1],"hands":["JDQD...","KDAD..."],
+ *      "bids":[2,0],"trump":"H","tricks":["JHQH",...],"leaders":[0,...],
+ *      "winners":[1,...],"marriages":["H",""],"points":[45,20],
+ *      "scores":[4,3],"bidWinner":0,"bidMade":true}
+ *
+ * In CSV every round is a row with the columns of \ref export_writeHeader.
+ * Values with one entry for every seat or hand are separated by spaces.
+ * Cards and suits are written with the letters of the notation.
+ */
+
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include "platform.h"
+#include "record.h"
+
+#include <stddef.h>
+
+/**
+ * @brief The maximum length of an exported round, in any format.
+ */
+#define EXPORT_MAX_ROUND_LENGTH 2048
+
+/**
+ * @brief Formats in which rounds can be exported.
+ *
+ * ExportFormatEnd is a flag used when iterating.
+ */
+enum ExportFormat {
+    EXPORT_NDJSON = 0,
+    EXPORT_CSV,
+    ExportFormatEnd
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Writes the text which precedes the rounds of an export.
+ *
+ * @param format The format of the export.
+ * @param text Buffer where the text is written. It is not null terminated.
+ * @param size The size of the buffer.
+ *
+ * @return The number of bytes written on success (0 if the format has no
+ *         header), negative value on failure.
+ */
+EXPORT int export_writeHeader(const enum ExportFormat format, char *text,
+                              const size_t size);
+
+/**
+ * @brief Writes a round, including the line ending after it.
+ *
+ * @param record The round.
+ * @param format The format of the export.
+ * @param text Buffer where the round is written. It is not null terminated.
+ * @param size The size of the buffer.
+ *
+ * @return The number of bytes written on success, negative value on failure.
+ */
+EXPORT int export_writeRound(const struct RoundRecord *record,
+                             const enum ExportFormat format, char *text,
+                             const size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -33,6 +33,7 @@ struct Game *game_createGame(const int pointsNumber)
     newGame->numberPlayers = 0;
     newGame->round = NULL;
     newGame->deck = NULL;
+    newGame->hooks = NULL;
 
     return newGame;
 }
@@ -341,6 +342,7 @@ int game_updateScore(const struct Game *game, struct Player *bidWinner)
     int bidWinnerId = round_findPlayerIndexRound(bidWinner, game->round);
     for (int i = 0; i < MAX_GAME_TEAMS; i++) {
         if (game->teams[i] != NULL) {
+            int oldScore = game->teams[i]->score;
             if (game->teams[i] != bidWinnerTeam)
                 game->teams[i]->score += teamScores[i] / 33;
             else if (game->round->bids[bidWinnerId] <=
@@ -348,8 +350,11 @@ int game_updateScore(const struct Game *game, struct Player *bidWinner)
                 bidWinnerTeam->score += teamScores[bidWinnerTeamId] / 33;
             else
                 bidWinnerTeam->score -= game->round->bids[bidWinnerId];
+            team_updatePlayersScore(game->teams[i]);
+            if (game->teams[i]->score != oldScore)
+                HOOKS_EMIT(game->hooks, scoreChanged, struct ScoreEvent, game,
+                           game->teams[i], oldScore, game->teams[i]->score);
         }
-        team_updatePlayersScore(game->teams[i]);
     }
 
     return NO_ERROR;
@@ -369,8 +374,20 @@ int game_arrangePlayersRound(struct Game *game, const int i)
         if (game->players[j % MAX_GAME_PLAYERS] != NULL)
             round_addPlayer(game->players[j % MAX_GAME_PLAYERS], round);
 
+    round->hooks = game->hooks;
     game->round = round;
 
     return NO_ERROR;
 }
 
+int game_setHooks(struct Game *game, const struct GameHooks *hooks)
+{
+    if (game == NULL)
+        return GAME_NULL;
+
+    game->hooks = hooks;
+    if (game->round != NULL)
+        game->round->hooks = hooks;
+
+    return NO_ERROR;
+}
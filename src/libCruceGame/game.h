@@ -11,6 +11,7 @@
 #include "team.h"
 #include "deck.h"
 #include "round.h"
+#include "hooks.h"
 
 /**
  * @struct Game
@@ -30,6 +31,8 @@
  *     Pointer to the teams of the game.
  * @var Game::deck
  *     Pointer to the deck of the game.
+ * @var Game::hooks
+ *     The hooks of the game, NULL if none are registered.
  */
 struct Game {
     int numberPlayers;
@@ -38,6 +41,7 @@ struct Game {
     struct Player *players[MAX_GAME_PLAYERS];
     struct Team *teams[MAX_GAME_TEAMS];
     struct Deck *deck;
+    const struct GameHooks *hooks;
 };
 
 #ifdef __cplusplus
@@ -190,6 +194,18 @@ EXPORT int game_updateScore(const struct Game *game, struct Player *bidWinner);
  */
 EXPORT int game_arrangePlayersRound(struct Game *game, const int i);
 
+/**
+ * @brief Function to register the hooks of a game. They are called by the
+ *        current round and by the rounds arranged later.
+ *
+ * @param game The game.
+ * @param hooks The hooks, NULL to remove them. They must stay valid while
+ *              they are registered.
+ *
+ * @return \ref NO_ERROR or 0 on success, other value on failure.
+ */
+EXPORT int game_setHooks(struct Game *game, const struct GameHooks *hooks);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,172 @@
+/**
+ * @file hooks.h
+ * @brief Event structures and the hooks called by the rules of the game
+ *        when a bid is placed, a card is put down, a marriage is scored, a
+ *        hand is won or a score changes.
+ *
+ * Hooks are registered per game with game_setHooks. When none are
+ * registered, an event costs one test of a NULL pointer; when the library
+ * is built with NO_HOOKS (configure --disable-hooks), no code is emitted.
+ * The events are built on the stack of the rules function and are only
+ * valid during the call of the hook.
+ */
+
+#ifndef HOOKS_H
+#define HOOKS_H
+
+#include "constants.h"
+
+struct Card;
+struct Player;
+struct Team;
+struct Hand;
+struct Round;
+struct Game;
+
+/**
+ * @struct BidEvent
+ * @brief A player placed a bid (round_placeBid).
+ *
+ * @var BidEvent::round
+ *     The round.
+ * @var BidEvent::player
+ *     The player.
+ * @var BidEvent::bid
+ *     The bid.
+ */
+struct BidEvent {
+    const struct Round *round;
+    const struct Player *player;
+    int bid;
+};
+
+/**
+ * @struct CardEvent
+ * @brief A player put down a card (round_putCard).
+ *
+ * @var CardEvent::round
+ *     The round.
+ * @var CardEvent::player
+ *     The player.
+ * @var CardEvent::card
+ *     The card.
+ * @var CardEvent::handId
+ *     The index of the hand in Round::hands.
+ */
+struct CardEvent {
+    const struct Round *round;
+    const struct Player *player;
+    const struct Card *card;
+    int handId;
+};
+
+/**
+ * @struct MarriageEvent
+ * @brief A player scored a marriage (round_putCard).
+ *
+ * @var MarriageEvent::round
+ *     The round.
+ * @var MarriageEvent::player
+ *     The player.
+ * @var MarriageEvent::suit
+ *     The suit of the marriage.
+ * @var MarriageEvent::points
+ *     The points scored, 20 or 40.
+ */
+struct MarriageEvent {
+    const struct Round *round;
+    const struct Player *player;
+    enum Suit suit;
+    int points;
+};
+
+/**
+ * @struct TrickEvent
+ * @brief A player won a hand (round_handWinner).
+ *
+ * @var TrickEvent::round
+ *     The round.
+ * @var TrickEvent::hand
+ *     The hand.
+ * @var TrickEvent::winner
+ *     The player who won the hand.
+ * @var TrickEvent::points
+ *     The points of the cards of the hand.
+ */
+struct TrickEvent {
+    const struct Round *round;
+    const struct Hand *hand;
+    const struct Player *winner;
+    int points;
+};
+
+/**
+ * @struct ScoreEvent
+ * @brief The score of a team changed (game_updateScore).
+ *
+ * @var ScoreEvent::game
+ *     The game.
+ * @var ScoreEvent::team
+ *     The team.
+ * @var ScoreEvent::oldScore
+ *     The score before the change.
+ * @var ScoreEvent::score
+ *     The new score.
+ */
+struct ScoreEvent {
+    const struct Game *game;
+    const struct Team *team;
+    int oldScore;
+    int score;
+};
+
+/**
+ * @struct GameHooks
+ * @brief The hooks of a game. Every hook may be NULL.
+ *
+ * @var GameHooks::context
+ *     Passed to every hook.
+ * @var GameHooks::bidPlaced
+ *     Called after a bid is placed.
+ * @var GameHooks::cardPut
+ *     Called after a card is put down, before the marriage it scores.
+ * @var GameHooks::marriageScored
+ *     Called after the points of a marriage are added.
+ * @var GameHooks::trickWon
+ *     Called after the points of a hand are added.
+ * @var GameHooks::scoreChanged
+ *     Called after the score of a team changes.
+ */
+struct GameHooks {
+    void *context;
+    void (*bidPlaced)(void *context, const struct BidEvent *event);
+    void (*cardPut)(void *context, const struct CardEvent *event);
+    void (*marriageScored)(void *context, const struct MarriageEvent *event);
+    void (*trickWon)(void *context, const struct TrickEvent *event);
+    void (*scoreChanged)(void *context, const struct ScoreEvent *event);
+};
+
+/**
+ * @brief Calls a hook with an event.
+ *
+ * @param hooks The hooks, NULL if none are registered.
+ * @param hook The name of the hook in GameHooks.
+ * @param ... The initializer of the event, whose type is given first, as
+ *            in HOOKS_EMIT(round->hooks, bidPlaced, struct BidEvent,
+ *            round, player, bid).
+ */
+#ifdef NO_HOOKS
+#define HOOKS_EMIT(hooks, hook, ...) ((void)0)
+#else
+#define HOOKS_EMIT(hooks, hook, type, ...)                                  \
+    do {                                                                    \
+        const struct GameHooks *hooks_ = (hooks);                           \
+        if (hooks_ != NULL && hooks_->hook != NULL) {                       \
+            type event_ = {__VA_ARGS__};                                    \
+            hooks_->hook(hooks_->context, &event_);                         \
+        }                                                                   \
+    } while (0)
+#endif
+
+#endif
+
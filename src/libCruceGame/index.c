@@ -0,0 +1,396 @@
+/**
+ * @file index.c
+ * @brief Contains implementations of the functions used to build and query
+ *        the inverted index of recorded rounds.
+ */
+
+#include "index.h"
+#include "errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define INDEX_SSE2
+#endif
+
+/**
+ * @brief The initial number of slots of the hash table.
+ */
+#define INDEX_INITIAL_CAPACITY 64
+
+/**
+ * @brief Helper to compute the key of a term.
+ *
+ * Names are hashed with FNV-1a. Only the characters kept in a RoundRecord
+ * are hashed, so that a full name finds its truncated record.
+ *
+ * @param field The field of the term.
+ * @param value The value, for fields which are not names.
+ * @param name The name, for fields which are names.
+ *
+ * @return The key, which is never 0.
+ */
+static unsigned long long termKey(const enum IndexField field,
+                                  const int value, const char *name)
+{
+    unsigned long long hash = (unsigned int)value;
+    if (field == INDEX_PLAYER || field == INDEX_BIDDER ||
+        field == INDEX_MARRIAGE_PLAYER) {
+        hash = 14695981039346656037ULL;
+        for (int i = 0; i < RECORD_NAME_LENGTH - 1 && name[i] != '\0'; i++) {
+            hash ^= (unsigned char)name[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return (hash << 3) | field | (1ULL << 63);
+}
+
+/**
+ * @brief Helper to find the slot of a key in the hash table.
+ *
+ * @param index The index.
+ * @param key The key.
+ *
+ * @return The slot holding the key, or the empty slot where it belongs.
+ */
+static struct Posting *findSlot(const struct Index *index,
+                                const unsigned long long key)
+{
+    size_t mask = index->capacity - 1;
+    size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+
+    while (index->postings[slot].key != 0 && index->postings[slot].key != key)
+        slot = (slot + 1) & mask;
+
+    return &index->postings[slot];
+}
+
+/**
+ * @brief Helper to double the size of the hash table.
+ *
+ * @param index The index.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int growIndex(struct Index *index)
+{
+    struct Posting *old = index->postings;
+    size_t oldCapacity = index->capacity;
+
+    index->postings = calloc(oldCapacity * 2, sizeof(struct Posting));
+    if (index->postings == NULL) {
+        index->postings = old;
+        return MALLOC_ERROR;
+    }
+    index->capacity = oldCapacity * 2;
+
+    for (size_t i = 0; i < oldCapacity; i++)
+        if (old[i].key != 0)
+            *findSlot(index, old[i].key) = old[i];
+
+    free(old);
+
+    return NO_ERROR;
+}
+
+struct Index *index_createIndex()
+{
+    struct Index *index = malloc(sizeof(struct Index));
+    if (index == NULL)
+        return NULL;
+
+    index->postings = calloc(INDEX_INITIAL_CAPACITY, sizeof(struct Posting));
+    if (index->postings == NULL) {
+        free(index);
+        return NULL;
+    }
+
+    index->capacity = INDEX_INITIAL_CAPACITY;
+    index->termsNumber = 0;
+    index->roundsNumber = 0;
+    index->lastId = 0;
+
+    return index;
+}
+
+int index_deleteIndex(struct Index **index)
+{
+    if (index == NULL)
+        return POINTER_NULL;
+    if (*index == NULL)
+        return INDEX_NULL;
+
+    for (size_t i = 0; i < (*index)->capacity; i++)
+        free((*index)->postings[i].bytes);
+
+    free((*index)->postings);
+    free(*index);
+    *index = NULL;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to append a round id to the posting list of a term.
+ *
+ * @param index The index.
+ * @param field The field of the term.
+ * @param value The value of the term.
+ * @param name The name of the term.
+ * @param roundId The round id.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int addTerm(struct Index *index, const enum IndexField field,
+                   const int value, const char *name,
+                   const unsigned int roundId)
+{
+    if ((index->termsNumber + 1) * 4 > index->capacity * 3) {
+        int error = growIndex(index);
+        if (error != NO_ERROR)
+            return error;
+    }
+
+    unsigned long long key = termKey(field, value, name);
+    struct Posting *posting = findSlot(index, key);
+    if (posting->key == 0) {
+        posting->key = key;
+        index->termsNumber++;
+    } else if (posting->last == roundId) {
+        return NO_ERROR;
+    }
+
+    if (posting->size + 5 > posting->capacity) {
+        size_t capacity = posting->capacity == 0 ? 16 : posting->capacity * 2;
+        unsigned char *bytes = realloc(posting->bytes, capacity);
+        if (bytes == NULL)
+            return MALLOC_ERROR;
+        posting->bytes = bytes;
+        posting->capacity = capacity;
+    }
+
+    unsigned int delta = posting->count == 0 ? roundId
+                                             : roundId - posting->last;
+    while (delta >= 0x80) {
+        posting->bytes[posting->size++] = (delta & 0x7F) | 0x80;
+        delta >>= 7;
+    }
+    posting->bytes[posting->size++] = delta;
+
+    posting->count++;
+    posting->last = roundId;
+
+    return NO_ERROR;
+}
+
+int index_addRound(struct Index *index, const struct RoundRecord *record,
+                   const unsigned int roundId)
+{
+    if (index == NULL)
+        return INDEX_NULL;
+    if (record == NULL)
+        return RECORD_NULL;
+    if (index->roundsNumber > 0 && roundId <= index->lastId)
+        return ILLEGAL_VALUE;
+
+    int bidWinner = record_bidWinner(record);
+    if (bidWinner < 0)
+        return bidWinner;
+
+    int error = NO_ERROR;
+    int marriages = 0;
+    for (int i = 0; i < record->playersNumber && error == NO_ERROR; i++) {
+        error = addTerm(index, INDEX_PLAYER, 0, record->names[i], roundId);
+        if (error == NO_ERROR && record->marriages[i] != 0)
+            error = addTerm(index, INDEX_MARRIAGE_PLAYER, 0,
+                            record->names[i], roundId);
+        marriages |= record->marriages[i];
+    }
+
+    for (int i = 0; i < SuitEnd && error == NO_ERROR; i++)
+        if (marriages & (1 << i))
+            error = addTerm(index, INDEX_MARRIAGE, i, NULL, roundId);
+
+    if (error == NO_ERROR)
+        error = addTerm(index, INDEX_BIDDER, 0, record->names[bidWinner],
+                        roundId);
+    if (error == NO_ERROR)
+        error = addTerm(index, INDEX_BID, record->bids[bidWinner], NULL,
+                        roundId);
+    if (error == NO_ERROR)
+        error = addTerm(index, INDEX_TRUMP, record->trump, NULL, roundId);
+    if (error == NO_ERROR)
+        error = addTerm(index, INDEX_OUTCOME, record_bidMade(record), NULL,
+                        roundId);
+    if (error != NO_ERROR)
+        return error;
+
+    index->roundsNumber++;
+    index->lastId = roundId;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to decode a posting list.
+ *
+ * @param posting The posting list.
+ * @param ids Array of at least posting->count elements for the ids.
+ */
+static void decodePosting(const struct Posting *posting, unsigned int *ids)
+{
+    unsigned int id = 0;
+    size_t position = 0;
+    for (unsigned int i = 0; i < posting->count; i++) {
+        unsigned int delta = 0;
+        int shift = 0;
+        unsigned char byte;
+        do {
+            byte = posting->bytes[position++];
+            delta |= (unsigned int)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+
+        id = i == 0 ? delta : id + delta;
+        ids[i] = id;
+    }
+}
+
+/**
+ * @brief Helper to intersect two sorted lists of unique ids.
+ *
+ * Blocks of 4 ids of each list are compared at once (all 4 rotations of
+ * the second block against the first one). The result is written over
+ * the first list.
+ *
+ * @param a The first list, which receives the result.
+ * @param sizeA The size of the first list.
+ * @param b The second list.
+ * @param sizeB The size of the second list.
+ *
+ * @return The size of the intersection.
+ */
+static size_t intersect(unsigned int *a, const size_t sizeA,
+                        const unsigned int *b, const size_t sizeB)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t count = 0;
+
+#ifdef INDEX_SSE2
+    while (i + 4 <= sizeA && j + 4 <= sizeB) {
+        unsigned int maxA = a[i + 3];
+        unsigned int maxB = b[j + 3];
+        __m128i blockA = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i blockB = _mm_loadu_si128((const __m128i *)(b + j));
+        __m128i rotation1 = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(0, 3, 2, 1));
+        __m128i rotation2 = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(1, 0, 3, 2));
+        __m128i rotation3 = _mm_shuffle_epi32(blockB, _MM_SHUFFLE(2, 1, 0, 3));
+        __m128i equal = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(blockA, blockB),
+                         _mm_cmpeq_epi32(blockA, rotation1)),
+            _mm_or_si128(_mm_cmpeq_epi32(blockA, rotation2),
+                         _mm_cmpeq_epi32(blockA, rotation3)));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+
+        for (int k = 0; k < 4; k++)
+            if (mask & (1 << k))
+                a[count++] = a[i + k];
+
+        if (maxA <= maxB)
+            i += 4;
+        if (maxB <= maxA)
+            j += 4;
+    }
+#endif
+
+    while (i < sizeA && j < sizeB) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (b[j] < a[i]) {
+            j++;
+        } else {
+            a[count++] = a[i];
+            i++;
+            j++;
+        }
+    }
+
+    return count;
+}
+
+int index_query(const struct Index *index, const struct IndexTerm *terms,
+                const int termsNumber, unsigned int *results,
+                const int maxResults)
+{
+    if (index == NULL)
+        return INDEX_NULL;
+    if (terms == NULL || (results == NULL && maxResults > 0))
+        return POINTER_NULL;
+    if (termsNumber <= 0 || maxResults < 0)
+        return ILLEGAL_VALUE;
+
+    const struct Posting **postings = malloc(termsNumber *
+                                             sizeof(struct Posting *));
+    if (postings == NULL)
+        return MALLOC_ERROR;
+
+    for (int i = 0; i < termsNumber; i++) {
+        if (terms[i].field < 0 || terms[i].field >= IndexFieldEnd) {
+            free(postings);
+            return ILLEGAL_VALUE;
+        }
+        if (terms[i].name == NULL && (terms[i].field == INDEX_PLAYER ||
+                                      terms[i].field == INDEX_BIDDER ||
+                                      terms[i].field == INDEX_MARRIAGE_PLAYER)) {
+            free(postings);
+            return POINTER_NULL;
+        }
+
+        const struct Posting *posting = findSlot(index,
+            termKey(terms[i].field, terms[i].value, terms[i].name));
+        if (posting->key == 0) {
+            free(postings);
+            return 0;
+        }
+
+        int j = i;
+        while (j > 0 && postings[j - 1]->count > posting->count) {
+            postings[j] = postings[j - 1];
+            j--;
+        }
+        postings[j] = posting;
+    }
+
+    unsigned int *ids = malloc(postings[0]->count * sizeof(unsigned int));
+    unsigned int *other = NULL;
+    if (termsNumber > 1)
+        other = malloc(postings[termsNumber - 1]->count *
+                       sizeof(unsigned int));
+    if (ids == NULL || (termsNumber > 1 && other == NULL)) {
+        free(ids);
+        free(other);
+        free(postings);
+        return MALLOC_ERROR;
+    }
+
+    decodePosting(postings[0], ids);
+    size_t count = postings[0]->count;
+    for (int i = 1; i < termsNumber && count > 0; i++) {
+        decodePosting(postings[i], other);
+        count = intersect(ids, count, other, postings[i]->count);
+    }
+
+    for (size_t i = 0; i < count && i < (size_t)maxResults; i++)
+        results[i] = ids[i];
+
+    free(ids);
+    free(other);
+    free(postings);
+
+    return count;
+}
+
@@ -0,0 +1,156 @@
+/**
+ * @file index.h
+ * @brief Index structure, an inverted index over recorded rounds, as well
+ *        as the functions used to fill and query it.
+ */
+
+#ifndef INDEX_H
+#define INDEX_H
+
+#include "platform.h"
+#include "record.h"
+
+#include <stddef.h>
+
+/**
+ * @brief Fields of a round which can be searched in an index.
+ *
+ * IndexFieldEnd is a flag used when iterating.
+ */
+enum IndexField {
+    INDEX_PLAYER = 0,      //!< A player took part in the round (name).
+    INDEX_BIDDER,          //!< A player won the bid (name).
+    INDEX_BID,             //!< The value of the winning bid (0 - 6).
+    INDEX_TRUMP,           //!< The trump of the round (enum Suit).
+    INDEX_MARRIAGE,        //!< A marriage of a suit was scored (enum Suit).
+    INDEX_MARRIAGE_PLAYER, //!< A player scored a marriage (name).
+    INDEX_OUTCOME,         //!< 1 if the bid was made, 0 if it failed.
+    IndexFieldEnd
+};
+
+/**
+ * @struct IndexTerm
+ * @brief A condition of an index query.
+ *
+ * @var IndexTerm::field
+ *     The field to search.
+ * @var IndexTerm::value
+ *     The value searched, for fields which are not names.
+ * @var IndexTerm::name
+ *     The player name searched, for fields which are names.
+ */
+struct IndexTerm {
+    enum IndexField field;
+    int value;
+    const char *name;
+};
+
+/**
+ * @struct Posting
+ * @brief The sorted list of the rounds containing a term.
+ *
+ * The ids are kept as variable length encoded differences between
+ * consecutive ids.
+ *
+ * @var Posting::key
+ *     The hash of the term. 0 marks an empty slot of the index.
+ * @var Posting::count
+ *     The number of rounds in the list.
+ * @var Posting::last
+ *     The last round id added to the list.
+ * @var Posting::bytes
+ *     The encoded list.
+ * @var Posting::size
+ *     The number of used bytes.
+ * @var Posting::capacity
+ *     The number of allocated bytes.
+ */
+struct Posting {
+    unsigned long long key;
+    unsigned int count;
+    unsigned int last;
+    unsigned char *bytes;
+    size_t size;
+    size_t capacity;
+};
+
+/**
+ * @struct Index
+ * @brief Inverted index mapping terms to the rounds containing them.
+ *
+ * @var Index::postings
+ *     Open addressing hash table of the posting lists.
+ * @var Index::capacity
+ *     The size of the hash table, always a power of 2.
+ * @var Index::termsNumber
+ *     The number of used slots of the hash table.
+ * @var Index::roundsNumber
+ *     The number of rounds added to the index.
+ * @var Index::lastId
+ *     The id of the last round added to the index.
+ */
+struct Index {
+    struct Posting *postings;
+    size_t capacity;
+    size_t termsNumber;
+    unsigned int roundsNumber;
+    unsigned int lastId;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates and initializes an empty index.
+ *
+ * @return Pointer to the new index on success or NULL on failure.
+ */
+EXPORT struct Index *index_createIndex();
+
+/**
+ * @brief Frees the memory of an index and sets the pointer to NULL.
+ *
+ * @param index Pointer to the pointer to be freed.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int index_deleteIndex(struct Index **index);
+
+/**
+ * @brief Adds a recorded round to an index.
+ *
+ * @param index The index.
+ * @param record The recorded round.
+ * @param roundId The id of the round. The ids must be added in strictly
+ *                increasing order.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int index_addRound(struct Index *index,
+                          const struct RoundRecord *record,
+                          const unsigned int roundId);
+
+/**
+ * @brief Finds the rounds matching all the terms of a query.
+ *
+ * @param index The index.
+ * @param terms The terms of the query.
+ * @param termsNumber The number of terms.
+ * @param results Array where the matching round ids are written, in
+ *                increasing order. May be NULL if maxResults is 0.
+ * @param maxResults The size of results.
+ *
+ * @return The number of matching rounds (which may be bigger than
+ *         maxResults) on success, negative value on failure.
+ */
+EXPORT int index_query(const struct Index *index,
+                       const struct IndexTerm *terms, const int termsNumber,
+                       unsigned int *results, const int maxResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
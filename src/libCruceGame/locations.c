@@ -0,0 +1,349 @@
+/**
+ * @file locations.c
+ * @brief Contains implementations of the functions used to compute where
+ *        the cards a player does not see are.
+ */
+
+#include "locations.h"
+#include "round.h"
+#include "deck.h"
+#include "simulation.h"
+#include "errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Helper to get the cards of a suit.
+ *
+ * @return A bit mask with the ids of the cards of the suit set.
+ */
+static uint32_t suitCards(const enum Suit suit)
+{
+    return ((1u << SUIT_SIZE) - 1) << (suit * SUIT_SIZE);
+}
+
+/**
+ * @brief Helper to get the cards of a suit higher than a value.
+ *
+ * @return A bit mask with the ids of the cards set.
+ */
+static uint32_t higherCards(const enum Suit suit, const int value)
+{
+    uint32_t cards = 0;
+    for (int i = 0; i < SUIT_SIZE; i++)
+        if (VALUES[i] > value)
+            cards |= 1u << (suit * SUIT_SIZE + i);
+
+    return cards;
+}
+
+/**
+ * @brief Helper to remove from the cards a seat may hold the ones the seat
+ *        did not have when it put down its card in a hand, following the
+ *        rules of game_checkCard.
+ */
+static void addHandConstraints(struct Locations *locations,
+                               const struct Round *round,
+                               const struct Hand *hand, const int seat)
+{
+    const struct Card *first = hand->cards[0];
+    if (first == NULL)
+        return;
+
+    enum Suit trump = round->trump;
+    int maxFirstValue = first->value;
+    int maxTrumpValue = first->suit == trump ? first->value : -1;
+
+    for (int i = 1; i < MAX_GAME_PLAYERS; i++) {
+        const struct Card *card = hand->cards[i];
+        if (hand->players[i] == NULL || card == NULL)
+            break;
+
+        uint32_t excluded = 0;
+        if (card->suit != first->suit) {
+            excluded |= suitCards(first->suit);
+            if (trump != SuitEnd && card->suit != trump)
+                excluded |= suitCards(trump);
+            else if (trump != SuitEnd && card->value < maxTrumpValue)
+                excluded |= higherCards(trump, maxTrumpValue);
+        } else if (card->value < maxFirstValue &&
+                   (maxTrumpValue == -1 || first->suit == trump)) {
+            excluded |= higherCards(first->suit, maxFirstValue);
+        }
+
+        int index = round_findPlayerIndexRound(hand->players[i], round);
+        if (index >= 0 && index != seat)
+            locations->allowed[index] &= ~excluded;
+
+        if (card->suit == first->suit && card->value > maxFirstValue)
+            maxFirstValue = card->value;
+        if (card->suit == trump && card->value > maxTrumpValue)
+            maxTrumpValue = card->value;
+    }
+}
+
+int locations_fromGame(struct Locations *locations, const struct Game *game,
+                       const struct Player *player)
+{
+    if (locations == NULL)
+        return POINTER_NULL;
+    if (game == NULL)
+        return GAME_NULL;
+    if (player == NULL)
+        return PLAYER_NULL;
+    if (game->round == NULL)
+        return ROUND_NULL;
+
+    const struct Round *round = game->round;
+    int seat = round_findPlayerIndexRound(player, round);
+    if (seat < 0)
+        return NOT_FOUND;
+
+    uint32_t unknown = (1u << DECK_SIZE) - 1;
+    int playersNumber = 0;
+    memset(locations, 0, sizeof(struct Locations));
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (round->players[i] == NULL)
+            continue;
+        playersNumber++;
+        for (int j = 0; j < MAX_CARDS; j++) {
+            const struct Card *card = round->players[i]->hand[j];
+            if (card == NULL)
+                continue;
+            if (i == seat)
+                unknown &= ~(1u << deck_cardId(card));
+            else
+                locations->sizes[i]++;
+        }
+    }
+    if (game->deck != NULL)
+        locations->sizes[LOCATIONS_STOCK] = deck_cardsNumber(game->deck);
+
+    for (int i = 0; i < MAX_HANDS && round->hands[i] != NULL; i++)
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++)
+            if (round->hands[i]->cards[j] != NULL)
+                unknown &= ~(1u << deck_cardId(round->hands[i]->cards[j]));
+
+    locations->unknown = unknown;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (round->players[i] != NULL && i != seat)
+            locations->allowed[i] = unknown;
+    locations->allowed[LOCATIONS_STOCK] = unknown;
+
+    // A seat may have been dealt any card after a hand, so only the hands
+    // put down since the last cards were dealt tell what it holds.
+    int dealt = DECK_SIZE / playersNumber < MAX_CARDS ?
+                DECK_SIZE / playersNumber : MAX_CARDS;
+    int dealsNumber = (DECK_SIZE - playersNumber * dealt -
+                       locations->sizes[LOCATIONS_STOCK]) / playersNumber;
+    for (int i = dealsNumber; i < MAX_HANDS && round->hands[i] != NULL; i++)
+        addHandConstraints(locations, round, round->hands[i], seat);
+
+    return NO_ERROR;
+}
+
+/**
+ * @struct DealCounts
+ * @brief The numbers of deals which agree with a knowledge, by card and
+ *        state. A state is the number of cards dealt to every holder,
+ *        written in a mixed radix.
+ *
+ * @var DealCounts::cards
+ *     The ids of the unknown cards, in the order they are dealt.
+ * @var DealCounts::cardsNumber
+ *     The number of unknown cards.
+ * @var DealCounts::strides
+ *     The weight of the number of cards of every holder in a state.
+ * @var DealCounts::statesNumber
+ *     The number of states.
+ * @var DealCounts::after
+ *     after[i * statesNumber + s] is the number of ways to deal the cards i
+ *     to cardsNumber - 1 from state s.
+ * @var DealCounts::room
+ *     For every state, a bit mask with bit h set if holder h may be dealt
+ *     one more card.
+ */
+struct DealCounts {
+    int cards[DECK_SIZE];
+    int cardsNumber;
+    int strides[LOCATIONS_HOLDERS];
+    int statesNumber;
+    uint64_t *after;
+    unsigned char *room;
+};
+
+/**
+ * @brief Helper to count the deals which agree with a knowledge.
+ *
+ * @param extraRows The number of rows of DealCounts::statesNumber counts
+ *                  allocated after DealCounts::after for the caller.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int countDeals(const struct Locations *locations,
+                      struct DealCounts *counts, const int extraRows)
+{
+    counts->cardsNumber = 0;
+    for (int i = 0; i < DECK_SIZE; i++)
+        if (locations->unknown & (1u << i))
+            counts->cards[counts->cardsNumber++] = i;
+
+    int sizesSum = 0;
+    counts->statesNumber = 1;
+    for (int i = 0; i < LOCATIONS_HOLDERS; i++) {
+        if (locations->sizes[i] < 0)
+            return ILLEGAL_VALUE;
+        counts->strides[i] = counts->statesNumber;
+        counts->statesNumber *= locations->sizes[i] + 1;
+        sizesSum += locations->sizes[i];
+    }
+    if (sizesSum != counts->cardsNumber)
+        return ILLEGAL_VALUE;
+
+    int statesNumber = counts->statesNumber;
+    int rowsNumber = counts->cardsNumber + 1;
+    counts->after = malloc(sizeof(uint64_t) * statesNumber *
+                           (rowsNumber + extraRows));
+    counts->room = malloc(statesNumber);
+    if (counts->after == NULL || counts->room == NULL) {
+        free(counts->after);
+        free(counts->room);
+        return MALLOC_ERROR;
+    }
+
+    for (int s = 0; s < statesNumber; s++) {
+        counts->room[s] = 0;
+        for (int i = 0; i < LOCATIONS_HOLDERS; i++)
+            if (s / counts->strides[i] % (locations->sizes[i] + 1) <
+                locations->sizes[i])
+                counts->room[s] |= 1 << i;
+    }
+
+    uint64_t *after = counts->after;
+    memset(after, 0, sizeof(uint64_t) * statesNumber * rowsNumber);
+    after[(rowsNumber - 1) * statesNumber + statesNumber - 1] = 1;
+    for (int i = counts->cardsNumber - 1; i >= 0; i--) {
+        uint64_t *row = after + i * statesNumber;
+        const uint64_t *nextRow = row + statesNumber;
+        for (int s = 0; s < statesNumber; s++)
+            for (int h = 0; h < LOCATIONS_HOLDERS; h++)
+                if ((counts->room[s] >> h & 1) &&
+                    (locations->allowed[h] >> counts->cards[i] & 1))
+                    row[s] += nextRow[s + counts->strides[h]];
+    }
+
+    return NO_ERROR;
+}
+
+int locations_computeProbabilities(const struct Locations *locations,
+                                   double probabilities
+                                   [LOCATIONS_HOLDERS][DECK_SIZE],
+                                   uint64_t *dealsNumber)
+{
+    if (locations == NULL || probabilities == NULL)
+        return POINTER_NULL;
+
+    // before: the number of ways to deal the cards 0 to i - 1 to state s.
+    struct DealCounts counts;
+    int error = countDeals(locations, &counts, 2);
+    if (error != NO_ERROR)
+        return error;
+
+    int statesNumber = counts.statesNumber;
+    uint64_t *before = counts.after + (counts.cardsNumber + 1) *
+                                      statesNumber;
+    uint64_t *next = before + statesNumber;
+    uint64_t deals = counts.after[0];
+    if (dealsNumber != NULL)
+        *dealsNumber = deals;
+    memset(probabilities, 0, sizeof(double) * LOCATIONS_HOLDERS * DECK_SIZE);
+    if (deals == 0) {
+        free(counts.after);
+        free(counts.room);
+        return NOT_FOUND;
+    }
+
+    memset(before, 0, sizeof(uint64_t) * statesNumber);
+    before[0] = 1;
+    for (int i = 0; i < counts.cardsNumber; i++) {
+        const uint64_t *nextRow = counts.after + (i + 1) * statesNumber;
+        int card = counts.cards[i];
+        uint64_t cardCounts[LOCATIONS_HOLDERS] = {0};
+        memset(next, 0, sizeof(uint64_t) * statesNumber);
+        for (int s = 0; s < statesNumber; s++) {
+            if (before[s] == 0)
+                continue;
+            for (int h = 0; h < LOCATIONS_HOLDERS; h++)
+                if ((counts.room[s] >> h & 1) &&
+                    (locations->allowed[h] >> card & 1)) {
+                    int stride = counts.strides[h];
+                    cardCounts[h] += before[s] * nextRow[s + stride];
+                    next[s + stride] += before[s];
+                }
+        }
+        for (int h = 0; h < LOCATIONS_HOLDERS; h++)
+            probabilities[h][card] = (double)cardCounts[h] / deals;
+
+        uint64_t *swap = before;
+        before = next;
+        next = swap;
+    }
+
+    free(counts.after);
+    free(counts.room);
+
+    return NO_ERROR;
+}
+
+int locations_sampleDeals(const struct Locations *locations,
+                          uint32_t deals[][LOCATIONS_HOLDERS],
+                          const int dealsNumber, uint64_t *random)
+{
+    if (locations == NULL || deals == NULL || random == NULL)
+        return POINTER_NULL;
+    if (dealsNumber < 0)
+        return ILLEGAL_VALUE;
+
+    struct DealCounts counts;
+    int error = countDeals(locations, &counts, 0);
+    if (error != NO_ERROR)
+        return error;
+
+    int statesNumber = counts.statesNumber;
+    if (counts.after[0] == 0) {
+        free(counts.after);
+        free(counts.room);
+        return NOT_FOUND;
+    }
+
+    // Every card goes to a holder with a probability proportional to the
+    // number of deals of the next cards, so every deal is equally likely.
+    for (int i = 0; i < dealsNumber; i++) {
+        int s = 0;
+        memset(deals[i], 0, sizeof(deals[i]));
+        for (int j = 0; j < counts.cardsNumber; j++) {
+            const uint64_t *nextRow = counts.after + (j + 1) * statesNumber;
+            int card = counts.cards[j];
+            uint64_t chosen = simulation_random(random) %
+                              counts.after[j * statesNumber + s];
+            int h = 0;
+            for (; h < LOCATIONS_HOLDERS - 1; h++) {
+                if (!(counts.room[s] >> h & 1) ||
+                    !(locations->allowed[h] >> card & 1))
+                    continue;
+                uint64_t ways = nextRow[s + counts.strides[h]];
+                if (chosen < ways)
+                    break;
+                chosen -= ways;
+            }
+            deals[i][h] |= 1u << card;
+            s += counts.strides[h];
+        }
+    }
+
+    free(counts.after);
+    free(counts.room);
+
+    return NO_ERROR;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file locations.h
+ * @brief Functions used to compute, for a player, the probability that
+ *        every other seat holds every card, from what the player saw of the
+ *        round.
+ *
+ * The cards the player does not see are dealt to the other seats and to the
+ * deck. The cards a seat put down tell which suits it did not have: a seat
+ * which does not follow the suit has none of it, a seat which does not cut
+ * either has no trump, and a seat which does not beat the hand has no
+ * higher card of the suit (see game_checkCard). All the deals which agree
+ * with them are counted exactly, one card after the other, with a dynamic
+ * program over the number of cards still free in every hand, so every
+ * probability is a ratio of two counts of deals.
+ */
+
+#ifndef LOCATIONS_H
+#define LOCATIONS_H
+
+#include "platform.h"
+#include "constants.h"
+#include "game.h"
+
+#include <stdint.h>
+
+/**
+ * @brief The index of the deck among the holders of the cards, after the
+ *        seats.
+ */
+#define LOCATIONS_STOCK MAX_GAME_PLAYERS
+
+/**
+ * @brief The number of holders of the cards: the seats and the deck.
+ */
+#define LOCATIONS_HOLDERS (MAX_GAME_PLAYERS + 1)
+
+/**
+ * @struct Locations
+ * @brief What a player knows about the cards it does not see.
+ *
+ * @var Locations::unknown
+ *     A bit mask with bit id set if the player does not know where the
+ *     card id is.
+ * @var Locations::allowed
+ *     For every holder, a bit mask with bit id set if it may hold the card
+ *     id.
+ * @var Locations::sizes
+ *     For every holder, the number of cards of Locations::unknown it
+ *     holds.
+ */
+struct Locations {
+    uint32_t unknown;
+    uint32_t allowed[LOCATIONS_HOLDERS];
+    int sizes[LOCATIONS_HOLDERS];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Gathers what a player of a game knows about the cards it does not
+ *        see: the size of every hand and of the deck, and the suits the
+ *        cards put down since the last cards were dealt show a seat does not
+ *        have.
+ *
+ * @param locations Where the knowledge is stored.
+ * @param game The game.
+ * @param player The player, a player of the round of the game.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int locations_fromGame(struct Locations *locations,
+                              const struct Game *game,
+                              const struct Player *player);
+
+/**
+ * @brief Computes the probability that every holder holds every card of
+ *        Locations::unknown, all the deals which agree with the knowledge
+ *        being equally likely.
+ *
+ * @param locations The knowledge.
+ * @param probabilities Where the probability that holder h holds card id
+ *                      is stored, in probabilities[h][id]. It is 0 for the
+ *                      cards which are not in Locations::unknown.
+ * @param dealsNumber Where the number of deals which agree with the
+ *                    knowledge is stored, if it is not NULL.
+ *
+ * @return \ref NO_ERROR on success, \ref NOT_FOUND if no deal agrees with
+ *         the knowledge, other value on failure.
+ */
+EXPORT int locations_computeProbabilities(const struct Locations *locations,
+                                          double probabilities
+                                          [LOCATIONS_HOLDERS][DECK_SIZE],
+                                          uint64_t *dealsNumber);
+
+/**
+ * @brief Deals the unknown cards at random, every deal which agrees with
+ *        the knowledge being equally likely.
+ *
+ * @param locations The knowledge.
+ * @param deals Where the deals are stored: deals[i][h] is a bit mask with
+ *              bit id set if holder h holds the card id in deal i.
+ * @param dealsNumber The number of deals.
+ * @param random The state of the generator (see simulation_random),
+ *               updated.
+ *
+ * @return \ref NO_ERROR on success, \ref NOT_FOUND if no deal agrees with
+ *         the knowledge, other value on failure.
+ */
+EXPORT int locations_sampleDeals(const struct Locations *locations,
+                                 uint32_t deals[][LOCATIONS_HOLDERS],
+                                 const int dealsNumber, uint64_t *random);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,485 @@
+/**
+ * @file network.c
+ * @brief Contains implementations of the functions used to evaluate, train
+ *        and save a policy and value network.
+ */
+
+#include "network.h"
+#include "simulation.h"
+#include "round.h"
+#include "deck.h"
+#include "errors.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NETWORK_SSE2
+#endif
+
+/**
+ * @brief The offsets of the features of a position.
+ */
+#define FEATURES_HAND 0
+#define FEATURES_PLAYED (FEATURES_HAND + DECK_SIZE)
+#define FEATURES_TABLE (FEATURES_PLAYED + DECK_SIZE)
+#define FEATURES_TRUMP (FEATURES_TABLE + DECK_SIZE)
+#define FEATURES_BID (FEATURES_TRUMP + SuitEnd)
+#define FEATURES_BID_WINNER (FEATURES_BID + 1)
+#define FEATURES_POINTS (FEATURES_BID_WINNER + 1)
+#define FEATURES_PLAYERS (FEATURES_POINTS + 1)
+
+/**
+ * @brief The points a player is expected to make at most in a round, used
+ *        to scale the points of a position.
+ */
+#define ROUND_POINTS 120.0f
+
+/**
+ * @brief The constants of Adam.
+ */
+#define ADAM_BETA1 0.9
+#define ADAM_BETA2 0.999
+#define ADAM_EPSILON 1e-8
+
+static const unsigned char MAGIC[] = {'C', 'G', 'N', 1};
+
+/**
+ * @brief Helper to compute the dot product of two vectors.
+ */
+static float dot(const float *a, const float *b, const int n)
+{
+    int i = 0;
+    float sum = 0;
+#ifdef NETWORK_SSE2
+    __m128 sums = _mm_setzero_ps();
+    for (; i + 4 <= n; i += 4)
+        sums = _mm_add_ps(sums, _mm_mul_ps(_mm_loadu_ps(a + i),
+                                           _mm_loadu_ps(b + i)));
+    float parts[4];
+    _mm_storeu_ps(parts, sums);
+    sum = (parts[0] + parts[1]) + (parts[2] + parts[3]);
+#endif
+    for (; i < n; i++)
+        sum += a[i] * b[i];
+
+    return sum;
+}
+
+/**
+ * @brief Helper to add a multiple of a vector to another one.
+ */
+static void addScaled(float *y, const float a, const float *x, const int n)
+{
+    int i = 0;
+#ifdef NETWORK_SSE2
+    __m128 scale = _mm_set1_ps(a);
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i),
+                                        _mm_mul_ps(scale,
+                                                   _mm_loadu_ps(x + i))));
+#endif
+    for (; i < n; i++)
+        y[i] += a * x[i];
+}
+
+/**
+ * @brief Helper to count the parameters of a network with the given sizes.
+ */
+static size_t countParameters(const int *sizes, const int layersNumber)
+{
+    size_t parametersNumber = 0;
+    for (int i = 0; i < layersNumber; i++)
+        parametersNumber += (size_t)(sizes[i] + 1) * sizes[i + 1];
+
+    return parametersNumber;
+}
+
+/**
+ * @brief Helper to allocate a network with the given sizes.
+ *
+ * @return Pointer to the new network on success or NULL on failure.
+ */
+static struct Network *allocateNetwork(const int *sizes,
+                                       const int layersNumber)
+{
+    if (layersNumber < 1 || layersNumber > NETWORK_MAX_LAYERS ||
+        sizes[0] != NETWORK_FEATURES ||
+        sizes[layersNumber] != NETWORK_OUTPUTS)
+        return NULL;
+    for (int i = 1; i < layersNumber; i++)
+        if (sizes[i] < 1 || sizes[i] > NETWORK_MAX_WIDTH)
+            return NULL;
+
+    struct Network *network = malloc(sizeof(struct Network));
+    if (network == NULL)
+        return NULL;
+
+    network->layersNumber = layersNumber;
+    memset(network->sizes, 0, sizeof(network->sizes));
+    memcpy(network->sizes, sizes, sizeof(int) * (layersNumber + 1));
+    network->parametersNumber = countParameters(sizes, layersNumber);
+    network->parameters = calloc(network->parametersNumber, sizeof(float));
+    if (network->parameters == NULL) {
+        free(network);
+        return NULL;
+    }
+
+    return network;
+}
+
+/**
+ * @brief Helper to compute the activations of every layer.
+ *
+ * @param network The network.
+ * @param features The features.
+ * @param activations Where the activations of every layer are stored, one
+ *                    row for the features and one for every layer.
+ */
+static void forward(const struct Network *network,
+                    const float features[NETWORK_FEATURES],
+                    float activations[][NETWORK_MAX_WIDTH])
+{
+    memcpy(activations[0], features, sizeof(float) * NETWORK_FEATURES);
+
+    const float *parameters = network->parameters;
+    for (int l = 0; l < network->layersNumber; l++) {
+        int inputs = network->sizes[l];
+        int outputs = network->sizes[l + 1];
+        const float *biases = parameters + inputs * outputs;
+        int hidden = l + 1 < network->layersNumber;
+        for (int o = 0; o < outputs; o++) {
+            float sum = dot(parameters + o * inputs, activations[l], inputs) +
+                        biases[o];
+            activations[l + 1][o] = hidden && sum < 0 ? 0 : sum;
+        }
+        parameters = biases + outputs;
+    }
+}
+
+/**
+ * @brief Helper to compute the probabilities of the allowed cards from the
+ *        logits of the policy.
+ */
+static void softmax(const float *logits, const uint32_t allowed,
+                    float probabilities[DECK_SIZE])
+{
+    float maxLogit = -HUGE_VALF;
+    for (int i = 0; i < DECK_SIZE; i++)
+        if ((allowed >> i & 1) && logits[i] > maxLogit)
+            maxLogit = logits[i];
+
+    float sum = 0;
+    for (int i = 0; i < DECK_SIZE; i++) {
+        probabilities[i] = allowed >> i & 1 ? expf(logits[i] - maxLogit) : 0;
+        sum += probabilities[i];
+    }
+    for (int i = 0; i < DECK_SIZE; i++)
+        probabilities[i] /= sum;
+}
+
+struct Network *network_createNetwork(const int *hiddenSizes,
+                                      const int hiddenNumber,
+                                      const uint64_t seed)
+{
+    if (hiddenNumber < 0 || hiddenNumber >= NETWORK_MAX_LAYERS ||
+        (hiddenSizes == NULL && hiddenNumber > 0))
+        return NULL;
+
+    int sizes[NETWORK_MAX_LAYERS + 1];
+    sizes[0] = NETWORK_FEATURES;
+    for (int i = 0; i < hiddenNumber; i++)
+        sizes[i + 1] = hiddenSizes[i];
+    sizes[hiddenNumber + 1] = NETWORK_OUTPUTS;
+
+    struct Network *network = allocateNetwork(sizes, hiddenNumber + 1);
+    if (network == NULL)
+        return NULL;
+
+    // Uniform weights which keep the variance of the rectified layers.
+    uint64_t random = simulation_seed(seed, 0);
+    float *parameters = network->parameters;
+    for (int l = 0; l < network->layersNumber; l++) {
+        int inputs = network->sizes[l];
+        int outputs = network->sizes[l + 1];
+        double bound = sqrt(6.0 / inputs);
+        for (int i = 0; i < inputs * outputs; i++)
+            parameters[i] = (float)(((simulation_random(&random) >> 11) *
+                                     (2.0 / 9007199254740992.0) - 1) * bound);
+        parameters += (inputs + 1) * outputs;
+    }
+
+    return network;
+}
+
+int network_deleteNetwork(struct Network **network)
+{
+    if (network == NULL)
+        return POINTER_NULL;
+    if (*network == NULL)
+        return NETWORK_NULL;
+
+    free((*network)->parameters);
+    free(*network);
+    *network = NULL;
+
+    return NO_ERROR;
+}
+
+int network_encodePosition(float features[NETWORK_FEATURES],
+                           uint32_t *allowed, const struct Game *game,
+                           struct Player *player, struct Hand *hand)
+{
+    if (features == NULL || allowed == NULL)
+        return POINTER_NULL;
+    if (game == NULL)
+        return GAME_NULL;
+    if (player == NULL)
+        return PLAYER_NULL;
+    if (hand == NULL)
+        return HAND_NULL;
+    const struct Round *round = game->round;
+    if (round == NULL)
+        return ROUND_NULL;
+
+    memset(features, 0, sizeof(float) * NETWORK_FEATURES);
+    *allowed = 0;
+    for (int i = 0; i < MAX_CARDS; i++) {
+        if (player->hand[i] == NULL)
+            continue;
+        int id = deck_cardId(player->hand[i]);
+        if (id < 0)
+            return id;
+        features[FEATURES_HAND + id] = 1;
+        if (game_checkCard(player, game, hand, i) == 1)
+            *allowed |= 1u << id;
+    }
+
+    for (int i = 0; i < MAX_HANDS && round->hands[i] != NULL; i++) {
+        int offset = round->hands[i] == hand ? FEATURES_TABLE :
+                     FEATURES_PLAYED;
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++)
+            if (round->hands[i]->cards[j] != NULL)
+                features[offset + deck_cardId(round->hands[i]->cards[j])] = 1;
+    }
+
+    if (round->trump < SuitEnd)
+        features[FEATURES_TRUMP + round->trump] = 1;
+
+    int maxBid = 0;
+    int playersNumber = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (round->players[i] == NULL)
+            continue;
+        playersNumber++;
+        if (round->bids[i] > maxBid)
+            maxBid = round->bids[i];
+        if (round->players[i] == player)
+            features[FEATURES_POINTS] = round->pointsNumber[i] /
+                                        ROUND_POINTS;
+    }
+    features[FEATURES_BID] = maxBid / 6.0f;
+    features[FEATURES_BID_WINNER] = maxBid > 0 &&
+                                    round_getBidWinner(round) == player;
+    features[FEATURES_PLAYERS] = (float)playersNumber / MAX_GAME_PLAYERS;
+
+    return NO_ERROR;
+}
+
+int network_evaluate(const struct Network *network,
+                     const float features[NETWORK_FEATURES],
+                     const uint32_t allowed, float outputs[NETWORK_OUTPUTS])
+{
+    if (network == NULL)
+        return NETWORK_NULL;
+    if (features == NULL || outputs == NULL)
+        return POINTER_NULL;
+    if ((allowed & ((1u << DECK_SIZE) - 1)) == 0)
+        return ILLEGAL_VALUE;
+
+    float activations[NETWORK_MAX_LAYERS + 1][NETWORK_MAX_WIDTH];
+    forward(network, features, activations);
+
+    const float *logits = activations[network->layersNumber];
+    softmax(logits, allowed, outputs);
+    outputs[DECK_SIZE] = logits[DECK_SIZE];
+
+    return NO_ERROR;
+}
+
+double network_addGradients(const struct Network *network,
+                            const struct NetworkExample *example,
+                            float *gradients)
+{
+    if (network == NULL)
+        return NETWORK_NULL;
+    if (example == NULL || gradients == NULL)
+        return POINTER_NULL;
+    if (example->card < 0 || example->card >= DECK_SIZE ||
+        !(example->allowed >> example->card & 1))
+        return ILLEGAL_VALUE;
+
+    float activations[NETWORK_MAX_LAYERS + 1][NETWORK_MAX_WIDTH];
+    forward(network, example->features, activations);
+
+    int layersNumber = network->layersNumber;
+    const float *logits = activations[layersNumber];
+    float deltas[NETWORK_MAX_WIDTH];
+    softmax(logits, example->allowed, deltas);
+    double loss = -log(deltas[example->card] > 1e-30f ?
+                       deltas[example->card] : 1e-30f);
+    deltas[example->card] -= 1;
+    deltas[DECK_SIZE] = logits[DECK_SIZE] - example->value;
+    loss += 0.5 * deltas[DECK_SIZE] * deltas[DECK_SIZE];
+
+    // The parameters of the layers, from the last one to the first one.
+    size_t offset = network->parametersNumber;
+    for (int l = layersNumber - 1; l >= 0; l--) {
+        int inputs = network->sizes[l];
+        int outputs = network->sizes[l + 1];
+        offset -= (size_t)(inputs + 1) * outputs;
+        const float *weights = network->parameters + offset;
+        float *weightGradients = gradients + offset;
+        float *biasGradients = weightGradients + inputs * outputs;
+
+        float previous[NETWORK_MAX_WIDTH];
+        if (l > 0)
+            memset(previous, 0, sizeof(float) * inputs);
+        for (int o = 0; o < outputs; o++) {
+            if (deltas[o] == 0)
+                continue;
+            biasGradients[o] += deltas[o];
+            addScaled(weightGradients + o * inputs, deltas[o],
+                      activations[l], inputs);
+            if (l > 0)
+                addScaled(previous, deltas[o], weights + o * inputs, inputs);
+        }
+
+        if (l > 0)
+            for (int i = 0; i < inputs; i++)
+                deltas[i] = activations[l][i] > 0 ? previous[i] : 0;
+    }
+
+    return loss;
+}
+
+int network_adamStep(struct Network *network, const float *gradients,
+                     float *moments, const long step, const double rate)
+{
+    if (network == NULL)
+        return NETWORK_NULL;
+    if (gradients == NULL || moments == NULL)
+        return POINTER_NULL;
+    if (step < 1 || !(rate > 0))
+        return ILLEGAL_VALUE;
+
+    double correction1 = 1 - pow(ADAM_BETA1, (double)step);
+    double correction2 = 1 - pow(ADAM_BETA2, (double)step);
+    float scale = (float)(rate * sqrt(correction2) / correction1);
+    float epsilon = (float)(ADAM_EPSILON * sqrt(correction2));
+
+    float *first = moments;
+    float *second = moments + network->parametersNumber;
+    for (size_t i = 0; i < network->parametersNumber; i++) {
+        float gradient = gradients[i];
+        first[i] = (float)ADAM_BETA1 * first[i] +
+                   (float)(1 - ADAM_BETA1) * gradient;
+        second[i] = (float)ADAM_BETA2 * second[i] +
+                    (float)(1 - ADAM_BETA2) * gradient * gradient;
+        network->parameters[i] -= scale * first[i] /
+                                  (sqrtf(second[i]) + epsilon);
+    }
+
+    return NO_ERROR;
+}
+
+size_t network_savedSize(const struct Network *network)
+{
+    if (network == NULL)
+        return 0;
+
+    return sizeof(MAGIC) + 4 * (network->layersNumber + 2) +
+           4 * network->parametersNumber;
+}
+
+/**
+ * @brief Helpers to write and read a number on four bytes.
+ */
+static void putNumber(unsigned char *buffer, const uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        buffer[i] = (value >> (8 * i)) & 0xFF;
+}
+
+static uint32_t getNumber(const unsigned char *buffer)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= (uint32_t)buffer[i] << (8 * i);
+
+    return value;
+}
+
+long network_writeNetwork(const struct Network *network,
+                          unsigned char *buffer, const size_t size)
+{
+    if (network == NULL)
+        return NETWORK_NULL;
+    if (buffer == NULL)
+        return POINTER_NULL;
+
+    size_t length = network_savedSize(network);
+    if (length > size)
+        return FULL;
+
+    memcpy(buffer, MAGIC, sizeof(MAGIC));
+    unsigned char *position = buffer + sizeof(MAGIC);
+    putNumber(position, network->layersNumber);
+    position += 4;
+    for (int i = 0; i <= network->layersNumber; i++, position += 4)
+        putNumber(position, network->sizes[i]);
+    for (size_t i = 0; i < network->parametersNumber; i++, position += 4) {
+        uint32_t bits;
+        memcpy(&bits, &network->parameters[i], 4);
+        putNumber(position, bits);
+    }
+
+    return (long)length;
+}
+
+struct Network *network_readNetwork(const unsigned char *buffer,
+                                    const size_t length)
+{
+    if (buffer == NULL || length < sizeof(MAGIC) + 4 ||
+        memcmp(buffer, MAGIC, sizeof(MAGIC)) != 0)
+        return NULL;
+
+    const unsigned char *position = buffer + sizeof(MAGIC);
+    uint32_t layersNumber = getNumber(position);
+    position += 4;
+    if (layersNumber < 1 || layersNumber > NETWORK_MAX_LAYERS ||
+        length < sizeof(MAGIC) + 4 * (layersNumber + 2))
+        return NULL;
+
+    int sizes[NETWORK_MAX_LAYERS + 1];
+    for (uint32_t i = 0; i <= layersNumber; i++, position += 4)
+        sizes[i] = getNumber(position) > NETWORK_MAX_WIDTH ? -1 :
+                   (int)getNumber(position);
+
+    struct Network *network = allocateNetwork(sizes, layersNumber);
+    if (network == NULL)
+        return NULL;
+    if (network_savedSize(network) != length) {
+        network_deleteNetwork(&network);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < network->parametersNumber; i++, position += 4) {
+        uint32_t bits = getNumber(position);
+        memcpy(&network->parameters[i], &bits, 4);
+    }
+
+    return network;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file network.h
+ * @brief Network structure, a small policy and value network for bots, as
+ *        well as the functions used to evaluate it, to train it and to
+ *        save it.
+ *
+ * The network is a perceptron with rectified hidden layers. It reads the
+ * features of a position (see network_encodePosition) and gives a logit
+ * for every card, the policy, and the share of the points of the round
+ * the player is expected to make, the value. The parameters of every
+ * layer are its weights, row by row, followed by its biases, and the
+ * layers follow one another in Network::parameters, so a trainer handles
+ * them, and their gradients, as a single array.
+ *
+ * A saved network starts with the bytes 'C', 'G', 'N' and the version of
+ * the format, followed by the number of layers and the size of every
+ * layer, from the features to the outputs. The parameters follow. Numbers
+ * are written on four bytes, little endian, and the parameters as IEEE 754
+ * single precision numbers.
+ */
+
+#ifndef NETWORK_H
+#define NETWORK_H
+
+#include "platform.h"
+#include "game.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The number of features of a position.
+ */
+#define NETWORK_FEATURES 80
+
+/**
+ * @brief The number of outputs of a network: a logit for every card,
+ *        followed by the value.
+ */
+#define NETWORK_OUTPUTS (DECK_SIZE + 1)
+
+/**
+ * @brief The maximum number of layers of a network, without the features.
+ */
+#define NETWORK_MAX_LAYERS 4
+
+/**
+ * @brief The maximum size of a hidden layer.
+ */
+#define NETWORK_MAX_WIDTH 256
+
+/**
+ * @struct Network
+ * @brief A policy and value network.
+ *
+ * @var Network::layersNumber
+ *     The number of layers, without the features.
+ * @var Network::sizes
+ *     The size of the features, followed by the size of every layer.
+ * @var Network::parameters
+ *     The weights and biases of every layer.
+ * @var Network::parametersNumber
+ *     The number of parameters.
+ */
+struct Network {
+    int layersNumber;
+    int sizes[NETWORK_MAX_LAYERS + 1];
+    float *parameters;
+    size_t parametersNumber;
+};
+
+/**
+ * @struct NetworkExample
+ * @brief A position the network is trained on.
+ *
+ * @var NetworkExample::features
+ *     The features of the position.
+ * @var NetworkExample::allowed
+ *     A bit mask with bit id set if the card id may be put down.
+ * @var NetworkExample::card
+ *     The id of the card which was put down.
+ * @var NetworkExample::value
+ *     The share of the points of the round the player made.
+ */
+struct NetworkExample {
+    float features[NETWORK_FEATURES];
+    uint32_t allowed;
+    int card;
+    float value;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates a network with random weights and biases equal to 0.
+ *
+ * @param hiddenSizes The size of every hidden layer, at most
+ *                    \ref NETWORK_MAX_WIDTH.
+ * @param hiddenNumber The number of hidden layers, less than
+ *                     \ref NETWORK_MAX_LAYERS.
+ * @param seed The seed of the weights.
+ *
+ * @return Pointer to the new network on success or NULL on failure.
+ */
+EXPORT struct Network *network_createNetwork(const int *hiddenSizes,
+                                             const int hiddenNumber,
+                                             const uint64_t seed);
+
+/**
+ * @brief Frees the memory of a network and sets the pointer to NULL.
+ *
+ * @param network Pointer to the pointer to be freed.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int network_deleteNetwork(struct Network **network);
+
+/**
+ * @brief Computes the features of a position and the cards a player may
+ *        put down in it.
+ *
+ * @param features Where the features are stored.
+ * @param allowed Where the bit mask of the cards the player may put down
+ *                is stored.
+ * @param game The game.
+ * @param player The player who puts down the next card.
+ * @param hand The hand in which the card is put down.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int network_encodePosition(float features[NETWORK_FEATURES],
+                                  uint32_t *allowed, const struct Game *game,
+                                  struct Player *player, struct Hand *hand);
+
+/**
+ * @brief Evaluates a position.
+ *
+ * @param network The network.
+ * @param features The features of the position.
+ * @param allowed The bit mask of the cards which may be put down.
+ * @param outputs Where the probability of every card, 0 for the cards
+ *                which may not be put down, and the value are stored.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int network_evaluate(const struct Network *network,
+                            const float features[NETWORK_FEATURES],
+                            const uint32_t allowed,
+                            float outputs[NETWORK_OUTPUTS]);
+
+/**
+ * @brief Adds the gradients of the loss of an example to the gradients of
+ *        a minibatch. The loss is the cross entropy of the card put down,
+ *        plus half the square of the error of the value.
+ *
+ * @param network The network.
+ * @param example The example.
+ * @param gradients The gradients, one for every parameter.
+ *
+ * @return The loss on success, negative value on failure.
+ */
+EXPORT double network_addGradients(const struct Network *network,
+                                   const struct NetworkExample *example,
+                                   float *gradients);
+
+/**
+ * @brief Updates the parameters of a network with a step of Adam.
+ *
+ * @param network The network.
+ * @param gradients The mean gradients of a minibatch.
+ * @param moments The first and second moments of the gradients, two for
+ *                every parameter, equal to 0 before the first step.
+ * @param step The number of the step, starting from 1.
+ * @param rate The learning rate.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int network_adamStep(struct Network *network, const float *gradients,
+                            float *moments, const long step,
+                            const double rate);
+
+/**
+ * @brief Computes the size of a saved network.
+ *
+ * @param network The network.
+ *
+ * @return The size in bytes on success, 0 on failure.
+ */
+EXPORT size_t network_savedSize(const struct Network *network);
+
+/**
+ * @brief Saves a network.
+ *
+ * @param network The network.
+ * @param buffer Buffer where the network is written.
+ * @param size The size of the buffer, at least network_savedSize.
+ *
+ * @return The length of the saved network on success, \ref FULL if the
+ *         buffer is too small, other negative value on failure.
+ */
+EXPORT long network_writeNetwork(const struct Network *network,
+                                 unsigned char *buffer, const size_t size);
+
+/**
+ * @brief Loads a saved network.
+ *
+ * @param buffer The saved network.
+ * @param length The length of the saved network.
+ *
+ * @return Pointer to the new network on success or NULL on failure.
+ */
+EXPORT struct Network *network_readNetwork(const unsigned char *buffer,
+                                           const size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
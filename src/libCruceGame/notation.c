@@ -0,0 +1,719 @@
+/**
+ * @file notation.c
+ * @brief Contains implementations of the functions used to write and parse
+ *        rounds in the text notation.
+ */
+
+#include "notation.h"
+#include "errors.h"
+
+#include <string.h>
+
+/**
+ * Letters of the card values and suits.
+ */
+const char VALUE_LETTERS[] = "JQK9TA";
+const char SUIT_LETTERS[] = "DCSH";
+
+/**
+ * @brief Tags of the notation, in the order they are written.
+ */
+enum Tag {PLAYERS = 0, DEAL, BIDS, TRUMP, PLAY, MARRIAGES, POINTS, SCORES,
+          TagEnd};
+
+/**
+ * @brief States of a reader skipping a round longer than its buffer: not
+ *        skipping, at the start of a line before the round, at the start of
+ *        a line of the round, or inside a line of the round.
+ */
+enum Skip {SKIP_NONE = 0, SKIP_START, SKIP_CONTENT, SKIP_LINE};
+
+static const char *TAG_NAMES[] = {"Players", "Deal", "Bids", "Trump", "Play",
+                                  "Marriages", "Points", "Scores"};
+
+/**
+ * @brief Helper to write a tag name and the beginning of its value.
+ */
+static char *writeTagStart(char *text, const enum Tag tag)
+{
+    *text++ = '[';
+    for (const char *name = TAG_NAMES[tag]; *name != '\0'; name++)
+        *text++ = *name;
+    *text++ = ' ';
+    *text++ = '"';
+
+    return text;
+}
+
+/**
+ * @brief Helper to write the end of a tag line.
+ */
+static char *writeTagEnd(char *text)
+{
+    text[-1] = '"';
+    *text++ = ']';
+    *text++ = '\n';
+
+    return text;
+}
+
+char *notation_writeInt(char *text, const int value)
+{
+    char digits[12];
+    int length = 0;
+    unsigned int absolute = value < 0 ? -(unsigned int)value : value;
+
+    if (value < 0)
+        *text++ = '-';
+    do {
+        digits[length++] = '0' + absolute % 10;
+        absolute /= 10;
+    } while (absolute > 0);
+    while (length > 0)
+        *text++ = digits[--length];
+
+    return text;
+}
+
+char *notation_writeCard(char *text, const int cardId)
+{
+    if (cardId < 0 || cardId >= DECK_SIZE)
+        return NULL;
+
+    *text++ = VALUE_LETTERS[cardId % SUIT_SIZE];
+    *text++ = SUIT_LETTERS[cardId / SUIT_SIZE];
+
+    return text;
+}
+
+int notation_checkRecord(const struct RoundRecord *record)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+
+    int playersNumber = record->playersNumber;
+    if (playersNumber < 2 || playersNumber > MAX_GAME_PLAYERS ||
+        record->handsNumber > MAX_HANDS ||
+        record->handsNumber * playersNumber > DECK_SIZE)
+        return ILLEGAL_VALUE;
+
+    for (int i = 0; i < DECK_SIZE; i++)
+        if (record->deck[i] >= DECK_SIZE)
+            return ILLEGAL_VALUE;
+    for (int i = 0; i < record->handsNumber; i++) {
+        if (record->leaders[i] >= playersNumber ||
+            record->winners[i] >= playersNumber)
+            return ILLEGAL_VALUE;
+        for (int j = 0; j < playersNumber; j++)
+            if (record->cards[i][j] >= DECK_SIZE)
+                return ILLEGAL_VALUE;
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to write an integer followed by a space.
+ */
+static char *writeInt(char *text, const int value)
+{
+    text = notation_writeInt(text, value);
+    *text++ = ' ';
+
+    return text;
+}
+
+/**
+ * @brief Helper for notation_writeRound, writing in a buffer big enough
+ *        for any round.
+ */
+static int writeRound(const struct RoundRecord *record, char *text)
+{
+    char *start = text;
+    int playersNumber = record->playersNumber;
+
+    text = writeTagStart(text, PLAYERS);
+    for (int i = 0; i < playersNumber; i++) {
+        for (int j = 0; j < RECORD_NAME_LENGTH &&
+                        record->names[i][j] != '\0'; j++) {
+            char c = record->names[i][j];
+            if (c == ';' || c == '/' || c == '"' || c == '\n' || c == '\r')
+                c = '_';
+            *text++ = c;
+        }
+        *text++ = '/';
+        if (record->teams[i] < MAX_GAME_TEAMS)
+            *text++ = '0' + record->teams[i];
+        else
+            *text++ = '-';
+        *text++ = ';';
+    }
+    text = writeTagEnd(text);
+
+    text = writeTagStart(text, DEAL);
+    for (int i = 0; i < playersNumber; i++) {
+        for (int j = i; j < DECK_SIZE; j += playersNumber)
+            text = notation_writeCard(text, record->deck[j]);
+        *text++ = ' ';
+    }
+    text = writeTagEnd(text);
+
+    text = writeTagStart(text, BIDS);
+    for (int i = 0; i < playersNumber; i++)
+        text = writeInt(text, record->bids[i]);
+    text = writeTagEnd(text);
+
+    text = writeTagStart(text, TRUMP);
+    *text++ = record->trump < SuitEnd ? SUIT_LETTERS[record->trump] : '-';
+    *text++ = ' ';
+    text = writeTagEnd(text);
+
+    if (record->handsNumber > 0) {
+        text = writeTagStart(text, PLAY);
+        for (int i = 0; i < record->handsNumber; i++) {
+            for (int j = 0; j < playersNumber; j++)
+                text = notation_writeCard(text, record->cards[i][j]);
+            *text++ = ' ';
+        }
+        text = writeTagEnd(text);
+    }
+
+    text = writeTagStart(text, MARRIAGES);
+    for (int i = 0; i < playersNumber; i++) {
+        if (record->marriages[i] == 0)
+            *text++ = '-';
+        for (int j = 0; j < SuitEnd; j++)
+            if (record->marriages[i] & (1 << j))
+                *text++ = SUIT_LETTERS[j];
+        *text++ = ' ';
+    }
+    text = writeTagEnd(text);
+
+    text = writeTagStart(text, POINTS);
+    for (int i = 0; i < playersNumber; i++)
+        text = writeInt(text, record->pointsNumber[i]);
+    text = writeTagEnd(text);
+
+    text = writeTagStart(text, SCORES);
+    for (int i = 0; i < playersNumber; i++)
+        text = writeInt(text, record->scores[i]);
+    text = writeTagEnd(text);
+
+    *text++ = '\n';
+
+    return text - start;
+}
+
+int notation_writeRound(const struct RoundRecord *record, char *text,
+                        const size_t size)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (text == NULL)
+        return POINTER_NULL;
+    int error = notation_checkRecord(record);
+    if (error != NO_ERROR)
+        return error;
+
+    if (size >= NOTATION_MAX_ROUND_LENGTH)
+        return writeRound(record, text);
+
+    char buffer[NOTATION_MAX_ROUND_LENGTH];
+    int length = writeRound(record, buffer);
+    if ((size_t)length > size)
+        return FULL;
+    memcpy(text, buffer, length);
+
+    return length;
+}
+
+/**
+ * @brief Helper to find the id of a written card.
+ *
+ * @return The id of the card, negative value if the text is not a card.
+ */
+static int parseCard(const char *text)
+{
+    const char *value = memchr(VALUE_LETTERS, text[0], SUIT_SIZE);
+    const char *suit = memchr(SUIT_LETTERS, text[1], SuitEnd);
+    if (text[0] == '\0' || text[1] == '\0' || value == NULL || suit == NULL)
+        return SYNTAX_ERROR;
+
+    return (suit - SUIT_LETTERS) * SUIT_SIZE + (value - VALUE_LETTERS);
+}
+
+/**
+ * @brief Helper to parse the integers of a tag value, one for every seat.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int parseInts(const char *text, const size_t length, int *values,
+                     const int count)
+{
+    const char *end = text + length;
+    for (int i = 0; i < count; i++) {
+        while (text < end && *text == ' ')
+            text++;
+
+        int sign = 1;
+        if (text < end && *text == '-') {
+            sign = -1;
+            text++;
+        }
+        if (text == end || *text < '0' || *text > '9')
+            return SYNTAX_ERROR;
+
+        int value = 0;
+        while (text < end && *text >= '0' && *text <= '9' && value < 100000)
+            value = value * 10 + (*text++ - '0');
+        values[i] = sign * value;
+    }
+
+    while (text < end && *text == ' ')
+        text++;
+
+    return text == end ? NO_ERROR : SYNTAX_ERROR;
+}
+
+/**
+ * @brief Helper to check which card wins, with the rules of
+ *        deck_compareCards.
+ *
+ * @return 1 if the first card wins, 2 if the second card wins.
+ */
+static int compareCardIds(const int first, const int second,
+                          const int trump)
+{
+    int firstSuit = first / SUIT_SIZE;
+    int secondSuit = second / SUIT_SIZE;
+
+    if (firstSuit != secondSuit)
+        return secondSuit == trump ? 2 : 1;
+
+    return VALUES[first % SUIT_SIZE] > VALUES[second % SUIT_SIZE] ? 1 : 2;
+}
+
+/**
+ * @brief Helper to parse the players of a round.
+ */
+static int parsePlayers(struct RoundRecord *record, const char *text,
+                        const size_t length)
+{
+    const char *end = text + length;
+    int playersNumber = 0;
+
+    while (text < end) {
+        if (playersNumber == MAX_GAME_PLAYERS)
+            return SYNTAX_ERROR;
+
+        const char *separator = memchr(text, '/', end - text);
+        if (separator == NULL || separator + 1 == end)
+            return SYNTAX_ERROR;
+
+        size_t nameLength = separator - text;
+        if (nameLength > RECORD_NAME_LENGTH - 1)
+            nameLength = RECORD_NAME_LENGTH - 1;
+        memcpy(record->names[playersNumber], text, nameLength);
+        record->names[playersNumber][nameLength] = '\0';
+
+        char team = separator[1];
+        if (team == '-')
+            record->teams[playersNumber] = MAX_GAME_TEAMS;
+        else if (team >= '0' && team < '0' + MAX_GAME_TEAMS)
+            record->teams[playersNumber] = team - '0';
+        else
+            return SYNTAX_ERROR;
+
+        text = separator + 2;
+        if (text < end && *text++ != ';')
+            return SYNTAX_ERROR;
+        playersNumber++;
+    }
+
+    if (playersNumber < 2)
+        return SYNTAX_ERROR;
+    record->playersNumber = playersNumber;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to parse the deal of a round.
+ */
+static int parseDeal(struct RoundRecord *record, const char *text,
+                     const size_t length)
+{
+    int playersNumber = record->playersNumber;
+    int cardsNumber = DECK_SIZE / playersNumber;
+    int handLength = 2 * cardsNumber;
+    unsigned int seen = 0;
+
+    if (length != (size_t)(playersNumber * (handLength + 1) - 1))
+        return SYNTAX_ERROR;
+
+    for (int i = 0; i < playersNumber; i++) {
+        const char *hand = text + i * (handLength + 1);
+        if (i > 0 && hand[-1] != ' ')
+            return SYNTAX_ERROR;
+
+        for (int j = 0; j < cardsNumber; j++) {
+            int cardId = parseCard(hand + 2 * j);
+            if (cardId < 0 || (seen & (1u << cardId)))
+                return SYNTAX_ERROR;
+            seen |= 1u << cardId;
+            record->deck[j * playersNumber + i] = cardId;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to parse the hands of a round. Computes the leader and the
+ *        winner of every hand.
+ */
+static int parsePlay(struct RoundRecord *record, const char *text,
+                     const size_t length)
+{
+    int playersNumber = record->playersNumber;
+    int handLength = 2 * playersNumber;
+    unsigned char owners[DECK_SIZE];
+    unsigned int seen = 0;
+
+    for (int i = 0; i < DECK_SIZE; i++)
+        owners[record->deck[i]] = i % playersNumber;
+
+    if ((length + 1) % (handLength + 1) != 0)
+        return SYNTAX_ERROR;
+    int handsNumber = (length + 1) / (handLength + 1);
+    if (handsNumber > MAX_HANDS || handsNumber > DECK_SIZE / playersNumber)
+        return SYNTAX_ERROR;
+
+    for (int i = 0; i < handsNumber; i++) {
+        const char *hand = text + i * (handLength + 1);
+        if (i > 0 && hand[-1] != ' ')
+            return SYNTAX_ERROR;
+
+        int winner = 0;
+        for (int j = 0; j < playersNumber; j++) {
+            int cardId = parseCard(hand + 2 * j);
+            if (cardId < 0 || (seen & (1u << cardId)))
+                return SYNTAX_ERROR;
+            seen |= 1u << cardId;
+            record->cards[i][j] = cardId;
+
+            if (j == 0)
+                record->leaders[i] = owners[cardId];
+            else if (owners[cardId] != (record->leaders[i] + j) %
+                                       playersNumber)
+                return SYNTAX_ERROR;
+
+            if (j > 0 && compareCardIds(record->cards[i][winner], cardId,
+                                        record->trump) == 2)
+                winner = j;
+        }
+        record->winners[i] = owners[record->cards[i][winner]];
+        if (i > 0 && record->leaders[i] != record->winners[i - 1])
+            return SYNTAX_ERROR;
+    }
+    record->handsNumber = handsNumber;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to parse the marriages of a round.
+ */
+static int parseMarriages(struct RoundRecord *record, const char *text,
+                          const size_t length)
+{
+    const char *end = text + length;
+    for (int i = 0; i < record->playersNumber; i++) {
+        if (text >= end)
+            return SYNTAX_ERROR;
+        if (*text == '-') {
+            text++;
+        } else {
+            const char *suit;
+            while (text < end && *text != ' ' &&
+                   (suit = memchr(SUIT_LETTERS, *text, SuitEnd)) != NULL) {
+                record->marriages[i] |= 1 << (suit - SUIT_LETTERS);
+                text++;
+            }
+        }
+        if (text < end && *text++ != ' ')
+            return SYNTAX_ERROR;
+    }
+
+    return text == end ? NO_ERROR : SYNTAX_ERROR;
+}
+
+/**
+ * @brief Helper to decode the values of the tags of a round.
+ */
+static int parseTags(struct RoundRecord *record, const char **values,
+                     const size_t *lengths)
+{
+    if (values[PLAYERS] == NULL || values[DEAL] == NULL ||
+        values[BIDS] == NULL || values[TRUMP] == NULL)
+        return SYNTAX_ERROR;
+
+    int error = parsePlayers(record, values[PLAYERS], lengths[PLAYERS]);
+    if (error == NO_ERROR)
+        error = parseDeal(record, values[DEAL], lengths[DEAL]);
+    if (error != NO_ERROR)
+        return error;
+
+    int ints[MAX_GAME_PLAYERS];
+    int playersNumber = record->playersNumber;
+    error = parseInts(values[BIDS], lengths[BIDS], ints, playersNumber);
+    if (error != NO_ERROR)
+        return error;
+    for (int i = 0; i < playersNumber; i++) {
+        if (ints[i] < 0 || ints[i] > 6)
+            return SYNTAX_ERROR;
+        record->bids[i] = ints[i];
+    }
+
+    const char *trump = memchr(SUIT_LETTERS, values[TRUMP][0], SuitEnd);
+    if (lengths[TRUMP] != 1 || (trump == NULL && values[TRUMP][0] != '-'))
+        return SYNTAX_ERROR;
+    record->trump = trump != NULL ? trump - SUIT_LETTERS : SuitEnd;
+
+    if (values[PLAY] != NULL) {
+        error = parsePlay(record, values[PLAY], lengths[PLAY]);
+        if (error != NO_ERROR)
+            return error;
+    }
+
+    if (values[MARRIAGES] != NULL) {
+        error = parseMarriages(record, values[MARRIAGES], lengths[MARRIAGES]);
+        if (error != NO_ERROR)
+            return error;
+    }
+
+    for (enum Tag tag = POINTS; tag <= SCORES; tag++) {
+        if (values[tag] == NULL)
+            continue;
+        error = parseInts(values[tag], lengths[tag], ints, playersNumber);
+        if (error != NO_ERROR)
+            return error;
+        for (int i = 0; i < playersNumber; i++) {
+            if (tag == POINTS)
+                record->pointsNumber[i] = ints[i];
+            else
+                record->scores[i] = ints[i];
+        }
+    }
+
+    return NO_ERROR;
+}
+
+int notation_parseRound(struct RoundRecord *record, const char *text,
+                        const size_t length)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (text == NULL)
+        return POINTER_NULL;
+
+    const char *values[TagEnd] = {NULL};
+    size_t lengths[TagEnd] = {0};
+    const char *position = text;
+    const char *end = text + length;
+    int tagsNumber = 0;
+
+    memset(record, 0, sizeof(struct RoundRecord));
+    while (position < end) {
+        const char *lineEnd = memchr(position, '\n', end - position);
+        const char *next = lineEnd != NULL ? lineEnd + 1 : end;
+        if (lineEnd == NULL)
+            lineEnd = end;
+        if (lineEnd > position && lineEnd[-1] == '\r')
+            lineEnd--;
+
+        const char *line = position;
+        position = next;
+        while (line < lineEnd && (*line == ' ' || *line == '\t'))
+            line++;
+
+        if (line == lineEnd) {
+            if (tagsNumber > 0)
+                break;
+            continue;
+        }
+        if (*line == '%')
+            continue;
+
+        const char *nameEnd = memchr(line, ' ', lineEnd - line);
+        if (*line != '[' || nameEnd == NULL || lineEnd - nameEnd < 4 ||
+            nameEnd[1] != '"' || lineEnd[-1] != ']' || lineEnd[-2] != '"')
+            return SYNTAX_ERROR;
+
+        tagsNumber++;
+        line++;
+        for (enum Tag tag = PLAYERS; tag < TagEnd; tag++) {
+            size_t nameLength = strlen(TAG_NAMES[tag]);
+            if ((size_t)(nameEnd - line) == nameLength &&
+                memcmp(line, TAG_NAMES[tag], nameLength) == 0) {
+                values[tag] = nameEnd + 2;
+                lengths[tag] = lineEnd - 2 - values[tag];
+            }
+        }
+    }
+
+    if (tagsNumber == 0)
+        return 0;
+
+    int error = parseTags(record, values, lengths);
+    if (error != NO_ERROR)
+        return error;
+
+    return position - text;
+}
+
+size_t notation_roundLength(const char *text, const size_t length)
+{
+    if (text == NULL)
+        return 0;
+
+    const char *position = text;
+    const char *end = text + length;
+    int content = 0;
+
+    while (position < end) {
+        const char *lineEnd = memchr(position, '\n', end - position);
+        if (lineEnd == NULL)
+            return 0;
+
+        const char *line = position;
+        while (line < lineEnd && (*line == ' ' || *line == '\t' ||
+                                  *line == '\r'))
+            line++;
+        position = lineEnd + 1;
+
+        if (line != lineEnd)
+            content = 1;
+        else if (content)
+            return position - text;
+    }
+
+    return 0;
+}
+
+int notation_initReader(struct NotationReader *reader, FILE *file,
+                        char *buffer, const size_t size)
+{
+    if (reader == NULL || file == NULL || buffer == NULL)
+        return POINTER_NULL;
+    if (size < NOTATION_MAX_ROUND_LENGTH)
+        return ILLEGAL_VALUE;
+
+    reader->file = file;
+    reader->buffer = buffer;
+    reader->size = size;
+    reader->start = 0;
+    reader->end = 0;
+    reader->skipping = SKIP_NONE;
+    reader->failed = 0;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to skip the text read of a round longer than the buffer of
+ *        a reader, up to the empty line after it.
+ */
+static void skipRound(struct NotationReader *reader)
+{
+    const char *position = reader->buffer + reader->start;
+    const char *end = reader->buffer + reader->end;
+
+    while (position < end && reader->skipping != SKIP_NONE) {
+        if (reader->skipping == SKIP_LINE) {
+            const char *lineEnd = memchr(position, '\n', end - position);
+            if (lineEnd == NULL) {
+                position = end;
+                break;
+            }
+            position = lineEnd + 1;
+            reader->skipping = SKIP_CONTENT;
+            continue;
+        }
+
+        // Spaces do not change the state, so they are skipped even if the
+        // rest of the line is not read yet.
+        while (position < end && (*position == ' ' || *position == '\t' ||
+                                  *position == '\r'))
+            position++;
+        if (position == end)
+            break;
+        if (*position == '\n') {
+            position++;
+            if (reader->skipping == SKIP_CONTENT)
+                reader->skipping = SKIP_NONE;
+        } else {
+            reader->skipping = SKIP_LINE;
+        }
+    }
+
+    reader->start = position - reader->buffer;
+}
+
+int notation_readRound(struct NotationReader *reader,
+                       struct RoundRecord *record)
+{
+    if (reader == NULL)
+        return POINTER_NULL;
+    if (record == NULL)
+        return RECORD_NULL;
+
+    while (1) {
+        if (reader->skipping != SKIP_NONE)
+            skipRound(reader);
+
+        char *text = reader->buffer + reader->start;
+        size_t available = reader->end - reader->start;
+        int endOfFile = reader->failed || feof(reader->file);
+
+        if (reader->skipping == SKIP_NONE) {
+            size_t length = notation_roundLength(text, available);
+            if (length > 0 || (endOfFile && available > 0)) {
+                int consumed = notation_parseRound(record, text,
+                                                   length > 0 ? length
+                                                              : available);
+                reader->start += length > 0 ? length : available;
+                if (consumed < 0)
+                    return consumed;
+                if (consumed > 0)
+                    return 1;
+                continue;
+            }
+        }
+        if (!reader->failed && ferror(reader->file)) {
+            reader->failed = 1;
+            reader->start = reader->end;
+            return READ_ERROR;
+        }
+        if (endOfFile) {
+            reader->start = reader->end;
+            return 0;
+        }
+
+        if (reader->start > 0) {
+            memmove(reader->buffer, text, available);
+            reader->start = 0;
+            reader->end = available;
+        }
+        if (reader->end == reader->size) {
+            // The round does not fit in the buffer, so the rest of it is
+            // skipped by the next reads.
+            reader->skipping = SKIP_START;
+            skipRound(reader);
+            return SYNTAX_ERROR;
+        }
+
+        reader->end += fread(reader->buffer + reader->end, 1,
+                             reader->size - reader->end, reader->file);
+    }
+}
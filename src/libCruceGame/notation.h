@@ -0,0 +1,187 @@
+/**
+ * @file notation.h
+ * @brief Text notation for recorded rounds, with a writer and a streaming
+ *        reader which do not allocate memory.
+ *
+ * A round is written as a block of tag lines, followed by an empty line:
+ *
+ *     [Players "Alexandru/0;Bogdan/1;Cristina/0;Diana/1"]
+ *     [Deal "JD9DJC9CJS9S QDTDQCTCQSTS KDADKCACKSAS JHQHKH9HTHAH"]
+ *     [Bids "0 3 0 4"]
+ *     [Trump "H"]
+ *     [Play "JHQHKH9H ..."]
+ *     [Marriages "- - C -"]
+ *     [Points "45 20 33 22"]
+ *     [Scores "4 3 4 3"]
+ *
+ * Players holds the name and the team of every seat ('-' for no team).
+ * Deal holds the cards of every seat, in the order they are distributed.
+ * Play holds the hands, every hand with the cards in the order they were
+ * put down. Marriages holds the suits of the marriages of every seat ('-'
+ * for none). Cards are written as value (9, J, Q, K, T, A) and suit (D, C,
+ * S, H). Only Players, Deal, Bids and Trump are required. Unknown tags and
+ * lines starting with '%' are ignored.
+ */
+
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include "platform.h"
+#include "record.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @brief The maximum length of a written round.
+ */
+#define NOTATION_MAX_ROUND_LENGTH 1024
+
+/**
+ * @struct NotationReader
+ * @brief State of a streaming reader of rounds from a file.
+ *
+ * @var NotationReader::file
+ *     The file from where rounds are read.
+ * @var NotationReader::buffer
+ *     Buffer provided by the caller, holding the text read.
+ * @var NotationReader::size
+ *     The size of the buffer. It must hold at least a whole round.
+ * @var NotationReader::start
+ *     The position of the first byte not parsed yet.
+ * @var NotationReader::end
+ *     The position after the last byte read.
+ * @var NotationReader::skipping
+ *     Not 0 while the rest of a round longer than the buffer is skipped.
+ * @var NotationReader::failed
+ *     1 once reading from the file failed, 0 otherwise.
+ */
+struct NotationReader {
+    FILE *file;
+    char *buffer;
+    size_t size;
+    size_t start;
+    size_t end;
+    int skipping;
+    int failed;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Letters of the card values in notation, indexed like VALUES.
+ */
+EXPORT extern const char VALUE_LETTERS[SUIT_SIZE + 1];
+
+/**
+ * @brief Letters of the suits in notation, indexed by enum Suit.
+ */
+EXPORT extern const char SUIT_LETTERS[SuitEnd + 1];
+
+/**
+ * @brief Writes an integer in decimal. Used by the writers of rounds.
+ *
+ * @param text Where the integer is written, with room for 11 bytes.
+ * @param value The integer.
+ *
+ * @return The position after the integer.
+ */
+EXPORT char *notation_writeInt(char *text, const int value);
+
+/**
+ * @brief Writes a card in notation, as its value and suit letters. Used by
+ *        the writers of rounds.
+ *
+ * @param text Where the card is written, with room for 2 bytes.
+ * @param cardId The id of the card.
+ *
+ * @return The position after the card, or NULL if the id is not the id of
+ *         a card.
+ */
+EXPORT char *notation_writeCard(char *text, const int cardId);
+
+/**
+ * @brief Checks that the counts and the card ids of a record are in range,
+ *        so it can be written. A record read from a file is not trusted.
+ *
+ * @param record The round.
+ *
+ * @return \ref NO_ERROR if the record can be written, other value
+ *         otherwise.
+ */
+EXPORT int notation_checkRecord(const struct RoundRecord *record);
+
+/**
+ * @brief Writes a round in notation.
+ *
+ * @param record The round.
+ * @param text Buffer where the round is written. It is not null terminated.
+ * @param size The size of the buffer.
+ *
+ * @return The number of bytes written on success, negative value on failure.
+ */
+EXPORT int notation_writeRound(const struct RoundRecord *record, char *text,
+                               const size_t size);
+
+/**
+ * @brief Parses the first round from a text.
+ *
+ * The round ends at the first empty line or at the end of the text.
+ *
+ * @param record The record where the round is stored.
+ * @param text The text.
+ * @param length The length of the text.
+ *
+ * @return The number of bytes consumed on success (0 if the text contains
+ *         no round), negative value on failure.
+ */
+EXPORT int notation_parseRound(struct RoundRecord *record, const char *text,
+                               const size_t length);
+
+/**
+ * @brief Finds the end of the first round of a text, without parsing it.
+ *
+ * @param text The text.
+ * @param length The length of the text.
+ *
+ * @return The length of the round, including the empty line after it, or
+ *         0 if the text does not contain a whole round.
+ */
+EXPORT size_t notation_roundLength(const char *text, const size_t length);
+
+/**
+ * @brief Initializes a streaming reader.
+ *
+ * @param reader The reader.
+ * @param file The file to read from.
+ * @param buffer The buffer used by the reader.
+ * @param size The size of buffer, at least \ref NOTATION_MAX_ROUND_LENGTH.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int notation_initReader(struct NotationReader *reader, FILE *file,
+                               char *buffer, const size_t size);
+
+/**
+ * @brief Reads the next round from a file.
+ *
+ * @param reader The reader.
+ * @param record The record where the round is stored.
+ *
+ * @return 1 if a round was read, 0 at the end of file, negative value on
+ *         failure. A round which can not be parsed, or which is longer than
+ *         the buffer, is skipped, so reading may continue after a failure.
+ *         \ref READ_ERROR is returned once if reading from the file fails,
+ *         after which the reader is at the end of file.
+ */
+EXPORT int notation_readRound(struct NotationReader *reader,
+                              struct RoundRecord *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
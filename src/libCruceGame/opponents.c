@@ -0,0 +1,385 @@
+/**
+ * @file opponents.c
+ * @brief Contains implementations of the functions used to fill, query and
+ *        save a store of the tendencies of players.
+ *
+ * A saved store starts with the bytes 'C', 'G', 'O' and the version of the
+ * format, followed by the number of players. Every player is written as
+ * its name, padded with zeros to RECORD_NAME_LENGTH bytes, and its
+ * statistics, in the order of struct OpponentStats. Numbers are written on
+ * four bytes, little endian.
+ */
+
+#include "opponents.h"
+#include "errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The initial number of slots of the hash table.
+ */
+#define OPPONENTS_INITIAL_CAPACITY 16
+
+/**
+ * @brief The number of statistics of a player.
+ */
+#define STATS_NUMBER 8
+
+static const unsigned char MAGIC[] = {'C', 'G', 'O', 1};
+
+/**
+ * @brief Helper to compute the key of a name with FNV-1a. Only the
+ *        characters kept in a RoundRecord are hashed.
+ *
+ * @return The key, which is never 0.
+ */
+static unsigned long long nameKey(const char *name)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for (int i = 0; i < RECORD_NAME_LENGTH - 1 && name[i] != '\0'; i++) {
+        hash ^= (unsigned char)name[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash | (1ULL << 63);
+}
+
+/**
+ * @brief Helper to find the slot of a name in the hash table.
+ *
+ * @return The slot holding the name, or the empty slot where it belongs.
+ */
+static struct OpponentStats *findSlot(const struct OpponentStore *store,
+                                      const unsigned long long key,
+                                      const char *name)
+{
+    size_t mask = store->capacity - 1;
+    size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+
+    while (store->stats[slot].key != 0 &&
+           (store->stats[slot].key != key ||
+            strncmp(store->stats[slot].name, name,
+                    RECORD_NAME_LENGTH - 1) != 0))
+        slot = (slot + 1) & mask;
+
+    return &store->stats[slot];
+}
+
+/**
+ * @brief Helper to double the size of the hash table.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int growStore(struct OpponentStore *store)
+{
+    struct OpponentStats *old = store->stats;
+    size_t oldCapacity = store->capacity;
+
+    store->stats = calloc(oldCapacity * 2, sizeof(struct OpponentStats));
+    if (store->stats == NULL) {
+        store->stats = old;
+        return MALLOC_ERROR;
+    }
+    store->capacity = oldCapacity * 2;
+
+    for (size_t i = 0; i < oldCapacity; i++)
+        if (old[i].key != 0)
+            *findSlot(store, old[i].key, old[i].name) = old[i];
+
+    free(old);
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to find the statistics of a player, adding the player to
+ *        the store if it is missing.
+ *
+ * @return Pointer to the statistics, NULL on failure.
+ */
+static struct OpponentStats *addPlayer(struct OpponentStore *store,
+                                       const char *name)
+{
+    if ((store->playersNumber + 1) * 4 > store->capacity * 3 &&
+        growStore(store) != NO_ERROR)
+        return NULL;
+
+    unsigned long long key = nameKey(name);
+    struct OpponentStats *stats = findSlot(store, key, name);
+    if (stats->key == 0) {
+        stats->key = key;
+        strncpy(stats->name, name, RECORD_NAME_LENGTH - 1);
+        stats->name[RECORD_NAME_LENGTH - 1] = '\0';
+        store->playersNumber++;
+    }
+
+    return stats;
+}
+
+/**
+ * @brief Helper to check if two seats of a round play against each other.
+ */
+static int areOpponents(const struct RoundRecord *record, const int seat,
+                        const int otherSeat)
+{
+    if (seat == otherSeat)
+        return 0;
+
+    return record->teams[seat] != record->teams[otherSeat] ||
+           record->teams[seat] == MAX_GAME_TEAMS;
+}
+
+/**
+ * @brief Helper to check if a card wins over the card winning a hand so
+ *        far, with the rule of deck_compareCards.
+ */
+static int beatsCard(const int cardId, const int winnerId, const int trump)
+{
+    int suit = cardId / SUIT_SIZE;
+    int winnerSuit = winnerId / SUIT_SIZE;
+    if (suit != winnerSuit)
+        return suit == trump;
+
+    return VALUES[cardId % SUIT_SIZE] > VALUES[winnerId % SUIT_SIZE];
+}
+
+/**
+ * @brief Helper to update the statistics of a seat with the bids and the
+ *        points of a round.
+ */
+static void addBid(struct OpponentStats *stats,
+                   const struct RoundRecord *record, const int seat)
+{
+    stats->roundsNumber++;
+    if (record->bids[seat] <= 0)
+        return;
+
+    int points = 0;
+    for (int i = 0; i < record->playersNumber; i++)
+        if (i == seat || !areOpponents(record, seat, i))
+            points += record->pointsNumber[i];
+
+    stats->bidsNumber++;
+    stats->bidUnits += record->bids[seat];
+    stats->madeUnits += points / 33;
+}
+
+/**
+ * @brief Helper to update the statistics of the seats with the cards of a
+ *        hand.
+ */
+static void addHand(struct OpponentStats *stats[],
+                    const struct RoundRecord *record, const int handId)
+{
+    int playersNumber = record->playersNumber;
+    int leader = record->leaders[handId];
+    const unsigned char *cards = record->cards[handId];
+
+    stats[leader]->leadsNumber++;
+    if (cards[0] / SUIT_SIZE == record->trump)
+        stats[leader]->trumpLeadsNumber++;
+
+    int winner = 0;
+    for (int i = 1; i < playersNumber; i++) {
+        int seat = (leader + i) % playersNumber;
+        int winnerSeat = (leader + winner) % playersNumber;
+        int beats = beatsCard(cards[i], cards[winner], record->trump);
+        if (cards[winner] / SUIT_SIZE == record->trump &&
+            areOpponents(record, seat, winnerSeat)) {
+            stats[seat]->overtrumpChancesNumber++;
+            stats[seat]->overtrumpsNumber += beats;
+        }
+        if (beats)
+            winner = i;
+    }
+}
+
+struct OpponentStore *opponents_createStore()
+{
+    struct OpponentStore *store = malloc(sizeof(struct OpponentStore));
+    if (store == NULL)
+        return NULL;
+
+    store->stats = calloc(OPPONENTS_INITIAL_CAPACITY,
+                          sizeof(struct OpponentStats));
+    if (store->stats == NULL) {
+        free(store);
+        return NULL;
+    }
+
+    store->capacity = OPPONENTS_INITIAL_CAPACITY;
+    store->playersNumber = 0;
+
+    return store;
+}
+
+int opponents_deleteStore(struct OpponentStore **store)
+{
+    if (store == NULL)
+        return POINTER_NULL;
+    if (*store == NULL)
+        return OPPONENTS_NULL;
+
+    free((*store)->stats);
+    free(*store);
+    *store = NULL;
+
+    return NO_ERROR;
+}
+
+int opponents_addRound(struct OpponentStore *store,
+                       const struct RoundRecord *record)
+{
+    if (store == NULL)
+        return OPPONENTS_NULL;
+    if (record == NULL)
+        return RECORD_NULL;
+    if (record->playersNumber < 2 ||
+        record->playersNumber > MAX_GAME_PLAYERS ||
+        record->handsNumber > MAX_HANDS)
+        return ILLEGAL_VALUE;
+    for (int i = 0; i < record->handsNumber; i++)
+        if (record->leaders[i] >= record->playersNumber)
+            return ILLEGAL_VALUE;
+
+    // The slots may move while the players are added.
+    for (int i = 0; i < record->playersNumber; i++)
+        if (addPlayer(store, record->names[i]) == NULL)
+            return MALLOC_ERROR;
+
+    struct OpponentStats *stats[MAX_GAME_PLAYERS];
+    for (int i = 0; i < record->playersNumber; i++) {
+        stats[i] = findSlot(store, nameKey(record->names[i]),
+                            record->names[i]);
+        addBid(stats[i], record, i);
+    }
+
+    for (int i = 0; i < record->handsNumber; i++)
+        addHand(stats, record, i);
+
+    return NO_ERROR;
+}
+
+const struct OpponentStats *opponents_find(const struct OpponentStore *store,
+                                           const char *name)
+{
+    if (store == NULL || name == NULL)
+        return NULL;
+
+    const struct OpponentStats *stats = findSlot(store, nameKey(name), name);
+    if (stats->key == 0)
+        return NULL;
+
+    return stats;
+}
+
+/**
+ * @brief Helpers to write and read a number on four bytes.
+ */
+static void putNumber(unsigned char *buffer, const unsigned int value)
+{
+    for (int i = 0; i < 4; i++)
+        buffer[i] = (value >> (8 * i)) & 0xFF;
+}
+
+static unsigned int getNumber(const unsigned char *buffer)
+{
+    unsigned int value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= (unsigned int)buffer[i] << (8 * i);
+
+    return value;
+}
+
+/**
+ * @brief Helper to get the statistics of a player in the order they are
+ *        saved.
+ */
+static void statsNumbers(struct OpponentStats *stats,
+                         unsigned int *numbers[STATS_NUMBER])
+{
+    numbers[0] = &stats->roundsNumber;
+    numbers[1] = &stats->bidsNumber;
+    numbers[2] = &stats->bidUnits;
+    numbers[3] = &stats->madeUnits;
+    numbers[4] = &stats->leadsNumber;
+    numbers[5] = &stats->trumpLeadsNumber;
+    numbers[6] = &stats->overtrumpChancesNumber;
+    numbers[7] = &stats->overtrumpsNumber;
+}
+
+long opponents_writeStore(const struct OpponentStore *store,
+                          unsigned char *buffer, const size_t size)
+{
+    if (store == NULL)
+        return OPPONENTS_NULL;
+    if (buffer == NULL)
+        return POINTER_NULL;
+
+    size_t length = OPPONENTS_HEADER_SIZE +
+                    store->playersNumber * OPPONENTS_PLAYER_SIZE;
+    if (length > size)
+        return FULL;
+
+    memcpy(buffer, MAGIC, sizeof(MAGIC));
+    putNumber(buffer + sizeof(MAGIC), store->playersNumber);
+
+    unsigned char *position = buffer + OPPONENTS_HEADER_SIZE;
+    for (size_t i = 0; i < store->capacity; i++) {
+        struct OpponentStats stats = store->stats[i];
+        if (stats.key == 0)
+            continue;
+
+        memcpy(position, stats.name, RECORD_NAME_LENGTH);
+        position += RECORD_NAME_LENGTH;
+
+        unsigned int *numbers[STATS_NUMBER];
+        statsNumbers(&stats, numbers);
+        for (int j = 0; j < STATS_NUMBER; j++, position += 4)
+            putNumber(position, *numbers[j]);
+    }
+
+    return (long)length;
+}
+
+struct OpponentStore *opponents_readStore(const unsigned char *buffer,
+                                          const size_t length)
+{
+    if (buffer == NULL || length < OPPONENTS_HEADER_SIZE ||
+        memcmp(buffer, MAGIC, sizeof(MAGIC)) != 0)
+        return NULL;
+
+    size_t playersNumber = getNumber(buffer + sizeof(MAGIC));
+    if ((length - OPPONENTS_HEADER_SIZE) / OPPONENTS_PLAYER_SIZE !=
+            playersNumber ||
+        (length - OPPONENTS_HEADER_SIZE) % OPPONENTS_PLAYER_SIZE != 0)
+        return NULL;
+
+    struct OpponentStore *store = opponents_createStore();
+    if (store == NULL)
+        return NULL;
+
+    const unsigned char *position = buffer + OPPONENTS_HEADER_SIZE;
+    for (size_t i = 0; i < playersNumber; i++) {
+        char name[RECORD_NAME_LENGTH];
+        memcpy(name, position, RECORD_NAME_LENGTH);
+        position += RECORD_NAME_LENGTH;
+
+        size_t oldNumber = store->playersNumber;
+        struct OpponentStats *stats = NULL;
+        if (name[RECORD_NAME_LENGTH - 1] == '\0')
+            stats = addPlayer(store, name);
+        if (stats == NULL || store->playersNumber == oldNumber) {
+            opponents_deleteStore(&store);
+            return NULL;
+        }
+
+        unsigned int *numbers[STATS_NUMBER];
+        statsNumbers(stats, numbers);
+        for (int j = 0; j < STATS_NUMBER; j++, position += 4)
+            *numbers[j] = getNumber(position);
+    }
+
+    return store;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file opponents.h
+ * @brief OpponentStore structure, which keeps the tendencies of the players
+ *        a bot has met, as well as the functions used to fill, query and
+ *        save it.
+ *
+ * The statistics of a player are updated from every round the player took
+ * part in, recorded with record_captureRound after game_updateScore. They
+ * are kept in an open addressing hash table keyed by the name of the
+ * player, as long as it is kept in a RoundRecord, so a bot finds them in
+ * constant time while deciding. A store is saved in a compact binary form,
+ * to be loaded again in the next session.
+ */
+
+#ifndef OPPONENTS_H
+#define OPPONENTS_H
+
+#include "platform.h"
+#include "record.h"
+
+#include <stddef.h>
+
+/**
+ * @brief The size of a saved store, without its players.
+ */
+#define OPPONENTS_HEADER_SIZE 8
+
+/**
+ * @brief The size of every player of a saved store.
+ */
+#define OPPONENTS_PLAYER_SIZE (RECORD_NAME_LENGTH + 32)
+
+/**
+ * @struct OpponentStats
+ * @brief The tendencies of a player.
+ *
+ * @var OpponentStats::key
+ *     The hash of the name of the player. 0 marks an empty slot of the
+ *     store.
+ * @var OpponentStats::name
+ *     The name of the player, as kept in a RoundRecord.
+ * @var OpponentStats::roundsNumber
+ *     The number of rounds the player took part in.
+ * @var OpponentStats::bidsNumber
+ *     The number of rounds in which the player bid more than 0.
+ * @var OpponentStats::bidUnits
+ *     The sum of those bids, in units of 33 points.
+ * @var OpponentStats::madeUnits
+ *     The sum of the units of 33 points the team of the player made in
+ *     those rounds.
+ * @var OpponentStats::leadsNumber
+ *     The number of hands the player put down the first card of.
+ * @var OpponentStats::trumpLeadsNumber
+ *     The number of those hands in which the first card was a trump.
+ * @var OpponentStats::overtrumpChancesNumber
+ *     The number of cards the player put down in a hand won so far by a
+ *     trump of an opponent.
+ * @var OpponentStats::overtrumpsNumber
+ *     The number of those cards which were higher trumps.
+ */
+struct OpponentStats {
+    unsigned long long key;
+    char name[RECORD_NAME_LENGTH];
+    unsigned int roundsNumber;
+    unsigned int bidsNumber;
+    unsigned int bidUnits;
+    unsigned int madeUnits;
+    unsigned int leadsNumber;
+    unsigned int trumpLeadsNumber;
+    unsigned int overtrumpChancesNumber;
+    unsigned int overtrumpsNumber;
+};
+
+/**
+ * @struct OpponentStore
+ * @brief The tendencies of the players a bot has met.
+ *
+ * @var OpponentStore::stats
+ *     Open addressing hash table of the statistics of the players.
+ * @var OpponentStore::capacity
+ *     The size of the hash table, always a power of 2.
+ * @var OpponentStore::playersNumber
+ *     The number of used slots of the hash table.
+ */
+struct OpponentStore {
+    struct OpponentStats *stats;
+    size_t capacity;
+    size_t playersNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates and initializes an empty store.
+ *
+ * @return Pointer to the new store on success or NULL on failure.
+ */
+EXPORT struct OpponentStore *opponents_createStore();
+
+/**
+ * @brief Frees the memory of a store and sets the pointer to NULL.
+ *
+ * @param store Pointer to the pointer to be freed.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int opponents_deleteStore(struct OpponentStore **store);
+
+/**
+ * @brief Updates the statistics of the players of a recorded round.
+ *
+ * @param store The store.
+ * @param record The round, recorded after it was scored.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int opponents_addRound(struct OpponentStore *store,
+                              const struct RoundRecord *record);
+
+/**
+ * @brief Finds the statistics of a player.
+ *
+ * @param store The store.
+ * @param name The name of the player.
+ *
+ * @return Pointer to the statistics, NULL if the player is not in the store
+ *         or on failure.
+ */
+EXPORT const struct OpponentStats *opponents_find(
+    const struct OpponentStore *store, const char *name);
+
+/**
+ * @brief Saves a store.
+ *
+ * @param store The store.
+ * @param buffer Buffer where the store is written. It needs
+ *               \ref OPPONENTS_HEADER_SIZE bytes, and
+ *               \ref OPPONENTS_PLAYER_SIZE bytes for every player.
+ * @param size The size of the buffer.
+ *
+ * @return The length of the saved store on success, \ref FULL if the buffer
+ *         is too small, other negative value on failure.
+ */
+EXPORT long opponents_writeStore(const struct OpponentStore *store,
+                                 unsigned char *buffer, const size_t size);
+
+/**
+ * @brief Loads a saved store.
+ *
+ * @param buffer The saved store.
+ * @param length The length of the saved store.
+ *
+ * @return Pointer to the new store on success or NULL on failure.
+ */
+EXPORT struct OpponentStore *opponents_readStore(const unsigned char *buffer,
+                                                 const size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
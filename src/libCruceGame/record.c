@@ -0,0 +1,264 @@
+/**
+ * @file record.c
+ * @brief Contains implementations of the functions used to record the
+ *        rounds of a game into RoundRecord structures.
+ */
+
+#include "record.h"
+#include "errors.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+int record_captureDeal(struct RoundRecord *record, const struct Deck *deck)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (deck == NULL)
+        return DECK_NULL;
+
+    memset(record, 0, sizeof(struct RoundRecord));
+    for (int i = 0; i < DECK_SIZE; i++) {
+        if (deck->cards[i] == NULL)
+            return LESS_CARDS;
+        int id = deck_cardId(deck->cards[i]);
+        if (id < 0)
+            return id;
+        record->deck[i] = id;
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to find the position of the winning card of a hand,
+ *        with the rules of round_handWinner, but without awarding points.
+ *
+ * @param hand The hand.
+ * @param playersNumber The number of cards in the hand.
+ * @param trump The trump of the round.
+ *
+ * @return The position of the winning card on success, negative otherwise.
+ */
+static int handWinnerPosition(const struct Hand *hand, const int playersNumber,
+                              const enum Suit trump)
+{
+    int winner = 0;
+    for (int i = 1; i < playersNumber; i++) {
+        int compare = deck_compareCards(hand->cards[winner], hand->cards[i],
+                                        trump);
+        if (compare <= 0)
+            return ERROR_COMPARE;
+        if (compare == 2)
+            winner = i;
+    }
+
+    return winner;
+}
+
+/**
+ * @brief Helper to find the first hand before which a seat holds a card.
+ *
+ * The cards that are not distributed at the beginning of the round are
+ * distributed one to every player after every hand.
+ *
+ * @param record The record containing the deal.
+ * @param cardId The card.
+ *
+ * @return The id of the first hand in which the card can be put down.
+ */
+static int dealtBeforeHand(const struct RoundRecord *record, const int cardId)
+{
+    int position = 0;
+    while (position < DECK_SIZE && record->deck[position] != cardId)
+        position++;
+
+    int playersNumber = record->playersNumber;
+    int firstDeal = DECK_SIZE / playersNumber;
+    if (firstDeal > MAX_CARDS)
+        firstDeal = MAX_CARDS;
+    firstDeal *= playersNumber;
+
+    if (position < firstDeal)
+        return 0;
+
+    return (position - firstDeal) / playersNumber + 1;
+}
+
+/**
+ * @brief Helper to check if a seat still held a card after a hand.
+ *
+ * @param record The record, with the hands already filled.
+ * @param player The player of the seat, for the cards never put down.
+ * @param seat The seat.
+ * @param cardId The card.
+ * @param handId The hand.
+ *
+ * @return 1 if the seat held the card, 0 otherwise.
+ */
+static int heldAfterHand(const struct RoundRecord *record,
+                         const struct Player *player, const int seat,
+                         const int cardId, const int handId)
+{
+    if (dealtBeforeHand(record, cardId) > handId)
+        return 0;
+
+    for (int i = handId + 1; i < record->handsNumber; i++)
+        for (int j = 0; j < record->playersNumber; j++)
+            if (record->cards[i][j] == cardId)
+                return (record->leaders[i] + j) % record->playersNumber
+                       == seat;
+
+    for (int i = 0; i < MAX_CARDS; i++)
+        if (player->hand[i] != NULL && deck_cardId(player->hand[i]) == cardId)
+            return 1;
+
+    return 0;
+}
+
+int record_captureRound(struct RoundRecord *record, const struct Game *game)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (game == NULL)
+        return GAME_NULL;
+    if (game->round == NULL)
+        return ROUND_NULL;
+
+    const struct Round *round = game->round;
+    struct Player *players[MAX_GAME_PLAYERS];
+    int playersNumber = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (round->players[i] == NULL)
+            continue;
+
+        struct Player *player = round->players[i];
+        players[playersNumber] = player;
+        strncpy(record->names[playersNumber], player->name,
+                RECORD_NAME_LENGTH - 1);
+        record->names[playersNumber][RECORD_NAME_LENGTH - 1] = '\0';
+        record->bids[playersNumber] = round->bids[i];
+        record->pointsNumber[playersNumber] = round->pointsNumber[i];
+        record->scores[playersNumber] = player->score;
+
+        struct Team *team = game_findTeam(game, player);
+        record->teams[playersNumber] = MAX_GAME_TEAMS;
+        for (int j = 0; j < MAX_GAME_TEAMS; j++)
+            if (team != NULL && game->teams[j] == team)
+                record->teams[playersNumber] = j;
+
+        playersNumber++;
+    }
+
+    if (playersNumber < 2)
+        return INSUFFICIENT_PLAYERS;
+
+    record->playersNumber = playersNumber;
+    record->trump = round->trump;
+
+    int handsNumber = 0;
+    for (; handsNumber < MAX_HANDS; handsNumber++) {
+        const struct Hand *hand = round->hands[handsNumber];
+        if (hand == NULL)
+            break;
+
+        int complete = 1;
+        for (int i = 0; i < playersNumber; i++)
+            if (hand->players[i] == NULL || hand->cards[i] == NULL)
+                complete = 0;
+        if (!complete)
+            break;
+
+        int leader = 0;
+        while (leader < playersNumber && players[leader] != hand->players[0])
+            leader++;
+        if (leader == playersNumber)
+            return NOT_FOUND;
+
+        int winner = handWinnerPosition(hand, playersNumber, round->trump);
+        if (winner < 0)
+            return winner;
+
+        record->leaders[handsNumber] = leader;
+        record->winners[handsNumber] = (leader + winner) % playersNumber;
+        for (int i = 0; i < playersNumber; i++)
+            record->cards[handsNumber][i] = deck_cardId(hand->cards[i]);
+    }
+    record->handsNumber = handsNumber;
+
+    for (int i = 0; i < handsNumber; i++) {
+        int cardId = record->cards[i][0];
+        int valueId = cardId % SUIT_SIZE;
+        if (VALUES[valueId] != 3 && VALUES[valueId] != 4)
+            continue;
+
+        int pairId = cardId - valueId + (VALUES[valueId] == 3 ? 2 : 1);
+        int seat = record->leaders[i];
+        if (heldAfterHand(record, players[seat], seat, pairId, i))
+            record->marriages[seat] |= 1 << (cardId / SUIT_SIZE);
+    }
+
+    return NO_ERROR;
+}
+
+struct Deck *record_createDeck(const struct RoundRecord *record)
+{
+    if (record == NULL)
+        return NULL;
+
+    uint32_t cards = 0;
+    for (int i = 0; i < DECK_SIZE; i++) {
+        if (record->deck[i] >= DECK_SIZE ||
+            (cards & 1u << record->deck[i]) != 0)
+            return NULL;
+        cards |= 1u << record->deck[i];
+    }
+
+    struct Deck *deck = calloc(1, sizeof(struct Deck));
+    if (deck == NULL)
+        return NULL;
+
+    for (int i = 0; i < DECK_SIZE; i++) {
+        int cardId = record->deck[i];
+        deck->cards[i] = deck_createCard(cardId / SUIT_SIZE,
+                                         VALUES[cardId % SUIT_SIZE]);
+        if (deck->cards[i] == NULL) {
+            deck_deleteDeck(&deck);
+            return NULL;
+        }
+    }
+
+    return deck;
+}
+
+int record_bidWinner(const struct RoundRecord *record)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (record->playersNumber < 2 || record->playersNumber > MAX_GAME_PLAYERS)
+        return ILLEGAL_VALUE;
+
+    int winner = 0;
+    for (int i = 1; i < record->playersNumber; i++)
+        if (record->bids[i] > record->bids[winner])
+            winner = i;
+
+    return winner;
+}
+
+int record_bidMade(const struct RoundRecord *record)
+{
+    int winner = record_bidWinner(record);
+    if (winner < 0)
+        return winner;
+
+    int points = 0;
+    for (int i = 0; i < record->playersNumber; i++)
+        if (i == winner || (record->teams[i] == record->teams[winner] &&
+                            record->teams[i] != MAX_GAME_TEAMS))
+            points += record->pointsNumber[i];
+
+    return record->bids[winner] <= points / 33;
+}
+
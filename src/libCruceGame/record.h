@@ -0,0 +1,134 @@
+/**
+ * @file record.h
+ * @brief RoundRecord structure, a compact and self contained log of a
+ *        played round, as well as helper functions.
+ */
+
+#ifndef RECORD_H
+#define RECORD_H
+
+#include "platform.h"
+#include "constants.h"
+#include "deck.h"
+#include "game.h"
+
+/**
+ * @struct RoundRecord
+ * @brief Fixed size log of a round.
+ *
+ * Players are identified by their seat, which is the order they have in
+ * Round::players. Cards are identified by their id (see deck_cardId).
+ * The card from position i of the deck is dealt to the seat
+ * i % playersNumber, so the deck order describes the whole deal.
+ *
+ * @var RoundRecord::names
+ *     The names of the players, by seat.
+ * @var RoundRecord::deck
+ *     The ids of the cards in the order they were in the shuffled deck.
+ * @var RoundRecord::bids
+ *     The bids of the players, by seat.
+ * @var RoundRecord::teams
+ *     The index in Game::teams of the team of every seat.
+ * @var RoundRecord::playersNumber
+ *     The number of players of the round.
+ * @var RoundRecord::trump
+ *     The trump of the round.
+ * @var RoundRecord::handsNumber
+ *     The number of hands played in the round.
+ * @var RoundRecord::marriages
+ *     For every seat, a bit mask with bit s set if the player scored a
+ *     marriage (3 and 4) of suit s.
+ * @var RoundRecord::leaders
+ *     The seat of the player who put down the first card of every hand.
+ * @var RoundRecord::winners
+ *     The seat of the player who won every hand.
+ * @var RoundRecord::cards
+ *     The ids of the cards put down in every hand, in the order they were
+ *     put down.
+ * @var RoundRecord::pointsNumber
+ *     The points of every seat at the end of the round.
+ * @var RoundRecord::scores
+ *     The score of every seat after the round was scored.
+ */
+struct RoundRecord {
+    char names[MAX_GAME_PLAYERS][RECORD_NAME_LENGTH];
+    unsigned char deck[DECK_SIZE];
+    signed char bids[MAX_GAME_PLAYERS];
+    unsigned char teams[MAX_GAME_PLAYERS];
+    unsigned char playersNumber;
+    unsigned char trump;
+    unsigned char handsNumber;
+    unsigned char marriages[MAX_GAME_PLAYERS];
+    unsigned char leaders[MAX_HANDS];
+    unsigned char winners[MAX_HANDS];
+    unsigned char cards[MAX_HANDS][MAX_GAME_PLAYERS];
+    short pointsNumber[MAX_GAME_PLAYERS];
+    short scores[MAX_GAME_PLAYERS];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Records the order of a shuffled deck, before it is distributed.
+ *        Clears all the other fields of the record.
+ *
+ * @param record The record to fill.
+ * @param deck The full deck, as it is going to be distributed.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int record_captureDeal(struct RoundRecord *record,
+                              const struct Deck *deck);
+
+/**
+ * @brief Records the players, bids, hands and points of the current round
+ *        of a game. The deal must be already recorded with
+ *        record_captureDeal. Call it after game_updateScore to record the
+ *        scores of the round.
+ *
+ * @param record The record to fill.
+ * @param game The game whose current round is recorded.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int record_captureRound(struct RoundRecord *record,
+                               const struct Game *game);
+
+/**
+ * @brief Allocates a deck with the cards in the recorded order, so that the
+ *        recorded deal can be distributed with round_distributeDeck.
+ *
+ * @param record The record.
+ *
+ * @return Pointer to the new deck on success or NULL on failure, which
+ *         includes a recorded deck with a card missing or repeated.
+ */
+EXPORT struct Deck *record_createDeck(const struct RoundRecord *record);
+
+/**
+ * @brief Finds the seat which won the bid, with the same rule as
+ *        round_getBidWinner.
+ *
+ * @param record The record.
+ *
+ * @return The seat of the bid winner on success, negative value on failure.
+ */
+EXPORT int record_bidWinner(const struct RoundRecord *record);
+
+/**
+ * @brief Checks if the team of the bid winner made its bid.
+ *
+ * @param record The record.
+ *
+ * @return 1 if the bid was made, 0 if it failed, negative value on failure.
+ */
+EXPORT int record_bidMade(const struct RoundRecord *record);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
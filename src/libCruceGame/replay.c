@@ -0,0 +1,219 @@
+/**
+ * @file replay.c
+ * @brief Contains implementations of the functions used to rebuild a live
+ *        game from a recorded round.
+ */
+
+#include "replay.h"
+#include "round.h"
+#include "team.h"
+#include "errors.h"
+
+#include <stdlib.h>
+
+/**
+ * @brief Helper to add the players and the teams of a record to a game.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int addPlayers(struct Game *game, const struct RoundRecord *record)
+{
+    for (int i = 0; i < record->playersNumber; i++) {
+        struct Player *player = team_createPlayer(record->names[i], 0);
+        int error = game_addPlayer(player, game);
+        if (error != NO_ERROR) {
+            if (player != NULL)
+                team_deletePlayer(&player);
+            return error;
+        }
+    }
+
+    for (int i = 0; i < record->playersNumber; i++) {
+        int teamId = record->teams[i];
+        if (teamId >= MAX_GAME_TEAMS)
+            continue;
+
+        if (game->teams[teamId] == NULL) {
+            game->teams[teamId] = team_createTeam();
+            if (game->teams[teamId] == NULL)
+                return MALLOC_ERROR;
+        }
+        int error = team_addPlayer(game->teams[teamId], game->players[i]);
+        if (error != NO_ERROR)
+            return error;
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to put down a card of a hand.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int putCard(struct Round *round, const int handId, const int position,
+                   const int cardId)
+{
+    struct Player *player = round->hands[handId]->players[position];
+    if (player == NULL)
+        return PLAYER_NULL;
+
+    for (int i = 0; i < MAX_CARDS; i++)
+        if (player->hand[i] != NULL && deck_cardId(player->hand[i]) == cardId)
+            return round_putCard(player, i, handId, round);
+
+    return NOT_FOUND;
+}
+
+/**
+ * @brief Helper to put down the first cards of a record.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int playCards(struct Game *game, const struct RoundRecord *record,
+                     const int cardsNumber)
+{
+    struct Round *round = game->round;
+    int playersNumber = record->playersNumber;
+    int played = 0;
+
+    for (int i = 0; i < MAX_HANDS; i++) {
+        int leader;
+        if (i < record->handsNumber)
+            leader = record->leaders[i];
+        else if (i > 0)
+            leader = record->winners[i - 1];
+        else
+            leader = record_bidWinner(record);
+        if (!team_hasCards(round->players[leader]))
+            return NO_ERROR;
+
+        int error = round_arrangePlayersHand(round, leader);
+        if (error != NO_ERROR)
+            return error;
+        if (played == cardsNumber)
+            return NO_ERROR;
+
+        for (int j = 0; j < playersNumber && played < cardsNumber; j++) {
+            error = putCard(round, i, j, record->cards[i][j]);
+            if (error != NO_ERROR)
+                return error;
+            played++;
+        }
+        if (played % playersNumber != 0)
+            return NO_ERROR;
+
+        if (round_handWinner(round->hands[i], round) == NULL)
+            return ERROR_COMPARE;
+        if (deck_cardsNumber(game->deck) > 0) {
+            error = round_distributeCard(game->deck, round);
+            if (error != NO_ERROR)
+                return error;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+struct Game *replay_createGame(const struct RoundRecord *record,
+                               const int cardsNumber)
+{
+    if (record == NULL || record->playersNumber < 2 ||
+        record->playersNumber > MAX_GAME_PLAYERS ||
+        record->handsNumber > MAX_HANDS || cardsNumber < 0 ||
+        cardsNumber > record->handsNumber * record->playersNumber)
+        return NULL;
+
+    struct Game *game = game_createGame(11);
+    if (game == NULL)
+        return NULL;
+
+    int error = addPlayers(game, record);
+    if (error == NO_ERROR)
+        error = game_arrangePlayersRound(game, 0);
+    if (error == NO_ERROR) {
+        game->deck = record_createDeck(record);
+        error = round_distributeDeck(game->deck, game->round);
+    }
+    if (error == NO_ERROR) {
+        game->round->trump = record->trump;
+        for (int i = 0; i < record->playersNumber; i++)
+            game->round->bids[i] = record->bids[i];
+        error = playCards(game, record, cardsNumber);
+    }
+
+    if (error != NO_ERROR) {
+        replay_deleteGame(&game);
+        return NULL;
+    }
+
+    return game;
+}
+
+int replay_deleteGame(struct Game **game)
+{
+    if (game == NULL)
+        return POINTER_NULL;
+    if (*game == NULL)
+        return GAME_NULL;
+
+    struct Round *round = (*game)->round;
+    if (round != NULL) {
+        for (int i = 0; i < MAX_HANDS; i++) {
+            if (round->hands[i] == NULL)
+                continue;
+            for (int j = 0; j < MAX_GAME_PLAYERS; j++)
+                if (round->hands[i]->cards[j] != NULL)
+                    deck_deleteCard(&round->hands[i]->cards[j]);
+            round_deleteHand(&round->hands[i]);
+        }
+        round_deleteRound(&(*game)->round);
+    }
+
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        struct Player *player = (*game)->players[i];
+        if (player == NULL)
+            continue;
+        for (int j = 0; j < MAX_CARDS; j++)
+            if (player->hand[j] != NULL)
+                deck_deleteCard(&player->hand[j]);
+        team_deletePlayer(&(*game)->players[i]);
+    }
+
+    for (int i = 0; i < MAX_GAME_TEAMS; i++)
+        if ((*game)->teams[i] != NULL)
+            team_deleteTeam(&(*game)->teams[i]);
+    if ((*game)->deck != NULL)
+        deck_deleteDeck(&(*game)->deck);
+
+    return game_deleteGame(game);
+}
+
+int replay_findTurn(const struct Game *game, int *handId, int *position)
+{
+    if (game == NULL)
+        return GAME_NULL;
+    if (handId == NULL || position == NULL)
+        return POINTER_NULL;
+    if (game->round == NULL)
+        return ROUND_NULL;
+
+    const struct Round *round = game->round;
+    int last = -1;
+    while (last + 1 < MAX_HANDS && round->hands[last + 1] != NULL)
+        last++;
+    if (last < 0)
+        return NOT_FOUND;
+
+    const struct Hand *hand = round->hands[last];
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (hand->players[i] != NULL && hand->cards[i] == NULL) {
+            *handId = last;
+            *position = i;
+            return NO_ERROR;
+        }
+    }
+
+    return NOT_FOUND;
+}
+
@@ -0,0 +1,64 @@
+/**
+ * @file replay.h
+ * @brief Functions used to rebuild a live game from a recorded round, at
+ *        any point of its play.
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "platform.h"
+#include "record.h"
+#include "game.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Builds a game with the players, teams, deal, bids and trump of a
+ *        recorded round, and puts down its first cards.
+ *
+ * The players and the teams keep the seats and the team indexes of the
+ * record. The cards which are not distributed yet stay in Game::deck. If
+ * the round is not over, the hand in which the next card is put down is
+ * created.
+ *
+ * @param record The recorded round.
+ * @param cardsNumber The number of cards put down, at most
+ *                    RoundRecord::handsNumber * RoundRecord::playersNumber.
+ *
+ * @return Pointer to the new game on success or NULL on failure.
+ */
+EXPORT struct Game *replay_createGame(const struct RoundRecord *record,
+                                      const int cardsNumber);
+
+/**
+ * @brief Frees a game built by replay_createGame, with its round, hands,
+ *        players, teams, deck and cards.
+ *
+ * @param game Pointer to the game.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int replay_deleteGame(struct Game **game);
+
+/**
+ * @brief Finds the player who puts down the next card.
+ *
+ * @param game The game.
+ * @param handId Where the id of the current hand is stored.
+ * @param position Where the position of the player in the hand is stored.
+ *
+ * @return \ref NO_ERROR on success, \ref NOT_FOUND if no card can be put
+ *         down, other value on failure.
+ */
+EXPORT int replay_findTurn(const struct Game *game, int *handId,
+                           int *position);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,396 @@
+/**
+ * @file repro.c
+ * @brief Contains implementations of the functions used to capture slow
+ *        decisions and to write and read them.
+ */
+
+#include "repro.h"
+#include "errors.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The times written are below this number of seconds, so the
+ *        written decision fits in REPRO_MAX_LENGTH.
+ */
+#define REPRO_MAX_TIME 1e9
+
+/**
+ * @brief The tags of a written decision.
+ */
+enum ReproTag {ROUTINE = 0, STATE, BUDGET, ELAPSED, PHASES, SNAPSHOT,
+               ReproTagEnd};
+
+static const char *TAG_NAMES[] = {"Routine", "State", "Budget", "Elapsed",
+                                  "Phases", "Snapshot"};
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+struct ReproRecorder *repro_createRecorder(const int capacity)
+{
+    if (capacity < 1)
+        return NULL;
+
+    struct ReproRecorder *recorder = calloc(1, sizeof(struct ReproRecorder));
+    if (recorder == NULL)
+        return NULL;
+
+    recorder->repros = malloc(sizeof(struct Repro) * capacity);
+    if (recorder->repros == NULL) {
+        free(recorder);
+        return NULL;
+    }
+    recorder->capacity = capacity;
+
+    return recorder;
+}
+
+int repro_deleteRecorder(struct ReproRecorder **recorder)
+{
+    if (recorder == NULL)
+        return POINTER_NULL;
+    if (*recorder == NULL)
+        return RECORDER_NULL;
+
+    free((*recorder)->repros);
+    free(*recorder);
+    *recorder = NULL;
+
+    return NO_ERROR;
+}
+
+int repro_startDecision(struct ReproRecorder *recorder, const char *routine,
+                        const uint64_t state, const double budget)
+{
+    if (recorder == NULL)
+        return RECORDER_NULL;
+    if (routine == NULL)
+        return POINTER_NULL;
+
+    recorder->routine = routine;
+    recorder->state = state;
+    recorder->budget = budget;
+    recorder->phasesNumber = 0;
+
+    return NO_ERROR;
+}
+
+int repro_addPhase(struct ReproRecorder *recorder, const char *name,
+                   const double time)
+{
+    if (recorder == NULL)
+        return RECORDER_NULL;
+    if (name == NULL)
+        return POINTER_NULL;
+
+    if (recorder->phasesNumber < REPRO_MAX_PHASES) {
+        recorder->phaseNames[recorder->phasesNumber] = name;
+        recorder->phaseTimes[recorder->phasesNumber++] = time;
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to copy a name, cut to REPRO_NAME_LENGTH - 1 bytes.
+ */
+static void copyName(char *copy, const char *name)
+{
+    strncpy(copy, name, REPRO_NAME_LENGTH - 1);
+    copy[REPRO_NAME_LENGTH - 1] = '\0';
+}
+
+int repro_finishDecision(struct ReproRecorder *recorder,
+                         const struct Game *game, const double elapsed)
+{
+    if (recorder == NULL)
+        return RECORDER_NULL;
+    if (game == NULL)
+        return GAME_NULL;
+    if (recorder->routine == NULL)
+        return ILLEGAL_VALUE;
+
+    recorder->decisionsNumber++;
+    const char *routine = recorder->routine;
+    recorder->routine = NULL;
+    if (!(elapsed > recorder->budget))
+        return 0;
+    if (recorder->reprosNumber == recorder->capacity) {
+        recorder->droppedNumber++;
+        return 0;
+    }
+
+    struct Repro *repro = &recorder->repros[recorder->reprosNumber];
+    int length = snapshot_writeGame(game, repro->snapshot, SNAPSHOT_MAX_SIZE);
+    if (length < 0)
+        return length;
+
+    copyName(repro->routine, routine);
+    repro->state = recorder->state;
+    repro->budget = recorder->budget;
+    repro->elapsed = elapsed;
+    repro->phasesNumber = recorder->phasesNumber;
+    for (int i = 0; i < recorder->phasesNumber; i++) {
+        copyName(repro->phaseNames[i], recorder->phaseNames[i]);
+        repro->phaseTimes[i] = recorder->phaseTimes[i];
+    }
+    repro->snapshotLength = length;
+    recorder->reprosNumber++;
+    recorder->capturedNumber++;
+
+    return 1;
+}
+
+int repro_clearRecorder(struct ReproRecorder *recorder)
+{
+    if (recorder == NULL)
+        return RECORDER_NULL;
+
+    recorder->reprosNumber = 0;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to check that a time can be written in a tag.
+ */
+static int checkTime(const double time)
+{
+    return time >= 0 && time < REPRO_MAX_TIME;
+}
+
+/**
+ * @brief Helper to check that a name can be written in a tag.
+ */
+static int checkName(const char *name)
+{
+    if (name[0] == '\0')
+        return 0;
+    for (; *name != '\0'; name++)
+        if (*name == ' ' || *name == '=' || *name == '"' || *name == '\n' ||
+            *name == '\r')
+            return 0;
+
+    return 1;
+}
+
+int repro_writeRepro(const struct Repro *repro, char *text, const size_t size)
+{
+    if (repro == NULL || text == NULL)
+        return POINTER_NULL;
+    if (repro->phasesNumber < 0 || repro->phasesNumber > REPRO_MAX_PHASES ||
+        repro->snapshotLength < 0 ||
+        repro->snapshotLength > SNAPSHOT_MAX_SIZE ||
+        !checkName(repro->routine) || !checkTime(repro->budget) ||
+        !checkTime(repro->elapsed))
+        return ILLEGAL_VALUE;
+    for (int i = 0; i < repro->phasesNumber; i++)
+        if (!checkName(repro->phaseNames[i]) ||
+            !checkTime(repro->phaseTimes[i]))
+            return ILLEGAL_VALUE;
+
+    char buffer[REPRO_MAX_LENGTH];
+    int length = sprintf(buffer, "[%s \"%s\"]\n[%s \"%" PRIu64 "\"]\n"
+                         "[%s \"%.9f\"]\n[%s \"%.9f\"]\n[%s \"",
+                         TAG_NAMES[ROUTINE], repro->routine,
+                         TAG_NAMES[STATE], repro->state,
+                         TAG_NAMES[BUDGET], repro->budget,
+                         TAG_NAMES[ELAPSED], repro->elapsed,
+                         TAG_NAMES[PHASES]);
+    for (int i = 0; i < repro->phasesNumber; i++)
+        length += sprintf(buffer + length, "%s%s=%.9f", i > 0 ? " " : "",
+                          repro->phaseNames[i], repro->phaseTimes[i]);
+    length += sprintf(buffer + length, "\"]\n[%s \"", TAG_NAMES[SNAPSHOT]);
+    for (int i = 0; i < repro->snapshotLength; i++) {
+        buffer[length++] = HEX_DIGITS[repro->snapshot[i] >> 4];
+        buffer[length++] = HEX_DIGITS[repro->snapshot[i] & 0xF];
+    }
+    length += sprintf(buffer + length, "\"]\n\n");
+
+    if ((size_t)length > size)
+        return FULL;
+    memcpy(text, buffer, length);
+
+    return length;
+}
+
+/**
+ * @brief Helper to parse a number of a tag value.
+ *
+ * @param integer 1 for an unsigned 64 bit integer, 0 for a double.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int parseNumber(const char *text, const size_t length,
+                       const int integer, uint64_t *unsignedValue,
+                       double *doubleValue)
+{
+    char copy[64];
+    if (length == 0 || length >= sizeof(copy) || text[0] == '-' ||
+        text[0] == ' ')
+        return SYNTAX_ERROR;
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+
+    char *end;
+    if (integer)
+        *unsignedValue = strtoull(copy, &end, 10);
+    else
+        *doubleValue = strtod(copy, &end);
+
+    return *end == '\0' ? NO_ERROR : SYNTAX_ERROR;
+}
+
+/**
+ * @brief Helper to parse the phases of a decision.
+ */
+static int parsePhases(struct Repro *repro, const char *text,
+                       const size_t length)
+{
+    const char *end = text + length;
+    while (text < end) {
+        const char *wordEnd = memchr(text, ' ', end - text);
+        if (wordEnd == NULL)
+            wordEnd = end;
+        const char *equals = memchr(text, '=', wordEnd - text);
+        if (equals == NULL || equals == text ||
+            equals - text >= REPRO_NAME_LENGTH ||
+            repro->phasesNumber == REPRO_MAX_PHASES)
+            return SYNTAX_ERROR;
+
+        int phase = repro->phasesNumber++;
+        memcpy(repro->phaseNames[phase], text, equals - text);
+        repro->phaseNames[phase][equals - text] = '\0';
+        int error = parseNumber(equals + 1, wordEnd - equals - 1, 0, NULL,
+                                &repro->phaseTimes[phase]);
+        if (error != NO_ERROR)
+            return error;
+        text = wordEnd < end ? wordEnd + 1 : end;
+    }
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to find the value of a hexadecimal digit.
+ *
+ * @return The value, negative value if the character is not a digit.
+ */
+static int hexValue(const char digit)
+{
+    const char *found = digit != '\0' ? strchr(HEX_DIGITS, digit) : NULL;
+    if (found != NULL)
+        return found - HEX_DIGITS;
+    if (digit >= 'A' && digit <= 'F')
+        return digit - 'A' + 10;
+
+    return SYNTAX_ERROR;
+}
+
+/**
+ * @brief Helper to decode the values of the tags of a decision.
+ */
+static int parseTags(struct Repro *repro, const char **values,
+                     const size_t *lengths)
+{
+    if (values[ROUTINE] == NULL || values[STATE] == NULL ||
+        values[SNAPSHOT] == NULL)
+        return SYNTAX_ERROR;
+
+    if (lengths[ROUTINE] == 0 || lengths[ROUTINE] >= REPRO_NAME_LENGTH)
+        return SYNTAX_ERROR;
+    memcpy(repro->routine, values[ROUTINE], lengths[ROUTINE]);
+    repro->routine[lengths[ROUTINE]] = '\0';
+    if (!checkName(repro->routine))
+        return SYNTAX_ERROR;
+
+    int error = parseNumber(values[STATE], lengths[STATE], 1, &repro->state,
+                            NULL);
+    for (enum ReproTag tag = BUDGET; tag <= ELAPSED; tag++)
+        if (error == NO_ERROR && values[tag] != NULL)
+            error = parseNumber(values[tag], lengths[tag], 0, NULL,
+                                tag == BUDGET ? &repro->budget :
+                                &repro->elapsed);
+    if (error == NO_ERROR && values[PHASES] != NULL)
+        error = parsePhases(repro, values[PHASES], lengths[PHASES]);
+    if (error != NO_ERROR)
+        return error;
+
+    if (lengths[SNAPSHOT] % 2 != 0 ||
+        lengths[SNAPSHOT] / 2 > SNAPSHOT_MAX_SIZE)
+        return SYNTAX_ERROR;
+    repro->snapshotLength = lengths[SNAPSHOT] / 2;
+    for (int i = 0; i < repro->snapshotLength; i++) {
+        int high = hexValue(values[SNAPSHOT][2 * i]);
+        int low = hexValue(values[SNAPSHOT][2 * i + 1]);
+        if (high < 0 || low < 0)
+            return SYNTAX_ERROR;
+        repro->snapshot[i] = high << 4 | low;
+    }
+
+    return NO_ERROR;
+}
+
+int repro_parseRepro(struct Repro *repro, const char *text,
+                     const size_t length)
+{
+    if (repro == NULL || text == NULL)
+        return POINTER_NULL;
+
+    const char *values[ReproTagEnd] = {NULL};
+    size_t lengths[ReproTagEnd] = {0};
+    const char *position = text;
+    const char *end = text + length;
+    int tagsNumber = 0;
+
+    memset(repro, 0, sizeof(struct Repro));
+    while (position < end) {
+        const char *lineEnd = memchr(position, '\n', end - position);
+        const char *next = lineEnd != NULL ? lineEnd + 1 : end;
+        if (lineEnd == NULL)
+            lineEnd = end;
+        if (lineEnd > position && lineEnd[-1] == '\r')
+            lineEnd--;
+
+        const char *line = position;
+        position = next;
+        while (line < lineEnd && (*line == ' ' || *line == '\t'))
+            line++;
+
+        if (line == lineEnd) {
+            if (tagsNumber > 0)
+                break;
+            continue;
+        }
+        if (*line == '%')
+            continue;
+
+        const char *nameEnd = memchr(line, ' ', lineEnd - line);
+        if (*line != '[' || nameEnd == NULL || lineEnd - nameEnd < 4 ||
+            nameEnd[1] != '"' || lineEnd[-1] != ']' || lineEnd[-2] != '"')
+            return SYNTAX_ERROR;
+
+        tagsNumber++;
+        line++;
+        for (enum ReproTag tag = ROUTINE; tag < ReproTagEnd; tag++) {
+            size_t nameLength = strlen(TAG_NAMES[tag]);
+            if ((size_t)(nameEnd - line) == nameLength &&
+                memcmp(line, TAG_NAMES[tag], nameLength) == 0) {
+                values[tag] = nameEnd + 2;
+                lengths[tag] = lineEnd - 2 - values[tag];
+            }
+        }
+    }
+
+    if (tagsNumber == 0)
+        return 0;
+
+    int error = parseTags(repro, values, lengths);
+    if (error != NO_ERROR)
+        return error;
+
+    return position - text;
+}
@@ -0,0 +1,244 @@
+/**
+ * @file repro.h
+ * @brief Repro and ReproRecorder structures, which capture the decisions
+ *        of a bot that used more than their time as reproducible cases, as
+ *        well as the functions used to write and read them.
+ *
+ * The host tells the recorder when a decision starts, with the routine,
+ * the state of its random generator and its time, then the time of every
+ * phase of the decision, then the time the decision used. When that time
+ * is more than the time of the decision, the position is saved with
+ * snapshot_writeGame in the next slot of the recorder, which are all
+ * allocated with it, so nothing is allocated while the bot decides. The
+ * host writes the captured decisions later, in a text close to the
+ * notation of rounds:
+ *
+ *     [Routine "legalMoves"]
+ *     [State "8964215913410958812"]
+ *     [Budget "0.000100000"]
+ *     [Elapsed "0.000341250"]
+ *     [Phases "turn=0.000000210 decide=0.000341040"]
+ *     [Snapshot "43475301..."]
+ *
+ * Times are in seconds and Snapshot holds the bytes of the snapshot in
+ * hexadecimal. `cruceLatency -R FILE` rebuilds the positions and measures
+ * the routines again, so the slow decisions stay as benchmarks.
+ */
+
+#ifndef REPRO_H
+#define REPRO_H
+
+#include "platform.h"
+#include "game.h"
+#include "snapshot.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The maximum number of phases of a decision.
+ */
+#define REPRO_MAX_PHASES 8
+
+/**
+ * @brief The maximum length of the name of a routine or a phase, with the
+ *        null terminator.
+ */
+#define REPRO_NAME_LENGTH 32
+
+/**
+ * @brief The maximum length of a written repro.
+ */
+#define REPRO_MAX_LENGTH (2 * SNAPSHOT_MAX_SIZE + 1024)
+
+/**
+ * @struct Repro
+ * @brief A captured decision.
+ *
+ * @var Repro::routine
+ *     The name of the routine which decided.
+ * @var Repro::state
+ *     The state of the random generator of the routine when it started.
+ * @var Repro::budget
+ *     The time of the decision, in seconds.
+ * @var Repro::elapsed
+ *     The time the decision used, in seconds.
+ * @var Repro::phasesNumber
+ *     The number of phases of the decision.
+ * @var Repro::phaseNames
+ *     The name of every phase.
+ * @var Repro::phaseTimes
+ *     The time of every phase, in seconds.
+ * @var Repro::snapshotLength
+ *     The length of the snapshot.
+ * @var Repro::snapshot
+ *     The snapshot of the game before the decision.
+ */
+struct Repro {
+    char routine[REPRO_NAME_LENGTH];
+    uint64_t state;
+    double budget;
+    double elapsed;
+    int phasesNumber;
+    char phaseNames[REPRO_MAX_PHASES][REPRO_NAME_LENGTH];
+    double phaseTimes[REPRO_MAX_PHASES];
+    int snapshotLength;
+    unsigned char snapshot[SNAPSHOT_MAX_SIZE];
+};
+
+/**
+ * @struct ReproRecorder
+ * @brief The decision being timed and the slots of the captured ones. A
+ *        recorder is used by one thread.
+ *
+ * @var ReproRecorder::routine
+ *     The name of the routine of the current decision.
+ * @var ReproRecorder::state
+ *     The state of the random generator of the current decision.
+ * @var ReproRecorder::budget
+ *     The time of the current decision, in seconds.
+ * @var ReproRecorder::phasesNumber
+ *     The number of phases of the current decision timed so far.
+ * @var ReproRecorder::phaseNames
+ *     The name of every phase of the current decision.
+ * @var ReproRecorder::phaseTimes
+ *     The time of every phase of the current decision, in seconds.
+ * @var ReproRecorder::repros
+ *     The slots of the captured decisions.
+ * @var ReproRecorder::capacity
+ *     The number of slots.
+ * @var ReproRecorder::reprosNumber
+ *     The number of captured decisions in the slots.
+ * @var ReproRecorder::decisionsNumber
+ *     The number of decisions timed.
+ * @var ReproRecorder::capturedNumber
+ *     The number of decisions captured.
+ * @var ReproRecorder::droppedNumber
+ *     The number of decisions which used more than their time while all
+ *     the slots were taken.
+ */
+struct ReproRecorder {
+    const char *routine;
+    uint64_t state;
+    double budget;
+    int phasesNumber;
+    const char *phaseNames[REPRO_MAX_PHASES];
+    double phaseTimes[REPRO_MAX_PHASES];
+    struct Repro *repros;
+    int capacity;
+    int reprosNumber;
+    long decisionsNumber;
+    long capturedNumber;
+    long droppedNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates a recorder and its slots.
+ *
+ * @param capacity The number of slots.
+ *
+ * @return Pointer to the new recorder on success or NULL on failure.
+ */
+EXPORT struct ReproRecorder *repro_createRecorder(const int capacity);
+
+/**
+ * @brief Frees the memory of a recorder and sets the pointer to NULL.
+ *
+ * @param recorder Pointer to the pointer to the recorder.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int repro_deleteRecorder(struct ReproRecorder **recorder);
+
+/**
+ * @brief Starts timing a decision.
+ *
+ * @param recorder The recorder.
+ * @param routine The name of the routine which decides. It is kept until
+ *                the decision is finished, not copied.
+ * @param state The state of the random generator of the routine.
+ * @param budget The time of the decision, in seconds.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int repro_startDecision(struct ReproRecorder *recorder,
+                               const char *routine, const uint64_t state,
+                               const double budget);
+
+/**
+ * @brief Adds the time of a phase of the current decision. The phases
+ *        after the first REPRO_MAX_PHASES are not kept.
+ *
+ * @param recorder The recorder.
+ * @param name The name of the phase, without spaces, '=' or quotes. It is
+ *             kept until the decision is finished, not copied.
+ * @param time The time of the phase, in seconds.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int repro_addPhase(struct ReproRecorder *recorder, const char *name,
+                          const double time);
+
+/**
+ * @brief Finishes the current decision, and captures it if it used more
+ *        than its time.
+ *
+ * @param recorder The recorder.
+ * @param game The game as it was when the decision started.
+ * @param elapsed The time the decision used, in seconds.
+ *
+ * @return 1 if the decision was captured, 0 if it was not, negative value
+ *         on failure.
+ */
+EXPORT int repro_finishDecision(struct ReproRecorder *recorder,
+                                const struct Game *game,
+                                const double elapsed);
+
+/**
+ * @brief Empties the slots of a recorder, once the host wrote them.
+ *
+ * @param recorder The recorder.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int repro_clearRecorder(struct ReproRecorder *recorder);
+
+/**
+ * @brief Writes a captured decision, followed by an empty line.
+ *
+ * @param repro The decision.
+ * @param text Buffer where the decision is written. It is not null
+ *             terminated.
+ * @param size The size of the buffer.
+ *
+ * @return The number of bytes written on success, negative value on failure.
+ */
+EXPORT int repro_writeRepro(const struct Repro *repro, char *text,
+                            const size_t size);
+
+/**
+ * @brief Parses the first captured decision from a text.
+ *
+ * The decision ends at the first empty line or at the end of the text.
+ * Routine, State and Snapshot are required. Unknown tags and lines
+ * starting with '%' are ignored.
+ *
+ * @param repro Where the decision is stored.
+ * @param text The text.
+ * @param length The length of the text.
+ *
+ * @return The number of bytes consumed on success (0 if the text contains
+ *         no decision), negative value on failure.
+ */
+EXPORT int repro_parseRepro(struct Repro *repro, const char *text,
+                            const size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -32,6 +32,8 @@ struct Round *round_createRound()
     for (int i = 0; i < MAX_GAME_PLAYERS; i++)
         round->pointsNumber[i] = 0;
 
+    round->hooks = NULL;
+
     return round;
 }
 
@@ -131,6 +133,7 @@ int round_placeBid(const struct Player *player, const int bid,
         return NOT_FOUND;
 
     round->bids[index] = bid;
+    HOOKS_EMIT(round->hooks, bidPlaced, struct BidEvent, round, player, bid);
 
     return NO_ERROR;
 }
@@ -232,6 +235,8 @@ int round_putCard(struct Player *player, const int cardId,
             enum Suit suit = player->hand[cardId]->suit;
             int value = player->hand[cardId]->value;
             player->hand[cardId] = NULL;
+            HOOKS_EMIT(round->hooks, cardPut, struct CardEvent, round,
+                       player, round->hands[handId]->cards[i], handId);
             if (i == 0 && (value == 3 || value == 4)) {
                 int check = 0;
                 for (int j = 0; j < MAX_CARDS; j++) {
@@ -244,10 +249,11 @@ int round_putCard(struct Player *player, const int cardId,
                 }
                 if (check == 1) {
                     int position = round_findPlayerIndexRound(player, round);
-                    if (suit == round->trump)
-                        round->pointsNumber[position] += 40;
-                    else
-                        round->pointsNumber[position] += 20;
+                    int points = suit == round->trump ? 40 : 20;
+                    round->pointsNumber[position] += points;
+                    HOOKS_EMIT(round->hooks, marriageScored,
+                               struct MarriageEvent, round, player, suit,
+                               points);
                 }
             }
             return NO_ERROR;
@@ -312,7 +318,10 @@ struct Player *round_handWinner(const struct Hand *hand, struct Round *round)
 
     int playerWinner_inRound = 
         round_findPlayerIndexRound(hand->players[playerWinner], round);
-    round->pointsNumber[playerWinner_inRound] += totalPointsNumber(hand);
+    int points = totalPointsNumber(hand);
+    round->pointsNumber[playerWinner_inRound] += points;
+    HOOKS_EMIT(round->hooks, trickWon, struct TrickEvent, round, hand,
+               hand->players[playerWinner], points);
     return hand->players[playerWinner];
 }
 
@@ -11,6 +11,7 @@
 #include "team.h"
 #include "constants.h"
 #include "errors.h"
+#include "hooks.h"
 
 /**
  * @struct Hand
@@ -47,6 +48,8 @@ struct Hand{
  *     Pointer to the players of the round.
  * @var Round::pointsNumber
  *     The total amount of points of the round.
+ * @var Round::hooks
+ *     The hooks of the game of the round, NULL if none are registered.
  */
 struct Round{
     enum Suit trump;
@@ -54,6 +57,7 @@ struct Round{
     int bids[MAX_GAME_PLAYERS];
     struct Player *players[MAX_GAME_PLAYERS];
     int pointsNumber[MAX_GAME_PLAYERS];
+    const struct GameHooks *hooks;
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,307 @@
+/**
+ * @file sampling.c
+ * @brief Contains implementations of the functions used to deal random
+ *        rounds in which the bid winner holds a hand of a chosen stratum.
+ */
+
+#include "sampling.h"
+#include "simulation.h"
+#include "errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief The bits of the queen and of the king of a suit.
+ */
+#define MARRIAGE_CARDS 0x06
+
+/**
+ * @brief The bit of the ace of a suit.
+ */
+#define ACE_CARD 0x20
+
+/**
+ * @brief The number of subsets of the cards of a suit.
+ */
+#define SUIT_SUBSETS (1 << SUIT_SIZE)
+
+/**
+ * @brief Helper to count the cards of a bit mask.
+ */
+static int countCards(uint32_t cards)
+{
+    cards = cards - ((cards >> 1) & 0x55555555);
+    cards = (cards & 0x33333333) + ((cards >> 2) & 0x33333333);
+    cards = (cards + (cards >> 4)) & 0x0F0F0F0F;
+
+    return (cards * 0x01010101) >> 24;
+}
+
+/**
+ * @brief Helper to draw a number from 0 to bound - 1.
+ */
+static uint32_t randomInt(uint64_t *state, const uint32_t bound)
+{
+    return (uint32_t)(((simulation_random(state) >> 32) * bound) >> 32);
+}
+
+/**
+ * @brief Helper to give the number of hands with a subset of a suit.
+ *
+ * @return The number of ways of choosing the cards of the suits after
+ *         suit, 0 if the counts left are not reachable.
+ */
+static uint32_t completions(const struct DealSampler *sampler,
+                            const int suit, const uint32_t subset,
+                            const int cards, const int aces,
+                            const int marriages)
+{
+    int cardsLeft = cards - countCards(subset);
+    int acesLeft = aces - ((subset & ACE_CARD) != 0);
+    int marriagesLeft = marriages -
+                        ((subset & MARRIAGE_CARDS) == MARRIAGE_CARDS);
+    if (cardsLeft < 0 || acesLeft < 0 || marriagesLeft < 0)
+        return 0;
+
+    return sampler->ways[suit + 1][cardsLeft][acesLeft][marriagesLeft];
+}
+
+/**
+ * @brief Helper to choose the subset of a suit of a hand, every hand with
+ *        the counts left being equally likely.
+ *
+ * @param trumps The number of cards of the subset, -1 for any number.
+ *
+ * @return The subset.
+ */
+static uint32_t chooseSubset(const struct DealSampler *sampler,
+                             const int suit, const int trumps,
+                             const int cards, const int aces,
+                             const int marriages, uint64_t *state)
+{
+    uint32_t counts[SUIT_SUBSETS];
+    uint32_t total = 0;
+    for (uint32_t subset = 0; subset < SUIT_SUBSETS; subset++) {
+        counts[subset] = trumps < 0 || countCards(subset) == trumps ?
+                         completions(sampler, suit, subset, cards, aces,
+                                     marriages) : 0;
+        total += counts[subset];
+    }
+
+    uint32_t chosen = randomInt(state, total);
+    uint32_t subset = 0;
+    while (chosen >= counts[subset])
+        chosen -= counts[subset++];
+
+    return subset;
+}
+
+/**
+ * @brief Helper to shuffle cards.
+ */
+static void shuffleCards(unsigned char *cards, const int cardsNumber,
+                         uint64_t *state)
+{
+    for (int i = cardsNumber - 1; i > 0; i--) {
+        int j = randomInt(state, i + 1);
+        unsigned char id = cards[i];
+        cards[i] = cards[j];
+        cards[j] = id;
+    }
+}
+
+struct DealSampler *sampling_createSampler(const int playersNumber)
+{
+    if (playersNumber < 2 || playersNumber > MAX_GAME_PLAYERS)
+        return NULL;
+
+    struct DealSampler *sampler = calloc(1, sizeof(struct DealSampler));
+    if (sampler == NULL)
+        return NULL;
+
+    sampler->playersNumber = playersNumber;
+    sampler->handSize = DECK_SIZE / playersNumber < MAX_CARDS ?
+                        DECK_SIZE / playersNumber : MAX_CARDS;
+
+    sampler->ways[SuitEnd][0][0][0] = 1;
+    for (int suit = SuitEnd - 1; suit >= 0; suit--)
+        for (int c = 0; c <= MAX_CARDS; c++)
+            for (int a = 0; a < SAMPLING_HONOURS; a++)
+                for (int m = 0; m < SAMPLING_HONOURS; m++)
+                    for (uint32_t subset = 0; subset < SUIT_SUBSETS;
+                         subset++)
+                        sampler->ways[suit][c][a][m] +=
+                            completions(sampler, suit, subset, c, a, m);
+
+    double hands = 0;
+    for (int a = 0; a < SAMPLING_HONOURS; a++)
+        for (int m = 0; m < SAMPLING_HONOURS; m++)
+            hands += sampler->ways[0][sampler->handSize][a][m];
+
+    for (int t = 0; t < SAMPLING_TRUMPS; t++)
+        for (int a = 0; a < SAMPLING_HONOURS; a++)
+            for (int m = 0; m < SAMPLING_HONOURS; m++) {
+                uint32_t count = 0;
+                for (uint32_t subset = 0; subset < SUIT_SUBSETS; subset++)
+                    if (countCards(subset) == t)
+                        count += completions(sampler, 0, subset,
+                                             sampler->handSize, a, m);
+                int stratum = (t * SAMPLING_HONOURS + a) *
+                              SAMPLING_HONOURS + m;
+                sampler->probabilities[stratum] = count / hands;
+            }
+    memcpy(sampler->proposal, sampler->probabilities,
+           sizeof(sampler->proposal));
+
+    return sampler;
+}
+
+int sampling_deleteSampler(struct DealSampler **sampler)
+{
+    if (sampler == NULL)
+        return POINTER_NULL;
+    if (*sampler == NULL)
+        return SAMPLER_NULL;
+
+    free(*sampler);
+    *sampler = NULL;
+
+    return NO_ERROR;
+}
+
+int sampling_handStratum(const struct RoundRecord *record, const int seat)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    int playersNumber = record->playersNumber;
+    if (playersNumber < 2 || playersNumber > MAX_GAME_PLAYERS ||
+        seat < 0 || seat >= playersNumber ||
+        record->trump < 0 || record->trump >= SuitEnd)
+        return ILLEGAL_VALUE;
+
+    int handSize = DECK_SIZE / playersNumber < MAX_CARDS ?
+                   DECK_SIZE / playersNumber : MAX_CARDS;
+    uint32_t suits[SuitEnd] = {0};
+    for (int i = seat; i < handSize * playersNumber; i += playersNumber) {
+        if (record->deck[i] >= DECK_SIZE)
+            return ILLEGAL_VALUE;
+        suits[record->deck[i] / SUIT_SIZE] |=
+            1u << record->deck[i] % SUIT_SIZE;
+    }
+
+    int aces = 0, marriages = 0;
+    for (int i = 0; i < SuitEnd; i++) {
+        aces += (suits[i] & ACE_CARD) != 0;
+        marriages += (suits[i] & MARRIAGE_CARDS) == MARRIAGE_CARDS;
+    }
+
+    return (countCards(suits[record->trump]) * SAMPLING_HONOURS + aces) *
+           SAMPLING_HONOURS + marriages;
+}
+
+int sampling_tiltProposal(struct DealSampler *sampler, const double tilt)
+{
+    if (sampler == NULL)
+        return SAMPLER_NULL;
+    if (!(tilt > 0))
+        return ILLEGAL_VALUE;
+
+    double sum = 0;
+    for (int i = 0; i < SAMPLING_STRATA; i++) {
+        int strength = i / (SAMPLING_HONOURS * SAMPLING_HONOURS) +
+                       i / SAMPLING_HONOURS % SAMPLING_HONOURS +
+                       i % SAMPLING_HONOURS;
+        double proposal = sampler->probabilities[i];
+        for (int j = 0; j < strength; j++)
+            proposal *= tilt;
+        sampler->proposal[i] = proposal;
+        sum += proposal;
+    }
+    if (!(sum > 0) || sum > 1e300)
+        return ILLEGAL_VALUE;
+
+    for (int i = 0; i < SAMPLING_STRATA; i++)
+        sampler->proposal[i] /= sum;
+
+    return NO_ERROR;
+}
+
+int sampling_drawStratum(const struct DealSampler *sampler, uint64_t *state,
+                         double *weight)
+{
+    if (sampler == NULL)
+        return SAMPLER_NULL;
+    if (state == NULL || weight == NULL)
+        return POINTER_NULL;
+
+    double chosen = (simulation_random(state) >> 11) /
+                    9007199254740992.0;
+    int stratum = -1;
+    for (int i = 0; i < SAMPLING_STRATA; i++) {
+        if (sampler->proposal[i] == 0)
+            continue;
+        stratum = i;
+        if (chosen < sampler->proposal[i])
+            break;
+        chosen -= sampler->proposal[i];
+    }
+    if (stratum < 0)
+        return NOT_FOUND;
+
+    *weight = sampler->probabilities[stratum] / sampler->proposal[stratum];
+
+    return stratum;
+}
+
+int sampling_drawDeal(const struct DealSampler *sampler,
+                      struct RoundRecord *record, const int stratum,
+                      const int bid, uint64_t *state)
+{
+    if (sampler == NULL)
+        return SAMPLER_NULL;
+    if (record == NULL)
+        return RECORD_NULL;
+    if (state == NULL)
+        return POINTER_NULL;
+    if (stratum < 0 || stratum >= SAMPLING_STRATA ||
+        sampler->probabilities[stratum] == 0 || bid < 0 || bid > 6)
+        return ILLEGAL_VALUE;
+
+    int trumps = stratum / (SAMPLING_HONOURS * SAMPLING_HONOURS);
+    int aces = stratum / SAMPLING_HONOURS % SAMPLING_HONOURS;
+    int marriages = stratum % SAMPLING_HONOURS;
+    int cards = sampler->handSize;
+    int trump = randomInt(state, SuitEnd);
+
+    unsigned char hand[MAX_CARDS];
+    unsigned char others[DECK_SIZE];
+    int handNumber = 0, othersNumber = 0;
+    for (int suit = 0; suit < SuitEnd; suit++) {
+        uint32_t subset = chooseSubset(sampler, suit, suit == 0 ? trumps : -1,
+                                       cards, aces, marriages, state);
+        cards -= countCards(subset);
+        aces -= (subset & ACE_CARD) != 0;
+        marriages -= (subset & MARRIAGE_CARDS) == MARRIAGE_CARDS;
+
+        int first = (trump + suit) % SuitEnd * SUIT_SIZE;
+        for (int i = 0; i < SUIT_SIZE; i++)
+            if (subset >> i & 1)
+                hand[handNumber++] = first + i;
+            else
+                others[othersNumber++] = first + i;
+    }
+    shuffleCards(hand, handNumber, state);
+    shuffleCards(others, othersNumber, state);
+
+    memset(record, 0, sizeof(struct RoundRecord));
+    record->playersNumber = sampler->playersNumber;
+    int dealt = sampler->handSize * sampler->playersNumber;
+    for (int i = 0, h = 0, o = 0; i < DECK_SIZE; i++)
+        record->deck[i] = i < dealt && i % sampler->playersNumber == 0 ?
+                          hand[h++] : others[o++];
+    record->bids[0] = bid;
+    record->trump = trump;
+
+    return NO_ERROR;
+}
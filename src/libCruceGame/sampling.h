@@ -0,0 +1,153 @@
+/**
+ * @file sampling.h
+ * @brief DealSampler structure and the functions used to deal random rounds
+ *        in which the bid winner holds a hand of a chosen kind, so the rare
+ *        rounds, such as the ones with a bid of 5 or 6, are estimated with
+ *        few samples.
+ *
+ * The first cards dealt to the bid winner, seat 0, are classified in
+ * strata by the number of trumps, the number of aces and the number of
+ * marriages they hold. The probability of every stratum under a uniform
+ * deal is counted exactly, suit by suit, and a deal of a stratum is drawn
+ * uniformly among the deals of the stratum with the same counts, so a
+ * stratified estimate is the sum of the mean of every stratum times its
+ * probability. For importance sampling the strata are drawn from a
+ * proposal and every deal has the weight of its stratum, its probability
+ * divided by its probability in the proposal: the mean of the weighted
+ * values is an unbiased estimate of their mean under uniform deals.
+ */
+
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include "platform.h"
+#include "record.h"
+
+#include <stdint.h>
+
+/**
+ * @brief The number of values of the number of trumps of a hand.
+ */
+#define SAMPLING_TRUMPS (SUIT_SIZE + 1)
+
+/**
+ * @brief The number of values of the number of aces, or of marriages, of a
+ *        hand.
+ */
+#define SAMPLING_HONOURS (SuitEnd + 1)
+
+/**
+ * @brief The number of strata. The stratum of a hand with t trumps, a aces
+ *        and m marriages is (t * SAMPLING_HONOURS + a) * SAMPLING_HONOURS + m.
+ */
+#define SAMPLING_STRATA (SAMPLING_TRUMPS * SAMPLING_HONOURS * SAMPLING_HONOURS)
+
+/**
+ * @struct DealSampler
+ * @brief The strata of the hands of the bid winner for a number of players.
+ *
+ * @var DealSampler::playersNumber
+ *     The number of players.
+ * @var DealSampler::handSize
+ *     The number of cards of a hand when the deck is distributed.
+ * @var DealSampler::probabilities
+ *     The probability of every stratum under a uniform deal.
+ * @var DealSampler::proposal
+ *     The probability with which every stratum is drawn.
+ * @var DealSampler::ways
+ *     ways[s][c][a][m] is the number of ways of choosing c cards with a
+ *     aces and m marriages from the suits s to SuitEnd - 1, counted from
+ *     the trump.
+ */
+struct DealSampler {
+    int playersNumber;
+    int handSize;
+    double probabilities[SAMPLING_STRATA];
+    double proposal[SAMPLING_STRATA];
+    uint32_t ways[SuitEnd + 1][MAX_CARDS + 1][SAMPLING_HONOURS]
+                 [SAMPLING_HONOURS];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates and counts the strata of a number of players. The
+ *        proposal is the distribution of the strata under a uniform deal.
+ *
+ * @param playersNumber The number of players, 2 to 4.
+ *
+ * @return Pointer to the new sampler on success or NULL on failure.
+ */
+EXPORT struct DealSampler *sampling_createSampler(const int playersNumber);
+
+/**
+ * @brief Frees the memory of a sampler and sets the pointer to NULL.
+ *
+ * @param sampler Pointer to the pointer to be freed.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int sampling_deleteSampler(struct DealSampler **sampler);
+
+/**
+ * @brief Finds the stratum of the first cards dealt to a seat.
+ *
+ * @param record The round, with its deck and its trump.
+ * @param seat The seat.
+ *
+ * @return The stratum on success, negative value on failure.
+ */
+EXPORT int sampling_handStratum(const struct RoundRecord *record,
+                                const int seat);
+
+/**
+ * @brief Tilts the proposal toward strong hands: the probability of a
+ *        stratum is multiplied by tilt to the power of the number of
+ *        trumps, aces and marriages, and the proposal is normalized.
+ *
+ * @param sampler The sampler.
+ * @param tilt The tilt, 1 for the distribution under a uniform deal.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int sampling_tiltProposal(struct DealSampler *sampler,
+                                 const double tilt);
+
+/**
+ * @brief Draws a stratum from the proposal.
+ *
+ * @param sampler The sampler.
+ * @param state The state of the generator (see simulation_random).
+ * @param weight Where the probability of the stratum divided by its
+ *               probability in the proposal is stored.
+ *
+ * @return The stratum on success, negative value on failure.
+ */
+EXPORT int sampling_drawStratum(const struct DealSampler *sampler,
+                                uint64_t *state, double *weight);
+
+/**
+ * @brief Deals a random round in which seat 0 wins the bid with a hand of
+ *        a stratum. Every deal of the stratum is equally likely and the
+ *        trump is drawn uniformly.
+ *
+ * @param sampler The sampler.
+ * @param record The record where the players number, the deck, the bids
+ *               and the trump are stored, ready for simulation_playDeal.
+ * @param stratum The stratum, whose probability is not 0.
+ * @param bid The bid of seat 0, the other seats bid 0.
+ * @param state The state of the generator (see simulation_random).
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int sampling_drawDeal(const struct DealSampler *sampler,
+                             struct RoundRecord *record, const int stratum,
+                             const int bid, uint64_t *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
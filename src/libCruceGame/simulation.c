@@ -0,0 +1,335 @@
+/**
+ * @file simulation.c
+ * @brief Contains implementations of the functions used to simulate random
+ *        rounds and to gather statistics about them.
+ */
+
+#include "simulation.h"
+#include "replay.h"
+#include "round.h"
+#include "team.h"
+#include "errors.h"
+
+#include <string.h>
+
+/**
+ * @brief Helper to mix the bits of a number (the finalizer of SplitMix64).
+ */
+static uint64_t mix(uint64_t value)
+{
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+
+    return value ^ (value >> 31);
+}
+
+uint64_t simulation_seed(const uint64_t seed, const long gameIndex)
+{
+    return mix(seed ^ mix((uint64_t)gameIndex + 0x9E3779B97F4A7C15ULL));
+}
+
+uint64_t simulation_random(uint64_t *state)
+{
+    *state += 0x9E3779B97F4A7C15ULL;
+
+    return mix(*state);
+}
+
+/**
+ * @brief Helper to draw a number from 0 to bound - 1.
+ */
+static int randomInt(uint64_t *state, const int bound)
+{
+    return (int)(((simulation_random(state) >> 32) * (uint64_t)bound) >> 32);
+}
+
+/**
+ * @brief Helper to choose the deal, the bids and the trump of a round.
+ */
+static void chooseDeal(struct RoundRecord *record, const int playersNumber,
+                       uint64_t *state)
+{
+    memset(record, 0, sizeof(struct RoundRecord));
+    record->playersNumber = playersNumber;
+    for (int i = 0; i < DECK_SIZE; i++)
+        record->deck[i] = i;
+    for (int i = DECK_SIZE - 1; i > 0; i--) {
+        int j = randomInt(state, i + 1);
+        int id = record->deck[i];
+        record->deck[i] = record->deck[j];
+        record->deck[j] = id;
+    }
+
+    int maximumBid = 0;
+    for (int i = 0; i < playersNumber; i++) {
+        int bid = randomInt(state, 7);
+        if (bid > maximumBid) {
+            record->bids[i] = bid;
+            maximumBid = bid;
+        }
+    }
+    record->trump = randomInt(state, SuitEnd);
+}
+
+/**
+ * @brief Helper to give the seats of a round their names and teams. Four
+ *        players play in two teams.
+ */
+static void seatPlayers(struct RoundRecord *record)
+{
+    static const char *NAMES[MAX_GAME_PLAYERS] = {"North", "East", "South",
+                                                  "West"};
+
+    for (int i = 0; i < record->playersNumber; i++) {
+        strcpy(record->names[i], NAMES[i]);
+        record->teams[i] = record->playersNumber == MAX_GAME_PLAYERS ?
+                           i % 2 : i;
+    }
+}
+
+/**
+ * @brief Helper to put down random allowed cards until the round is over.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+static int playCards(struct Game *game, uint64_t *state)
+{
+    struct Round *round = game->round;
+    int handId;
+    int position;
+
+    while (replay_findTurn(game, &handId, &position) == NO_ERROR) {
+        struct Hand *hand = round->hands[handId];
+        struct Player *player = hand->players[position];
+        int allowed[MAX_CARDS];
+        int allowedNumber = 0;
+        for (int i = 0; i < MAX_CARDS; i++)
+            if (player->hand[i] != NULL &&
+                game_checkCard(player, game, hand, i) == 1)
+                allowed[allowedNumber++] = i;
+        if (allowedNumber == 0)
+            return NOT_FOUND;
+
+        int error = round_putCard(player,
+                                  allowed[randomInt(state, allowedNumber)],
+                                  handId, round);
+        if (error != NO_ERROR)
+            return error;
+        if (position < game->numberPlayers - 1)
+            continue;
+
+        struct Player *winner = round_handWinner(hand, round);
+        if (winner == NULL)
+            return ERROR_COMPARE;
+        if (deck_cardsNumber(game->deck) > 0) {
+            error = round_distributeCard(game->deck, round);
+            if (error != NO_ERROR)
+                return error;
+        }
+        if (team_hasCards(winner)) {
+            error = round_arrangePlayersHand(round,
+                                        round_findPlayerIndexRound(winner,
+                                                                   round));
+            if (error != NO_ERROR)
+                return error;
+        }
+    }
+
+    return game_updateScore(game, round_getBidWinner(round));
+}
+
+int simulation_playRound(struct RoundRecord *record, const int playersNumber,
+                         const uint64_t seed, const long gameIndex)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (playersNumber < 2 || playersNumber > MAX_GAME_PLAYERS ||
+        gameIndex < 0)
+        return ILLEGAL_VALUE;
+
+    uint64_t state = simulation_seed(seed, gameIndex);
+    chooseDeal(record, playersNumber, &state);
+
+    return simulation_playDeal(record, &state);
+}
+
+int simulation_playDeal(struct RoundRecord *record, uint64_t *state)
+{
+    if (record == NULL)
+        return RECORD_NULL;
+    if (state == NULL)
+        return POINTER_NULL;
+    if (record->playersNumber < 2 ||
+        record->playersNumber > MAX_GAME_PLAYERS)
+        return ILLEGAL_VALUE;
+
+    seatPlayers(record);
+    struct Game *game = replay_createGame(record, 0);
+    if (game == NULL)
+        return MALLOC_ERROR;
+    struct Deck *deck = record_createDeck(record);
+    if (deck == NULL) {
+        replay_deleteGame(&game);
+        return MALLOC_ERROR;
+    }
+
+    int error = playCards(game, state);
+    if (error == NO_ERROR)
+        error = record_captureDeal(record, deck);
+    if (error == NO_ERROR)
+        error = record_captureRound(record, game);
+
+    deck_deleteDeck(&deck);
+    replay_deleteGame(&game);
+
+    return error;
+}
+
+int simulation_initStats(struct SimulationStats *stats)
+{
+    if (stats == NULL)
+        return POINTER_NULL;
+
+    memset(stats, 0, sizeof(struct SimulationStats));
+
+    return NO_ERROR;
+}
+
+int simulation_addRound(struct SimulationStats *stats,
+                        const struct RoundRecord *record)
+{
+    return simulation_addWeightedRound(stats, record, 1);
+}
+
+int simulation_addWeightedRound(struct SimulationStats *stats,
+                                const struct RoundRecord *record,
+                                const double weight)
+{
+    if (stats == NULL)
+        return POINTER_NULL;
+    if (record == NULL)
+        return RECORD_NULL;
+
+    int bidMade = record_bidMade(record);
+    if (bidMade < 0)
+        return bidMade;
+
+    stats->roundsNumber++;
+    stats->bidsMade += bidMade;
+    double made = weight * bidMade - stats->weightedBidsMade;
+    stats->weightedBidsMade += made / stats->roundsNumber;
+    stats->weightedDeviations += made * (weight * bidMade -
+                                         stats->weightedBidsMade);
+    for (int i = 0; i < record->playersNumber; i++) {
+        double delta = record->pointsNumber[i] - stats->meanPoints[i];
+        stats->meanPoints[i] += delta / stats->roundsNumber;
+        stats->squaredDeviations[i] +=
+            delta * (record->pointsNumber[i] - stats->meanPoints[i]);
+        stats->meanScores[i] += (record->scores[i] - stats->meanScores[i]) /
+                                stats->roundsNumber;
+    }
+
+    return NO_ERROR;
+}
+
+int simulation_mergeStats(struct SimulationStats *stats,
+                          const struct SimulationStats *other)
+{
+    if (stats == NULL || other == NULL)
+        return POINTER_NULL;
+    if (other->roundsNumber == 0)
+        return NO_ERROR;
+
+    double count = stats->roundsNumber;
+    double otherCount = other->roundsNumber;
+    double total = count + otherCount;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        double delta = other->meanPoints[i] - stats->meanPoints[i];
+        stats->meanPoints[i] += delta * otherCount / total;
+        stats->squaredDeviations[i] += other->squaredDeviations[i] +
+                                       delta * delta * count * otherCount /
+                                       total;
+        stats->meanScores[i] += (other->meanScores[i] -
+                                 stats->meanScores[i]) * otherCount / total;
+    }
+    double delta = other->weightedBidsMade - stats->weightedBidsMade;
+    stats->weightedBidsMade += delta * otherCount / total;
+    stats->weightedDeviations += other->weightedDeviations +
+                                 delta * delta * count * otherCount / total;
+    stats->roundsNumber += other->roundsNumber;
+    stats->bidsMade += other->bidsMade;
+
+    return NO_ERROR;
+}
+
+int simulation_reduceStats(struct SimulationStats *stats, const int count)
+{
+    if (stats == NULL)
+        return POINTER_NULL;
+    if (count < 1)
+        return ILLEGAL_VALUE;
+
+    for (int step = 1; step < count; step *= 2)
+        for (int i = 0; i + step < count; i += 2 * step)
+            simulation_mergeStats(&stats[i], &stats[i + step]);
+
+    return NO_ERROR;
+}
+
+int simulation_initReducer(struct StatsReducer *reducer)
+{
+    if (reducer == NULL)
+        return POINTER_NULL;
+
+    reducer->blocksNumber = 0;
+
+    return NO_ERROR;
+}
+
+int simulation_pushStats(struct StatsReducer *reducer,
+                         const struct SimulationStats *stats)
+{
+    if (reducer == NULL || stats == NULL)
+        return POINTER_NULL;
+
+    // Like incrementing a binary counter: the full levels are merged into
+    // the new block, with the older blocks on the left.
+    struct SimulationStats node = *stats;
+    int level = 0;
+    for (; (reducer->blocksNumber >> level) & 1; level++) {
+        simulation_mergeStats(&reducer->levels[level], &node);
+        node = reducer->levels[level];
+    }
+    reducer->levels[level] = node;
+    reducer->blocksNumber++;
+
+    return NO_ERROR;
+}
+
+int simulation_finishStats(const struct StatsReducer *reducer,
+                           struct SimulationStats *stats)
+{
+    if (reducer == NULL || stats == NULL)
+        return POINTER_NULL;
+    if (reducer->blocksNumber < 1)
+        return ILLEGAL_VALUE;
+
+    // The last blocks are merged first, as the right subtrees of the
+    // larger levels, like simulation_reduceStats does.
+    int found = 0;
+    for (int level = 0; level < SIMULATION_MAX_LEVELS; level++) {
+        if (((reducer->blocksNumber >> level) & 1) == 0)
+            continue;
+        if (found) {
+            struct SimulationStats node = reducer->levels[level];
+            simulation_mergeStats(&node, stats);
+            *stats = node;
+        } else {
+            *stats = reducer->levels[level];
+            found = 1;
+        }
+    }
+
+    return NO_ERROR;
+}
+
@@ -0,0 +1,230 @@
+/**
+ * @file simulation.h
+ * @brief Functions used to simulate random rounds and to gather statistics
+ *        about them, with results which do not depend on the order in which
+ *        the rounds are simulated.
+ *
+ * All the random choices of a round come from a generator seeded with the
+ * seed of the simulation and the index of the round, so a round does not
+ * depend on the rounds simulated before it or by other threads. Statistics
+ * are gathered in blocks of SIMULATION_BLOCK_SIZE consecutive rounds and
+ * the blocks are merged in a fixed tree, so the floating point results do
+ * not depend on how the blocks are shared between threads.
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "platform.h"
+#include "record.h"
+
+#include <stdint.h>
+
+/**
+ * @brief The number of consecutive rounds whose statistics are gathered
+ *        together, before they are merged.
+ */
+#define SIMULATION_BLOCK_SIZE 64
+
+/**
+ * @struct SimulationStats
+ * @brief Statistics of a set of rounds.
+ *
+ * @var SimulationStats::roundsNumber
+ *     The number of rounds.
+ * @var SimulationStats::bidsMade
+ *     The number of rounds in which the bid winner made the bid.
+ * @var SimulationStats::meanPoints
+ *     The mean of the points of every seat.
+ * @var SimulationStats::squaredDeviations
+ *     The sum of the squared deviations from the mean of the points of
+ *     every seat.
+ * @var SimulationStats::meanScores
+ *     The mean of the score of every seat.
+ * @var SimulationStats::weightedBidsMade
+ *     The mean of the weight of a round if the bid winner made the bid, 0
+ *     otherwise: the probability the bid is made when the rounds are
+ *     weighted (see sampling_drawStratum).
+ * @var SimulationStats::weightedDeviations
+ *     The sum of the squared deviations from SimulationStats::weightedBidsMade.
+ */
+struct SimulationStats {
+    long roundsNumber;
+    long bidsMade;
+    double meanPoints[MAX_GAME_PLAYERS];
+    double squaredDeviations[MAX_GAME_PLAYERS];
+    double meanScores[MAX_GAME_PLAYERS];
+    double weightedBidsMade;
+    double weightedDeviations;
+};
+
+/**
+ * @brief The number of levels of the tree of a StatsReducer, enough for
+ *        any number of blocks.
+ */
+#define SIMULATION_MAX_LEVELS 64
+
+/**
+ * @struct StatsReducer
+ * @brief Merges the statistics of blocks as they come, in the same tree as
+ *        simulation_reduceStats, keeping one pending node of every level.
+ *
+ * @var StatsReducer::levels
+ *     Level k holds the merged statistics of 2^k consecutive blocks, if
+ *     bit k of StatsReducer::blocksNumber is set.
+ * @var StatsReducer::blocksNumber
+ *     The number of blocks added.
+ */
+struct StatsReducer {
+    struct SimulationStats levels[SIMULATION_MAX_LEVELS];
+    long blocksNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Seeds the generator of a round.
+ *
+ * @param seed The seed of the simulation.
+ * @param gameIndex The index of the round in the simulation.
+ *
+ * @return The state of the generator.
+ */
+EXPORT uint64_t simulation_seed(const uint64_t seed, const long gameIndex);
+
+/**
+ * @brief Returns the next number of a generator.
+ *
+ * @param state The state of the generator, updated.
+ *
+ * @return The number.
+ */
+EXPORT uint64_t simulation_random(uint64_t *state);
+
+/**
+ * @brief Plays a random round: the deal, the bids, the trump and every card
+ *        put down are chosen by the generator of the round.
+ *
+ * @param record The record where the round is stored.
+ * @param playersNumber The number of players, 2 to 4. Four players play
+ *                      in two teams.
+ * @param seed The seed of the simulation.
+ * @param gameIndex The index of the round in the simulation.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_playRound(struct RoundRecord *record,
+                                const int playersNumber, const uint64_t seed,
+                                const long gameIndex);
+
+/**
+ * @brief Plays the cards of a dealt round at random: every card put down is
+ *        chosen by a generator. The seats get the names and teams of
+ *        simulation_playRound.
+ *
+ * @param record The record of the round, with its players number, its
+ *               deck, its bids and its trump, where the round is stored.
+ * @param state The state of the generator.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_playDeal(struct RoundRecord *record, uint64_t *state);
+
+/**
+ * @brief Clears statistics.
+ *
+ * @param stats The statistics.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_initStats(struct SimulationStats *stats);
+
+/**
+ * @brief Adds a round to statistics.
+ *
+ * @param stats The statistics.
+ * @param record The round.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_addRound(struct SimulationStats *stats,
+                               const struct RoundRecord *record);
+
+/**
+ * @brief Adds a round to statistics, with a weight for the estimate of the
+ *        probability the bid is made.
+ *
+ * @param stats The statistics.
+ * @param record The round.
+ * @param weight The weight of the round, 1 for a uniform deal.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_addWeightedRound(struct SimulationStats *stats,
+                                       const struct RoundRecord *record,
+                                       const double weight);
+
+/**
+ * @brief Adds the statistics of a set of rounds to other statistics.
+ *
+ * @param stats The statistics which are updated.
+ * @param other The statistics added.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_mergeStats(struct SimulationStats *stats,
+                                 const struct SimulationStats *other);
+
+/**
+ * @brief Merges the statistics of consecutive blocks in a tree whose shape
+ *        depends only on the number of blocks.
+ *
+ * @param stats The statistics of the blocks, in order. The result is
+ *              stored in the first one, the others are changed.
+ * @param count The number of blocks.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_reduceStats(struct SimulationStats *stats,
+                                  const int count);
+
+/**
+ * @brief Initializes a reducer without blocks.
+ *
+ * @param reducer The reducer.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_initReducer(struct StatsReducer *reducer);
+
+/**
+ * @brief Adds the statistics of the next block to a reducer.
+ *
+ * @param reducer The reducer.
+ * @param stats The statistics of the block.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_pushStats(struct StatsReducer *reducer,
+                                const struct SimulationStats *stats);
+
+/**
+ * @brief Merges the pending nodes of a reducer. The result is the one
+ *        simulation_reduceStats gives for the same blocks.
+ *
+ * @param reducer The reducer, with at least one block.
+ * @param stats Where the statistics of all the blocks are stored.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int simulation_finishStats(const struct StatsReducer *reducer,
+                                  struct SimulationStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
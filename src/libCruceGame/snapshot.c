@@ -0,0 +1,366 @@
+/**
+ * @file snapshot.c
+ * @brief Contains implementations of the functions used to save a live game
+ *        in a binary snapshot and to rebuild it.
+ *
+ * A snapshot starts with the bytes 'C', 'G', 'S' and the version of the
+ * format. Numbers are written on one byte, or on two bytes (little endian)
+ * for scores and points. The slots of the players, teams, round, hands and
+ * deck follow, each starting with a byte which is 1 if the slot is used.
+ */
+
+#include "snapshot.h"
+#include "replay.h"
+#include "round.h"
+#include "team.h"
+#include "deck.h"
+#include "errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Written instead of the id of a missing card.
+ */
+#define NO_CARD 0xFF
+
+/**
+ * @brief Written instead of the index of a missing player.
+ */
+#define NO_PLAYER 0xFF
+
+static const unsigned char MAGIC[] = {'C', 'G', 'S', 1};
+
+/**
+ * @struct Cursor
+ * @brief A position in a snapshot being written or read.
+ *
+ * @var Cursor::data
+ *     The snapshot being written.
+ * @var Cursor::input
+ *     The snapshot being read.
+ * @var Cursor::position
+ *     The position of the next byte.
+ * @var Cursor::size
+ *     The size of the snapshot.
+ * @var Cursor::error
+ *     1 if a byte was read after the end of the snapshot or a value is not
+ *     valid, 0 otherwise.
+ */
+struct Cursor {
+    unsigned char *data;
+    const unsigned char *input;
+    size_t position;
+    size_t size;
+    int error;
+};
+
+/**
+ * @brief Helpers to write numbers. The bytes after the end of the buffer
+ *        are only counted.
+ */
+static void putByte(struct Cursor *cursor, const int value)
+{
+    if (cursor->position < cursor->size)
+        cursor->data[cursor->position] = value;
+    cursor->position++;
+}
+
+static void putShort(struct Cursor *cursor, const int value)
+{
+    putByte(cursor, value & 0xFF);
+    putByte(cursor, (value >> 8) & 0xFF);
+}
+
+/**
+ * @brief Helpers to read numbers.
+ */
+static int getByte(struct Cursor *cursor)
+{
+    if (cursor->position >= cursor->size) {
+        cursor->error = 1;
+        return 0;
+    }
+
+    return cursor->input[cursor->position++];
+}
+
+static int getShort(struct Cursor *cursor)
+{
+    int low = getByte(cursor);
+    int high = getByte(cursor);
+
+    return (short)(low | high << 8);
+}
+
+/**
+ * @brief Helper to find the index of a player in Game::players.
+ */
+static int playerIndex(const struct Game *game, const struct Player *player)
+{
+    if (player != NULL)
+        for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+            if (game->players[i] == player)
+                return i;
+
+    return NO_PLAYER;
+}
+
+/**
+ * @brief Helper to write a card.
+ */
+static void putCard(struct Cursor *cursor, const struct Card *card)
+{
+    int id = card != NULL ? deck_cardId(card) : NO_CARD;
+
+    if (id < 0)
+        cursor->error = 1;
+    putByte(cursor, id);
+}
+
+int snapshot_writeGame(const struct Game *game, unsigned char *buffer,
+                       const size_t size)
+{
+    if (game == NULL)
+        return GAME_NULL;
+    if (buffer == NULL)
+        return POINTER_NULL;
+
+    struct Cursor cursor = {buffer, NULL, 0, size, 0};
+    for (size_t i = 0; i < sizeof(MAGIC); i++)
+        putByte(&cursor, MAGIC[i]);
+    putByte(&cursor, game->pointsNumber);
+
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        const struct Player *player = game->players[i];
+        putByte(&cursor, player != NULL);
+        if (player == NULL)
+            continue;
+
+        size_t nameLength = strlen(player->name);
+        if (nameLength > 255)
+            return ILLEGAL_VALUE;
+        putByte(&cursor, nameLength);
+        for (size_t j = 0; j < nameLength; j++)
+            putByte(&cursor, player->name[j]);
+        putByte(&cursor, player->isHuman != 0);
+        putShort(&cursor, player->score);
+        for (int j = 0; j < MAX_CARDS; j++)
+            putCard(&cursor, player->hand[j]);
+    }
+
+    for (int i = 0; i < MAX_GAME_TEAMS; i++) {
+        const struct Team *team = game->teams[i];
+        putByte(&cursor, team != NULL);
+        if (team == NULL)
+            continue;
+
+        putShort(&cursor, team->score);
+        for (int j = 0; j < MAX_TEAM_PLAYERS; j++)
+            putByte(&cursor, playerIndex(game, team->players[j]));
+    }
+
+    const struct Round *round = game->round;
+    putByte(&cursor, round != NULL);
+    if (round != NULL) {
+        putByte(&cursor, round->trump);
+        for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+            putByte(&cursor, round->bids[i]);
+            putByte(&cursor, playerIndex(game, round->players[i]));
+            putShort(&cursor, round->pointsNumber[i]);
+        }
+        for (int i = 0; i < MAX_HANDS; i++) {
+            const struct Hand *hand = round->hands[i];
+            putByte(&cursor, hand != NULL);
+            if (hand == NULL)
+                continue;
+            for (int j = 0; j < MAX_GAME_PLAYERS; j++) {
+                putByte(&cursor, playerIndex(game, hand->players[j]));
+                putCard(&cursor, hand->cards[j]);
+            }
+        }
+    }
+
+    putByte(&cursor, game->deck != NULL);
+    if (game->deck != NULL)
+        for (int i = 0; i < DECK_SIZE; i++)
+            putCard(&cursor, game->deck->cards[i]);
+
+    if (cursor.error)
+        return ILLEGAL_VALUE;
+    if (cursor.position > size)
+        return FULL;
+
+    return cursor.position;
+}
+
+/**
+ * @brief Helper to read a card. Every card can be read only once.
+ *
+ * @return Pointer to the new card, NULL if the card is missing or on
+ *         failure.
+ */
+static struct Card *getCard(struct Cursor *cursor, int used[DECK_SIZE])
+{
+    int id = getByte(cursor);
+    if (id == NO_CARD)
+        return NULL;
+    if (id >= DECK_SIZE || used[id]) {
+        cursor->error = 1;
+        return NULL;
+    }
+
+    used[id] = 1;
+    struct Card *card = deck_createCard(id / SUIT_SIZE, VALUES[id % SUIT_SIZE]);
+    if (card == NULL)
+        cursor->error = 1;
+
+    return card;
+}
+
+/**
+ * @brief Helper to read the index of a player, who must be in the game.
+ */
+static struct Player *getPlayer(struct Cursor *cursor,
+                                const struct Game *game)
+{
+    int index = getByte(cursor);
+    if (index == NO_PLAYER)
+        return NULL;
+    if (index >= MAX_GAME_PLAYERS || game->players[index] == NULL) {
+        cursor->error = 1;
+        return NULL;
+    }
+
+    return game->players[index];
+}
+
+/**
+ * @brief Helpers to read the parts of a game.
+ */
+static void getPlayers(struct Cursor *cursor, struct Game *game,
+                       int used[DECK_SIZE])
+{
+    for (int i = 0; i < MAX_GAME_PLAYERS && !cursor->error; i++) {
+        if (!getByte(cursor))
+            continue;
+
+        char name[256];
+        int nameLength = getByte(cursor);
+        for (int j = 0; j < nameLength; j++)
+            name[j] = getByte(cursor);
+        name[nameLength] = '\0';
+
+        struct Player *player = team_createPlayer(name, getByte(cursor));
+        if (player == NULL) {
+            cursor->error = 1;
+            return;
+        }
+        game->players[i] = player;
+        game->numberPlayers++;
+        player->score = getShort(cursor);
+        for (int j = 0; j < MAX_CARDS; j++)
+            player->hand[j] = getCard(cursor, used);
+    }
+}
+
+static void getTeams(struct Cursor *cursor, struct Game *game)
+{
+    for (int i = 0; i < MAX_GAME_TEAMS && !cursor->error; i++) {
+        if (!getByte(cursor))
+            continue;
+
+        struct Team *team = team_createTeam();
+        if (team == NULL) {
+            cursor->error = 1;
+            return;
+        }
+        game->teams[i] = team;
+        team->score = getShort(cursor);
+        for (int j = 0; j < MAX_TEAM_PLAYERS; j++)
+            team->players[j] = getPlayer(cursor, game);
+    }
+}
+
+static void getRound(struct Cursor *cursor, struct Game *game,
+                     int used[DECK_SIZE])
+{
+    if (cursor->error || !getByte(cursor))
+        return;
+
+    struct Round *round = round_createRound();
+    if (round == NULL) {
+        cursor->error = 1;
+        return;
+    }
+    game->round = round;
+
+    round->trump = getByte(cursor);
+    if (round->trump > SuitEnd)
+        cursor->error = 1;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        round->bids[i] = (signed char)getByte(cursor);
+        round->players[i] = getPlayer(cursor, game);
+        round->pointsNumber[i] = getShort(cursor);
+    }
+
+    for (int i = 0; i < MAX_HANDS && !cursor->error; i++) {
+        if (!getByte(cursor))
+            continue;
+
+        struct Hand *hand = round_createHand();
+        if (hand == NULL) {
+            cursor->error = 1;
+            return;
+        }
+        round->hands[i] = hand;
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++) {
+            hand->players[j] = getPlayer(cursor, game);
+            hand->cards[j] = getCard(cursor, used);
+        }
+    }
+}
+
+static void getDeck(struct Cursor *cursor, struct Game *game,
+                    int used[DECK_SIZE])
+{
+    if (cursor->error || !getByte(cursor))
+        return;
+
+    game->deck = calloc(1, sizeof(struct Deck));
+    if (game->deck == NULL) {
+        cursor->error = 1;
+        return;
+    }
+    for (int i = 0; i < DECK_SIZE; i++)
+        game->deck->cards[i] = getCard(cursor, used);
+}
+
+struct Game *snapshot_readGame(const unsigned char *buffer,
+                               const size_t length)
+{
+    if (buffer == NULL)
+        return NULL;
+
+    struct Cursor cursor = {NULL, buffer, 0, length, 0};
+    for (size_t i = 0; i < sizeof(MAGIC); i++)
+        if (getByte(&cursor) != MAGIC[i])
+            return NULL;
+
+    struct Game *game = game_createGame(getByte(&cursor));
+    if (game == NULL)
+        return NULL;
+
+    int used[DECK_SIZE] = {0};
+    getPlayers(&cursor, game, used);
+    getTeams(&cursor, game);
+    getRound(&cursor, game, used);
+    getDeck(&cursor, game, used);
+    if (cursor.error || cursor.position != length) {
+        replay_deleteGame(&game);
+        return NULL;
+    }
+
+    return game;
+}
+
@@ -0,0 +1,59 @@
+/**
+ * @file snapshot.h
+ * @brief Functions used to save a live game, in the middle of a round, in
+ *        a compact binary snapshot and to rebuild it.
+ *
+ * A snapshot keeps the slots of the players, teams, hands, cards of the
+ * players and cards of the deck, so the rebuilt game can not be told
+ * apart from the saved one. Players are referenced by their index in
+ * Game::players and cards by their id (see deck_cardId).
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "platform.h"
+#include "game.h"
+
+#include <stddef.h>
+
+/**
+ * @brief The maximum size of a snapshot.
+ */
+#define SNAPSHOT_MAX_SIZE 2048
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Saves a game in a snapshot.
+ *
+ * @param game The game. Player names are at most 255 bytes long.
+ * @param buffer Buffer where the snapshot is written.
+ * @param size The size of the buffer.
+ *
+ * @return The length of the snapshot on success, negative value on
+ *         failure.
+ */
+EXPORT int snapshot_writeGame(const struct Game *game, unsigned char *buffer,
+                              const size_t size);
+
+/**
+ * @brief Rebuilds a game from a snapshot. The game is freed with
+ *        replay_deleteGame.
+ *
+ * @param buffer The snapshot.
+ * @param length The length of the snapshot.
+ *
+ * @return Pointer to the new game on success or NULL on failure.
+ */
+EXPORT struct Game *snapshot_readGame(const unsigned char *buffer,
+                                      const size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
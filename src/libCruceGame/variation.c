@@ -0,0 +1,266 @@
+/**
+ * @file variation.c
+ * @brief Contains implementations of the functions used to explore the
+ *        lines of play of a round.
+ */
+
+#include "variation.h"
+#include "replay.h"
+#include "deck.h"
+#include "errors.h"
+
+#include <stdlib.h>
+
+/**
+ * @brief The largest bid.
+ */
+#define MAX_BID 6
+
+struct Variation *variation_createVariation(const struct RoundRecord *record)
+{
+    struct Game *game = replay_createGame(record, 0);
+    if (game == NULL)
+        return NULL;
+
+    struct Variation *variation = calloc(1, sizeof(struct Variation));
+    struct VariationDeal *deal = malloc(sizeof(struct VariationDeal));
+    if (variation == NULL || deal == NULL) {
+        free(variation);
+        free(deal);
+        replay_deleteGame(&game);
+        return NULL;
+    }
+
+    deal->record = *record;
+    deal->stockSize = 0;
+    for (int i = 0; i < DECK_SIZE; i++)
+        if (game->deck->cards[i] != NULL)
+            deal->stock[deal->stockSize++] =
+                deck_cardId(game->deck->cards[i]);
+
+    variation->deal = deal;
+    variation->references = 1;
+    for (int i = 0; i < record->playersNumber; i++) {
+        for (int j = 0; j < MAX_CARDS; j++)
+            if (game->players[i]->hand[j] != NULL)
+                variation->hands[i] |=
+                    1u << deck_cardId(game->players[i]->hand[j]);
+    }
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        variation->bids[i] = -1;
+    variation->move = VARIATION_DEAL;
+    variation->trump = record->trump;
+    replay_deleteGame(&game);
+
+    return variation;
+}
+
+int variation_deleteVariation(struct Variation **variation)
+{
+    if (variation == NULL)
+        return POINTER_NULL;
+    if (*variation == NULL)
+        return VARIATION_NULL;
+
+    struct Variation *current = *variation;
+    while (current != NULL && --current->references == 0) {
+        struct Variation *parent = current->parent;
+        if (parent == NULL)
+            free(current->deal);
+        free(current);
+        current = parent;
+    }
+    *variation = NULL;
+
+    return NO_ERROR;
+}
+
+/**
+ * @brief Helper to create a copy of a variation to play a move on.
+ */
+static struct Variation *createChild(struct Variation *parent)
+{
+    struct Variation *child = malloc(sizeof(struct Variation));
+    if (child == NULL)
+        return NULL;
+
+    *child = *parent;
+    child->parent = parent;
+    child->references = 1;
+    child->movesNumber++;
+    parent->references++;
+
+    return child;
+}
+
+/**
+ * @brief Helper to count the bids of a variation.
+ */
+static int countBids(const struct Variation *variation)
+{
+    int count = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (variation->bids[i] >= 0)
+            count++;
+
+    return count;
+}
+
+struct Variation *variation_playBid(struct Variation *parent, const int bid)
+{
+    if (parent == NULL || bid < 0 || bid > MAX_BID)
+        return NULL;
+
+    int playersNumber = parent->deal->record.playersNumber;
+    if (countBids(parent) == playersNumber)
+        return NULL;
+    if (bid > 0)
+        for (int i = 0; i < playersNumber; i++)
+            if (parent->bids[i] > bid)
+                return NULL;
+
+    struct Variation *child = createChild(parent);
+    if (child == NULL)
+        return NULL;
+
+    child->move = VARIATION_BID;
+    child->value = bid;
+    child->seat = parent->toMove;
+    child->bids[child->seat] = bid;
+    if (child->seat + 1 < playersNumber) {
+        child->toMove = child->seat + 1;
+        return child;
+    }
+
+    /* The first of the highest bidders leads. */
+    int winner = 0;
+    for (int i = 1; i < playersNumber; i++)
+        if (child->bids[i] > child->bids[winner])
+            winner = i;
+    child->toMove = winner;
+    child->leader = winner;
+
+    return child;
+}
+
+/**
+ * @brief Helper to find the player who wins the current hand, as
+ *        round_handWinner does.
+ *
+ * @return The seat of the player.
+ */
+static int handWinner(const struct Variation *variation)
+{
+    int playersNumber = variation->deal->record.playersNumber;
+    struct Card cards[MAX_GAME_PLAYERS];
+
+    for (int i = 0; i < playersNumber; i++) {
+        cards[i].suit = variation->trick[i] / SUIT_SIZE;
+        cards[i].value = VALUES[variation->trick[i] % SUIT_SIZE];
+    }
+
+    int winner = 0;
+    for (int i = 1; i < playersNumber; i++)
+        if (deck_compareCards(&cards[winner], &cards[i],
+                              variation->trump) == 2)
+            winner = i;
+
+    return (variation->leader + winner) % playersNumber;
+}
+
+/**
+ * @brief Helper to score a marriage, as round_putCard does: the first card
+ *        of a hand is a 3 or a 4 and the player still holds the other one.
+ */
+static void scoreMarriage(struct Variation *variation, const int cardId)
+{
+    int suit = cardId / SUIT_SIZE;
+    int value = VALUES[cardId % SUIT_SIZE];
+    if (variation->trickSize != 0 || (value != 3 && value != 4))
+        return;
+
+    for (int i = 0; i < SUIT_SIZE; i++) {
+        if (VALUES[i] != 7 - value ||
+            !(variation->hands[variation->seat] &
+              (1u << (suit * SUIT_SIZE + i))))
+            continue;
+        variation->pointsNumber[variation->seat] +=
+            suit == variation->trump ? 40 : 20;
+    }
+}
+
+struct Variation *variation_playCard(struct Variation *parent,
+                                     const int cardId)
+{
+    if (parent == NULL || cardId < 0 || cardId >= DECK_SIZE)
+        return NULL;
+
+    int playersNumber = parent->deal->record.playersNumber;
+    if (countBids(parent) < playersNumber ||
+        parent->toMove == VARIATION_OVER ||
+        !(parent->hands[parent->toMove] & (1u << cardId)))
+        return NULL;
+
+    struct Variation *child = createChild(parent);
+    if (child == NULL)
+        return NULL;
+
+    child->move = VARIATION_CARD;
+    child->value = cardId;
+    child->seat = parent->toMove;
+    child->hands[child->seat] &= ~(1u << cardId);
+    if (child->trump == SuitEnd)
+        child->trump = cardId / SUIT_SIZE;
+    scoreMarriage(child, cardId);
+    child->trick[child->trickSize++] = cardId;
+    if (child->trickSize < playersNumber) {
+        child->toMove = (child->seat + 1) % playersNumber;
+        return child;
+    }
+
+    int winner = handWinner(child);
+    for (int i = 0; i < playersNumber; i++)
+        child->pointsNumber[winner] += VALUES[child->trick[i] % SUIT_SIZE];
+    child->handsNumber++;
+    child->trickSize = 0;
+    for (int i = 0; i < playersNumber; i++)
+        if (child->stockUsed < child->deal->stockSize)
+            child->hands[i] |=
+                1u << child->deal->stock[child->stockUsed++];
+
+    child->leader = winner;
+    child->toMove = child->hands[winner] != 0 ? winner : VARIATION_OVER;
+
+    return child;
+}
+
+struct Game *variation_createGame(const struct Variation *variation)
+{
+    if (variation == NULL)
+        return NULL;
+
+    struct RoundRecord record = variation->deal->record;
+    for (int i = 0; i < record.playersNumber; i++)
+        record.bids[i] = variation->bids[i] >= 0 ? variation->bids[i] : 0;
+    record.trump = variation->trump;
+    record.handsNumber = variation->handsNumber +
+                         (variation->trickSize > 0);
+    if (variation->handsNumber > 0)
+        record.winners[variation->handsNumber - 1] = variation->leader;
+
+    /* The hand and the position of a card are the ones of its parent. */
+    int cardsNumber = 0;
+    for (const struct Variation *current = variation;
+         current->parent != NULL; current = current->parent) {
+        if (current->move != VARIATION_CARD)
+            continue;
+        const struct Variation *parent = current->parent;
+        record.cards[parent->handsNumber][parent->trickSize] = current->value;
+        record.leaders[parent->handsNumber] = parent->leader;
+        if (parent->handsNumber > 0)
+            record.winners[parent->handsNumber - 1] = parent->leader;
+        cardsNumber++;
+    }
+
+    return replay_createGame(&record, cardsNumber);
+}
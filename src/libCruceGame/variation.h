@@ -0,0 +1,195 @@
+/**
+ * @file variation.h
+ * @brief Variation structure, an immutable state of a round used to
+ *        explore many lines of play, as well as helper functions.
+ *
+ * Playing a bid or a card does not change a variation: it creates a new
+ * one, which points to its parent for the history and keeps the hands of
+ * the players as bit masks of card ids. A variation costs a few dozen
+ * bytes, whatever the number of moves before it, so a take back is a
+ * pointer to the parent and every branch of an analysis shares the moves
+ * it has in common with the others. The deal, the names and the teams are
+ * shared by all the variations of a round.
+ */
+
+#ifndef VARIATION_H
+#define VARIATION_H
+
+#include "platform.h"
+#include "constants.h"
+#include "record.h"
+#include "game.h"
+
+#include <stdint.h>
+
+/**
+ * @brief Written instead of the seat of the player to move when the round
+ *        is over.
+ */
+#define VARIATION_OVER 0xFF
+
+/**
+ * @brief The kinds of moves.
+ */
+enum VariationMove {
+    VARIATION_DEAL, //!< The first variation of a round, after the deal.
+    VARIATION_BID,  //!< A player bid.
+    VARIATION_CARD  //!< A player put down a card.
+};
+
+/**
+ * @struct VariationDeal
+ * @brief The part of a round shared by all its variations. It belongs to
+ *        the first variation.
+ *
+ * @var VariationDeal::record
+ *     The players, the teams and the deck of the round.
+ * @var VariationDeal::stock
+ *     The ids of the cards left in the deck after the deal, in the order
+ *     they are dealt after every hand.
+ * @var VariationDeal::stockSize
+ *     The number of cards in VariationDeal::stock.
+ */
+struct VariationDeal {
+    struct RoundRecord record;
+    unsigned char stock[DECK_SIZE];
+    int stockSize;
+};
+
+/**
+ * @struct Variation
+ * @brief A state of a round.
+ *
+ * @var Variation::parent
+ *     The variation before the last move, NULL for the deal.
+ * @var Variation::deal
+ *     The deal of the round.
+ * @var Variation::references
+ *     The number of owners of the variation: the caller which created it
+ *     and the variations created from it.
+ * @var Variation::hands
+ *     For every seat, a bit mask with bit id set if the player holds the
+ *     card id.
+ * @var Variation::pointsNumber
+ *     The points of every seat.
+ * @var Variation::bids
+ *     The bid of every seat, -1 if the player did not bid yet.
+ * @var Variation::trick
+ *     The ids of the cards of the current hand, in the order they were put
+ *     down.
+ * @var Variation::move
+ *     The kind of the last move (see \ref VariationMove).
+ * @var Variation::value
+ *     The bid or the card id of the last move.
+ * @var Variation::seat
+ *     The seat of the player who made the last move.
+ * @var Variation::toMove
+ *     The seat of the player to move, \ref VARIATION_OVER at the end of the
+ *     round.
+ * @var Variation::leader
+ *     The seat of the player who put down the first card of the current
+ *     hand.
+ * @var Variation::trickSize
+ *     The number of cards of the current hand.
+ * @var Variation::trump
+ *     The trump, SuitEnd until it is known.
+ * @var Variation::handsNumber
+ *     The number of hands finished.
+ * @var Variation::stockUsed
+ *     The number of cards dealt from VariationDeal::stock.
+ * @var Variation::movesNumber
+ *     The number of moves since the deal.
+ */
+struct Variation {
+    struct Variation *parent;
+    struct VariationDeal *deal;
+    int references;
+    uint32_t hands[MAX_GAME_PLAYERS];
+    short pointsNumber[MAX_GAME_PLAYERS];
+    signed char bids[MAX_GAME_PLAYERS];
+    unsigned char trick[MAX_GAME_PLAYERS];
+    unsigned char move;
+    unsigned char value;
+    unsigned char seat;
+    unsigned char toMove;
+    unsigned char leader;
+    unsigned char trickSize;
+    unsigned char trump;
+    unsigned char handsNumber;
+    unsigned char stockUsed;
+    unsigned char movesNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Creates the first variation of a round: the cards of the record
+ *        are dealt and the first player is to bid. The bids and the cards
+ *        played of the record are not used; the trump of the record is
+ *        kept, and if it is SuitEnd the first card put down chooses it.
+ *
+ * @param record The record of the round.
+ *
+ * @return Pointer to the new variation on success or NULL on failure.
+ */
+EXPORT struct Variation *variation_createVariation(const struct RoundRecord
+                                                   *record);
+
+/**
+ * @brief Releases a variation. It is freed, with the parents only it used,
+ *        when no variation is created from it any more.
+ *
+ * @param variation Pointer to the pointer to the variation.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int variation_deleteVariation(struct Variation **variation);
+
+/**
+ * @brief Creates the variation after the player to move bids. Players bid
+ *        in the order of their seats, following the rules of
+ *        round_placeBid.
+ *
+ * @param parent The variation before the bid.
+ * @param bid The bid.
+ *
+ * @return Pointer to the new variation on success or NULL if the bid is not
+ *         allowed or on failure.
+ */
+EXPORT struct Variation *variation_playBid(struct Variation *parent,
+                                           const int bid);
+
+/**
+ * @brief Creates the variation after the player to move puts down a card.
+ *        The hand is scored as round_putCard and round_handWinner do, and
+ *        the cards left in the deck are dealt after it.
+ *
+ * @param parent The variation before the card.
+ * @param cardId The id of the card (see deck_cardId). The player must hold
+ *               it; following the suit is checked by game_checkCard on the
+ *               game built by variation_createGame.
+ *
+ * @return Pointer to the new variation on success or NULL if the card is
+ *         not allowed or on failure.
+ */
+EXPORT struct Variation *variation_playCard(struct Variation *parent,
+                                            const int cardId);
+
+/**
+ * @brief Builds the live game of a variation with replay_createGame.
+ *
+ * @param variation The variation.
+ *
+ * @return Pointer to the new game on success or NULL on failure. The game
+ *         is freed with replay_deleteGame.
+ */
+EXPORT struct Game *variation_createGame(const struct Variation *variation);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
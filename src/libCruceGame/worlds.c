@@ -0,0 +1,264 @@
+/**
+ * @file worlds.c
+ * @brief Contains implementations of the functions used to keep a pool of
+ *        worlds from a decision to the next one.
+ */
+
+#include "worlds.h"
+#include "simulation.h"
+#include "errors.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Helper to count the cards of a bit mask.
+ */
+static int countCards(uint32_t cards)
+{
+    cards = cards - ((cards >> 1) & 0x55555555);
+    cards = (cards & 0x33333333) + ((cards >> 2) & 0x33333333);
+    cards = (cards + (cards >> 4)) & 0x0F0F0F0F;
+
+    return (cards * 0x01010101) >> 24;
+}
+
+/**
+ * @brief Helper to choose a card of a bit mask at random.
+ *
+ * @return The bit of the card, 0 if the mask is empty.
+ */
+static uint32_t chooseCard(uint32_t cards, uint64_t *random)
+{
+    int count = countCards(cards);
+    if (count == 0)
+        return 0;
+
+    for (int i = simulation_random(random) % count; i > 0; i--)
+        cards &= cards - 1;
+
+    return cards & -cards;
+}
+
+/**
+ * @brief Helper to choose at random a holder with room for a card.
+ *
+ * @return The holder, -1 if there is none.
+ */
+static int chooseHolder(const struct World *world,
+                        const struct Locations *locations,
+                        const uint32_t card, uint64_t *random)
+{
+    int holders[LOCATIONS_HOLDERS];
+    int holdersNumber = 0;
+    for (int h = 0; h < LOCATIONS_HOLDERS; h++)
+        if ((locations->allowed[h] & card) &&
+            countCards(world->hands[h]) < locations->sizes[h])
+            holders[holdersNumber++] = h;
+
+    if (holdersNumber == 0)
+        return -1;
+
+    return holders[simulation_random(random) % holdersNumber];
+}
+
+/**
+ * @brief Helper to give a card to a hand which may hold it but is full,
+ *        moving one of its cards to a hand with room for it.
+ *
+ * @return 1 on success, 0 if no such hands exist.
+ */
+static int exchangeCard(struct World *world,
+                        const struct Locations *locations,
+                        const uint32_t card, uint64_t *random)
+{
+    int start = simulation_random(random) % LOCATIONS_HOLDERS;
+    for (int i = 0; i < LOCATIONS_HOLDERS; i++) {
+        int h = (start + i) % LOCATIONS_HOLDERS;
+        if (!(locations->allowed[h] & card))
+            continue;
+        for (uint32_t cards = world->hands[h]; cards != 0;
+             cards &= cards - 1) {
+            uint32_t other = cards & -cards;
+            int g = chooseHolder(world, locations, other, random);
+            if (g >= 0 && g != h) {
+                world->hands[h] = (world->hands[h] & ~other) | card;
+                world->hands[g] |= other;
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Helper to swap two random cards of two random hands, if both hands
+ *        may hold the card they receive. Every deal has the same
+ *        probability in the stationary distribution of these swaps.
+ */
+static void swapCards(struct World *world, const struct Locations *locations,
+                      uint64_t *random)
+{
+    int holders[LOCATIONS_HOLDERS];
+    int holdersNumber = 0;
+    for (int h = 0; h < LOCATIONS_HOLDERS; h++)
+        if (world->hands[h] != 0)
+            holders[holdersNumber++] = h;
+    if (holdersNumber < 2)
+        return;
+
+    int i = simulation_random(random) % holdersNumber;
+    int j = simulation_random(random) % (holdersNumber - 1);
+    if (j >= i)
+        j++;
+    int h = holders[i];
+    int g = holders[j];
+
+    uint32_t card = chooseCard(world->hands[h], random);
+    uint32_t other = chooseCard(world->hands[g], random);
+    if (!(locations->allowed[g] & card) || !(locations->allowed[h] & other))
+        return;
+
+    world->hands[h] = (world->hands[h] & ~card) | other;
+    world->hands[g] = (world->hands[g] & ~other) | card;
+}
+
+/**
+ * @brief Helper to make a world agree with a knowledge.
+ *
+ * @return 1 if the world agreed with it, 0 if it was repaired, -1 if it can
+ *         not be repaired.
+ */
+static int repairWorld(struct World *world, const struct Locations *locations,
+                       uint64_t *random)
+{
+    uint32_t held = 0;
+    for (int h = 0; h < LOCATIONS_HOLDERS; h++) {
+        uint32_t hand = world->hands[h] & locations->unknown &
+                        locations->allowed[h];
+        while (countCards(hand) > locations->sizes[h])
+            hand &= ~chooseCard(hand, random);
+        world->hands[h] = hand;
+        held |= hand;
+    }
+
+    uint32_t loose = locations->unknown & ~held;
+    if (loose == 0)
+        return 1;
+
+    // Only the exchanges made to follow a new constraint need swaps.
+    int swapsNumber = 0;
+    while (loose != 0) {
+        uint32_t card = chooseCard(loose, random);
+        loose &= ~card;
+        int h = chooseHolder(world, locations, card, random);
+        if (h >= 0) {
+            world->hands[h] |= card;
+        } else {
+            if (!exchangeCard(world, locations, card, random))
+                return -1;
+            swapsNumber += WORLDS_SWAPS;
+        }
+    }
+
+    for (int i = 0; i < swapsNumber; i++)
+        swapCards(world, locations, random);
+
+    return 0;
+}
+
+struct WorldPool *worlds_createPool(const int capacity, const uint64_t seed)
+{
+    if (capacity <= 0)
+        return NULL;
+
+    struct WorldPool *pool = malloc(sizeof(struct WorldPool));
+    if (pool == NULL)
+        return NULL;
+
+    pool->worlds = malloc(sizeof(struct World) * capacity);
+    if (pool->worlds == NULL) {
+        free(pool);
+        return NULL;
+    }
+
+    memset(&pool->locations, 0, sizeof(struct Locations));
+    pool->worldsNumber = 0;
+    pool->capacity = capacity;
+    pool->random = simulation_seed(seed, 0);
+    pool->keptNumber = 0;
+    pool->repairedNumber = 0;
+    pool->sampledNumber = 0;
+
+    return pool;
+}
+
+int worlds_deletePool(struct WorldPool **pool)
+{
+    if (pool == NULL)
+        return POINTER_NULL;
+    if (*pool == NULL)
+        return WORLD_POOL_NULL;
+
+    free((*pool)->worlds);
+    free(*pool);
+    *pool = NULL;
+
+    return NO_ERROR;
+}
+
+int worlds_updatePool(struct WorldPool *pool,
+                      const struct Locations *locations)
+{
+    if (pool == NULL)
+        return WORLD_POOL_NULL;
+    if (locations == NULL)
+        return POINTER_NULL;
+
+    pool->locations = *locations;
+    pool->keptNumber = 0;
+    pool->repairedNumber = 0;
+    pool->sampledNumber = 0;
+
+    int worldsNumber = 0;
+    for (int i = 0; i < pool->worldsNumber; i++) {
+        struct World world = pool->worlds[i];
+        int state = repairWorld(&world, locations, &pool->random);
+        if (state < 0)
+            continue;
+        if (state == 1)
+            pool->keptNumber++;
+        else
+            pool->repairedNumber++;
+        pool->worlds[worldsNumber++] = world;
+    }
+    pool->worldsNumber = worldsNumber;
+
+    int missing = pool->capacity - worldsNumber;
+    if (missing == 0)
+        return NO_ERROR;
+
+    uint32_t (*deals)[LOCATIONS_HOLDERS] = malloc(sizeof(*deals) * missing);
+    if (deals == NULL) {
+        pool->worldsNumber = 0;
+        return MALLOC_ERROR;
+    }
+
+    int error = locations_sampleDeals(locations, deals, missing,
+                                      &pool->random);
+    if (error != NO_ERROR) {
+        free(deals);
+        pool->worldsNumber = 0;
+        return error;
+    }
+
+    for (int i = 0; i < missing; i++)
+        memcpy(pool->worlds[worldsNumber + i].hands, deals[i],
+               sizeof(deals[i]));
+    pool->worldsNumber = pool->capacity;
+    pool->sampledNumber = missing;
+    free(deals);
+
+    return NO_ERROR;
+}
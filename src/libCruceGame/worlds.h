@@ -0,0 +1,120 @@
+/**
+ * @file worlds.h
+ * @brief Pool of worlds, the deals of the cards a player does not see, kept
+ *        from a decision of the player to the next one.
+ *
+ * The worlds are dealt at random with locations_sampleDeals, every deal
+ * which agrees with what the player knows being equally likely. After a
+ * card is put down, the worlds which gave it to the seat which put it down
+ * are kept, and they stay equally likely, as a uniform sample of a set is a
+ * uniform sample of each of its subsets. In the other worlds the card is
+ * exchanged with a random card of that seat, which keeps the deals equally
+ * likely too. When the card also shows a seat does not have a suit, its
+ * cards of the suit are exchanged with cards of hands which may hold them,
+ * followed by a few random swaps of two cards between two hands: they are
+ * steps of a chain whose stationary distribution gives every deal the same
+ * probability, so the world forgets most of the world it came from. Only
+ * the worlds which can not be repaired, and the ones missing to fill the
+ * pool, are dealt again.
+ */
+
+#ifndef WORLDS_H
+#define WORLDS_H
+
+#include "platform.h"
+#include "locations.h"
+
+#include <stdint.h>
+
+/**
+ * @brief The number of random swaps made in a world for every card moved
+ *        to follow a new constraint.
+ */
+#define WORLDS_SWAPS 8
+
+/**
+ * @struct World
+ * @brief A deal of the cards a player does not see.
+ *
+ * @var World::hands
+ *     For every holder, a bit mask with bit id set if it holds the card id.
+ */
+struct World {
+    uint32_t hands[LOCATIONS_HOLDERS];
+};
+
+/**
+ * @struct WorldPool
+ * @brief A pool of worlds.
+ *
+ * @var WorldPool::locations
+ *     What the player knows, which every world agrees with.
+ * @var WorldPool::worlds
+ *     The worlds.
+ * @var WorldPool::worldsNumber
+ *     The number of worlds.
+ * @var WorldPool::capacity
+ *     The number of worlds the pool keeps.
+ * @var WorldPool::random
+ *     The state of the generator of the pool (see simulation_random).
+ * @var WorldPool::keptNumber
+ *     The number of worlds kept as they were by the last update.
+ * @var WorldPool::repairedNumber
+ *     The number of worlds repaired by the last update.
+ * @var WorldPool::sampledNumber
+ *     The number of worlds dealt by the last update.
+ */
+struct WorldPool {
+    struct Locations locations;
+    struct World *worlds;
+    int worldsNumber;
+    int capacity;
+    uint64_t random;
+    int keptNumber;
+    int repairedNumber;
+    int sampledNumber;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocates an empty pool of worlds.
+ *
+ * @param capacity The number of worlds the pool keeps.
+ * @param seed The seed of the generator of the pool.
+ *
+ * @return Pointer to the new pool on success or NULL on failure.
+ */
+EXPORT struct WorldPool *worlds_createPool(const int capacity,
+                                           const uint64_t seed);
+
+/**
+ * @brief Frees a pool of worlds.
+ *
+ * @param pool Pointer to the pointer to the pool.
+ *
+ * @return \ref NO_ERROR on success, other value on failure.
+ */
+EXPORT int worlds_deletePool(struct WorldPool **pool);
+
+/**
+ * @brief Brings the worlds of a pool up to date with what the player knows
+ *        now, usually after a card is put down, and fills the pool.
+ *
+ * @param pool The pool.
+ * @param locations What the player knows (see locations_fromGame).
+ *
+ * @return \ref NO_ERROR on success, \ref NOT_FOUND if no deal agrees with
+ *         the knowledge, other value on failure. On failure the pool is
+ *         empty.
+ */
+EXPORT int worlds_updatePool(struct WorldPool *pool,
+                             const struct Locations *locations);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,151 @@
+#include <accounting.h>
+#include <errors.h>
+
+#include <cutter.h>
+#include <pthread.h>
+#include <stdint.h>
+
+/**
+ * Uses CPU time until the thread used the given time.
+ */
+static void burn(const int64_t nanoseconds)
+{
+    volatile long sum = 0;
+    while (accounting_threadTime() < nanoseconds)
+        for (long i = 0; i < 10000; i++)
+            sum += i;
+}
+
+/**
+ * Charges an action which started the given time ago. The thread must
+ * have used that time already.
+ */
+static int charge(struct Accounting *accounting, const int table,
+                  const int seat, const enum ActionKind kind,
+                  const int64_t nanoseconds)
+{
+    int64_t start = accounting_threadTime() - nanoseconds;
+
+    return accounting_chargeAction(accounting, table, seat, kind, &start);
+}
+
+void test_accounting_chargeAction()
+{
+    struct Accounting *accounting = accounting_createAccounting(4);
+    cut_assert_not_null(accounting);
+    cut_assert_null(accounting_createAccounting(0));
+
+    int64_t start = accounting_threadTime();
+    cut_assert_operator_int(start, >=, 0);
+    burn(start + 1000000);
+    int64_t end = start;
+    cut_assert_equal_int(NO_ERROR,
+                         accounting_chargeAction(accounting, 1, 2,
+                                                 BOT_ACTION, &end));
+    cut_assert_operator_int(end, >=, start + 1000000);
+    const struct TableUsage *usage = &accounting->usages[1];
+    cut_assert_operator_int(usage->time, >, 0);
+    cut_assert_equal_int(usage->time, usage->kindTimes[BOT_ACTION]);
+    cut_assert_equal_int(usage->time, usage->seatTimes[2]);
+    cut_assert_equal_int(end - start, usage->time);
+
+    burn(accounting_threadTime() + 5000000);
+    cut_assert_equal_int(NO_ERROR, charge(accounting, 1, -1,
+                                          SERIALIZATION_ACTION, 5000000));
+    cut_assert_equal_int(NO_ERROR, charge(accounting, 1, 0, RULES_ACTION,
+                                          1000000));
+    cut_assert_equal_int(3, usage->actionsNumber);
+    cut_assert_operator_int(usage->kindTimes[SERIALIZATION_ACTION], >=,
+                            5000000);
+    cut_assert_equal_int(usage->time, usage->kindTimes[RULES_ACTION] +
+                         usage->kindTimes[BOT_ACTION] +
+                         usage->kindTimes[SERIALIZATION_ACTION]);
+    cut_assert_equal_int(usage->kindTimes[RULES_ACTION],
+                         usage->seatTimes[0]);
+
+    cut_assert_equal_int(NO_ERROR, accounting_clearTable(accounting, 1));
+    cut_assert_equal_int(0, usage->time);
+    cut_assert_equal_int(0, usage->actionsNumber);
+
+    cut_assert_equal_int(ACCOUNTING_NULL,
+                         accounting_chargeAction(NULL, 0, 0, BOT_ACTION,
+                                                 &start));
+    cut_assert_equal_int(POINTER_NULL,
+                         accounting_chargeAction(accounting, 0, 0,
+                                                 BOT_ACTION, NULL));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         charge(accounting, 4, 0, BOT_ACTION, 0));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         charge(accounting, 0, MAX_GAME_PLAYERS, BOT_ACTION,
+                                0));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         charge(accounting, 0, 0, ActionKindEnd, 0));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         charge(accounting, 0, 0, BOT_ACTION,
+                                -1000000000));
+    cut_assert_equal_int(ILLEGAL_VALUE, accounting_clearTable(accounting, -1));
+    cut_assert_equal_int(ACCOUNTING_NULL, accounting_clearTable(NULL, 0));
+    cut_assert_equal_int(NO_ERROR, accounting_deleteAccounting(&accounting));
+    cut_assert_null(accounting);
+    cut_assert_equal_int(ACCOUNTING_NULL,
+                         accounting_deleteAccounting(&accounting));
+    cut_assert_equal_int(POINTER_NULL, accounting_deleteAccounting(NULL));
+}
+
+/**
+ * Charges 1000 actions dispatched in a row to table 0.
+ */
+static void *chargeTable(void *argument)
+{
+    int64_t start = accounting_threadTime();
+    for (int i = 0; i < 1000; i++)
+        accounting_chargeAction(argument, 0, i % MAX_GAME_PLAYERS,
+                                BOT_ACTION, &start);
+
+    return NULL;
+}
+
+void test_accounting_topTables()
+{
+    struct Accounting *accounting = accounting_createAccounting(6);
+    int tables[6];
+    cut_assert_equal_int(0, accounting_topTables(accounting, tables, 3));
+
+    // Every thread adds to the same table without losing a charge.
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++)
+        pthread_create(&threads[i], NULL, chargeTable, accounting);
+    for (int i = 0; i < 4; i++)
+        pthread_join(threads[i], NULL);
+    const struct TableUsage *usage = &accounting->usages[0];
+    cut_assert_equal_int(4000, usage->actionsNumber);
+    cut_assert_equal_int(usage->time, usage->seatTimes[0] +
+                         usage->seatTimes[1] + usage->seatTimes[2] +
+                         usage->seatTimes[3]);
+    cut_assert_operator_int(usage->time, <, 5000000);
+
+    burn(60000000);
+    charge(accounting, 3, 1, BOT_ACTION, 50000000);
+    charge(accounting, 5, 1, RULES_ACTION, 20000000);
+    charge(accounting, 2, 1, RULES_ACTION, 10000000);
+    charge(accounting, 4, -1, SERIALIZATION_ACTION, 8000000);
+
+    cut_assert_equal_int(3, accounting_topTables(accounting, tables, 3));
+    cut_assert_equal_int(3, tables[0]);
+    cut_assert_equal_int(5, tables[1]);
+    cut_assert_equal_int(2, tables[2]);
+
+    // Table 1 used no time, so it is left out.
+    cut_assert_equal_int(5, accounting_topTables(accounting, tables, 6));
+    cut_assert_equal_int(4, tables[3]);
+    cut_assert_equal_int(0, tables[4]);
+
+    cut_assert_equal_int(0, accounting_topTables(accounting, tables, 0));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         accounting_topTables(accounting, tables, -1));
+    cut_assert_equal_int(POINTER_NULL,
+                         accounting_topTables(accounting, NULL, 3));
+    cut_assert_equal_int(ACCOUNTING_NULL,
+                         accounting_topTables(NULL, tables, 3));
+    accounting_deleteAccounting(&accounting);
+}
@@ -0,0 +1,161 @@
+#include <admission.h>
+#include <game.h>
+#include <team.h>
+#include <errors.h>
+
+#include <cutter.h>
+
+void test_admission_createAdmission()
+{
+    cut_assert_equal_pointer(NULL, admission_createAdmission(0));
+    cut_assert_equal_pointer(NULL, admission_createAdmission(-1));
+
+    struct Admission *admission = admission_createAdmission(0.005);
+    cut_assert_not_null(admission);
+    cut_assert_equal_double(0.005, 0, admission->target);
+    cut_assert_equal_int(0, admission->moves.samplesNumber);
+
+    cut_assert_equal_int(POINTER_NULL, admission_deleteAdmission(NULL));
+    cut_assert_equal_int(NO_ERROR, admission_deleteAdmission(&admission));
+    cut_assert_equal_pointer(NULL, admission);
+    cut_assert_equal_int(ADMISSION_NULL,
+                         admission_deleteAdmission(&admission));
+}
+
+void test_admission_moveLatency()
+{
+    struct Admission *admission = admission_createAdmission(0.005);
+
+    cut_assert_equal_int(ADMISSION_NULL, admission_recordMove(NULL, 1));
+    cut_assert_equal_int(ILLEGAL_VALUE, admission_recordMove(admission, -1));
+    cut_assert_equal_double(0, 0, admission_moveLatency(admission, 0.99));
+    cut_assert_equal_double(ILLEGAL_VALUE, 0,
+                            admission_moveLatency(admission, 2));
+
+    for (int i = 1; i <= 100; i++)
+        admission_recordMove(admission, i * 0.001);
+    cut_assert_equal_double(0.099, 1e-9,
+                            admission_moveLatency(admission, 0.99));
+    cut_assert_equal_double(0.050, 1e-9,
+                            admission_moveLatency(admission, 0.5));
+    cut_assert_equal_double(0.001, 1e-9,
+                            admission_moveLatency(admission, 0));
+
+    /* Only the latest samples count. */
+    for (int i = 0; i < ADMISSION_WINDOW; i++)
+        admission_recordMove(admission, 0.002);
+    cut_assert_equal_int(ADMISSION_WINDOW, admission->moves.samplesNumber);
+    cut_assert_equal_double(0.002, 1e-9,
+                            admission_moveLatency(admission, 1));
+
+    admission_deleteAdmission(&admission);
+}
+
+void test_admission_admitTable()
+{
+    struct Admission *admission = admission_createAdmission(0.005);
+    struct Game *game = game_createGame(11);
+    game_addPlayer(team_createPlayer("A", 0), game);
+    game_addPlayer(team_createPlayer("B", 0), game);
+
+    cut_assert_equal_int(ADMISSION_NULL, admission_admitTable(NULL, game));
+    cut_assert_equal_int(GAME_NULL, admission_admitTable(admission, NULL));
+    cut_assert_equal_int(1, admission_admitTable(admission, game));
+
+    for (int i = 0; i < 100; i++)
+        admission_recordMove(admission, 0.001);
+    cut_assert_equal_int(1, admission_admitTable(admission, game));
+
+    /* One slow move in a hundred is under the 99th percentile, two are
+     * over it. */
+    admission_recordMove(admission, 0.050);
+    cut_assert_equal_int(0, admission_isOverloaded(admission));
+    admission_recordMove(admission, 0.050);
+    cut_assert_equal_int(1, admission_isOverloaded(admission));
+    cut_assert_equal_int(0, admission_admitTable(admission, game));
+    cut_assert_equal_int(2, admission->admitted);
+    cut_assert_equal_int(1, admission->deferred);
+
+    for (int i = 0; i < ADMISSION_WINDOW; i++)
+        admission_recordMove(admission, 0.001);
+    cut_assert_equal_int(1, admission_admitTable(admission, game));
+
+    /* A lagging event loop is an overload too. */
+    for (int i = 0; i < 10; i++)
+        admission_recordLag(admission, 0.020);
+    cut_assert_equal_int(0, admission_admitTable(admission, game));
+
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (game->players[i] != NULL)
+            team_deletePlayer(&game->players[i]);
+    game_deleteGame(&game);
+    admission_deleteAdmission(&admission);
+}
+
+void test_admission_admitTable_bots()
+{
+    struct Admission *admission = admission_createAdmission(0.004);
+    struct Game *games[3];
+
+    /* Bots only, one human and one bot, humans only. */
+    for (int i = 0; i < 3; i++) {
+        games[i] = game_createGame(11);
+        game_addPlayer(team_createPlayer("A", i == 2), games[i]);
+        game_addPlayer(team_createPlayer("B", i > 0), games[i]);
+    }
+
+    /* As the load grows, the tables with the most bots wait first. */
+    const double loads[] = {0.003, 0.005, 0.007, 0.009};
+    const int admitted[][3] = {{1, 1, 1}, {0, 1, 1}, {0, 0, 1}, {0, 0, 0}};
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < ADMISSION_WINDOW; j++)
+            admission_recordMove(admission, loads[i]);
+        for (int j = 0; j < 3; j++)
+            cut_assert_equal_int(admitted[i][j],
+                                 admission_admitTable(admission, games[j]));
+    }
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++)
+            if (games[i]->players[j] != NULL)
+                team_deletePlayer(&games[i]->players[j]);
+        game_deleteGame(&games[i]);
+    }
+    admission_deleteAdmission(&admission);
+}
+
+void test_admission_chooseShed()
+{
+    struct Admission *admission = admission_createAdmission(0.005);
+    struct Game *games[3];
+
+    for (int i = 0; i < 3; i++)
+        games[i] = game_createGame(11);
+    game_addPlayer(team_createPlayer("A", 1), games[0]);
+    game_addPlayer(team_createPlayer("B", 1), games[0]);
+    game_addPlayer(team_createPlayer("C", 1), games[1]);
+    game_addPlayer(team_createPlayer("D", 0), games[1]);
+    game_addPlayer(team_createPlayer("E", 0), games[1]);
+    game_addPlayer(team_createPlayer("F", 0), games[2]);
+    game_addPlayer(team_createPlayer("G", 0), games[2]);
+
+    cut_assert_equal_int(ADMISSION_NULL,
+                         admission_chooseShed(NULL, games, 3));
+    cut_assert_equal_int(POINTER_NULL,
+                         admission_chooseShed(admission, NULL, 3));
+    cut_assert_equal_int(3, admission_chooseShed(admission, games, 3));
+
+    admission_recordLag(admission, 0.020);
+    cut_assert_equal_int(2, admission_chooseShed(admission, games, 3));
+    cut_assert_equal_int(1, admission_chooseShed(admission, games, 2));
+    cut_assert_equal_int(1, admission_chooseShed(admission, games, 1));
+    cut_assert_equal_int(0, admission_chooseShed(admission, NULL, 0));
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++)
+            if (games[i]->players[j] != NULL)
+                team_deletePlayer(&games[i]->players[j]);
+        game_deleteGame(&games[i]);
+    }
+    admission_deleteAdmission(&admission);
+}
@@ -0,0 +1,202 @@
+#include <archive.h>
+#include <notation.h>
+#include <record.h>
+#include <errors.h>
+
+#include <cutter.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "\n";
+
+static const char *otherRound =
+    "[Players \"Cip/0;Ana/1\"]\n"
+    "[Deal \"9DJDQDKDTDAD 9CJCQCKCTCAC\"]\n"
+    "[Bids \"1 0\"]\n"
+    "[Trump \"D\"]\n"
+    "\n";
+
+void test_archive_makeEntries()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct ArchiveEntry entries[MAX_GAME_PLAYERS];
+
+    cut_assert_equal_int(4, archive_makeEntries(&record, ARCHIVE_PLAYER, 10,
+                                                entries));
+    cut_assert_equal_string("Cip", (const char *)entries[2].key);
+    cut_assert_equal_int(0, entries[2].key[RECORD_NAME_LENGTH]);
+    cut_assert_equal_int(42, entries[2].sequence);
+    cut_assert_equal_int(0, memcmp(&record, &entries[2].record,
+                                   sizeof(record)));
+    cut_assert_operator_int(archive_compareEntries(&entries[0],
+                                                   &entries[1]), <, 0);
+
+    // The same hands dealt in another order have the same key.
+    cut_assert_equal_int(1, archive_makeEntries(&record, ARCHIVE_DEAL, 3,
+                                                entries));
+    cut_assert_equal_int(4, entries[0].key[0]);
+    for (int i = 0; i < 4; i++)
+        for (int j = 1; j < 6; j++)
+            cut_assert_operator_int(entries[0].key[1 + 6 * i + j - 1], <,
+                                    entries[0].key[1 + 6 * i + j]);
+    unsigned char swap = record.deck[0];
+    record.deck[0] = record.deck[4];
+    record.deck[4] = swap;
+    cut_assert_equal_int(1, archive_makeEntries(&record, ARCHIVE_DEAL, 5,
+                                                &entries[1]));
+    cut_assert_equal_int(0, memcmp(entries[0].key, entries[1].key,
+                                   ARCHIVE_KEY_LENGTH));
+    cut_assert_operator_int(archive_compareEntries(&entries[0],
+                                                   &entries[1]), <, 0);
+    cut_assert_operator_int(archive_compareEntries(&entries[1],
+                                                   &entries[0]), >, 0);
+    cut_assert_equal_int(0, archive_compareEntries(&entries[1],
+                                                   &entries[1]));
+
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         archive_makeEntries(&record, ArchiveKeyEnd, 0,
+                                             entries));
+    record.deck[0] = DECK_SIZE;
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         archive_makeEntries(&record, ARCHIVE_DEAL, 0,
+                                             entries));
+    record.playersNumber = 1;
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         archive_makeEntries(&record, ARCHIVE_PLAYER, 0,
+                                             entries));
+    cut_assert_equal_int(RECORD_NULL,
+                         archive_makeEntries(NULL, ARCHIVE_DEAL, 0,
+                                             entries));
+    cut_assert_equal_int(POINTER_NULL,
+                         archive_makeEntries(&record, ARCHIVE_DEAL, 0,
+                                             NULL));
+}
+
+void test_archive_readEntry()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct ArchiveEntry entries[MAX_GAME_PLAYERS];
+    archive_makeEntries(&record, ARCHIVE_PLAYER, 0, entries);
+
+    for (int packed = 0; packed < 2; packed++) {
+        FILE *file = tmpfile();
+        struct ArchiveWriter writer;
+        cut_assert_equal_int(NO_ERROR, archive_initWriter(&writer, file,
+                                                          packed));
+        for (int i = 0; i < 4; i++)
+            cut_assert_equal_int(NO_ERROR,
+                                 archive_writeEntry(&writer, &entries[i]));
+        cut_assert_equal_int(4, writer.entriesNumber);
+
+        // Packed, the entries after the first one only hold what changed.
+        long size = ftell(file);
+        if (packed)
+            cut_assert_operator_int(size, <,
+                                    2 * sizeof(struct ArchiveEntry));
+        else
+            cut_assert_equal_int(4 * sizeof(struct ArchiveEntry), size);
+
+        rewind(file);
+        struct ArchiveReader reader;
+        struct ArchiveEntry entry;
+        cut_assert_equal_int(NO_ERROR, archive_initReader(&reader, file,
+                                                          packed));
+        for (int i = 0; i < 4; i++) {
+            cut_assert_equal_int(1, archive_readEntry(&reader, &entry));
+            cut_assert_equal_int(0, memcmp(&entries[i], &entry,
+                                           sizeof(entry)));
+        }
+        cut_assert_equal_int(0, archive_readEntry(&reader, &entry));
+
+        // A truncated entry is an error.
+        rewind(file);
+        char bytes[4 * sizeof(struct ArchiveEntry)];
+        size = fread(bytes, 1, size - 1, file);
+        fclose(file);
+        file = tmpfile();
+        fwrite(bytes, 1, size, file);
+        rewind(file);
+        archive_initReader(&reader, file, packed);
+        for (int i = 0; i < 3; i++)
+            cut_assert_equal_int(1, archive_readEntry(&reader, &entry));
+        cut_assert_equal_int(SYNTAX_ERROR, archive_readEntry(&reader,
+                                                             &entry));
+        fclose(file);
+    }
+
+    struct ArchiveWriter writer;
+    cut_assert_equal_int(POINTER_NULL, archive_initWriter(&writer, NULL, 0));
+    cut_assert_equal_int(POINTER_NULL, archive_writeEntry(NULL, entries));
+    cut_assert_equal_int(POINTER_NULL, archive_initReader(NULL, stdin, 0));
+    cut_assert_equal_int(POINTER_NULL, archive_readEntry(NULL, entries));
+}
+
+void test_archive_mergeEntry()
+{
+    struct RoundRecord records[2];
+    notation_parseRound(&records[0], fourPlayersRound,
+                        strlen(fourPlayersRound));
+    notation_parseRound(&records[1], otherRound, strlen(otherRound));
+
+    // Three sorted runs of the entries by player of rounds 0 to 5.
+    FILE *files[3];
+    struct ArchiveWriter writer;
+    for (int run = 0; run < 3; run++) {
+        files[run] = tmpfile();
+        archive_initWriter(&writer, files[run], 1);
+        struct ArchiveEntry entries[2 * MAX_GAME_PLAYERS];
+        int entriesNumber = 0;
+        for (int round = run; round < 6; round += 3)
+            entriesNumber +=
+                archive_makeEntries(&records[round % 2], ARCHIVE_PLAYER,
+                                    round, &entries[entriesNumber]);
+        for (int i = 0; i < entriesNumber; i++)
+            for (int j = i; j > 0 && archive_compareEntries(
+                     &entries[j - 1], &entries[j]) > 0; j--) {
+                struct ArchiveEntry swap = entries[j];
+                entries[j] = entries[j - 1];
+                entries[j - 1] = swap;
+            }
+        for (int i = 0; i < entriesNumber; i++)
+            archive_writeEntry(&writer, &entries[i]);
+        rewind(files[run]);
+    }
+
+    struct ArchiveMerger *merger = archive_createMerger(files, 3, 1);
+    cut_assert_not_null(merger);
+    struct ArchiveEntry entry, previous;
+    int entriesNumber = 0, anaRounds = 0;
+    while (archive_mergeEntry(merger, &entry) == 1) {
+        if (entriesNumber > 0)
+            cut_assert_operator_int(archive_compareEntries(&previous,
+                                                           &entry), <, 0);
+        if (strcmp((const char *)entry.key, "Ana") == 0)
+            anaRounds++;
+        previous = entry;
+        entriesNumber++;
+    }
+    cut_assert_equal_int(3 * 4 + 3 * 2, entriesNumber);
+    cut_assert_equal_int(6, anaRounds);
+    cut_assert_equal_int(0, archive_mergeEntry(merger, &entry));
+    cut_assert_equal_int(POINTER_NULL, archive_mergeEntry(merger, NULL));
+    cut_assert_equal_int(NO_ERROR, archive_deleteMerger(&merger));
+    cut_assert_null(merger);
+    cut_assert_equal_int(MERGER_NULL, archive_deleteMerger(&merger));
+    cut_assert_equal_int(POINTER_NULL, archive_deleteMerger(NULL));
+    cut_assert_equal_int(MERGER_NULL, archive_mergeEntry(NULL, &entry));
+
+    merger = archive_createMerger(files, 0, 1);
+    cut_assert_equal_int(0, archive_mergeEntry(merger, &entry));
+    archive_deleteMerger(&merger);
+    cut_assert_null(archive_createMerger(NULL, 3, 1));
+    for (int i = 0; i < 3; i++)
+        fclose(files[i]);
+}
@@ -0,0 +1,160 @@
+#include <budget.h>
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+static const char *twoPlayersRound =
+    "[Players \"Ana/0;Bob/1\"]\n"
+    "[Deal \"TDKCKHTCJC9CJSQSQCAHQDAC 9D9STHKDASTSJHJDKSADQH9H\"]\n"
+    "[Bids \"0 3\"]\n"
+    "[Trump \"D\"]\n"
+    "[Play \"9DTD QCKD KSJS QHAH ACAD 9HKH KCJD 9SQS TCTH JCAS 9CTS QDJH\"]\n"
+    "[Marriages \"C -\"]\n"
+    "[Points \"99 41\"]\n"
+    "[Scores \"3 -3\"]\n"
+    "\n";
+
+/**
+ * Allocates the time of the next card of a recorded round with a new
+ * budget of one round.
+ */
+static double allocateCard(const struct RoundRecord *record,
+                           const int cardsNumber, long *forcedNumber)
+{
+    struct Game *game = replay_createGame(record, cardsNumber);
+    cut_assert_not_null(game);
+    int handId, position;
+    cut_assert_equal_int(NO_ERROR, replay_findTurn(game, &handId, &position));
+    struct Hand *hand = game->round->hands[handId];
+
+    struct Budget *budget = budget_createBudget(10);
+    budget->roundTime = 10;
+    double time = budget_allocate(budget, game, hand->players[position],
+                                  hand);
+    cut_assert_equal_int(1, budget->decisionsNumber);
+    *forcedNumber = budget->forcedNumber;
+    cut_assert_equal_double(time, 1e-9, budget->allocatedTime);
+
+    budget_deleteBudget(&budget);
+    replay_deleteGame(&game);
+
+    return time;
+}
+
+void test_budget_startRound()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, twoPlayersRound, strlen(twoPlayersRound));
+    struct Game *game = replay_createGame(&record, 0);
+    struct Budget *budget = budget_createBudget(60);
+    cut_assert_not_null(budget);
+
+    // 11 points left, about 4 rounds.
+    cut_assert_equal_double(0, 1e-9, budget_criticality(game));
+    cut_assert_equal_int(NO_ERROR, budget_startRound(budget, game));
+    cut_assert_equal_double(15, 1e-9, budget->roundTime);
+
+    // A team needs 2 points: the round may be the last one.
+    game->teams[0]->score = 9;
+    cut_assert_equal_double(9.0 / 11, 1e-9, budget_criticality(game));
+    cut_assert_equal_int(NO_ERROR, budget_startRound(budget, game));
+    cut_assert_equal_double(60, 1e-9, budget->roundTime);
+    game->teams[0]->score = 12;
+    cut_assert_equal_double(1, 1e-9, budget_criticality(game));
+
+    cut_assert_equal_int(BUDGET_NULL, budget_startRound(NULL, game));
+    cut_assert_equal_int(GAME_NULL, budget_startRound(budget, NULL));
+    cut_assert_equal_double(GAME_NULL, 1e-9, budget_criticality(NULL));
+
+    budget_deleteBudget(&budget);
+    cut_assert_null(budget);
+    cut_assert_equal_int(BUDGET_NULL, budget_deleteBudget(&budget));
+    cut_assert_equal_int(POINTER_NULL, budget_deleteBudget(NULL));
+    cut_assert_null(budget_createBudget(-1));
+    replay_deleteGame(&game);
+}
+
+void test_budget_allocate()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, twoPlayersRound, strlen(twoPlayersRound));
+    long forcedNumber;
+
+    // The second card of the first hand is the only one allowed.
+    cut_assert_equal_double(0, 0, allocateCard(&record, 1, &forcedNumber));
+    cut_assert_equal_int(1, forcedNumber);
+
+    // The leader of the second hand may put down any of its 7 cards, the
+    // other player fewer of them.
+    double leadTime = allocateCard(&record, 2, &forcedNumber);
+    cut_assert_equal_int(0, forcedNumber);
+    double followTime = allocateCard(&record, 3, &forcedNumber);
+    cut_assert_equal_int(0, forcedNumber);
+    cut_assert_operator_double(0, <, followTime);
+    cut_assert_operator_double(followTime, <, leadTime);
+    cut_assert_operator_double(leadTime, <, 10);
+
+    // The cards of the last hand are played at once.
+    int last = record.handsNumber * record.playersNumber - 1;
+    cut_assert_equal_double(0, 0, allocateCard(&record, last, &forcedNumber));
+    cut_assert_equal_int(1, forcedNumber);
+    double secondLastTime = allocateCard(&record, last - 2, &forcedNumber);
+    cut_assert_operator_double(leadTime, <, secondLastTime);
+
+    // A bid is given more time the closer a team is to winning.
+    struct Game *game = replay_createGame(&record, 0);
+    struct Budget *budget = budget_createBudget(10);
+    budget->roundTime = 10;
+    game->round->bids[0] = 0;
+    game->round->bids[1] = 0;
+    struct Player *player = game->round->players[0];
+    double bidTime = budget_allocate(budget, game, player, NULL);
+    cut_assert_operator_double(0, <, bidTime);
+    game->teams[1]->score = 10;
+    cut_assert_operator_double(bidTime, <,
+                               budget_allocate(budget, game, player, NULL));
+
+    // Nothing to allocate when no time is left.
+    budget->roundTime = 0;
+    cut_assert_equal_double(0, 0, budget_allocate(budget, game, player, NULL));
+    cut_assert_equal_int(3, budget->decisionsNumber);
+    cut_assert_equal_int(0, budget->forcedNumber);
+
+    cut_assert_equal_double(BUDGET_NULL, 0,
+                            budget_allocate(NULL, game, player, NULL));
+    cut_assert_equal_double(GAME_NULL, 0,
+                            budget_allocate(budget, NULL, player, NULL));
+    cut_assert_equal_double(PLAYER_NULL, 0,
+                            budget_allocate(budget, game, NULL, NULL));
+
+    budget_deleteBudget(&budget);
+    replay_deleteGame(&game);
+}
+
+void test_budget_spend()
+{
+    struct Budget *budget = budget_createBudget(20);
+    budget->roundTime = 5;
+
+    cut_assert_equal_int(NO_ERROR, budget_spend(budget, 2, 1.5));
+    cut_assert_equal_double(18.5, 1e-9, budget->gameTime);
+    cut_assert_equal_double(3.5, 1e-9, budget->roundTime);
+    cut_assert_equal_int(0, budget->overrunsNumber);
+
+    cut_assert_equal_int(NO_ERROR, budget_spend(budget, 1, 4));
+    cut_assert_equal_double(14.5, 1e-9, budget->gameTime);
+    cut_assert_equal_double(0, 1e-9, budget->roundTime);
+    cut_assert_equal_double(5.5, 1e-9, budget->usedTime);
+    cut_assert_equal_int(1, budget->overrunsNumber);
+
+    cut_assert_equal_int(ILLEGAL_VALUE, budget_spend(budget, 1, -1));
+    cut_assert_equal_int(BUDGET_NULL, budget_spend(NULL, 1, 1));
+
+    budget_deleteBudget(&budget);
+}
@@ -0,0 +1,257 @@
+#include <connection.h>
+#include <errors.h>
+
+#include <cutter.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int sockets[2];
+
+void cut_setup()
+{
+    socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+}
+
+void cut_teardown()
+{
+    close(sockets[0]);
+    close(sockets[1]);
+}
+
+/**
+ * Reads everything the peer of a connection received.
+ */
+static size_t readAll(char *buffer, const size_t size)
+{
+    size_t length = 0;
+    ssize_t n;
+
+    shutdown(sockets[0], SHUT_WR);
+    while (length < size &&
+           (n = read(sockets[1], buffer + length, size - length)) > 0)
+        length += n;
+
+    return length;
+}
+
+void test_connection_createConnection()
+{
+    cut_assert_equal_pointer(NULL, connection_createConnection(-1));
+
+    struct Connection *connection = connection_createConnection(sockets[0]);
+    cut_assert_not_null(connection);
+    cut_assert_equal_int(sockets[0], connection->fd);
+    cut_assert_equal_int(0, connection_queuedBytes(connection));
+    cut_assert_equal_int(0, connection->shed);
+
+    cut_assert_equal_int(POINTER_NULL, connection_deleteConnection(NULL));
+    cut_assert_equal_int(NO_ERROR, connection_deleteConnection(&connection));
+    cut_assert_equal_pointer(NULL, connection);
+    cut_assert_equal_int(CONNECTION_NULL,
+                         connection_deleteConnection(&connection));
+}
+
+void test_connection_queueEvent()
+{
+    struct Connection *connection = connection_createConnection(sockets[0]);
+    char buffer[256];
+
+    cut_assert_equal_int(CONNECTION_NULL,
+                         connection_queueEvent(NULL, "a", 1));
+    cut_assert_equal_int(POINTER_NULL,
+                         connection_queueEvent(connection, NULL, 1));
+
+    cut_assert_equal_int(NO_ERROR,
+                         connection_queueEvent(connection, "bid 3\n", 6));
+    cut_assert_equal_int(NO_ERROR,
+                         connection_queueEvent(connection, "card AH\n", 8));
+    cut_assert_equal_int(1, connection->messagesNumber);
+    cut_assert_equal_int(14, connection_queuedBytes(connection));
+
+    cut_assert_equal_int(14, connection_flush(connection));
+    cut_assert_equal_int(0, connection_queuedBytes(connection));
+    cut_assert_equal_int(0, connection_flush(connection));
+    cut_assert_equal_int(14, readAll(buffer, sizeof(buffer)));
+    cut_assert_equal_memory("bid 3\ncard AH\n", 14, buffer, 14);
+
+    static char big[CONNECTION_BUFFER_SIZE + 1];
+    cut_assert_equal_int(FULL, connection_queueEvent(connection, big,
+                                                     sizeof(big)));
+    cut_assert_equal_int(1, connection->shed);
+    cut_assert_equal_int(CONNECTION_CLOSED,
+                         connection_queueEvent(connection, "a", 1));
+    cut_assert_equal_int(CONNECTION_CLOSED, connection_flush(connection));
+
+    connection_deleteConnection(&connection);
+}
+
+void test_connection_queueView()
+{
+    struct Connection *connection = connection_createConnection(sockets[0]);
+    char buffer[256];
+    char view[CONNECTION_VIEW_SIZE + 1];
+
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         connection_queueView(connection, view, 0));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         connection_queueView(connection, view, sizeof(view)));
+
+    connection_queueEvent(connection, "a\n", 2);
+    connection_queueView(connection, "view 1\n", 7);
+    connection_queueEvent(connection, "b\n", 2);
+    connection_queueView(connection, "view 2\n", 7);
+    cut_assert_equal_int(2, connection->messagesNumber);
+    cut_assert_equal_int(11, connection_queuedBytes(connection));
+
+    cut_assert_equal_int(11, connection_flush(connection));
+    cut_assert_equal_int(11, readAll(buffer, sizeof(buffer)));
+    cut_assert_equal_memory("a\nb\nview 2\n", 11, buffer, 11);
+
+    connection_deleteConnection(&connection);
+}
+
+void test_connection_flush()
+{
+    struct Connection *connection = connection_createConnection(sockets[0]);
+    static char sent[3 * CONNECTION_BUFFER_SIZE];
+    static char received[3 * CONNECTION_BUFFER_SIZE];
+    size_t sentLength = 0;
+    size_t receivedLength = 0;
+
+    for (size_t i = 0; i < sizeof(sent); i++)
+        sent[i] = 'a' + i % 23;
+
+    /* The peer reads a little at a time, so the events wrap around the
+     * ring and are written in several parts. */
+    while (receivedLength < sizeof(sent) / 2) {
+        size_t length = 1000 + sentLength % 700;
+        if (sentLength + length > sizeof(sent) / 2)
+            length = sizeof(sent) / 2 - sentLength;
+        if (length > 0 && connection_queuedBytes(connection) + length <
+                          CONNECTION_BUFFER_SIZE) {
+            cut_assert_equal_int(NO_ERROR,
+                                 connection_queueEvent(connection,
+                                                       sent + sentLength,
+                                                       length));
+            sentLength += length;
+        }
+        cut_assert_true(connection_flush(connection) >= 0);
+        ssize_t n = read(sockets[1], received + receivedLength, 1500);
+        if (n > 0)
+            receivedLength += n;
+    }
+
+    cut_assert_equal_int(sizeof(sent) / 2, receivedLength);
+    cut_assert_equal_memory(sent, receivedLength, received, receivedLength);
+    cut_assert_equal_int(0, connection_queuedBytes(connection));
+
+    connection_deleteConnection(&connection);
+}
+
+void test_connection_checkBudget()
+{
+    struct Connection *connection = connection_createConnection(sockets[0]);
+    static char events[CONNECTION_HIGH_WATER + 1];
+
+    cut_assert_equal_int(CONNECTION_NULL,
+                         connection_checkBudget(NULL, 0, 1));
+    cut_assert_equal_int(0, connection_checkBudget(connection, 0, 1));
+
+    connection_queueEvent(connection, events, sizeof(events));
+    cut_assert_equal_int(0, connection_checkBudget(connection, 10, 1));
+    cut_assert_equal_int(0, connection_checkBudget(connection, 10.5, 1));
+    cut_assert_equal_int(1, connection_checkBudget(connection, 11.5, 1));
+    cut_assert_equal_int(CONNECTION_CLOSED, connection_flush(connection));
+
+    connection_deleteConnection(&connection);
+}
+
+void test_connection_slowReader()
+{
+    struct Connection *connection = connection_createConnection(sockets[0]);
+    char view[CONNECTION_VIEW_SIZE];
+    static char received[1 << 22];
+    int size = 4096;
+
+    setsockopt(sockets[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    memset(view, '.', sizeof(view));
+
+    /* The peer does not read: views are coalesced, so the queue stays
+     * bounded however many of them are sent. */
+    for (int i = 0; i < 100000; i++) {
+        int length = snprintf(view, sizeof(view), "view %d", i);
+        view[length] = '\n';
+        cut_assert_equal_int(NO_ERROR,
+                             connection_queueView(connection, view,
+                                                  length + 1));
+        cut_assert_true(connection_flush(connection) >= 0);
+        cut_assert_true(connection_queuedBytes(connection) <=
+                        2 * CONNECTION_VIEW_SIZE);
+        cut_assert_equal_int(0, connection_checkBudget(connection, i, 1));
+    }
+
+    /* When the peer reads again, it gets the latest view. */
+    size_t length = 0;
+    while (connection_queuedBytes(connection) > 0) {
+        connection_flush(connection);
+        ssize_t n = read(sockets[1], received + length,
+                         sizeof(received) - length);
+        if (n > 0)
+            length += n;
+    }
+    cut_assert_true(length >= 11);
+    cut_assert_equal_memory("view 99999\n", 11, received + length - 11, 11);
+
+    /* Events can not be coalesced, so the client is shed. */
+    int error = NO_ERROR;
+    for (int i = 0; i < 100000 && error == NO_ERROR; i++) {
+        error = connection_queueEvent(connection, "card 9D\n", 8);
+        connection_flush(connection);
+    }
+    cut_assert_equal_int(FULL, error);
+    cut_assert_equal_int(1, connection_checkBudget(connection, 0, 1));
+    cut_assert_true(readAll(received, sizeof(received)) < sizeof(received));
+
+    connection_deleteConnection(&connection);
+}
+
+
+void test_connection_saveQueue()
+{
+    struct Connection *connection = connection_createConnection(sockets[0]);
+    unsigned char saved[CONNECTION_MAX_SAVED_SIZE];
+    char buffer[256];
+
+    cut_assert_equal_int(CONNECTION_NULL,
+                         connection_saveQueue(NULL, saved, sizeof(saved)));
+    cut_assert_equal_int(POINTER_NULL,
+                         connection_saveQueue(connection, NULL, 0));
+    cut_assert_equal_int(0, connection_saveQueue(connection, saved,
+                                                 sizeof(saved)));
+
+    connection_queueEvent(connection, "a\n", 2);
+    connection_queueView(connection, "view 1\n", 7);
+    connection_queueEvent(connection, "b\n", 2);
+    cut_assert_equal_int(FULL, connection_saveQueue(connection, saved, 10));
+    long length = connection_saveQueue(connection, saved, sizeof(saved));
+    cut_assert_equal_int(3 * 5 + 11, length);
+    connection_deleteConnection(&connection);
+
+    connection = connection_createConnection(sockets[0]);
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         connection_restoreQueue(connection, saved,
+                                                 length - 1));
+    connection_deleteConnection(&connection);
+
+    connection = connection_createConnection(sockets[0]);
+    cut_assert_equal_int(NO_ERROR,
+                         connection_restoreQueue(connection, saved, length));
+    cut_assert_equal_int(3, connection->messagesNumber);
+    cut_assert_equal_int(11, connection_flush(connection));
+    cut_assert_equal_int(11, readAll(buffer, sizeof(buffer)));
+    cut_assert_equal_memory("a\nview 1\nb\n", 11, buffer, 11);
+
+    connection_deleteConnection(&connection);
+}
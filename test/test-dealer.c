@@ -0,0 +1,96 @@
+#include <dealer.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Counts the cards of a bit mask.
+ */
+static int countCards(uint32_t cards)
+{
+    int count = 0;
+    for (; cards != 0; cards &= cards - 1)
+        count++;
+
+    return count;
+}
+
+void test_dealer_dealBatch()
+{
+    const int handSizes[] = {0, 0, 8, 8, 6};
+    const long dealsNumber = 1003;
+    struct DealMasks *deals = malloc(sizeof(struct DealMasks) * dealsNumber);
+    struct Dealer dealer;
+
+    for (int players = 2; players <= MAX_GAME_PLAYERS; players++) {
+        cut_assert_equal_int(NO_ERROR, dealer_initDealer(&dealer, 11));
+        cut_assert_equal_int(NO_ERROR, dealer_dealBatch(&dealer, players,
+                                                        deals, dealsNumber));
+        for (long i = 0; i < dealsNumber; i++) {
+            uint32_t cards = 0;
+            for (int j = 0; j < DEALER_HOLDERS; j++) {
+                cut_assert_equal_uint(0, cards & deals[i].hands[j]);
+                cards |= deals[i].hands[j];
+                int expected = j < players ? handSizes[players] :
+                               j < DEALER_HOLDERS - 1 ? 0 :
+                               DECK_SIZE - players * handSizes[players];
+                cut_assert_equal_int(expected,
+                                     countCards(deals[i].hands[j]));
+            }
+            cut_assert_equal_uint((1u << DECK_SIZE) - 1, cards);
+        }
+    }
+
+    // The lanes and the steps deal different rounds, the seed the same.
+    struct DealMasks again[DEALER_LANES + 1];
+    dealer_initDealer(&dealer, 11);
+    dealer_dealBatch(&dealer, MAX_GAME_PLAYERS, again, DEALER_LANES + 1);
+    cut_assert_equal_int(0, memcmp(deals, again, sizeof(again)));
+    for (int i = 1; i <= DEALER_LANES; i++)
+        cut_assert_false(memcmp(&again[0], &again[i],
+                                sizeof(struct DealMasks)) == 0);
+    dealer_initDealer(&dealer, 12);
+    dealer_dealBatch(&dealer, MAX_GAME_PLAYERS, again, 1);
+    cut_assert_false(memcmp(deals, again, sizeof(struct DealMasks)) == 0);
+
+    cut_assert_equal_int(DEALER_NULL, dealer_initDealer(NULL, 1));
+    cut_assert_equal_int(DEALER_NULL,
+                         dealer_dealBatch(NULL, 4, deals, dealsNumber));
+    cut_assert_equal_int(POINTER_NULL,
+                         dealer_dealBatch(&dealer, 4, NULL, dealsNumber));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         dealer_dealBatch(&dealer, 5, deals, dealsNumber));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         dealer_dealBatch(&dealer, 4, deals, -1));
+    free(deals);
+}
+
+void test_dealer_uniform()
+{
+    const long dealsNumber = 24000;
+    struct DealMasks *deals = malloc(sizeof(struct DealMasks) * dealsNumber);
+    struct Dealer dealer;
+    dealer_initDealer(&dealer, 3);
+    dealer_dealBatch(&dealer, MAX_GAME_PLAYERS, deals, dealsNumber);
+
+    // Every card goes to every seat 6000 times, give or take 67.
+    for (int card = 0; card < DECK_SIZE; card++)
+        for (int seat = 0; seat < MAX_GAME_PLAYERS; seat++) {
+            long count = 0;
+            for (long i = 0; i < dealsNumber; i++)
+                count += deals[i].hands[seat] >> card & 1;
+            cut_assert_operator_int(labs(count - 6000), <, 400);
+        }
+
+    // Two cards are together in a hand 24000 * 5 / 23 times.
+    long together = 0;
+    for (long i = 0; i < dealsNumber; i++)
+        for (int seat = 0; seat < MAX_GAME_PLAYERS; seat++)
+            together += (deals[i].hands[seat] & 0x800001) == 0x800001;
+    cut_assert_operator_int(labs(together - 5217), <, 300);
+
+    free(deals);
+}
@@ -139,4 +139,20 @@ void test_deck_cardsNumber()
     deck_deleteDeck(&deck);
 }
 
+void test_deck_cardId()
+{
+    struct Deck *deck = deck_createDeck();
+    struct Card card = {SuitEnd, VALUES[0]};
+
+    cut_assert_equal_int(CARD_NULL, deck_cardId(NULL));
+    cut_assert_equal_int(ILLEGAL_VALUE, deck_cardId(&card));
+    card.suit = HEARTS;
+    card.value = 7;
+    cut_assert_equal_int(ILLEGAL_VALUE, deck_cardId(&card));
+
+    for (int i = 0; i < DECK_SIZE; i++)
+        cut_assert_equal_int(i, deck_cardId(deck->cards[i]));
+
+    deck_deleteDeck(&deck);
+}
 
@@ -0,0 +1,184 @@
+#include <dedup.h>
+#include <dealer.h>
+#include <notation.h>
+#include <record.h>
+#include <errors.h>
+
+#include <cutter.h>
+#include <string.h>
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "\n";
+
+/**
+ * Counts the cards of a mask.
+ */
+static int countCards(uint32_t cards)
+{
+    int count = 0;
+    for (; cards != 0; cards &= cards - 1)
+        count++;
+
+    return count;
+}
+
+/**
+ * Renames the suits of the cards of a record, and its trump.
+ */
+static void renameSuits(struct RoundRecord *record, const int *suits)
+{
+    for (int i = 0; i < DECK_SIZE; i++)
+        record->deck[i] = suits[record->deck[i] / SUIT_SIZE] * SUIT_SIZE +
+                          record->deck[i] % SUIT_SIZE;
+    record->trump = suits[record->trump];
+}
+
+void test_dedup_canonicalDeal()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct DealMasks deal, canonical, renamed;
+
+    cut_assert_equal_int(NO_ERROR, dedup_recordDeal(&record, &deal));
+    uint32_t all = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        cut_assert_equal_int(6, countCards(deal.hands[i]));
+        all |= deal.hands[i];
+    }
+    cut_assert_equal_int(0, deal.hands[MAX_GAME_PLAYERS]);
+    cut_assert_equal_int((1 << DECK_SIZE) - 1, all);
+
+    // The trump becomes the first suit, the cards stay with their seats.
+    cut_assert_equal_int(NO_ERROR, dedup_canonicalDeal(&deal, record.trump,
+                                                       &canonical));
+    int trumps = 0;
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        cut_assert_equal_int(6, countCards(canonical.hands[i]));
+        trumps += countCards(canonical.hands[i] & 0x3F);
+    }
+    cut_assert_equal_int(SUIT_SIZE, trumps);
+    cut_assert_equal_int(countCards(deal.hands[1] &
+                                    0x3F << SUIT_SIZE * SPADES),
+                         countCards(canonical.hands[1] & 0x3F));
+
+    static const int suits[SuitEnd] = {HEARTS, SPADES, DIAMONDS, CLUBS};
+    renameSuits(&record, suits);
+    dedup_recordDeal(&record, &deal);
+    dedup_canonicalDeal(&deal, record.trump, &renamed);
+    cut_assert_equal_int(0, memcmp(&canonical, &renamed, sizeof(renamed)));
+
+    // Without a trump, every renaming is tried.
+    struct DealMasks any;
+    dedup_canonicalDeal(&deal, SuitEnd, &any);
+    for (int i = 0; i < SuitEnd; i++) {
+        dedup_canonicalDeal(&deal, i, &renamed);
+        int j = 0;
+        while (j < DEALER_HOLDERS && any.hands[j] == renamed.hands[j])
+            j++;
+        if (j < DEALER_HOLDERS)
+            cut_assert_operator_int(any.hands[j], <, renamed.hands[j]);
+    }
+
+    record.playersNumber = 2;
+    cut_assert_equal_int(NO_ERROR, dedup_recordDeal(&record, &deal));
+    cut_assert_equal_int(8, countCards(deal.hands[0]));
+    cut_assert_equal_int(8, countCards(deal.hands[MAX_GAME_PLAYERS]));
+
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         dedup_canonicalDeal(&deal, SuitEnd + 1, &renamed));
+    deal.hands[0] |= 1u << DECK_SIZE;
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         dedup_canonicalDeal(&deal, 0, &renamed));
+    cut_assert_equal_int(POINTER_NULL, dedup_canonicalDeal(NULL, 0,
+                                                           &renamed));
+    record.deck[3] = DECK_SIZE;
+    cut_assert_equal_int(ILLEGAL_VALUE, dedup_recordDeal(&record, &deal));
+    record.playersNumber = 5;
+    cut_assert_equal_int(ILLEGAL_VALUE, dedup_recordDeal(&record, &deal));
+    cut_assert_equal_int(RECORD_NULL, dedup_recordDeal(NULL, &deal));
+}
+
+void test_dedup_addDeal()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct Deduplicator *deduplicator = dedup_createDeduplicator(1000, 100);
+    cut_assert_not_null(deduplicator);
+    cut_assert_null(dedup_createDeduplicator(0, 100));
+    cut_assert_null(dedup_createDeduplicator(1000, 0));
+
+    cut_assert_equal_int(1, dedup_addRound(deduplicator, &record));
+    cut_assert_equal_int(0, dedup_addRound(deduplicator, &record));
+    static const int suits[SuitEnd] = {CLUBS, DIAMONDS, HEARTS, SPADES};
+    renameSuits(&record, suits);
+    cut_assert_equal_int(0, dedup_addRound(deduplicator, &record));
+
+    // The same cards with another trump are another deal.
+    record.trump = (record.trump + 1) % SuitEnd;
+    cut_assert_equal_int(1, dedup_addRound(deduplicator, &record));
+
+    struct Dealer dealer;
+    struct DealMasks deals[64];
+    dealer_initDealer(&dealer, 11);
+    dealer_dealBatch(&dealer, 3, deals, 64);
+    for (int i = 0; i < 64; i++)
+        cut_assert_equal_int(1, dedup_addDeal(deduplicator, &deals[i],
+                                              SuitEnd));
+    for (int i = 0; i < 64; i++)
+        cut_assert_equal_int(0, dedup_addDeal(deduplicator, &deals[i],
+                                              SuitEnd));
+    unsigned char news[64];
+    memset(news, 2, sizeof(news));
+    cut_assert_equal_int(0, dedup_addDeals(deduplicator, deals, 64, SuitEnd,
+                                           news));
+    for (int i = 0; i < 64; i++)
+        cut_assert_equal_int(0, news[i]);
+    cut_assert_equal_int(4 + 192, deduplicator->dealsNumber);
+    cut_assert_equal_int(2 + 128, deduplicator->duplicatesNumber);
+    cut_assert_equal_int(66, deduplicator->keptNumber);
+    cut_assert_equal_int(0, deduplicator->unverifiedNumber);
+
+    cut_assert_equal_int(DEDUPLICATOR_NULL, dedup_addRound(NULL, &record));
+    cut_assert_equal_int(RECORD_NULL, dedup_addRound(deduplicator, NULL));
+    cut_assert_equal_int(DEDUPLICATOR_NULL, dedup_addDeal(NULL, deals, 0));
+    cut_assert_equal_int(POINTER_NULL, dedup_addDeal(deduplicator, NULL, 0));
+    cut_assert_equal_int(DEDUPLICATOR_NULL,
+                         dedup_addDeals(NULL, deals, 64, 0, news));
+    cut_assert_equal_int(POINTER_NULL,
+                         dedup_addDeals(deduplicator, NULL, 64, 0, news));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         dedup_addDeals(deduplicator, deals, -1, 0, news));
+    cut_assert_equal_int(NO_ERROR, dedup_deleteDeduplicator(&deduplicator));
+    cut_assert_null(deduplicator);
+    cut_assert_equal_int(DEDUPLICATOR_NULL,
+                         dedup_deleteDeduplicator(&deduplicator));
+    cut_assert_equal_int(POINTER_NULL, dedup_deleteDeduplicator(NULL));
+
+    // Once the table is full, a duplicate of a deal which is not kept is
+    // only found by the Bloom filter.
+    deduplicator = dedup_createDeduplicator(1000, 1);
+    cut_assert_equal_int(1, dedup_addDeal(deduplicator, &deals[0], SuitEnd));
+    cut_assert_equal_int(1, dedup_addDeal(deduplicator, &deals[1], SuitEnd));
+    cut_assert_equal_int(1, deduplicator->keptNumber);
+    cut_assert_equal_int(0, dedup_addDeal(deduplicator, &deals[0], SuitEnd));
+    cut_assert_equal_int(0, deduplicator->unverifiedNumber);
+    cut_assert_equal_int(0, dedup_addDeal(deduplicator, &deals[1], SuitEnd));
+    cut_assert_equal_int(1, deduplicator->unverifiedNumber);
+    dedup_deleteDeduplicator(&deduplicator);
+
+    // A batch longer than the deals fetched together gives the same answers
+    // as the deals added one by one.
+    deduplicator = dedup_createDeduplicator(1000, 100);
+    dedup_addDeals(deduplicator, deals, 32, SuitEnd, NULL);
+    cut_assert_equal_int(32, dedup_addDeals(deduplicator, deals, 64,
+                                            SuitEnd, news));
+    for (int i = 0; i < 64; i++)
+        cut_assert_equal_int(i >= 32, news[i]);
+    cut_assert_equal_int(0, dedup_addDeals(deduplicator, deals, 0, SuitEnd,
+                                           news));
+    dedup_deleteDeduplicator(&deduplicator);
+}
@@ -0,0 +1,108 @@
+#include <export.h>
+#include <notation.h>
+#include <record.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+static const char *twoPlayersDeal =
+    "[Players \"A\"na/0;Bob/-\"]\n"
+    "[Deal \"JDQDKD9DTDADJCQCKC9CTCAC JSQSKS9STSASJHQHKH9HTHAH\"]\n"
+    "[Bids \"2 0\"]\n"
+    "[Trump \"-\"]\n"
+    "[Points \"70 50\"]\n"
+    "[Scores \"2 1\"]\n"
+    "\n";
+
+void test_export_writeHeader()
+{
+    char text[EXPORT_MAX_ROUND_LENGTH];
+
+    cut_assert_equal_int(POINTER_NULL,
+                         export_writeHeader(EXPORT_CSV, NULL, 10));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         export_writeHeader(ExportFormatEnd, text, 10));
+    cut_assert_equal_int(FULL, export_writeHeader(EXPORT_CSV, text, 10));
+    cut_assert_equal_int(0, export_writeHeader(EXPORT_NDJSON, text, 10));
+
+    int length = export_writeHeader(EXPORT_CSV, text, sizeof(text));
+    cut_assert_operator_int(length, >, 0);
+    cut_assert_equal_int(0, memcmp("players,teams,hands,", text, 20));
+    cut_assert_equal_int('\n', text[length - 1]);
+}
+
+void test_export_writeRound()
+{
+    struct RoundRecord record;
+    char text[EXPORT_MAX_ROUND_LENGTH];
+    const char *ndjson =
+        "{\"players\":[\"A\\\"na\",\"Bob\"],\"teams\":[0,null],"
+        "\"hands\":[\"JDQDKD9DTDADJCQCKC9CTCAC\","
+        "\"JSQSKS9STSASJHQHKH9HTHAH\"],\"bids\":[2,0],\"trump\":null,"
+        "\"tricks\":[],\"leaders\":[],\"winners\":[],"
+        "\"marriages\":[\"\",\"\"],\"points\":[70,50],\"scores\":[2,1],"
+        "\"bidWinner\":0,\"bidMade\":true}\n";
+    const char *csv =
+        "\"A\"\"na;Bob\",0 -,JDQDKD9DTDADJCQCKC9CTCAC "
+        "JSQSKS9STSASJHQHKH9HTHAH,2 0,,,,, ,70 50,2 1,0,1\n";
+
+    cut_assert_operator_int(notation_parseRound(&record, twoPlayersDeal,
+                                                strlen(twoPlayersDeal)),
+                            >, 0);
+
+    cut_assert_equal_int(RECORD_NULL,
+                         export_writeRound(NULL, EXPORT_CSV, text, 10));
+    cut_assert_equal_int(POINTER_NULL,
+                         export_writeRound(&record, EXPORT_CSV, NULL, 10));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         export_writeRound(&record, ExportFormatEnd, text,
+                                           sizeof(text)));
+    cut_assert_equal_int(FULL,
+                         export_writeRound(&record, EXPORT_CSV, text, 10));
+
+    int length = export_writeRound(&record, EXPORT_NDJSON, text,
+                                   sizeof(text));
+    cut_assert_equal_int(strlen(ndjson), length);
+    cut_assert_equal_int(0, memcmp(ndjson, text, length));
+
+    length = export_writeRound(&record, EXPORT_CSV, text, strlen(csv));
+    cut_assert_equal_int(strlen(csv), length);
+    cut_assert_equal_int(0, memcmp(csv, text, length));
+
+    record.deck[3] = DECK_SIZE;
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         export_writeRound(&record, EXPORT_NDJSON, text,
+                                           sizeof(text)));
+}
+
+void test_export_writeRound_play()
+{
+    struct RoundRecord record;
+    char text[EXPORT_MAX_ROUND_LENGTH];
+    const char *round =
+        "[Players \"Ana/0;Bob/1;Cip/2\"]\n"
+        "[Deal \"QHKHJDQDKD9DTDAD JCQCKC9CTCACJSQS KS9STSASJH9HTHAH\"]\n"
+        "[Bids \"2 0 0\"]\n"
+        "[Trump \"H\"]\n"
+        "[Play \"KHACAH 9HQHJC\"]\n"
+        "[Marriages \"H - -\"]\n"
+        "\n";
+
+    notation_parseRound(&record, round, strlen(round));
+
+    int length = export_writeRound(&record, EXPORT_NDJSON, text,
+                                   sizeof(text));
+    text[length] = '\0';
+    cut_assert_not_null(strstr(text, "\"trump\":\"H\","));
+    cut_assert_not_null(strstr(text, "\"tricks\":[\"KHACAH\",\"9HQHJC\"],"
+                                     "\"leaders\":[0,2],"
+                                     "\"winners\":[2,0],"
+                                     "\"marriages\":[\"H\",\"\",\"\"],"));
+
+    length = export_writeRound(&record, EXPORT_CSV, text, sizeof(text));
+    text[length] = '\0';
+    cut_assert_not_null(strstr(text, ",H,KHACAH 9HQHJC,0 2,2 0,H  ,"));
+}
+
@@ -0,0 +1,237 @@
+#include <hooks.h>
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <round.h>
+#include <team.h>
+#include <deck.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+static const char *twoPlayersRound =
+    "[Players \"Ana/0;Bob/1\"]\n"
+    "[Deal \"TDKCKHTCJC9CJSQSQCAHQDAC 9D9STHKDASTSJHJDKSADQH9H\"]\n"
+    "[Bids \"0 3\"]\n"
+    "[Trump \"D\"]\n"
+    "[Play \"9DTD QCKD KSJS QHAH ACAD 9HKH KCJD 9SQS TCTH JCAS 9CTS QDJH\"]\n"
+    "[Marriages \"C -\"]\n"
+    "[Points \"99 41\"]\n"
+    "[Scores \"3 -3\"]\n"
+    "\n";
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "[Marriages \"- - - -\"]\n"
+    "[Points \"27 5 61 27\"]\n"
+    "[Scores \"2 -3 2 -3\"]\n"
+    "\n";
+
+/**
+ * The events seen by the hooks of a test.
+ */
+struct Events {
+    int bids;
+    int cards;
+    int marriages;
+    int tricks;
+    int scores;
+    int pointsNumber[MAX_GAME_PLAYERS];
+};
+
+static void bidPlaced(void *context, const struct BidEvent *event)
+{
+    struct Events *events = context;
+    cut_assert_equal_int(event->bid,
+                         event->round->bids[round_findPlayerIndexRound(
+                             event->player, event->round)]);
+    events->bids++;
+}
+
+static void cardPut(void *context, const struct CardEvent *event)
+{
+    struct Events *events = context;
+    cut_assert_not_null(event->card);
+    for (int i = 0; i < MAX_CARDS; i++)
+        cut_assert_false(event->player->hand[i] == event->card);
+    events->cards++;
+}
+
+static void marriageScored(void *context, const struct MarriageEvent *event)
+{
+    struct Events *events = context;
+    cut_assert_equal_int(event->suit == event->round->trump ? 40 : 20,
+                         event->points);
+    events->pointsNumber[round_findPlayerIndexRound(event->player,
+                                                    event->round)] +=
+        event->points;
+    events->marriages++;
+}
+
+static void trickWon(void *context, const struct TrickEvent *event)
+{
+    struct Events *events = context;
+    events->pointsNumber[round_findPlayerIndexRound(event->winner,
+                                                    event->round)] +=
+        event->points;
+    events->tricks++;
+}
+
+static void scoreChanged(void *context, const struct ScoreEvent *event)
+{
+    struct Events *events = context;
+    cut_assert_equal_int(event->team->score, event->score);
+    cut_assert_not_equal_int(event->oldScore, event->score);
+    for (int i = 0; i < MAX_TEAM_PLAYERS; i++)
+        if (event->team->players[i] != NULL)
+            cut_assert_equal_int(event->score,
+                                 event->team->players[i]->score);
+    events->scores++;
+}
+
+/**
+ * Helper to put down a card of a hand.
+ */
+static void putCard(struct Round *round, const int handId, const int position,
+                    const int cardId)
+{
+    struct Player *player = round->hands[handId]->players[position];
+    for (int i = 0; i < MAX_CARDS; i++)
+        if (player->hand[i] != NULL &&
+            deck_cardId(player->hand[i]) == cardId) {
+            cut_assert_equal_int(NO_ERROR,
+                                 round_putCard(player, i, handId, round));
+            return;
+        }
+
+    cut_fail("card %d not found", cardId);
+}
+
+/**
+ * Plays and scores a recorded round with the rules functions.
+ */
+static void playRecord(const char *text, const struct GameHooks *hooks)
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, text, strlen(text));
+
+    struct Game *game = replay_createGame(&record, 0);
+    cut_assert_not_null(game);
+    cut_assert_equal_int(NO_ERROR, game_setHooks(game, hooks));
+
+    struct Round *round = game->round;
+    for (int i = 0; i < record.playersNumber; i++)
+        cut_assert_equal_int(NO_ERROR, round_placeBid(round->players[i],
+                                                      record.bids[i], round));
+
+    for (int i = 0; i < record.handsNumber; i++) {
+        if (i > 0)
+            cut_assert_equal_int(NO_ERROR,
+                                 round_arrangePlayersHand(round,
+                                                          record.leaders[i]));
+        for (int j = 0; j < record.playersNumber; j++)
+            putCard(round, i, j, record.cards[i][j]);
+        cut_assert_equal_pointer(round->players[record.winners[i]],
+                                 round_handWinner(round->hands[i], round));
+        if (deck_cardsNumber(game->deck) > 0)
+            cut_assert_equal_int(NO_ERROR,
+                                 round_distributeCard(game->deck, round));
+    }
+
+    cut_assert_equal_int(NO_ERROR,
+                         game_updateScore(game, round_getBidWinner(round)));
+    for (int i = 0; i < record.playersNumber; i++) {
+        cut_assert_equal_int(record.pointsNumber[i], round->pointsNumber[i]);
+        cut_assert_equal_int(record.scores[i], round->players[i]->score);
+    }
+
+    replay_deleteGame(&game);
+}
+
+/**
+ * Plays a recorded round with hooks and checks the events against it.
+ */
+static void checkEvents(const char *text)
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, text, strlen(text));
+    struct Events events;
+    memset(&events, 0, sizeof(events));
+    struct GameHooks hooks = {&events, bidPlaced, cardPut, marriageScored,
+                              trickWon, scoreChanged};
+
+    playRecord(text, &hooks);
+
+#ifdef NO_HOOKS
+    cut_assert_equal_int(0, events.bids + events.cards + events.marriages +
+                            events.tricks + events.scores);
+#else
+    int marriages = 0;
+    for (int i = 0; i < record.playersNumber; i++)
+        for (int j = 0; j < SuitEnd; j++)
+            marriages += (record.marriages[i] >> j) & 1;
+
+    int scores = 0;
+    for (int i = 0; i < MAX_GAME_TEAMS; i++) {
+        int seat = 0;
+        while (seat < record.playersNumber && record.teams[seat] != i)
+            seat++;
+        if (seat < record.playersNumber && record.scores[seat] != 0)
+            scores++;
+    }
+
+    cut_assert_equal_int(record.playersNumber, events.bids);
+    cut_assert_equal_int(record.handsNumber * record.playersNumber,
+                         events.cards);
+    cut_assert_equal_int(marriages, events.marriages);
+    cut_assert_equal_int(record.handsNumber, events.tricks);
+    cut_assert_equal_int(scores, events.scores);
+    for (int i = 0; i < record.playersNumber; i++)
+        cut_assert_equal_int(record.pointsNumber[i], events.pointsNumber[i]);
+#endif
+}
+
+void test_hooks_events()
+{
+    checkEvents(twoPlayersRound);
+    checkEvents(fourPlayersRound);
+}
+
+void test_game_setHooks()
+{
+    struct GameHooks hooks;
+    memset(&hooks, 0, sizeof(hooks));
+    cut_assert_equal_int(GAME_NULL, game_setHooks(NULL, &hooks));
+
+    struct Game *game = game_createGame(11);
+    cut_assert_equal_int(NO_ERROR, game_setHooks(game, &hooks));
+    cut_assert_equal_pointer(&hooks, game->hooks);
+    cut_assert_equal_int(NO_ERROR, game_arrangePlayersRound(game, 0));
+    cut_assert_equal_pointer(&hooks, game->round->hooks);
+    cut_assert_equal_int(NO_ERROR, game_setHooks(game, NULL));
+    cut_assert_null(game->hooks);
+    cut_assert_null(game->round->hooks);
+
+    round_deleteRound(&game->round);
+    game_deleteGame(&game);
+
+    playRecord(twoPlayersRound, NULL);
+
+    // Hooks left NULL are not called.
+    struct Events events;
+    memset(&events, 0, sizeof(events));
+    hooks.context = &events;
+    hooks.trickWon = trickWon;
+    playRecord(twoPlayersRound, &hooks);
+    cut_assert_equal_int(0, events.bids + events.cards + events.scores);
+#ifndef NO_HOOKS
+    cut_assert_equal_int(12, events.tricks);
+#endif
+}
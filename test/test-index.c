@@ -0,0 +1,159 @@
+#include <index.h>
+#include <record.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+#define TEST_ROUNDS 5000
+
+static const char *names[] = {"Alexandru", "Bogdan", "Cristina", "Diana",
+                              "Eugen"};
+
+/**
+ * Fills a record from its id, so that every field varies between rounds.
+ */
+static void fillTestRecord(struct RoundRecord *record, const unsigned int id)
+{
+    memset(record, 0, sizeof(struct RoundRecord));
+    record->playersNumber = 2 + id % 3;
+    for (int i = 0; i < record->playersNumber; i++) {
+        strcpy(record->names[i], names[(id + i) % 5]);
+        record->teams[i] = i;
+    }
+
+    int bidder = id % record->playersNumber;
+    record->bids[bidder] = id % 7;
+    record->trump = (id / 7) % SuitEnd;
+    record->pointsNumber[bidder] = (id % 11) * 20;
+    if (id % 13 == 0)
+        record->marriages[bidder] = 1 << record->trump;
+}
+
+static int matchesTestQuery(const unsigned int id, const char *bidder,
+                            const int bid, const int trump, const int made)
+{
+    struct RoundRecord record;
+    fillTestRecord(&record, id);
+    int winner = record_bidWinner(&record);
+
+    return !strcmp(record.names[winner], bidder) &&
+           record.bids[winner] == bid && record.trump == trump &&
+           record_bidMade(&record) == made;
+}
+
+void test_index_createIndex()
+{
+    struct Index *index = index_createIndex();
+
+    cut_assert_equal_int(0, index->roundsNumber);
+    cut_assert_equal_int(0, index->termsNumber);
+    cut_assert_operator_int(index->capacity, >, 0);
+
+    index_deleteIndex(&index);
+}
+
+void test_index_deleteIndex()
+{
+    struct Index *index = index_createIndex();
+
+    cut_assert_equal_int(NO_ERROR, index_deleteIndex(&index));
+    cut_assert_equal_pointer(NULL, index);
+    cut_assert_equal_int(POINTER_NULL, index_deleteIndex(NULL));
+    cut_assert_equal_int(INDEX_NULL, index_deleteIndex(&index));
+}
+
+void test_index_addRound()
+{
+    struct Index *index = index_createIndex();
+    struct RoundRecord record;
+    fillTestRecord(&record, 0);
+
+    cut_assert_equal_int(INDEX_NULL, index_addRound(NULL, &record, 0));
+    cut_assert_equal_int(RECORD_NULL, index_addRound(index, NULL, 0));
+
+    cut_assert_equal_int(NO_ERROR, index_addRound(index, &record, 0));
+    cut_assert_equal_int(ILLEGAL_VALUE, index_addRound(index, &record, 0));
+    cut_assert_equal_int(NO_ERROR, index_addRound(index, &record, 1000000));
+    cut_assert_equal_int(ILLEGAL_VALUE, index_addRound(index, &record, 10));
+    cut_assert_equal_int(2, index->roundsNumber);
+
+    record.playersNumber = 0;
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         index_addRound(index, &record, 1000001));
+
+    index_deleteIndex(&index);
+}
+
+void test_index_query()
+{
+    struct Index *index = index_createIndex();
+    struct RoundRecord record;
+    unsigned int results[TEST_ROUNDS];
+
+    for (unsigned int i = 0; i < TEST_ROUNDS; i++) {
+        fillTestRecord(&record, i);
+        cut_assert_equal_int(NO_ERROR, index_addRound(index, &record, i * 3));
+    }
+
+    struct IndexTerm terms[] = {
+        {INDEX_BIDDER, 0, "Cristina"},
+        {INDEX_BID, 5, NULL},
+        {INDEX_TRUMP, HEARTS, NULL},
+        {INDEX_OUTCOME, 0, NULL}
+    };
+
+    cut_assert_equal_int(INDEX_NULL, index_query(NULL, terms, 4, results, 1));
+    cut_assert_equal_int(POINTER_NULL,
+                         index_query(index, NULL, 4, results, 1));
+    cut_assert_equal_int(POINTER_NULL, index_query(index, terms, 4, NULL, 1));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         index_query(index, terms, 0, results, 1));
+
+    int count = index_query(index, terms, 4, results, TEST_ROUNDS);
+    int expected = 0;
+    for (unsigned int i = 0; i < TEST_ROUNDS; i++) {
+        if (matchesTestQuery(i, "Cristina", 5, HEARTS, 0)) {
+            cut_assert_operator_int(expected, <, count);
+            cut_assert_equal_int(i * 3, results[expected]);
+            expected++;
+        }
+    }
+    cut_assert_operator_int(expected, >, 0);
+    cut_assert_equal_int(expected, count);
+    cut_assert_equal_int(count, index_query(index, terms, 4, NULL, 0));
+
+    struct IndexTerm player = {INDEX_PLAYER, 0, "Eugen"};
+    count = index_query(index, &player, 1, results, TEST_ROUNDS);
+    expected = 0;
+    for (unsigned int i = 0; i < TEST_ROUNDS; i++) {
+        fillTestRecord(&record, i);
+        for (int j = 0; j < record.playersNumber; j++)
+            if (!strcmp(record.names[j], "Eugen"))
+                expected++;
+    }
+    cut_assert_equal_int(expected, count);
+
+    struct IndexTerm marriage[] = {
+        {INDEX_MARRIAGE, SPADES, NULL},
+        {INDEX_TRUMP, SPADES, NULL}
+    };
+    count = index_query(index, marriage, 2, results, TEST_ROUNDS);
+    expected = 0;
+    for (unsigned int i = 0; i < TEST_ROUNDS; i++) {
+        fillTestRecord(&record, i);
+        if (i % 13 == 0 && record.trump == SPADES)
+            cut_assert_equal_int(i * 3, results[expected++]);
+    }
+    cut_assert_equal_int(expected, count);
+
+    struct IndexTerm missing[] = {
+        {INDEX_TRUMP, HEARTS, NULL},
+        {INDEX_PLAYER, 0, "Nobody"}
+    };
+    cut_assert_equal_int(0, index_query(index, missing, 2, results, 1));
+
+    index_deleteIndex(&index);
+}
+
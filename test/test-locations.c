@@ -0,0 +1,281 @@
+#include <locations.h>
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <round.h>
+#include <deck.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+static const char *twoPlayersRound =
+    "[Players \"Ana/0;Bob/1\"]\n"
+    "[Deal \"TDKCKHTCJC9CJSQSQCAHQDAC 9D9STHKDASTSJHJDKSADQH9H\"]\n"
+    "[Bids \"0 3\"]\n"
+    "[Trump \"D\"]\n"
+    "[Play \"9DTD QCKD KSJS QHAH ACAD 9HKH KCJD 9SQS TCTH JCAS 9CTS QDJH\"]\n"
+    "[Marriages \"C -\"]\n"
+    "[Points \"99 41\"]\n"
+    "[Scores \"3 -3\"]\n"
+    "\n";
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "[Marriages \"- - - -\"]\n"
+    "[Points \"27 5 61 27\"]\n"
+    "[Scores \"2 -3 2 -3\"]\n"
+    "\n";
+
+/**
+ * Counts, for every holder and card, the deals which agree with the
+ * knowledge, by dealing the unknown cards in every possible way.
+ */
+static uint64_t countDeals(const struct Locations *locations, int card,
+                           int sizes[LOCATIONS_HOLDERS],
+                           uint64_t counts[LOCATIONS_HOLDERS][DECK_SIZE],
+                           int holders[DECK_SIZE])
+{
+    while (card < DECK_SIZE && !(locations->unknown & (1u << card)))
+        card++;
+    if (card == DECK_SIZE) {
+        for (int i = 0; i < DECK_SIZE; i++)
+            if (locations->unknown & (1u << i))
+                counts[holders[i]][i]++;
+        return 1;
+    }
+
+    uint64_t deals = 0;
+    for (int h = 0; h < LOCATIONS_HOLDERS; h++) {
+        if (sizes[h] == 0 || !(locations->allowed[h] & (1u << card)))
+            continue;
+        sizes[h]--;
+        holders[card] = h;
+        deals += countDeals(locations, card + 1, sizes, counts, holders);
+        sizes[h]++;
+    }
+
+    return deals;
+}
+
+/**
+ * Checks the probabilities against the deals counted one by one.
+ */
+static void assertSameCounts(const struct Locations *locations)
+{
+    double probabilities[LOCATIONS_HOLDERS][DECK_SIZE];
+    uint64_t dealsNumber;
+    cut_assert_equal_int(NO_ERROR,
+                         locations_computeProbabilities(locations,
+                                                        probabilities,
+                                                        &dealsNumber));
+
+    int sizes[LOCATIONS_HOLDERS];
+    int holders[DECK_SIZE];
+    uint64_t counts[LOCATIONS_HOLDERS][DECK_SIZE];
+    memcpy(sizes, locations->sizes, sizeof(sizes));
+    memset(counts, 0, sizeof(counts));
+    cut_assert_equal_uint(countDeals(locations, 0, sizes, counts, holders),
+                          dealsNumber);
+    for (int h = 0; h < LOCATIONS_HOLDERS; h++)
+        for (int i = 0; i < DECK_SIZE; i++)
+            cut_assert_equal_double((double)counts[h][i] / dealsNumber,
+                                    1e-12, probabilities[h][i]);
+}
+
+/**
+ * Finds the holder of a card in a game.
+ */
+static int findHolder(const struct Game *game, const int cardId)
+{
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++) {
+        if (game->round->players[i] == NULL)
+            continue;
+        for (int j = 0; j < MAX_CARDS; j++)
+            if (game->round->players[i]->hand[j] != NULL &&
+                deck_cardId(game->round->players[i]->hand[j]) == cardId)
+                return i;
+    }
+
+    return LOCATIONS_STOCK;
+}
+
+/**
+ * Checks the probabilities of every player at every point of a recorded
+ * round.
+ */
+static void checkRecord(const char *text)
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, text, strlen(text));
+
+    for (int i = 0; i <= record.handsNumber * record.playersNumber; i++) {
+        struct Game *game = replay_createGame(&record, i);
+        cut_assert_not_null(game);
+
+        for (int seat = 0; seat < record.playersNumber; seat++) {
+            struct Locations locations;
+            double probabilities[LOCATIONS_HOLDERS][DECK_SIZE];
+            uint64_t dealsNumber;
+            cut_assert_equal_int(NO_ERROR,
+                                 locations_fromGame(&locations, game,
+                                                    game->round->players
+                                                    [seat]));
+            cut_assert_equal_int(NO_ERROR,
+                                 locations_computeProbabilities(&locations,
+                                     probabilities, &dealsNumber));
+
+            // The real deal agrees with what the player knows.
+            for (int j = 0; j < DECK_SIZE; j++) {
+                double sum = 0;
+                for (int h = 0; h < LOCATIONS_HOLDERS; h++)
+                    sum += probabilities[h][j];
+                if (locations.unknown & (1u << j)) {
+                    cut_assert_equal_double(1, 1e-9, sum);
+                    cut_assert_operator_double(
+                        probabilities[findHolder(game, j)][j], >, 0);
+                } else {
+                    cut_assert_equal_double(0, 0, sum);
+                }
+            }
+            for (int h = 0; h < LOCATIONS_HOLDERS; h++) {
+                double sum = 0;
+                for (int j = 0; j < DECK_SIZE; j++)
+                    sum += probabilities[h][j];
+                cut_assert_equal_double(locations.sizes[h], 1e-9, sum);
+            }
+
+            if (dealsNumber < 100000)
+                assertSameCounts(&locations);
+        }
+
+        replay_deleteGame(&game);
+    }
+}
+
+void test_locations_computeProbabilities()
+{
+    struct Locations locations;
+    double probabilities[LOCATIONS_HOLDERS][DECK_SIZE];
+    uint64_t dealsNumber;
+
+    memset(&locations, 0, sizeof(locations));
+    locations.unknown = 0xF;
+    locations.allowed[1] = 0xF;
+    locations.allowed[2] = 0xE;
+    locations.sizes[1] = 2;
+    locations.sizes[2] = 2;
+    cut_assert_equal_int(NO_ERROR,
+                         locations_computeProbabilities(&locations,
+                                                        probabilities,
+                                                        &dealsNumber));
+    cut_assert_equal_uint(3, dealsNumber);
+    cut_assert_equal_double(1, 1e-12, probabilities[1][0]);
+    cut_assert_equal_double(0, 1e-12, probabilities[2][0]);
+    cut_assert_equal_double(1.0 / 3, 1e-12, probabilities[1][3]);
+    cut_assert_equal_double(2.0 / 3, 1e-12, probabilities[2][3]);
+    assertSameCounts(&locations);
+
+    locations.unknown = 0xFF;
+    locations.allowed[3] = 0xF0;
+    locations.allowed[LOCATIONS_STOCK] = 0x3C;
+    locations.sizes[3] = 3;
+    locations.sizes[LOCATIONS_STOCK] = 1;
+    assertSameCounts(&locations);
+
+    // No deal agrees: two cards only the first seat may hold.
+    locations.allowed[2] = 0xFC;
+    locations.allowed[LOCATIONS_STOCK] = 0xFC;
+    locations.allowed[3] = 0xFC;
+    locations.sizes[1] = 1;
+    locations.sizes[2] = 3;
+    cut_assert_equal_int(NOT_FOUND,
+                         locations_computeProbabilities(&locations,
+                                                        probabilities,
+                                                        &dealsNumber));
+    cut_assert_equal_uint(0, dealsNumber);
+
+    locations.sizes[1] = 2;
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         locations_computeProbabilities(&locations,
+                                                        probabilities, NULL));
+    cut_assert_equal_int(POINTER_NULL,
+                         locations_computeProbabilities(NULL, probabilities,
+                                                        NULL));
+}
+
+void test_locations_sampleDeals()
+{
+    struct Locations locations;
+    double probabilities[LOCATIONS_HOLDERS][DECK_SIZE];
+    static uint32_t deals[10000][LOCATIONS_HOLDERS];
+    uint64_t random = 1;
+
+    memset(&locations, 0, sizeof(locations));
+    locations.unknown = 0xFF;
+    locations.allowed[1] = 0x0F;
+    locations.allowed[2] = 0xFE;
+    locations.allowed[3] = 0xF0;
+    locations.allowed[LOCATIONS_STOCK] = 0xFF;
+    locations.sizes[1] = 2;
+    locations.sizes[2] = 3;
+    locations.sizes[3] = 2;
+    locations.sizes[LOCATIONS_STOCK] = 1;
+    locations_computeProbabilities(&locations, probabilities, NULL);
+    cut_assert_equal_int(NO_ERROR,
+                         locations_sampleDeals(&locations, deals, 10000,
+                                               &random));
+
+    for (int h = 0; h < LOCATIONS_HOLDERS; h++)
+        for (int j = 0; j < DECK_SIZE; j++) {
+            int count = 0;
+            for (int i = 0; i < 10000; i++) {
+                cut_assert_equal_int(0, deals[i][h] &
+                                        ~locations.allowed[h]);
+                count += deals[i][h] >> j & 1;
+            }
+            cut_assert_equal_double(probabilities[h][j], 0.03,
+                                    count / 10000.0);
+        }
+
+    locations.allowed[1] = 0;
+    cut_assert_equal_int(NOT_FOUND,
+                         locations_sampleDeals(&locations, deals, 1,
+                                               &random));
+    cut_assert_equal_int(POINTER_NULL,
+                         locations_sampleDeals(&locations, deals, 1, NULL));
+}
+
+void test_locations_fromGame()
+{
+    checkRecord(twoPlayersRound);
+    checkRecord(fourPlayersRound);
+
+    // Dan puts down TH on AS, the trump: he has no spade left.
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct Game *game = replay_createGame(&record, 6);
+    struct Locations locations;
+    cut_assert_equal_int(NO_ERROR,
+                         locations_fromGame(&locations, game,
+                                            game->round->players[0]));
+    uint32_t spades = ((1u << SUIT_SIZE) - 1) << (SPADES * SUIT_SIZE);
+    cut_assert_equal_int(0, locations.allowed[3] & spades);
+    cut_assert_not_equal_int(0, locations.allowed[1] & spades);
+
+    cut_assert_equal_int(POINTER_NULL,
+                         locations_fromGame(NULL, game,
+                                            game->round->players[0]));
+    cut_assert_equal_int(GAME_NULL,
+                         locations_fromGame(&locations, NULL,
+                                            game->round->players[0]));
+    cut_assert_equal_int(PLAYER_NULL,
+                         locations_fromGame(&locations, game, NULL));
+    replay_deleteGame(&game);
+}
@@ -0,0 +1,177 @@
+#include <migration.h>
+#include <connection.h>
+#include <snapshot.h>
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <errors.h>
+
+#include <cutter.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const char *twoPlayersRound =
+    "[Players \"Ana/0;Bob/1\"]\n"
+    "[Deal \"TDKCKHTCJC9CJSQSQCAHQDAC 9D9STHKDASTSJHJDKSADQH9H\"]\n"
+    "[Bids \"0 3\"]\n"
+    "[Trump \"D\"]\n"
+    "[Play \"9DTD QCKD KSJS QHAH ACAD 9HKH KCJD 9SQS TCTH JCAS 9CTS QDJH\"]\n"
+    "[Marriages \"C -\"]\n"
+    "[Points \"99 41\"]\n"
+    "[Scores \"3 -3\"]\n"
+    "\n";
+
+static int hosts[2];
+static int players[2][2];
+
+void cut_setup()
+{
+    socketpair(AF_UNIX, SOCK_STREAM, 0, hosts);
+    socketpair(AF_UNIX, SOCK_STREAM, 0, players[0]);
+    socketpair(AF_UNIX, SOCK_STREAM, 0, players[1]);
+}
+
+void cut_teardown()
+{
+    close(hosts[0]);
+    close(hosts[1]);
+    for (int i = 0; i < 2; i++) {
+        close(players[i][0]);
+        close(players[i][1]);
+    }
+}
+
+void test_migration_sendTable()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, twoPlayersRound, strlen(twoPlayersRound));
+    struct Game *game = replay_createGame(&record, 9);
+    struct Connection *connections[MAX_GAME_PLAYERS] = {NULL};
+    struct Game *newGame = NULL;
+    struct Connection *newConnections[MAX_GAME_PLAYERS] = {NULL};
+
+    cut_assert_equal_int(GAME_NULL,
+                         migration_sendTable(hosts[0], NULL, connections));
+    cut_assert_equal_int(POINTER_NULL,
+                         migration_sendTable(hosts[0], game, NULL));
+    cut_assert_equal_int(POINTER_NULL,
+                         migration_receiveTable(hosts[1], NULL,
+                                                newConnections));
+
+    /* Bob is not connected while the table moves. */
+    connections[0] = connection_createConnection(players[0][0]);
+    connection_queueEvent(connections[0], "card 9S\n", 8);
+    connection_queueView(connections[0], "view 9\n", 7);
+    cut_assert_equal_int(NO_ERROR,
+                         migration_sendTable(hosts[0], game, connections));
+    cut_assert_equal_int(NO_ERROR,
+                         migration_receiveTable(hosts[1], &newGame,
+                                                newConnections));
+
+    /* The old process lets the table go. */
+    unsigned char snapshot[SNAPSHOT_MAX_SIZE];
+    unsigned char newSnapshot[SNAPSHOT_MAX_SIZE];
+    int length = snapshot_writeGame(game, snapshot, sizeof(snapshot));
+    connection_deleteConnection(&connections[0]);
+    replay_deleteGame(&game);
+    close(players[0][0]);
+    players[0][0] = -1;
+
+    cut_assert_not_null(newGame);
+    cut_assert_equal_int(length, snapshot_writeGame(newGame, newSnapshot,
+                                                    sizeof(newSnapshot)));
+    cut_assert_equal_int(0, memcmp(snapshot, newSnapshot, length));
+    cut_assert_not_null(newConnections[0]);
+    cut_assert_equal_pointer(NULL, newConnections[1]);
+
+    /* The player gets the queued messages, then the new ones, on the same
+     * socket. */
+    char buffer[64];
+    connection_queueEvent(newConnections[0], "card QS\n", 8);
+    cut_assert_equal_int(23, connection_flush(newConnections[0]));
+    close(newConnections[0]->fd);
+    cut_assert_equal_int(23, read(players[0][1], buffer, sizeof(buffer)));
+    cut_assert_equal_memory("card 9S\nview 9\ncard QS\n", 23, buffer, 23);
+
+    connection_deleteConnection(&newConnections[0]);
+    replay_deleteGame(&newGame);
+}
+
+void test_migration_receiveTable()
+{
+    struct Game *game = NULL;
+    struct Connection *connections[MAX_GAME_PLAYERS] = {NULL};
+    unsigned char message[] = {8, 0, 0, 0, 0, 5, 0, 'C', 'G', 'S', 1, 0};
+
+    cut_assert_equal_int(8 + 4, write(hosts[0], message, sizeof(message)));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         migration_receiveTable(hosts[1], &game,
+                                                connections));
+    cut_assert_equal_pointer(NULL, game);
+
+    close(hosts[0]);
+    cut_assert_equal_int(CONNECTION_CLOSED,
+                         migration_receiveTable(hosts[1], &game,
+                                                connections));
+    hosts[0] = -1;
+}
+
+void test_migration_sendHost()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, twoPlayersRound, strlen(twoPlayersRound));
+    struct Game *games[40];
+    struct Connection *connections[40][MAX_GAME_PLAYERS];
+    struct HostState host = {{players[1][0]}, 1, games, connections, 40};
+    struct HostState newHost;
+
+    cut_assert_equal_int(POINTER_NULL, migration_sendHost(hosts[0], NULL));
+    cut_assert_equal_int(POINTER_NULL, migration_receiveHost(hosts[1], NULL));
+    cut_assert_equal_int(POINTER_NULL, migration_clearHost(NULL));
+
+    /* Both players of every table share a socket, so more sockets are sent
+     * than fit in one batch. */
+    memset(connections, 0, sizeof(connections));
+    for (int i = 0; i < 40; i++) {
+        games[i] = replay_createGame(&record, i % 25);
+        for (int j = 0; j < 2; j++) {
+            connections[i][j] = connection_createConnection(players[0][0]);
+            connection_queueEvent(connections[i][j], "a\n", 2);
+        }
+    }
+    connection_queueView(connections[0][0], "view\n", 5);
+
+    cut_assert_equal_int(NO_ERROR, migration_sendHost(hosts[0], &host));
+    cut_assert_equal_int(NO_ERROR, migration_receiveHost(hosts[1], &newHost));
+    cut_assert_equal_int(40, newHost.tablesNumber);
+    cut_assert_equal_int(1, newHost.listenersNumber);
+
+    for (int i = 0; i < 40; i++) {
+        unsigned char snapshot[SNAPSHOT_MAX_SIZE];
+        unsigned char newSnapshot[SNAPSHOT_MAX_SIZE];
+        int length = snapshot_writeGame(games[i], snapshot, sizeof(snapshot));
+        cut_assert_equal_int(length,
+                             snapshot_writeGame(newHost.games[i], newSnapshot,
+                                                sizeof(newSnapshot)));
+        cut_assert_equal_int(0, memcmp(snapshot, newSnapshot, length));
+        cut_assert_not_null(newHost.connections[i][1]);
+        cut_assert_equal_pointer(NULL, newHost.connections[i][2]);
+
+        for (int j = 0; j < 2; j++)
+            connection_deleteConnection(&connections[i][j]);
+        replay_deleteGame(&games[i]);
+    }
+
+    char buffer[64];
+    cut_assert_equal_int(7, connection_flush(newHost.connections[0][0]));
+    cut_assert_equal_int(7, read(players[0][1], buffer, sizeof(buffer)));
+    cut_assert_equal_memory("a\nview\n", 7, buffer, 7);
+    cut_assert_equal_int(4, write(newHost.listeners[0], "ping", 4));
+    cut_assert_equal_int(4, read(players[1][1], buffer, sizeof(buffer)));
+
+    cut_assert_equal_int(NO_ERROR, migration_clearHost(&newHost));
+    cut_assert_equal_int(0, newHost.tablesNumber);
+    cut_assert_equal_pointer(NULL, newHost.games);
+}
@@ -0,0 +1,220 @@
+#include <network.h>
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <deck.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "[Marriages \"- - - -\"]\n"
+    "[Points \"27 5 61 27\"]\n"
+    "[Scores \"2 -3 2 -3\"]\n"
+    "\n";
+
+/**
+ * Builds the example of the next card of a recorded round.
+ */
+static void createExample(struct NetworkExample *example,
+                          const struct RoundRecord *record,
+                          const int cardsNumber)
+{
+    struct Game *game = replay_createGame(record, cardsNumber);
+    cut_assert_not_null(game);
+    int handId, position;
+    cut_assert_equal_int(NO_ERROR, replay_findTurn(game, &handId, &position));
+    struct Hand *hand = game->round->hands[handId];
+    cut_assert_equal_int(NO_ERROR,
+                         network_encodePosition(example->features,
+                                                &example->allowed, game,
+                                                hand->players[position],
+                                                hand));
+
+    int seat = (record->leaders[handId] + position) % record->playersNumber;
+    example->card = record->cards[handId][position];
+    example->value = record->pointsNumber[seat] / 120.0f;
+    replay_deleteGame(&game);
+}
+
+void test_network_encodePosition()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct NetworkExample example;
+
+    // Cip put down AC on JC and Dan follows with KC or 9C, his clubs.
+    createExample(&example, &record, 2);
+    int handCards = 0, tableCards = 0;
+    for (int i = 0; i < DECK_SIZE; i++) {
+        handCards += example.features[i] == 1;
+        tableCards += example.features[2 * DECK_SIZE + i] == 1;
+        cut_assert_equal_double(0, 0, example.features[DECK_SIZE + i]);
+    }
+    cut_assert_equal_int(6, handCards);
+    cut_assert_equal_int(2, tableCards);
+    cut_assert_equal_uint(1u << (CLUBS * SUIT_SIZE + 2) |
+                          1u << (CLUBS * SUIT_SIZE + 3), example.allowed);
+    cut_assert_equal_int(CLUBS * SUIT_SIZE + 2, example.card);
+    cut_assert_equal_double(1, 0, example.features[3 * DECK_SIZE + SPADES]);
+
+    // After the first hand, its cards were played.
+    createExample(&example, &record, 4);
+    int playedCards = 0;
+    for (int i = 0; i < DECK_SIZE; i++)
+        playedCards += example.features[DECK_SIZE + i] == 1;
+    cut_assert_equal_int(4, playedCards);
+
+    struct Game *game = replay_createGame(&record, 0);
+    struct Hand *hand = game->round->hands[0];
+    cut_assert_equal_int(HAND_NULL,
+                         network_encodePosition(example.features,
+                                                &example.allowed, game,
+                                                hand->players[0], NULL));
+    cut_assert_equal_int(POINTER_NULL,
+                         network_encodePosition(NULL, &example.allowed, game,
+                                                hand->players[0], hand));
+    replay_deleteGame(&game);
+}
+
+void test_network_addGradients()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct NetworkExample example;
+    createExample(&example, &record, 8);
+
+    int hiddenSizes[] = {7, 5};
+    struct Network *network = network_createNetwork(hiddenSizes, 2, 3);
+    cut_assert_not_null(network);
+    cut_assert_equal_int(81 * 7 + 8 * 5 + 6 * NETWORK_OUTPUTS,
+                         network->parametersNumber);
+    for (size_t i = 0; i < network->parametersNumber; i++)
+        network->parameters[i] += 0.01f * (i % 7);
+
+    // The gradients agree with finite differences of the loss.
+    float *gradients = calloc(network->parametersNumber, sizeof(float));
+    double loss = network_addGradients(network, &example, gradients);
+    cut_assert_operator_double(loss, >, 0);
+    for (size_t i = 0; i < network->parametersNumber; i += 13) {
+        float parameter = network->parameters[i];
+        float zero[1024] = {0};
+        network->parameters[i] = parameter + 1e-2f;
+        double plus = network_addGradients(network, &example, zero);
+        network->parameters[i] = parameter - 1e-2f;
+        double minus = network_addGradients(network, &example, zero);
+        network->parameters[i] = parameter;
+        cut_assert_equal_double((plus - minus) / 2e-2, 2e-3, gradients[i]);
+    }
+
+    example.card = 0;
+    example.allowed = 2;
+    cut_assert_equal_double(ILLEGAL_VALUE, 0,
+                            network_addGradients(network, &example,
+                                                 gradients));
+    cut_assert_equal_double(NETWORK_NULL, 0,
+                            network_addGradients(NULL, &example, gradients));
+
+    free(gradients);
+    network_deleteNetwork(&network);
+    cut_assert_null(network);
+    cut_assert_equal_int(NETWORK_NULL, network_deleteNetwork(&network));
+    cut_assert_null(network_createNetwork(hiddenSizes, NETWORK_MAX_LAYERS,
+                                          1));
+}
+
+void test_network_adamStep()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct NetworkExample examples[DECK_SIZE];
+    for (int i = 0; i < DECK_SIZE; i++)
+        createExample(&examples[i], &record, i);
+
+    int hiddenSizes[] = {32};
+    struct Network *network = network_createNetwork(hiddenSizes, 1, 5);
+    size_t parametersNumber = network->parametersNumber;
+    float *gradients = malloc(sizeof(float) * parametersNumber);
+    float *moments = calloc(2 * parametersNumber, sizeof(float));
+
+    // The network learns the cards of the round by heart.
+    double firstLoss = 0, loss = 0;
+    for (long step = 1; step <= 200; step++) {
+        memset(gradients, 0, sizeof(float) * parametersNumber);
+        loss = 0;
+        for (int i = 0; i < DECK_SIZE; i++)
+            loss += network_addGradients(network, &examples[i], gradients);
+        for (size_t i = 0; i < parametersNumber; i++)
+            gradients[i] /= DECK_SIZE;
+        if (step == 1)
+            firstLoss = loss;
+        cut_assert_equal_int(NO_ERROR, network_adamStep(network, gradients,
+                                                        moments, step, 1e-2));
+    }
+    cut_assert_operator_double(loss, <, firstLoss / 10);
+
+    float outputs[NETWORK_OUTPUTS];
+    cut_assert_equal_int(NO_ERROR,
+                         network_evaluate(network, examples[8].features,
+                                          examples[8].allowed, outputs));
+    double sum = 0;
+    for (int i = 0; i < DECK_SIZE; i++) {
+        sum += outputs[i];
+        if (!(examples[8].allowed >> i & 1))
+            cut_assert_equal_double(0, 0, outputs[i]);
+    }
+    cut_assert_equal_double(1, 1e-5, sum);
+    cut_assert_operator_double(outputs[examples[8].card], >, 0.5);
+    cut_assert_equal_double(examples[8].value, 0.1, outputs[DECK_SIZE]);
+
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         network_adamStep(network, gradients, moments, 0,
+                                          1e-2));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         network_evaluate(network, examples[8].features, 0,
+                                          outputs));
+
+    free(moments);
+    free(gradients);
+    network_deleteNetwork(&network);
+}
+
+void test_network_writeNetwork()
+{
+    int hiddenSizes[] = {16, 8};
+    struct Network *network = network_createNetwork(hiddenSizes, 2, 9);
+    size_t size = network_savedSize(network);
+    cut_assert_equal_int(4 + 4 + 4 * 4 + 4 * network->parametersNumber, size);
+    unsigned char *buffer = malloc(size);
+
+    cut_assert_equal_int(size, network_writeNetwork(network, buffer, size));
+    cut_assert_equal_int(FULL, network_writeNetwork(network, buffer,
+                                                    size - 1));
+    struct Network *copy = network_readNetwork(buffer, size);
+    cut_assert_not_null(copy);
+    cut_assert_equal_int(3, copy->layersNumber);
+    cut_assert_equal_int(0, memcmp(network->sizes, copy->sizes,
+                                   sizeof(network->sizes)));
+    cut_assert_equal_int(0, memcmp(network->parameters, copy->parameters,
+                                   sizeof(float) *
+                                   network->parametersNumber));
+
+    cut_assert_null(network_readNetwork(buffer, size - 1));
+    buffer[8] = 79;
+    cut_assert_null(network_readNetwork(buffer, size));
+    buffer[0] = 'X';
+    cut_assert_null(network_readNetwork(buffer, size));
+
+    free(buffer);
+    network_deleteNetwork(&copy);
+    network_deleteNetwork(&network);
+}
@@ -0,0 +1,264 @@
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <round.h>
+#include <team.h>
+#include <deck.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *threePlayersDeal =
+    "% A round with a marriage of hearts for Ana.\n"
+    "[Players \"Ana/0;Bob/1;Cip/2\"]\n"
+    "[Deal \"QHKHJDQDKD9DTDAD JCQCKC9CTCACJSQS KS9STSASJH9HTHAH\"]\n"
+    "[Bids \"2 0 0\"]\n"
+    "[Trump \"H\"]\n"
+    "\n";
+
+/**
+ * Plays a recorded deal, every player putting down his first allowed card.
+ */
+static void playRecordedDeal(struct RoundRecord *record)
+{
+    struct Game *game = game_createGame(11);
+    for (int i = 0; i < record->playersNumber; i++) {
+        game_addPlayer(team_createPlayer(record->names[i], 0), game);
+        struct Team *team = team_createTeam();
+        team_addPlayer(team, game->players[i]);
+        game_addTeam(team, game);
+    }
+
+    struct Deck *deck = record_createDeck(record);
+    game_arrangePlayersRound(game, 0);
+    record_captureDeal(record, deck);
+    round_distributeDeck(deck, game->round);
+    game->round->trump = record->trump;
+    for (int i = 0; i < record->playersNumber; i++)
+        round_placeBid(game->players[i], record->bids[i], game->round);
+
+    int lastCard = DECK_SIZE / game->numberPlayers - 1;
+    if (lastCard >= MAX_CARDS)
+        lastCard = MAX_CARDS - 1;
+
+    int first = 0;
+    for (int i = 0; team_hasCards(game->players[0]) == 1; i++) {
+        round_arrangePlayersHand(game->round, first);
+        struct Hand *hand = game->round->hands[i];
+        for (int j = 0; j < game->numberPlayers; j++) {
+            int cardId = game_findNextAllowedCard(hand->players[j], game,
+                                                  hand, lastCard);
+            round_putCard(hand->players[j], cardId, i, game->round);
+        }
+        struct Player *winner = round_handWinner(hand, game->round);
+        first = round_findPlayerIndexRound(winner, game->round);
+        if (deck_cardsNumber(deck) > 0)
+            round_distributeCard(deck, game->round);
+    }
+
+    game_updateScore(game, round_getBidWinner(game->round));
+    cut_assert_equal_int(NO_ERROR, record_captureRound(record, game));
+
+    for (int i = 0; i < MAX_HANDS; i++) {
+        if (game->round->hands[i] == NULL)
+            continue;
+        for (int j = 0; j < MAX_GAME_PLAYERS; j++)
+            if (game->round->hands[i]->cards[j] != NULL)
+                deck_deleteCard(&game->round->hands[i]->cards[j]);
+        round_deleteHand(&game->round->hands[i]);
+    }
+    round_deleteRound(&game->round);
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (game->players[i] != NULL)
+            team_deletePlayer(&game->players[i]);
+    for (int i = 0; i < MAX_GAME_TEAMS; i++)
+        if (game->teams[i] != NULL)
+            team_deleteTeam(&game->teams[i]);
+    deck_deleteDeck(&deck);
+    game_deleteGame(&game);
+}
+
+void test_notation_parseRound()
+{
+    struct RoundRecord record;
+    const char *text = threePlayersDeal;
+
+    cut_assert_equal_int(RECORD_NULL,
+                         notation_parseRound(NULL, text, strlen(text)));
+    cut_assert_equal_int(POINTER_NULL, notation_parseRound(&record, NULL, 0));
+    cut_assert_equal_int(0, notation_parseRound(&record, "\n \n", 3));
+
+    cut_assert_equal_int(strlen(text),
+                         notation_parseRound(&record, text, strlen(text)));
+    cut_assert_equal_int(3, record.playersNumber);
+    cut_assert_equal_string("Bob", record.names[1]);
+    cut_assert_equal_int(2, record.teams[2]);
+    cut_assert_equal_int(2, record.bids[0]);
+    cut_assert_equal_int(HEARTS, record.trump);
+    cut_assert_equal_int(0, record.handsNumber);
+    cut_assert_equal_int(HEARTS * SUIT_SIZE + 1, record.deck[0]);
+    cut_assert_equal_int(CLUBS * SUIT_SIZE, record.deck[1]);
+    cut_assert_equal_int(SPADES * SUIT_SIZE + 2, record.deck[2]);
+    cut_assert_equal_int(HEARTS * SUIT_SIZE + 2, record.deck[3]);
+
+    struct Deck *deck = record_createDeck(&record);
+    for (int i = 0; i < DECK_SIZE; i++)
+        cut_assert_equal_int(record.deck[i], deck_cardId(deck->cards[i]));
+    deck_deleteDeck(&deck);
+
+    // A deck with a card out of range or repeated is not created.
+    record.deck[3] = record.deck[0];
+    cut_assert_null(record_createDeck(&record));
+    record.deck[3] = DECK_SIZE;
+    cut_assert_null(record_createDeck(&record));
+    cut_assert_null(record_createDeck(NULL));
+}
+
+void test_notation_parseRound_errors()
+{
+    struct RoundRecord record;
+    const char *texts[] = {
+        "[Players \"Ana/0;Bob/1\"]\n[Bids \"0 0\"]\n[Trump \"H\"]\n",
+        "[Players \"Ana/0\"]\n[Deal \"JDQDKD9DTDADJCQCKC9CTCACJSQSKS9STSASJHQHKH9HTHAH\"]\n"
+        "[Bids \"0\"]\n[Trump \"H\"]\n",
+        "[Players \"Ana/0;Bob/1\"]\n[Deal \"JDQDKD9DTDADJCQC KC9CTCACJSQSKS9S\"]\n"
+        "[Bids \"0 0\"]\n[Trump \"H\"]\n",
+        "[Players \"Ana/0;Bob/1;Cip/2\"]\n"
+        "[Deal \"QHKHJDQDKD9DTDAD JCQCKC9CTCACJSQS KS9STSASJH9HTHQH\"]\n"
+        "[Bids \"2 0 0\"]\n[Trump \"H\"]\n",
+        "[Players \"Ana/0;Bob/1;Cip/2\"]\n"
+        "[Deal \"QHKHJDQDKD9DTDAD JCQCKC9CTCACJSQS KS9STSASJH9HTHAH\"]\n"
+        "[Bids \"2 0 7\"]\n[Trump \"H\"]\n",
+        "[Players \"Ana/0;Bob/1;Cip/2\"]\n"
+        "[Deal \"QHKHJDQDKD9DTDAD JCQCKC9CTCACJSQS KS9STSASJH9HTHAH\"]\n"
+        "[Bids \"2 0 0\"]\n[Trump \"H\"]\n[Play \"JCQHKS\"]\n",
+        "Players Ana/0;Bob/1\n"
+    };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++)
+        cut_assert_equal_int(SYNTAX_ERROR,
+                             notation_parseRound(&record, texts[i],
+                                                 strlen(texts[i])));
+}
+
+void test_notation_writeRound()
+{
+    struct RoundRecord record;
+    struct RoundRecord parsed;
+    char text[NOTATION_MAX_ROUND_LENGTH];
+
+    notation_parseRound(&record, threePlayersDeal, strlen(threePlayersDeal));
+    playRecordedDeal(&record);
+
+    cut_assert_equal_int(RECORD_NULL, notation_writeRound(NULL, text, 10));
+    cut_assert_equal_int(POINTER_NULL, notation_writeRound(&record, NULL, 10));
+    cut_assert_equal_int(FULL, notation_writeRound(&record, text, 10));
+
+    int length = notation_writeRound(&record, text, sizeof(text));
+    cut_assert_operator_int(length, >, 0);
+    cut_assert_equal_int('\n', text[length - 1]);
+    cut_assert_equal_int('\n', text[length - 2]);
+
+    cut_assert_equal_int(length, notation_parseRound(&parsed, text, length));
+    cut_assert_equal_int(0, memcmp(&record, &parsed, sizeof(record)));
+    cut_assert_equal_int(8, parsed.handsNumber);
+    cut_assert_equal_int(1 << HEARTS, parsed.marriages[0]);
+
+    char copy[NOTATION_MAX_ROUND_LENGTH];
+    cut_assert_equal_int(length, notation_writeRound(&parsed, copy, length));
+    cut_assert_equal_int(0, memcmp(text, copy, length));
+
+    // A corrupt record is not written.
+    cut_assert_null(notation_writeCard(copy, DECK_SIZE));
+    parsed.cards[7][2] = DECK_SIZE;
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         notation_writeRound(&parsed, copy, sizeof(copy)));
+    record.deck[5] = 255;
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         notation_writeRound(&record, copy, sizeof(copy)));
+    notation_parseRound(&record, text, length);
+    record.handsNumber = DECK_SIZE / record.playersNumber + 1;
+    cut_assert_equal_int(ILLEGAL_VALUE, notation_checkRecord(&record));
+    cut_assert_equal_int(RECORD_NULL, notation_checkRecord(NULL));
+}
+
+void test_notation_readRound()
+{
+    struct RoundRecord record;
+    struct RoundRecord parsed;
+    struct NotationReader reader;
+    char text[NOTATION_MAX_ROUND_LENGTH];
+    char buffer[NOTATION_MAX_ROUND_LENGTH];
+    FILE *file = tmpfile();
+
+    notation_parseRound(&record, threePlayersDeal, strlen(threePlayersDeal));
+    playRecordedDeal(&record);
+    int length = notation_writeRound(&record, text, sizeof(text));
+    for (int i = 0; i < 100; i++)
+        fwrite(text, 1, length, file);
+    fputs(threePlayersDeal, file);
+    fputs("[Players \"Ana/0;Bob/1\"]", file);
+    rewind(file);
+
+    cut_assert_equal_int(POINTER_NULL,
+                         notation_initReader(&reader, NULL, buffer, 10));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         notation_initReader(&reader, file, buffer, 10));
+    cut_assert_equal_int(NO_ERROR,
+                         notation_initReader(&reader, file, buffer,
+                                             sizeof(buffer)));
+
+    for (int i = 0; i < 100; i++) {
+        cut_assert_equal_int(1, notation_readRound(&reader, &parsed));
+        cut_assert_equal_int(0, memcmp(&record, &parsed, sizeof(record)));
+    }
+    cut_assert_equal_int(1, notation_readRound(&reader, &parsed));
+    cut_assert_equal_int(0, parsed.handsNumber);
+    cut_assert_equal_int(SYNTAX_ERROR, notation_readRound(&reader, &parsed));
+    cut_assert_equal_int(0, notation_readRound(&reader, &parsed));
+    fclose(file);
+
+    // A round longer than the buffer is skipped up to the empty line after
+    // it, wherever the buffer ends.
+    for (int extra = 0; extra < 40; extra++) {
+        file = tmpfile();
+        fputs("\n \n%", file);
+        for (int i = 0; i < NOTATION_MAX_ROUND_LENGTH + extra; i++)
+            fputc(i % 64 == 63 ? '\n' : 'x', file);
+        fputs("\n \r\n", file);
+        fwrite(text, 1, length, file);
+        rewind(file);
+        notation_initReader(&reader, file, buffer, sizeof(buffer));
+        cut_assert_equal_int(SYNTAX_ERROR,
+                             notation_readRound(&reader, &parsed));
+        cut_assert_equal_int(1, notation_readRound(&reader, &parsed));
+        cut_assert_equal_int(0, memcmp(&record, &parsed, sizeof(record)));
+        cut_assert_equal_int(0, notation_readRound(&reader, &parsed));
+        fclose(file);
+    }
+
+    // A failed read is reported once, not taken for the end of file.
+    file = fopen("/dev/null", "w");
+    cut_assert_not_null(file);
+    notation_initReader(&reader, file, buffer, sizeof(buffer));
+    cut_assert_equal_int(READ_ERROR, notation_readRound(&reader, &parsed));
+    cut_assert_equal_int(0, notation_readRound(&reader, &parsed));
+    fclose(file);
+}
+
+void test_notation_roundLength()
+{
+    const char *text = "% comment\n\n[Trump \"H\"]\n \r\n[Bids \"0\"]\n";
+
+    cut_assert_equal_int(0, notation_roundLength(NULL, 10));
+    cut_assert_equal_int(0, notation_roundLength(text, 10));
+    cut_assert_equal_int(11, notation_roundLength(text, strlen(text)));
+    cut_assert_equal_int(15, notation_roundLength(text + 11,
+                                                  strlen(text) - 11));
+    cut_assert_equal_int(0, notation_roundLength(text + 26,
+                                                 strlen(text) - 26));
+}
+
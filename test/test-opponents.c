@@ -0,0 +1,155 @@
+#include <opponents.h>
+#include <notation.h>
+#include <record.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *twoPlayersRound =
+    "[Players \"Ana/0;Bob/1\"]\n"
+    "[Deal \"TDKCKHTCJC9CJSQSQCAHQDAC 9D9STHKDASTSJHJDKSADQH9H\"]\n"
+    "[Bids \"0 3\"]\n"
+    "[Trump \"D\"]\n"
+    "[Play \"9DTD QCKD KSJS QHAH ACAD 9HKH KCJD 9SQS TCTH JCAS 9CTS QDJH\"]\n"
+    "[Marriages \"C -\"]\n"
+    "[Points \"99 41\"]\n"
+    "[Scores \"3 -3\"]\n"
+    "\n";
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "[Marriages \"- - - -\"]\n"
+    "[Points \"27 5 61 27\"]\n"
+    "[Scores \"2 -3 2 -3\"]\n"
+    "\n";
+
+/**
+ * Checks the statistics of a player.
+ */
+static void assertStats(const struct OpponentStore *store, const char *name,
+                        const unsigned int expected[8])
+{
+    const struct OpponentStats *stats = opponents_find(store, name);
+    cut_assert_not_null(stats);
+    cut_assert_equal_string(name, stats->name);
+    cut_assert_equal_uint(expected[0], stats->roundsNumber);
+    cut_assert_equal_uint(expected[1], stats->bidsNumber);
+    cut_assert_equal_uint(expected[2], stats->bidUnits);
+    cut_assert_equal_uint(expected[3], stats->madeUnits);
+    cut_assert_equal_uint(expected[4], stats->leadsNumber);
+    cut_assert_equal_uint(expected[5], stats->trumpLeadsNumber);
+    cut_assert_equal_uint(expected[6], stats->overtrumpChancesNumber);
+    cut_assert_equal_uint(expected[7], stats->overtrumpsNumber);
+}
+
+/**
+ * Fills a store with the recorded rounds.
+ */
+static struct OpponentStore *createStore()
+{
+    struct OpponentStore *store = opponents_createStore();
+    cut_assert_not_null(store);
+
+    struct RoundRecord record;
+    notation_parseRound(&record, twoPlayersRound, strlen(twoPlayersRound));
+    cut_assert_equal_int(NO_ERROR, opponents_addRound(store, &record));
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    cut_assert_equal_int(NO_ERROR, opponents_addRound(store, &record));
+
+    return store;
+}
+
+/**
+ * Checks the statistics of the players of the recorded rounds.
+ */
+static void assertRecordStats(const struct OpponentStore *store)
+{
+    // Ana overtrumps 9D with TD in the first hand of the first round.
+    const unsigned int ana[] = {2, 0, 0, 0, 8, 1, 1, 1};
+    // Bob bids 3 twice and his teams make 1 and 0.
+    const unsigned int bob[] = {2, 2, 6, 1, 7, 1, 4, 0};
+    // Cip leads AS, which Dan and Bob can not overtrump.
+    const unsigned int cip[] = {1, 0, 0, 0, 2, 1, 1, 0};
+    const unsigned int dan[] = {1, 0, 0, 0, 1, 0, 1, 0};
+
+    assertStats(store, "Ana", ana);
+    assertStats(store, "Bob", bob);
+    assertStats(store, "Cip", cip);
+    assertStats(store, "Dan", dan);
+}
+
+void test_opponents_addRound()
+{
+    struct OpponentStore *store = createStore();
+    cut_assert_equal_uint(4, store->playersNumber);
+    assertRecordStats(store);
+    cut_assert_null(opponents_find(store, "Eve"));
+    cut_assert_null(opponents_find(NULL, "Ana"));
+
+    // Enough players to grow the table.
+    struct RoundRecord record;
+    notation_parseRound(&record, twoPlayersRound, strlen(twoPlayersRound));
+    for (int i = 0; i < 50; i++) {
+        sprintf(record.names[0], "Player %d", 2 * i);
+        sprintf(record.names[1], "Player %d", 2 * i + 1);
+        cut_assert_equal_int(NO_ERROR, opponents_addRound(store, &record));
+    }
+    cut_assert_equal_uint(104, store->playersNumber);
+    cut_assert_operator_uint(store->capacity * 3, >=,
+                             store->playersNumber * 4);
+    for (int i = 0; i < 100; i++) {
+        char name[RECORD_NAME_LENGTH];
+        sprintf(name, "Player %d", i);
+        cut_assert_not_null(opponents_find(store, name));
+    }
+    assertRecordStats(store);
+
+    cut_assert_equal_int(OPPONENTS_NULL, opponents_addRound(NULL, &record));
+    cut_assert_equal_int(RECORD_NULL, opponents_addRound(store, NULL));
+    record.playersNumber = 5;
+    cut_assert_equal_int(ILLEGAL_VALUE, opponents_addRound(store, &record));
+
+    opponents_deleteStore(&store);
+    cut_assert_null(store);
+    cut_assert_equal_int(OPPONENTS_NULL, opponents_deleteStore(&store));
+    cut_assert_equal_int(POINTER_NULL, opponents_deleteStore(NULL));
+}
+
+void test_opponents_writeStore()
+{
+    struct OpponentStore *store = createStore();
+    unsigned char buffer[OPPONENTS_HEADER_SIZE + 4 * OPPONENTS_PLAYER_SIZE];
+
+    long length = opponents_writeStore(store, buffer, sizeof(buffer));
+    cut_assert_equal_int(sizeof(buffer), length);
+    cut_assert_equal_int(FULL, opponents_writeStore(store, buffer,
+                                                    sizeof(buffer) - 1));
+    cut_assert_equal_int(OPPONENTS_NULL,
+                         opponents_writeStore(NULL, buffer, sizeof(buffer)));
+    cut_assert_equal_int(POINTER_NULL,
+                         opponents_writeStore(store, NULL, sizeof(buffer)));
+    opponents_deleteStore(&store);
+
+    store = opponents_readStore(buffer, length);
+    cut_assert_not_null(store);
+    cut_assert_equal_uint(4, store->playersNumber);
+    assertRecordStats(store);
+    opponents_deleteStore(&store);
+
+    cut_assert_null(opponents_readStore(buffer, length - 1));
+    cut_assert_null(opponents_readStore(NULL, length));
+
+    // A player saved twice.
+    memcpy(buffer + OPPONENTS_HEADER_SIZE + OPPONENTS_PLAYER_SIZE,
+           buffer + OPPONENTS_HEADER_SIZE, RECORD_NAME_LENGTH);
+    cut_assert_null(opponents_readStore(buffer, length));
+    buffer[0] = 'X';
+    cut_assert_null(opponents_readStore(buffer, length));
+}
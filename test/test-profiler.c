@@ -0,0 +1,100 @@
+#include <profiler.h>
+#include <dealer.h>
+#include <errors.h>
+
+#include <cutter.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Reads a variable length integer of a protocol buffer.
+ */
+static uint64_t readVarint(const unsigned char *bytes, long *position)
+{
+    uint64_t value = 0;
+    int shift = 0;
+    for (; bytes[*position] & 0x80; shift += 7)
+        value |= (uint64_t)(bytes[(*position)++] & 0x7F) << shift;
+
+    return value | (uint64_t)bytes[(*position)++] << shift;
+}
+
+void test_profiler_writeProfile()
+{
+    struct Profiler *profiler = profiler_createProfiler(1000, 1000);
+    cut_assert_not_null(profiler);
+    cut_assert_null(profiler_createProfiler(1000, 1000));
+    cut_assert_equal_int(NO_ERROR, profiler_addThread(profiler));
+    cut_assert_equal_int(DUPLICATE, profiler_addThread(profiler));
+
+    // Deal until the timer has fired a few times.
+    struct Dealer dealer;
+    struct DealMasks deals[256];
+    dealer_initDealer(&dealer, 5);
+    for (long i = 0; i < 100000 && profiler->samplesNumber < 10; i++)
+        dealer_dealBatch(&dealer, MAX_GAME_PLAYERS, deals, 256);
+    cut_assert_equal_int(NO_ERROR, profiler_removeThread(profiler));
+    cut_assert_equal_int(NOT_FOUND, profiler_removeThread(profiler));
+    cut_assert_operator_int(profiler->samplesNumber, >=, 10);
+
+    FILE *file = tmpfile();
+    long samplesNumber = profiler_writeProfile(profiler, file);
+    cut_assert_operator_int(samplesNumber, >=, 10);
+    long length = ftell(file);
+    unsigned char *bytes = malloc(length);
+    rewind(file);
+    cut_assert_equal_int(length, fread(bytes, 1, length, file));
+    fclose(file);
+
+    // Every sample is a field 2 of the profile, every string a field 6.
+    long samples = 0;
+    int cpu = 0;
+    int nanoseconds = 0;
+    for (long position = 0; position < length;) {
+        uint64_t key = readVarint(bytes, &position);
+        if ((key & 7) == 0) {
+            readVarint(bytes, &position);
+            continue;
+        }
+        cut_assert_equal_int(2, key & 7);
+        long size = readVarint(bytes, &position);
+        cut_assert_operator_int(position + size, <=, length);
+        if (key >> 3 == 2)
+            samples++;
+        if (key >> 3 == 6 && size == 3)
+            cpu += memcmp(bytes + position, "cpu", 3) == 0;
+        if (key >> 3 == 6 && size == 11)
+            nanoseconds += memcmp(bytes + position, "nanoseconds", 11) == 0;
+        position += size;
+    }
+    cut_assert_equal_int(samplesNumber, samples);
+    cut_assert_equal_int(1, cpu);
+    cut_assert_equal_int(1, nanoseconds);
+    free(bytes);
+
+    // A profile can be written while the thread is still sampled.
+    cut_assert_equal_int(NO_ERROR, profiler_addThread(profiler));
+    for (int i = 0; i < 20; i++) {
+        dealer_dealBatch(&dealer, MAX_GAME_PLAYERS, deals, 256);
+        file = tmpfile();
+        cut_assert_operator_int(profiler_writeProfile(profiler, file), >=,
+                                samplesNumber);
+        fclose(file);
+    }
+    profiler_removeThread(profiler);
+
+    cut_assert_equal_int(PROFILER_NULL, profiler_addThread(NULL));
+    cut_assert_equal_int(PROFILER_NULL, profiler_removeThread(NULL));
+    cut_assert_equal_int(PROFILER_NULL, profiler_writeProfile(NULL, stdout));
+    cut_assert_equal_int(POINTER_NULL, profiler_writeProfile(profiler, NULL));
+    cut_assert_equal_int(NO_ERROR, profiler_deleteProfiler(&profiler));
+    cut_assert_null(profiler);
+    cut_assert_equal_int(PROFILER_NULL, profiler_deleteProfiler(&profiler));
+    cut_assert_equal_int(POINTER_NULL, profiler_deleteProfiler(NULL));
+
+    // A new profiler can be created once the old one is deleted.
+    profiler = profiler_createProfiler(1, 100);
+    cut_assert_not_null(profiler);
+    profiler_deleteProfiler(&profiler);
+}
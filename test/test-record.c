@@ -0,0 +1,242 @@
+#include <record.h>
+#include <game.h>
+#include <round.h>
+#include <team.h>
+#include <deck.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+/**
+ * Builds a game with playersNumber players, each in his own team.
+ */
+static struct Game *createTestGame(const int playersNumber)
+{
+    char *names[] = {"Alexandru", "Bogdan", "Cristina", "Diana"};
+    struct Game *game = game_createGame(11);
+    for (int i = 0; i < playersNumber; i++) {
+        game_addPlayer(team_createPlayer(names[i], 0), game);
+        struct Team *team = team_createTeam();
+        team_addPlayer(team, game->players[i]);
+        game_addTeam(team, game);
+    }
+
+    return game;
+}
+
+static void deleteTestGame(struct Game *game)
+{
+    for (int i = 0; i < MAX_GAME_PLAYERS; i++)
+        if (game->players[i] != NULL)
+            team_deletePlayer(&game->players[i]);
+    for (int i = 0; i < MAX_GAME_TEAMS; i++)
+        if (game->teams[i] != NULL)
+            team_deleteTeam(&game->teams[i]);
+    if (game->round != NULL) {
+        for (int i = 0; i < MAX_HANDS; i++) {
+            if (game->round->hands[i] == NULL)
+                continue;
+            for (int j = 0; j < MAX_GAME_PLAYERS; j++)
+                if (game->round->hands[i]->cards[j] != NULL)
+                    deck_deleteCard(&game->round->hands[i]->cards[j]);
+            round_deleteHand(&game->round->hands[i]);
+        }
+        round_deleteRound(&game->round);
+    }
+    game_deleteGame(&game);
+}
+
+/**
+ * Plays a whole round, every player putting down his first allowed card.
+ */
+static void playTestRound(struct Game *game, struct Deck *deck,
+                          struct RoundRecord *record, const enum Suit trump)
+{
+    game_arrangePlayersRound(game, 0);
+    cut_assert_equal_int(NO_ERROR, record_captureDeal(record, deck));
+    round_distributeDeck(deck, game->round);
+    game->round->trump = trump;
+
+    int lastCard = DECK_SIZE / game->numberPlayers - 1;
+    if (lastCard >= MAX_CARDS)
+        lastCard = MAX_CARDS - 1;
+
+    int first = 0;
+    for (int i = 0; team_hasCards(game->players[0]) == 1; i++) {
+        round_arrangePlayersHand(game->round, first);
+        struct Hand *hand = game->round->hands[i];
+        for (int j = 0; j < game->numberPlayers; j++) {
+            struct Player *player = hand->players[j];
+            int cardId = game_findNextAllowedCard(player, game, hand,
+                                                  lastCard);
+            cut_assert_operator_int(cardId, >=, 0);
+            cut_assert_equal_int(NO_ERROR,
+                                 round_putCard(player, cardId, i, game->round));
+        }
+        struct Player *winner = round_handWinner(hand, game->round);
+        first = round_findPlayerIndexRound(winner, game->round);
+        if (deck_cardsNumber(deck) > 0)
+            round_distributeCard(deck, game->round);
+    }
+
+    game_updateScore(game, round_getBidWinner(game->round));
+    cut_assert_equal_int(NO_ERROR, record_captureRound(record, game));
+}
+
+void test_record_captureDeal()
+{
+    struct RoundRecord record;
+    struct Deck *deck = deck_createDeck();
+
+    cut_assert_equal_int(RECORD_NULL, record_captureDeal(NULL, deck));
+    cut_assert_equal_int(DECK_NULL, record_captureDeal(&record, NULL));
+
+    struct Card *card = deck->cards[0];
+    deck->cards[0] = deck->cards[5];
+    deck->cards[5] = card;
+    cut_assert_equal_int(NO_ERROR, record_captureDeal(&record, deck));
+    for (int i = 0; i < DECK_SIZE; i++)
+        cut_assert_equal_int(deck_cardId(deck->cards[i]), record.deck[i]);
+    cut_assert_equal_int(5, record.deck[0]);
+    cut_assert_equal_int(0, record.handsNumber);
+
+    card = deck->cards[3];
+    deck->cards[3] = NULL;
+    cut_assert_equal_int(LESS_CARDS, record_captureDeal(&record, deck));
+    deck->cards[3] = card;
+
+    deck_deleteDeck(&deck);
+}
+
+void test_record_captureRound()
+{
+    struct RoundRecord record;
+    struct Game *game = createTestGame(MAX_GAME_PLAYERS);
+
+    cut_assert_equal_int(RECORD_NULL, record_captureRound(NULL, game));
+    cut_assert_equal_int(GAME_NULL, record_captureRound(&record, NULL));
+    cut_assert_equal_int(ROUND_NULL, record_captureRound(&record, game));
+
+    struct Deck *deck = deck_createDeck();
+    playTestRound(game, deck, &record, CLUBS);
+
+    cut_assert_equal_int(MAX_GAME_PLAYERS, record.playersNumber);
+    cut_assert_equal_int(CLUBS, record.trump);
+    cut_assert_equal_int(DECK_SIZE / MAX_GAME_PLAYERS, record.handsNumber);
+    cut_assert_equal_string("Alexandru", record.names[0]);
+    cut_assert_equal_string("Diana", record.names[3]);
+
+    int seen[DECK_SIZE] = {0};
+    for (int i = 0; i < record.handsNumber; i++) {
+        for (int j = 0; j < record.playersNumber; j++) {
+            int seat = (record.leaders[i] + j) % record.playersNumber;
+            int position = 0;
+            while (record.deck[position] != record.cards[i][j])
+                position++;
+            cut_assert_equal_int(seat, position % record.playersNumber);
+            seen[record.cards[i][j]]++;
+        }
+        if (i > 0)
+            cut_assert_equal_int(record.winners[i - 1], record.leaders[i]);
+    }
+    for (int i = 0; i < DECK_SIZE; i++)
+        cut_assert_equal_int(1, seen[i]);
+
+    for (int i = 0; i < record.playersNumber; i++) {
+        cut_assert_equal_int(game->round->pointsNumber[i],
+                             record.pointsNumber[i]);
+        cut_assert_equal_int(game->players[i]->score, record.scores[i]);
+        cut_assert_equal_int(i, record.teams[i]);
+    }
+
+    deck_deleteDeck(&deck);
+    deleteTestGame(game);
+}
+
+void test_record_captureRound_marriage()
+{
+    struct RoundRecord record;
+    struct Game *game = createTestGame(3);
+    struct Deck *deck = deck_createDeck();
+
+    // Queen and king of hearts are the first cards of the first player.
+    int queen = HEARTS * SUIT_SIZE + 1;
+    struct Card *card = deck->cards[0];
+    deck->cards[0] = deck->cards[queen];
+    deck->cards[queen] = card;
+    card = deck->cards[3];
+    deck->cards[3] = deck->cards[queen + 1];
+    deck->cards[queen + 1] = card;
+
+    playTestRound(game, deck, &record, HEARTS);
+
+    cut_assert_equal_int(8, record.handsNumber);
+    cut_assert_equal_int(queen, record.cards[0][0]);
+    cut_assert_equal_int(1 << HEARTS, record.marriages[0]);
+    cut_assert_equal_int(0, record.marriages[1]);
+    cut_assert_equal_int(0, record.marriages[2]);
+    cut_assert_operator_int(record.pointsNumber[0], >=, 40);
+
+    deck_deleteDeck(&deck);
+    deleteTestGame(game);
+}
+
+void test_record_captureRound_twoPlayers()
+{
+    struct RoundRecord record;
+    struct Game *game = createTestGame(2);
+    struct Deck *deck = deck_createDeck();
+
+    playTestRound(game, deck, &record, SPADES);
+
+    cut_assert_equal_int(DECK_SIZE / 2, record.handsNumber);
+    int points = 0;
+    for (int i = 0; i < 2; i++)
+        points += record.pointsNumber[i];
+    cut_assert_operator_int(points, >=, 120);
+
+    deck_deleteDeck(&deck);
+    deleteTestGame(game);
+}
+
+void test_record_bidWinner()
+{
+    struct RoundRecord record;
+    memset(&record, 0, sizeof(record));
+
+    cut_assert_equal_int(RECORD_NULL, record_bidWinner(NULL));
+    cut_assert_equal_int(ILLEGAL_VALUE, record_bidWinner(&record));
+
+    record.playersNumber = 3;
+    cut_assert_equal_int(0, record_bidWinner(&record));
+    record.bids[1] = 3;
+    record.bids[2] = 3;
+    cut_assert_equal_int(1, record_bidWinner(&record));
+}
+
+void test_record_bidMade()
+{
+    struct RoundRecord record;
+    memset(&record, 0, sizeof(record));
+
+    cut_assert_equal_int(RECORD_NULL, record_bidMade(NULL));
+
+    record.playersNumber = 4;
+    record.teams[0] = 0;
+    record.teams[1] = 1;
+    record.teams[2] = 0;
+    record.teams[3] = 1;
+    record.bids[2] = 3;
+    record.pointsNumber[0] = 50;
+    record.pointsNumber[2] = 48;
+    cut_assert_equal_int(0, record_bidMade(&record));
+    record.pointsNumber[0] = 51;
+    cut_assert_equal_int(1, record_bidMade(&record));
+
+    record.teams[0] = MAX_GAME_TEAMS;
+    record.teams[2] = MAX_GAME_TEAMS;
+    cut_assert_equal_int(0, record_bidMade(&record));
+}
+
@@ -0,0 +1,156 @@
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <round.h>
+#include <team.h>
+#include <deck.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+static const char *twoPlayersRound =
+    "[Players \"Ana/0;Bob/1\"]\n"
+    "[Deal \"TDKCKHTCJC9CJSQSQCAHQDAC 9D9STHKDASTSJHJDKSADQH9H\"]\n"
+    "[Bids \"0 3\"]\n"
+    "[Trump \"D\"]\n"
+    "[Play \"9DTD QCKD KSJS QHAH ACAD 9HKH KCJD 9SQS TCTH JCAS 9CTS QDJH\"]\n"
+    "[Marriages \"C -\"]\n"
+    "[Points \"99 41\"]\n"
+    "[Scores \"3 -3\"]\n"
+    "\n";
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "[Marriages \"- - - -\"]\n"
+    "[Points \"27 5 61 27\"]\n"
+    "[Scores \"2 -3 2 -3\"]\n"
+    "\n";
+
+/**
+ * Counts the cards held by a player.
+ */
+static int countCards(const struct Player *player)
+{
+    int count = 0;
+    for (int i = 0; i < MAX_CARDS; i++)
+        if (player->hand[i] != NULL)
+            count++;
+
+    return count;
+}
+
+void test_replay_createGame()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+
+    cut_assert_equal_pointer(NULL, replay_createGame(NULL, 0));
+    cut_assert_equal_pointer(NULL, replay_createGame(&record, -1));
+    cut_assert_equal_pointer(NULL, replay_createGame(&record, 25));
+
+    struct Game *game = replay_createGame(&record, 0);
+    cut_assert_not_null(game);
+    cut_assert_equal_int(4, game->numberPlayers);
+    cut_assert_equal_string("Cip", game->players[2]->name);
+    cut_assert_equal_pointer(game->players[2], game->teams[0]->players[1]);
+    cut_assert_equal_pointer(game->players[3], game->teams[1]->players[1]);
+    cut_assert_equal_int(SPADES, game->round->trump);
+    cut_assert_equal_int(3, game->round->bids[1]);
+    for (int i = 0; i < 4; i++)
+        cut_assert_equal_int(6, countCards(game->players[i]));
+    cut_assert_equal_pointer(game->players[1],
+                             game->round->hands[0]->players[0]);
+    cut_assert_equal_pointer(NULL, game->round->hands[0]->cards[0]);
+    replay_deleteGame(&game);
+
+    game = replay_createGame(&record, 6);
+    cut_assert_not_null(game);
+    cut_assert_equal_int(4, countCards(game->players[2]));
+    cut_assert_equal_int(5, countCards(game->players[0]));
+    cut_assert_equal_pointer(game->players[2],
+                             game->round->hands[1]->players[0]);
+    cut_assert_equal_int(SPADES * SUIT_SIZE + 5,
+                         deck_cardId(game->round->hands[1]->cards[0]));
+    cut_assert_equal_pointer(NULL, game->round->hands[1]->cards[2]);
+    cut_assert_equal_pointer(NULL, game->round->hands[2]);
+    replay_deleteGame(&game);
+
+    game = replay_createGame(&record, 24);
+    cut_assert_not_null(game);
+    cut_assert_equal_pointer(NULL, game->round->hands[6]);
+    for (int i = 0; i < 4; i++)
+        cut_assert_equal_int(record.pointsNumber[i],
+                             game->round->pointsNumber[i]);
+    replay_deleteGame(&game);
+}
+
+void test_replay_createGame_stock()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, twoPlayersRound, strlen(twoPlayersRound));
+
+    struct Game *game = replay_createGame(&record, 0);
+    cut_assert_not_null(game);
+    cut_assert_equal_int(8, countCards(game->players[0]));
+    cut_assert_equal_int(8, deck_cardsNumber(game->deck));
+    replay_deleteGame(&game);
+
+    game = replay_createGame(&record, 5);
+    cut_assert_not_null(game);
+    cut_assert_equal_int(4, deck_cardsNumber(game->deck));
+    cut_assert_equal_int(8, countCards(game->players[0]));
+    cut_assert_equal_int(7, countCards(game->players[1]));
+    replay_deleteGame(&game);
+
+    game = replay_createGame(&record, 24);
+    cut_assert_not_null(game);
+    cut_assert_equal_int(0, deck_cardsNumber(game->deck));
+    for (int i = 0; i < 2; i++)
+        cut_assert_equal_int(record.pointsNumber[i],
+                             game->round->pointsNumber[i]);
+    replay_deleteGame(&game);
+
+    record.cards[3][1] = record.cards[3][0];
+    cut_assert_equal_pointer(NULL, replay_createGame(&record, 8));
+}
+
+void test_replay_deleteGame()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, twoPlayersRound, strlen(twoPlayersRound));
+    struct Game *game = replay_createGame(&record, 7);
+
+    cut_assert_equal_int(POINTER_NULL, replay_deleteGame(NULL));
+    cut_assert_equal_int(NO_ERROR, replay_deleteGame(&game));
+    cut_assert_equal_pointer(NULL, game);
+    cut_assert_equal_int(GAME_NULL, replay_deleteGame(&game));
+}
+
+void test_replay_findTurn()
+{
+    struct RoundRecord record;
+    int handId;
+    int position;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+
+    struct Game *game = replay_createGame(&record, 6);
+    cut_assert_equal_int(GAME_NULL, replay_findTurn(NULL, &handId, &position));
+    cut_assert_equal_int(POINTER_NULL, replay_findTurn(game, NULL, &position));
+    cut_assert_equal_int(NO_ERROR, replay_findTurn(game, &handId, &position));
+    cut_assert_equal_int(1, handId);
+    cut_assert_equal_int(2, position);
+    replay_deleteGame(&game);
+
+    game = replay_createGame(&record, 24);
+    cut_assert_equal_int(NOT_FOUND,
+                         replay_findTurn(game, &handId, &position));
+    replay_deleteGame(&game);
+}
+
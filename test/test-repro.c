@@ -0,0 +1,179 @@
+#include <repro.h>
+#include <snapshot.h>
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <errors.h>
+
+#include <cutter.h>
+#include <stdint.h>
+#include <string.h>
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "\n";
+
+void test_repro_finishDecision()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct Game *game = replay_createGame(&record, 6);
+    struct ReproRecorder *recorder = repro_createRecorder(2);
+    cut_assert_not_null(recorder);
+    cut_assert_null(repro_createRecorder(0));
+
+    // A decision within its time is only counted.
+    cut_assert_equal_int(NO_ERROR, repro_startDecision(recorder, "search", 7,
+                                                       0.01));
+    cut_assert_equal_int(0, repro_finishDecision(recorder, game, 0.005));
+    cut_assert_equal_int(0, recorder->reprosNumber);
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         repro_finishDecision(recorder, game, 0.02));
+
+    repro_startDecision(recorder, "search", UINT64_MAX, 0.01);
+    cut_assert_equal_int(NO_ERROR, repro_addPhase(recorder, "worlds", 0.015));
+    cut_assert_equal_int(NO_ERROR, repro_addPhase(recorder, "rollouts",
+                                                  0.005));
+    cut_assert_equal_int(1, repro_finishDecision(recorder, game, 0.02));
+    cut_assert_equal_int(1, recorder->reprosNumber);
+    cut_assert_equal_int(2, recorder->decisionsNumber);
+
+    const struct Repro *repro = &recorder->repros[0];
+    cut_assert_equal_string("search", repro->routine);
+    cut_assert_true(repro->state == UINT64_MAX);
+    cut_assert_equal_double(0.02, 1e-12, repro->elapsed);
+    cut_assert_equal_int(2, repro->phasesNumber);
+    cut_assert_equal_string("rollouts", repro->phaseNames[1]);
+    cut_assert_equal_double(0.005, 1e-12, repro->phaseTimes[1]);
+    unsigned char snapshot[SNAPSHOT_MAX_SIZE];
+    int length = snapshot_writeGame(game, snapshot, sizeof(snapshot));
+    cut_assert_equal_int(length, repro->snapshotLength);
+    cut_assert_equal_int(0, memcmp(snapshot, repro->snapshot, length));
+
+    // The phases after the last slot and the decisions after the last
+    // repro slot are dropped.
+    for (int i = 0; i < 3; i++) {
+        repro_startDecision(recorder, "search", i, 0);
+        for (int j = 0; j < REPRO_MAX_PHASES + 2; j++)
+            repro_addPhase(recorder, "phase", j);
+        repro_finishDecision(recorder, game, 1);
+    }
+    cut_assert_equal_int(2, recorder->reprosNumber);
+    cut_assert_equal_int(2, recorder->droppedNumber);
+    cut_assert_equal_int(2, recorder->capturedNumber);
+    cut_assert_equal_int(REPRO_MAX_PHASES, recorder->repros[1].phasesNumber);
+    cut_assert_equal_int(NO_ERROR, repro_clearRecorder(recorder));
+    cut_assert_equal_int(0, recorder->reprosNumber);
+
+    cut_assert_equal_int(RECORDER_NULL,
+                         repro_startDecision(NULL, "search", 0, 0));
+    cut_assert_equal_int(POINTER_NULL,
+                         repro_startDecision(recorder, NULL, 0, 0));
+    cut_assert_equal_int(RECORDER_NULL, repro_addPhase(NULL, "phase", 0));
+    cut_assert_equal_int(RECORDER_NULL, repro_finishDecision(NULL, game, 0));
+    cut_assert_equal_int(GAME_NULL, repro_finishDecision(recorder, NULL, 0));
+    cut_assert_equal_int(RECORDER_NULL, repro_clearRecorder(NULL));
+    cut_assert_equal_int(NO_ERROR, repro_deleteRecorder(&recorder));
+    cut_assert_null(recorder);
+    cut_assert_equal_int(RECORDER_NULL, repro_deleteRecorder(&recorder));
+    cut_assert_equal_int(POINTER_NULL, repro_deleteRecorder(NULL));
+    replay_deleteGame(&game);
+}
+
+void test_repro_parseRepro()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct Game *game = replay_createGame(&record, 9);
+    struct ReproRecorder *recorder = repro_createRecorder(1);
+    repro_startDecision(recorder, "legalMoves", 12345678901234567ULL, 1e-4);
+    repro_addPhase(recorder, "turn", 2.5e-7);
+    repro_addPhase(recorder, "decide", 3e-4);
+    repro_finishDecision(recorder, game, 3.0025e-4);
+    const struct Repro *repro = &recorder->repros[0];
+
+    char text[REPRO_MAX_LENGTH];
+    int length = repro_writeRepro(repro, text, sizeof(text));
+    cut_assert_operator_int(length, >, 0);
+    cut_assert_equal_int(0, memcmp("[Routine \"legalMoves\"]\n"
+                                   "[State \"12345678901234567\"]\n"
+                                   "[Budget \"0.000100000\"]\n"
+                                   "[Elapsed \"0.000300250\"]\n"
+                                   "[Phases \"turn=0.000000250 "
+                                   "decide=0.000300000\"]\n"
+                                   "[Snapshot \"43475301", text, 130));
+    cut_assert_equal_int(0, memcmp("\"]\n\n", text + length - 4, 4));
+    cut_assert_equal_int(FULL, repro_writeRepro(repro, text, length - 1));
+
+    struct Repro parsed;
+    cut_assert_equal_int(length, repro_parseRepro(&parsed, text, length));
+    cut_assert_equal_string("legalMoves", parsed.routine);
+    cut_assert_true(parsed.state == 12345678901234567ULL);
+    cut_assert_equal_double(1e-4, 1e-12, parsed.budget);
+    cut_assert_equal_double(3.0025e-4, 1e-12, parsed.elapsed);
+    cut_assert_equal_int(2, parsed.phasesNumber);
+    cut_assert_equal_string("decide", parsed.phaseNames[1]);
+    cut_assert_equal_double(3e-4, 1e-12, parsed.phaseTimes[1]);
+    cut_assert_equal_int(repro->snapshotLength, parsed.snapshotLength);
+    cut_assert_equal_int(0, memcmp(repro->snapshot, parsed.snapshot,
+                                   parsed.snapshotLength));
+
+    // The position is rebuilt with the same turn.
+    struct Game *rebuilt = snapshot_readGame(parsed.snapshot,
+                                             parsed.snapshotLength);
+    cut_assert_not_null(rebuilt);
+    int handId, position, rebuiltHandId, rebuiltPosition;
+    replay_findTurn(game, &handId, &position);
+    replay_findTurn(rebuilt, &rebuiltHandId, &rebuiltPosition);
+    cut_assert_equal_int(handId, rebuiltHandId);
+    cut_assert_equal_int(position, rebuiltPosition);
+    replay_deleteGame(&rebuilt);
+
+    // Unknown tags and comments are skipped, an empty line ends a repro.
+    static const char *minimal =
+        "% captured on table 12\n"
+        "[Routine \"search\"]\n[Table \"12\"]\n[State \"0\"]\n"
+        "[Snapshot \"00FF\"]\n\n[Routine \"next\"]\n";
+    cut_assert_equal_int(strstr(minimal, "[Routine \"next") - minimal,
+                         repro_parseRepro(&parsed, minimal,
+                                          strlen(minimal)));
+    cut_assert_equal_int(2, parsed.snapshotLength);
+    cut_assert_equal_int(0xFF, parsed.snapshot[1]);
+    cut_assert_equal_int(0, parsed.phasesNumber);
+    cut_assert_equal_int(0, repro_parseRepro(&parsed, "\n% none\n", 8));
+
+    static const char *broken[] = {
+        "[Routine \"search\"]\n[State \"0\"]\n",
+        "[Routine \"search\"]\n[State \"-1\"]\n[Snapshot \"00\"]\n",
+        "[Routine \"search\"]\n[State \"0\"]\n[Snapshot \"0\"]\n",
+        "[Routine \"search\"]\n[State \"0\"]\n[Snapshot \"0g\"]\n",
+        "[Routine \"search\"]\n[State \"0\"]\n[Snapshot \"00\"]\n"
+        "[Phases \"turn\"]\n",
+        "[Routine \"search\"]\n[State \"0\"]\n[Snapshot \"00\"]\n"
+        "[Budget \"fast\"]\n",
+        "Routine search\n"
+    };
+    for (size_t i = 0; i < sizeof(broken) / sizeof(broken[0]); i++)
+        cut_assert_equal_int(SYNTAX_ERROR,
+                             repro_parseRepro(&parsed, broken[i],
+                                              strlen(broken[i])));
+
+    struct Repro bad = *repro;
+    strcpy(bad.phaseNames[0], "two words");
+    cut_assert_equal_int(ILLEGAL_VALUE, repro_writeRepro(&bad, text,
+                                                         sizeof(text)));
+    bad = *repro;
+    bad.elapsed = -1;
+    cut_assert_equal_int(ILLEGAL_VALUE, repro_writeRepro(&bad, text,
+                                                         sizeof(text)));
+    cut_assert_equal_int(POINTER_NULL, repro_writeRepro(NULL, text, 1));
+    cut_assert_equal_int(POINTER_NULL, repro_parseRepro(NULL, text, 1));
+
+    repro_deleteRecorder(&recorder);
+    replay_deleteGame(&game);
+}
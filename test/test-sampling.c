@@ -0,0 +1,146 @@
+#include <sampling.h>
+#include <simulation.h>
+#include <record.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+
+/**
+ * Gives the stratum of a hand.
+ */
+static int stratum(const int trumps, const int aces, const int marriages)
+{
+    return (trumps * SAMPLING_HONOURS + aces) * SAMPLING_HONOURS + marriages;
+}
+
+void test_sampling_createSampler()
+{
+    struct DealSampler *sampler = sampling_createSampler(4);
+    cut_assert_not_null(sampler);
+    cut_assert_equal_int(6, sampler->handSize);
+
+    // The number of trumps follows the hypergeometric distribution.
+    const double hands[] = {18564, 51408, 45900, 16320, 2295, 108, 1};
+    double sum = 0;
+    for (int t = 0; t < SAMPLING_TRUMPS; t++) {
+        double trumps = 0;
+        for (int i = 0; i < SAMPLING_HONOURS * SAMPLING_HONOURS; i++)
+            trumps += sampler->probabilities[t * SAMPLING_HONOURS *
+                                             SAMPLING_HONOURS + i];
+        cut_assert_equal_double(hands[t] / 134596, 1e-12, trumps);
+        sum += trumps;
+    }
+    cut_assert_equal_double(1, 1e-12, sum);
+
+    // Only the hand of all the trumps has 6 trumps.
+    cut_assert_equal_double(1.0 / 134596, 1e-15,
+                            sampler->probabilities[stratum(6, 1, 1)]);
+    cut_assert_equal_double(0, 0, sampler->probabilities[stratum(6, 0, 1)]);
+    cut_assert_equal_double(0, 0, sampler->probabilities[stratum(0, 4, 4)]);
+    sampling_deleteSampler(&sampler);
+    cut_assert_null(sampler);
+
+    sampler = sampling_createSampler(2);
+    cut_assert_equal_int(8, sampler->handSize);
+    // Four marriages and four aces take 12 cards.
+    cut_assert_equal_double(0, 0, sampler->probabilities[stratum(3, 4, 4)]);
+    cut_assert_operator_double(sampler->probabilities[stratum(3, 2, 3)], >,
+                               0);
+    sampling_deleteSampler(&sampler);
+
+    cut_assert_null(sampling_createSampler(1));
+    cut_assert_null(sampling_createSampler(5));
+    cut_assert_equal_int(SAMPLER_NULL, sampling_deleteSampler(&sampler));
+    cut_assert_equal_int(POINTER_NULL, sampling_deleteSampler(NULL));
+}
+
+void test_sampling_drawDeal()
+{
+    const int strata[] = {stratum(6, 1, 1), stratum(0, 0, 0),
+                          stratum(3, 2, 2), stratum(4, 1, 0)};
+    uint64_t state = simulation_seed(3, 0);
+
+    for (int players = 2; players <= MAX_GAME_PLAYERS; players++) {
+        struct DealSampler *sampler = sampling_createSampler(players);
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 20; j++) {
+                struct RoundRecord record;
+                cut_assert_equal_int(NO_ERROR,
+                                     sampling_drawDeal(sampler, &record,
+                                                       strata[i], 5, &state));
+                cut_assert_equal_int(strata[i],
+                                     sampling_handStratum(&record, 0));
+                uint32_t cards = 0;
+                for (int k = 0; k < DECK_SIZE; k++)
+                    cards |= 1u << record.deck[k];
+                cut_assert_equal_uint((1u << DECK_SIZE) - 1, cards);
+                cut_assert_equal_int(0, record_bidWinner(&record));
+                cut_assert_equal_int(5, record.bids[0]);
+
+                cut_assert_equal_int(NO_ERROR,
+                                     simulation_playDeal(&record, &state));
+                cut_assert_equal_int(strata[i],
+                                     sampling_handStratum(&record, 0));
+            }
+
+        struct RoundRecord record;
+        cut_assert_equal_int(ILLEGAL_VALUE,
+                             sampling_drawDeal(sampler, &record,
+                                               stratum(6, 0, 0), 5, &state));
+        cut_assert_equal_int(ILLEGAL_VALUE,
+                             sampling_drawDeal(sampler, &record,
+                                               SAMPLING_STRATA, 5, &state));
+        cut_assert_equal_int(ILLEGAL_VALUE,
+                             sampling_drawDeal(sampler, &record, strata[0],
+                                               7, &state));
+        cut_assert_equal_int(RECORD_NULL,
+                             sampling_drawDeal(sampler, NULL, strata[0], 5,
+                                               &state));
+        cut_assert_equal_int(ILLEGAL_VALUE,
+                             sampling_handStratum(&record, players));
+        sampling_deleteSampler(&sampler);
+    }
+}
+
+void test_sampling_drawStratum()
+{
+    struct DealSampler *sampler = sampling_createSampler(4);
+    uint64_t state = simulation_seed(5, 0);
+    double weight;
+
+    for (int i = 0; i < 100; i++) {
+        int drawn = sampling_drawStratum(sampler, &state, &weight);
+        cut_assert_operator_int(drawn, >=, 0);
+        cut_assert_operator_double(sampler->probabilities[drawn], >, 0);
+        cut_assert_equal_double(1, 1e-12, weight);
+    }
+
+    // Hands of 4 trumps or more are rare, about 1.8%, but the tilted
+    // proposal draws them often and the weights correct the estimate.
+    double exact = 0;
+    for (int i = stratum(4, 0, 0); i < SAMPLING_STRATA; i++)
+        exact += sampler->probabilities[i];
+    cut_assert_equal_int(NO_ERROR, sampling_tiltProposal(sampler, 3));
+    double estimate = 0, weights = 0;
+    int rare = 0;
+    for (int i = 0; i < 4000; i++) {
+        int drawn = sampling_drawStratum(sampler, &state, &weight);
+        weights += weight;
+        if (drawn >= stratum(4, 0, 0)) {
+            estimate += weight;
+            rare++;
+        }
+    }
+    cut_assert_operator_int(rare, >, 400);
+    cut_assert_equal_double(exact, exact / 10, estimate / 4000);
+    cut_assert_equal_double(1, 0.1, weights / 4000);
+
+    cut_assert_equal_int(ILLEGAL_VALUE, sampling_tiltProposal(sampler, 0));
+    cut_assert_equal_int(SAMPLER_NULL, sampling_tiltProposal(NULL, 2));
+    cut_assert_equal_int(POINTER_NULL,
+                         sampling_drawStratum(sampler, NULL, &weight));
+    cut_assert_equal_int(SAMPLER_NULL,
+                         sampling_drawStratum(NULL, &state, &weight));
+    sampling_deleteSampler(&sampler);
+}
@@ -0,0 +1,200 @@
+#include <simulation.h>
+#include <replay.h>
+#include <record.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+void test_simulation_random()
+{
+    uint64_t first = simulation_seed(7, 0);
+    uint64_t second = simulation_seed(7, 0);
+    cut_assert_true(first == second);
+    cut_assert_false(simulation_seed(7, 1) == first);
+    cut_assert_false(simulation_seed(8, 0) == first);
+
+    for (int i = 0; i < 100; i++)
+        cut_assert_true(simulation_random(&first) ==
+                        simulation_random(&second));
+    cut_assert_false(simulation_random(&first) ==
+                     simulation_random(&first));
+}
+
+void test_simulation_playRound()
+{
+    struct RoundRecord record;
+    struct RoundRecord other;
+
+    cut_assert_equal_int(RECORD_NULL, simulation_playRound(NULL, 4, 1, 0));
+    cut_assert_equal_int(ILLEGAL_VALUE, simulation_playRound(&record, 1, 1, 0));
+    cut_assert_equal_int(ILLEGAL_VALUE, simulation_playRound(&record, 5, 1, 0));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         simulation_playRound(&record, 4, 1, -1));
+
+    for (int players = 2; players <= MAX_GAME_PLAYERS; players++) {
+        cut_assert_equal_int(NO_ERROR,
+                             simulation_playRound(&record, players, 1, 5));
+        cut_assert_equal_int(NO_ERROR,
+                             simulation_playRound(&other, players, 1, 5));
+        cut_assert_equal_int(0, memcmp(&record, &other, sizeof(record)));
+        cut_assert_equal_int(players, record.playersNumber);
+
+        int points = 0;
+        for (int i = 0; i < players; i++)
+            points += record.pointsNumber[i];
+        cut_assert_true(points > 0);
+
+        struct Game *game = replay_createGame(&record, record.handsNumber *
+                                                       players);
+        cut_assert_not_null(game);
+        for (int i = 0; i < players; i++)
+            cut_assert_equal_int(record.pointsNumber[i],
+                                 game->round->pointsNumber[i]);
+        replay_deleteGame(&game);
+
+        cut_assert_equal_int(NO_ERROR,
+                             simulation_playRound(&other, players, 1, 6));
+        cut_assert_false(memcmp(record.deck, other.deck,
+                                sizeof(record.deck)) == 0);
+    }
+}
+
+void test_simulation_addRound()
+{
+    struct SimulationStats stats;
+    struct RoundRecord record;
+
+    cut_assert_equal_int(POINTER_NULL, simulation_initStats(NULL));
+    cut_assert_equal_int(NO_ERROR, simulation_initStats(&stats));
+    cut_assert_equal_int(POINTER_NULL, simulation_addRound(NULL, &record));
+    cut_assert_equal_int(RECORD_NULL, simulation_addRound(&stats, NULL));
+
+    int sum = 0;
+    for (int i = 0; i < 3; i++) {
+        simulation_playRound(&record, 2, 1, i);
+        cut_assert_equal_int(NO_ERROR, simulation_addRound(&stats, &record));
+        sum += record.pointsNumber[0];
+    }
+    cut_assert_equal_int(3, stats.roundsNumber);
+    cut_assert_equal_double(sum / 3.0, 1e-9, stats.meanPoints[0]);
+    cut_assert_true(stats.squaredDeviations[0] >= 0);
+    cut_assert_equal_double(stats.bidsMade / 3.0, 1e-9,
+                            stats.weightedBidsMade);
+
+    // A round with weight 2 whose bid is made counts twice.
+    record.pointsNumber[record_bidWinner(&record)] = 120;
+    simulation_initStats(&stats);
+    cut_assert_equal_int(NO_ERROR,
+                         simulation_addWeightedRound(&stats, &record, 2));
+    cut_assert_equal_int(NO_ERROR,
+                         simulation_addWeightedRound(&stats, &record, 0));
+    cut_assert_equal_double(1, 1e-9, stats.weightedBidsMade);
+    cut_assert_equal_double(2, 1e-9, stats.weightedDeviations);
+}
+
+void test_simulation_playDeal()
+{
+    struct RoundRecord record;
+    struct RoundRecord other;
+    uint64_t state = 1;
+
+    cut_assert_equal_int(RECORD_NULL, simulation_playDeal(NULL, &state));
+    cut_assert_equal_int(POINTER_NULL, simulation_playDeal(&record, NULL));
+
+    // The deal, the bids and the trump of a round, played again.
+    simulation_playRound(&record, 3, 4, 0);
+    memcpy(&other, &record, sizeof(record));
+    cut_assert_equal_int(NO_ERROR, simulation_playDeal(&other, &state));
+    cut_assert_equal_int(0, memcmp(record.deck, other.deck,
+                                   sizeof(record.deck)));
+    cut_assert_equal_int(0, memcmp(record.names, other.names,
+                                   sizeof(record.names)));
+    cut_assert_equal_int(record.trump, other.trump);
+
+    record.playersNumber = 1;
+    cut_assert_equal_int(ILLEGAL_VALUE, simulation_playDeal(&record, &state));
+}
+
+void test_simulation_reduceStats()
+{
+    struct SimulationStats blocks[5];
+    struct SimulationStats again[5];
+    struct SimulationStats all;
+    struct RoundRecord record;
+
+    cut_assert_equal_int(POINTER_NULL, simulation_reduceStats(NULL, 1));
+    cut_assert_equal_int(ILLEGAL_VALUE, simulation_reduceStats(blocks, 0));
+    cut_assert_equal_int(POINTER_NULL, simulation_mergeStats(NULL, &all));
+
+    simulation_initStats(&all);
+    for (int i = 0; i < 5; i++) {
+        simulation_initStats(&blocks[i]);
+        for (int j = 0; j < 4; j++) {
+            simulation_playRound(&record, 3, 2, i * 4 + j);
+            simulation_addRound(&blocks[i], &record);
+            simulation_addRound(&all, &record);
+        }
+    }
+    memcpy(again, blocks, sizeof(blocks));
+
+    cut_assert_equal_int(NO_ERROR, simulation_reduceStats(blocks, 5));
+    cut_assert_equal_int(NO_ERROR, simulation_reduceStats(again, 5));
+    cut_assert_equal_int(0, memcmp(&blocks[0], &again[0],
+                                   sizeof(struct SimulationStats)));
+
+    cut_assert_equal_int(20, blocks[0].roundsNumber);
+    cut_assert_equal_int(all.bidsMade, blocks[0].bidsMade);
+    cut_assert_equal_double(all.weightedBidsMade, 1e-9,
+                            blocks[0].weightedBidsMade);
+    cut_assert_equal_double(all.weightedDeviations, 1e-6,
+                            blocks[0].weightedDeviations);
+    for (int i = 0; i < 3; i++) {
+        cut_assert_equal_double(all.meanPoints[i], 1e-9,
+                                blocks[0].meanPoints[i]);
+        cut_assert_equal_double(all.squaredDeviations[i], 1e-6,
+                                blocks[0].squaredDeviations[i]);
+        cut_assert_equal_double(all.meanScores[i], 1e-9,
+                                blocks[0].meanScores[i]);
+    }
+}
+
+void test_simulation_pushStats()
+{
+    struct SimulationStats blocks[21];
+    struct SimulationStats tree[21];
+    struct SimulationStats stats;
+    struct StatsReducer reducer;
+    struct RoundRecord record;
+
+    for (int i = 0; i < 21; i++) {
+        simulation_initStats(&blocks[i]);
+        for (int j = 0; j < 1 + i % 3; j++) {
+            simulation_playRound(&record, 4, 3, i * 3 + j);
+            simulation_addRound(&blocks[i], &record);
+        }
+    }
+
+    // The result is the one of the tree, to the bit, for any count.
+    cut_assert_equal_int(NO_ERROR, simulation_initReducer(&reducer));
+    cut_assert_equal_int(ILLEGAL_VALUE,
+                         simulation_finishStats(&reducer, &stats));
+    for (int count = 1; count <= 21; count++) {
+        cut_assert_equal_int(NO_ERROR,
+                             simulation_pushStats(&reducer,
+                                                  &blocks[count - 1]));
+        cut_assert_equal_int(NO_ERROR,
+                             simulation_finishStats(&reducer, &stats));
+        memcpy(tree, blocks, sizeof(tree));
+        simulation_reduceStats(tree, count);
+        cut_assert_equal_int(0, memcmp(&tree[0], &stats, sizeof(stats)));
+    }
+
+    cut_assert_equal_int(POINTER_NULL, simulation_initReducer(NULL));
+    cut_assert_equal_int(POINTER_NULL, simulation_pushStats(NULL, &stats));
+    cut_assert_equal_int(POINTER_NULL, simulation_pushStats(&reducer, NULL));
+    cut_assert_equal_int(POINTER_NULL, simulation_finishStats(&reducer,
+                                                              NULL));
+}
+
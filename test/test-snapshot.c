@@ -0,0 +1,110 @@
+#include <snapshot.h>
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <round.h>
+#include <team.h>
+#include <deck.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "[Marriages \"- - - -\"]\n"
+    "[Points \"27 5 61 27\"]\n"
+    "[Scores \"2 -3 2 -3\"]\n"
+    "\n";
+
+void test_snapshot_writeGame()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct Game *game = replay_createGame(&record, 6);
+    unsigned char buffer[SNAPSHOT_MAX_SIZE];
+
+    cut_assert_equal_int(GAME_NULL,
+                         snapshot_writeGame(NULL, buffer, sizeof(buffer)));
+    cut_assert_equal_int(POINTER_NULL,
+                         snapshot_writeGame(game, NULL, sizeof(buffer)));
+    cut_assert_equal_int(FULL, snapshot_writeGame(game, buffer, 16));
+
+    int length = snapshot_writeGame(game, buffer, sizeof(buffer));
+    cut_assert_true(length > 0);
+    cut_assert_true(length < 256);
+    cut_assert_equal_int(length, snapshot_writeGame(game, buffer, length));
+    cut_assert_equal_int(0, memcmp("CGS", buffer, 3));
+
+    replay_deleteGame(&game);
+}
+
+void test_snapshot_readGame()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct Game *game = replay_createGame(&record, 6);
+    unsigned char buffer[SNAPSHOT_MAX_SIZE];
+    unsigned char copy[SNAPSHOT_MAX_SIZE];
+    int length = snapshot_writeGame(game, buffer, sizeof(buffer));
+
+    struct Game *newGame = snapshot_readGame(buffer, length);
+    cut_assert_not_null(newGame);
+    cut_assert_equal_int(game->numberPlayers, newGame->numberPlayers);
+    cut_assert_equal_int(game->pointsNumber, newGame->pointsNumber);
+    cut_assert_equal_string("Cip", newGame->players[2]->name);
+    cut_assert_equal_pointer(newGame->players[2],
+                             newGame->teams[0]->players[1]);
+    cut_assert_equal_int(SPADES, newGame->round->trump);
+    cut_assert_equal_int(3, newGame->round->bids[1]);
+    cut_assert_equal_pointer(newGame->players[2],
+                             newGame->round->hands[1]->players[0]);
+    cut_assert_equal_int(SPADES * SUIT_SIZE + 5,
+                         deck_cardId(newGame->round->hands[1]->cards[0]));
+    for (int i = 0; i < MAX_CARDS; i++)
+        if (game->players[0]->hand[i] != NULL)
+            cut_assert_equal_int(deck_cardId(game->players[0]->hand[i]),
+                            deck_cardId(newGame->players[0]->hand[i]));
+        else
+            cut_assert_equal_pointer(NULL, newGame->players[0]->hand[i]);
+
+    cut_assert_equal_int(length,
+                         snapshot_writeGame(newGame, copy, sizeof(copy)));
+    cut_assert_equal_int(0, memcmp(buffer, copy, length));
+    replay_deleteGame(&newGame);
+    replay_deleteGame(&game);
+
+    cut_assert_equal_pointer(NULL, snapshot_readGame(NULL, length));
+    cut_assert_equal_pointer(NULL, snapshot_readGame(buffer, length - 1));
+    cut_assert_equal_pointer(NULL, snapshot_readGame(buffer, length + 1));
+    buffer[0] = 'X';
+    cut_assert_equal_pointer(NULL, snapshot_readGame(buffer, length));
+}
+
+void test_snapshot_readGame_duplicateCard()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct Game *game = replay_createGame(&record, 0);
+    unsigned char buffer[SNAPSHOT_MAX_SIZE];
+    int length = snapshot_writeGame(game, buffer, sizeof(buffer));
+
+    /* The first two cards of the first player, after the magic, the points,
+     * the slot byte, the name, the type and the score. */
+    int first = 4 + 1 + 1 + 1 + 3 + 1 + 2;
+    cut_assert_equal_int(deck_cardId(game->players[0]->hand[0]),
+                         buffer[first]);
+    buffer[first + 1] = buffer[first];
+    cut_assert_equal_pointer(NULL, snapshot_readGame(buffer, length));
+
+    buffer[first + 1] = DECK_SIZE;
+    cut_assert_equal_pointer(NULL, snapshot_readGame(buffer, length));
+
+    replay_deleteGame(&game);
+}
@@ -0,0 +1,217 @@
+#include <variation.h>
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <round.h>
+#include <deck.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+static const char *twoPlayersRound =
+    "[Players \"Ana/0;Bob/1\"]\n"
+    "[Deal \"TDKCKHTCJC9CJSQSQCAHQDAC 9D9STHKDASTSJHJDKSADQH9H\"]\n"
+    "[Bids \"0 3\"]\n"
+    "[Trump \"D\"]\n"
+    "[Play \"9DTD QCKD KSJS QHAH ACAD 9HKH KCJD 9SQS TCTH JCAS 9CTS QDJH\"]\n"
+    "[Marriages \"C -\"]\n"
+    "[Points \"99 41\"]\n"
+    "[Scores \"3 -3\"]\n"
+    "\n";
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "[Marriages \"- - - -\"]\n"
+    "[Points \"27 5 61 27\"]\n"
+    "[Scores \"2 -3 2 -3\"]\n"
+    "\n";
+
+/**
+ * Counts the cards of a hand.
+ */
+static int countCards(uint32_t hand)
+{
+    int count = 0;
+    for (; hand != 0; hand &= hand - 1)
+        count++;
+
+    return count;
+}
+
+/**
+ * Checks that a variation holds the hands and the points of a game.
+ */
+static void assertSameRound(const struct Variation *variation,
+                            const struct Game *game)
+{
+    for (int i = 0; i < game->numberPlayers; i++) {
+        uint32_t hand = 0;
+        for (int j = 0; j < MAX_CARDS; j++)
+            if (game->players[i]->hand[j] != NULL)
+                hand |= 1u << deck_cardId(game->players[i]->hand[j]);
+        cut_assert_equal_int(hand, variation->hands[i]);
+        cut_assert_equal_int(game->round->pointsNumber[i],
+                             variation->pointsNumber[i]);
+    }
+}
+
+/**
+ * Plays a recorded round with variations and checks every of them against
+ * the game rebuilt by replay_createGame.
+ */
+static void playRecord(const char *text)
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, text, strlen(text));
+
+    struct Variation *variation = variation_createVariation(&record);
+    cut_assert_not_null(variation);
+    for (int i = 0; i < record.playersNumber; i++) {
+        struct Variation *child = variation_playBid(variation,
+                                                    record.bids[i]);
+        cut_assert_not_null(child);
+        variation_deleteVariation(&variation);
+        variation = child;
+    }
+    cut_assert_equal_int(record_bidWinner(&record), variation->toMove);
+
+    int cardsNumber = record.handsNumber * record.playersNumber;
+    for (int i = 0; i < cardsNumber; i++) {
+        int hand = i / record.playersNumber;
+        struct Variation *child =
+            variation_playCard(variation,
+                               record.cards[hand][i % record.playersNumber]);
+        cut_assert_not_null(child);
+        cut_assert_equal_pointer(variation, child->parent);
+        variation_deleteVariation(&variation);
+        variation = child;
+
+        struct Game *game = replay_createGame(&record, i + 1);
+        assertSameRound(variation, game);
+        replay_deleteGame(&game);
+
+        game = variation_createGame(variation);
+        cut_assert_not_null(game);
+        assertSameRound(variation, game);
+        replay_deleteGame(&game);
+    }
+
+    cut_assert_equal_int(VARIATION_OVER, variation->toMove);
+    for (int i = 0; i < record.playersNumber; i++)
+        cut_assert_equal_int(record.pointsNumber[i],
+                             variation->pointsNumber[i]);
+    cut_assert_equal_int(NO_ERROR, variation_deleteVariation(&variation));
+}
+
+void test_variation_createVariation()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+
+    cut_assert_equal_pointer(NULL, variation_createVariation(NULL));
+
+    struct Variation *variation = variation_createVariation(&record);
+    cut_assert_not_null(variation);
+    cut_assert_equal_pointer(NULL, variation->parent);
+    cut_assert_equal_int(VARIATION_DEAL, variation->move);
+    cut_assert_equal_int(SPADES, variation->trump);
+    cut_assert_equal_int(0, variation->toMove);
+    cut_assert_equal_int(-1, variation->bids[0]);
+    cut_assert_equal_int(0, variation->deal->stockSize);
+    for (int i = 0; i < 4; i++)
+        cut_assert_equal_int(6, countCards(variation->hands[i]));
+
+    cut_assert_equal_int(POINTER_NULL, variation_deleteVariation(NULL));
+    cut_assert_equal_int(NO_ERROR, variation_deleteVariation(&variation));
+    cut_assert_equal_pointer(NULL, variation);
+    cut_assert_equal_int(VARIATION_NULL,
+                         variation_deleteVariation(&variation));
+}
+
+void test_variation_playBid()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, fourPlayersRound, strlen(fourPlayersRound));
+    struct Variation *root = variation_createVariation(&record);
+
+    cut_assert_equal_pointer(NULL, variation_playBid(NULL, 0));
+    cut_assert_equal_pointer(NULL, variation_playBid(root, 7));
+    cut_assert_equal_pointer(NULL, variation_playBid(root, -1));
+    cut_assert_equal_pointer(NULL, variation_playCard(root, 0));
+
+    struct Variation *first = variation_playBid(root, 3);
+    cut_assert_not_null(first);
+    cut_assert_equal_int(1, first->toMove);
+    cut_assert_equal_int(3, first->bids[0]);
+    cut_assert_equal_int(-1, root->bids[0]);
+    cut_assert_equal_pointer(NULL, variation_playBid(first, 2));
+
+    struct Variation *second = variation_playBid(first, 4);
+    struct Variation *third = variation_playBid(second, 0);
+    struct Variation *fourth = variation_playBid(third, 4);
+    cut_assert_not_null(fourth);
+    cut_assert_equal_int(1, fourth->toMove);
+    cut_assert_equal_int(1, fourth->leader);
+    cut_assert_equal_pointer(NULL, variation_playBid(fourth, 5));
+
+    /* The variations are freed when the last one using them goes. */
+    variation_deleteVariation(&root);
+    variation_deleteVariation(&first);
+    variation_deleteVariation(&second);
+    variation_deleteVariation(&third);
+    cut_assert_equal_int(4, fourth->movesNumber);
+    cut_assert_equal_int(3, fourth->parent->parent->parent->bids[0]);
+    variation_deleteVariation(&fourth);
+}
+
+void test_variation_playCard()
+{
+    playRecord(twoPlayersRound);
+    playRecord(fourPlayersRound);
+}
+
+void test_variation_branches()
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, twoPlayersRound, strlen(twoPlayersRound));
+    struct Variation *variation = variation_createVariation(&record);
+    struct Variation *bid = variation_playBid(variation, 0);
+    variation_deleteVariation(&variation);
+    variation = variation_playBid(bid, 3);
+    variation_deleteVariation(&bid);
+
+    /* Bob leads: every card he holds starts a branch. */
+    struct Variation *branches[MAX_CARDS];
+    int branchesNumber = 0;
+    for (int id = 0; id < DECK_SIZE; id++) {
+        struct Variation *branch = variation_playCard(variation, id);
+        if (!(variation->hands[1] & (1u << id))) {
+            cut_assert_equal_pointer(NULL, branch);
+            continue;
+        }
+        cut_assert_not_null(branch);
+        cut_assert_equal_int(0, branch->toMove);
+        cut_assert_equal_int(0, branch->hands[1] & (1u << id));
+        branches[branchesNumber++] = branch;
+    }
+    cut_assert_equal_int(MAX_CARDS, branchesNumber);
+    cut_assert_equal_int(1 + MAX_CARDS, variation->references);
+
+    for (int i = 0; i < branchesNumber; i++) {
+        struct Game *game = variation_createGame(branches[i]);
+        cut_assert_not_null(game);
+        assertSameRound(branches[i], game);
+        replay_deleteGame(&game);
+    }
+
+    variation_deleteVariation(&variation);
+    for (int i = 0; i < branchesNumber; i++)
+        variation_deleteVariation(&branches[i]);
+}
@@ -0,0 +1,172 @@
+#include <worlds.h>
+#include <locations.h>
+#include <replay.h>
+#include <notation.h>
+#include <record.h>
+#include <game.h>
+#include <errors.h>
+#include <constants.h>
+
+#include <cutter.h>
+#include <string.h>
+
+static const char *twoPlayersRound =
+    "[Players \"Ana/0;Bob/1\"]\n"
+    "[Deal \"TDKCKHTCJC9CJSQSQCAHQDAC 9D9STHKDASTSJHJDKSADQH9H\"]\n"
+    "[Bids \"0 3\"]\n"
+    "[Trump \"D\"]\n"
+    "[Play \"9DTD QCKD KSJS QHAH ACAD 9HKH KCJD 9SQS TCTH JCAS 9CTS QDJH\"]\n"
+    "[Marriages \"C -\"]\n"
+    "[Points \"99 41\"]\n"
+    "[Scores \"3 -3\"]\n"
+    "\n";
+
+static const char *fourPlayersRound =
+    "[Players \"Ana/0;Bob/1;Cip/0;Dan/1\"]\n"
+    "[Deal \"TCQCQSKS9SJD JCTSKDKHJSAH ASACQH9HTD9D THKC9CQDADJH\"]\n"
+    "[Bids \"0 3 0 0\"]\n"
+    "[Trump \"S\"]\n"
+    "[Play \"JCACKCTC ASTHQSTS QHJHKSKH QCJS9H9C KDTDADJD QD9SAH9D\"]\n"
+    "[Marriages \"- - - -\"]\n"
+    "[Points \"27 5 61 27\"]\n"
+    "[Scores \"2 -3 2 -3\"]\n"
+    "\n";
+
+/**
+ * Counts the cards of a bit mask.
+ */
+static int countCards(uint32_t cards)
+{
+    int count = 0;
+    for (; cards != 0; cards &= cards - 1)
+        count++;
+
+    return count;
+}
+
+/**
+ * Checks that every world of a pool agrees with its knowledge.
+ */
+static void assertAgree(const struct WorldPool *pool)
+{
+    const struct Locations *locations = &pool->locations;
+    cut_assert_equal_int(pool->capacity, pool->worldsNumber);
+    for (int i = 0; i < pool->worldsNumber; i++) {
+        uint32_t held = 0;
+        for (int h = 0; h < LOCATIONS_HOLDERS; h++) {
+            uint32_t hand = pool->worlds[i].hands[h];
+            cut_assert_equal_int(0, hand & held);
+            cut_assert_equal_int(0, hand & ~locations->allowed[h]);
+            cut_assert_equal_int(locations->sizes[h], countCards(hand));
+            held |= hand;
+        }
+        cut_assert_equal_uint(locations->unknown, held);
+    }
+}
+
+/**
+ * Checks that the worlds of a pool are close to equally likely deals.
+ */
+static void assertUniform(const struct WorldPool *pool, const double error)
+{
+    double probabilities[LOCATIONS_HOLDERS][DECK_SIZE];
+    cut_assert_equal_int(NO_ERROR,
+                         locations_computeProbabilities(&pool->locations,
+                                                        probabilities, NULL));
+    for (int h = 0; h < LOCATIONS_HOLDERS; h++)
+        for (int j = 0; j < DECK_SIZE; j++) {
+            int count = 0;
+            for (int i = 0; i < pool->worldsNumber; i++)
+                count += pool->worlds[i].hands[h] >> j & 1;
+            cut_assert_equal_double(probabilities[h][j], error,
+                                    (double)count / pool->worldsNumber);
+        }
+}
+
+/**
+ * Follows a recorded round with the pool of a player.
+ */
+static void followRecord(const char *text, const int seat)
+{
+    struct RoundRecord record;
+    notation_parseRound(&record, text, strlen(text));
+    struct WorldPool *pool = worlds_createPool(64, 7);
+    cut_assert_not_null(pool);
+
+    int keptNumber = 0;
+    for (int i = 0; i <= record.handsNumber * record.playersNumber; i++) {
+        struct Game *game = replay_createGame(&record, i);
+        struct Locations locations;
+        locations_fromGame(&locations, game, game->round->players[seat]);
+        replay_deleteGame(&game);
+
+        cut_assert_equal_int(NO_ERROR, worlds_updatePool(pool, &locations));
+        cut_assert_equal_int(pool->capacity, pool->keptNumber +
+                                             pool->repairedNumber +
+                                             pool->sampledNumber);
+        if (i == 0)
+            cut_assert_equal_int(pool->capacity, pool->sampledNumber);
+        keptNumber += pool->keptNumber;
+        assertAgree(pool);
+    }
+    cut_assert_operator_int(keptNumber, >, 0);
+
+    worlds_deletePool(&pool);
+}
+
+void test_worlds_updatePool()
+{
+    for (int i = 0; i < 2; i++)
+        followRecord(twoPlayersRound, i);
+    for (int i = 0; i < 4; i++)
+        followRecord(fourPlayersRound, i);
+
+    cut_assert_equal_int(WORLD_POOL_NULL, worlds_updatePool(NULL, NULL));
+    struct WorldPool *pool = worlds_createPool(4, 1);
+    cut_assert_equal_int(POINTER_NULL, worlds_updatePool(pool, NULL));
+
+    // No deal agrees: the pool is emptied.
+    struct Locations locations;
+    memset(&locations, 0, sizeof(locations));
+    locations.unknown = 0x3;
+    locations.allowed[1] = 0x1;
+    locations.allowed[2] = 0x1;
+    locations.sizes[1] = 1;
+    locations.sizes[2] = 1;
+    cut_assert_equal_int(NOT_FOUND, worlds_updatePool(pool, &locations));
+    cut_assert_equal_int(0, pool->worldsNumber);
+    worlds_deletePool(&pool);
+}
+
+void test_worlds_uniform()
+{
+    struct WorldPool *pool = worlds_createPool(20000, 3);
+    struct Locations locations;
+    memset(&locations, 0, sizeof(locations));
+    locations.unknown = 0xFF;
+    locations.allowed[1] = 0xFF;
+    locations.allowed[2] = 0xFE;
+    locations.allowed[3] = 0xFF;
+    locations.sizes[1] = 3;
+    locations.sizes[2] = 3;
+    locations.sizes[3] = 2;
+    cut_assert_equal_int(NO_ERROR, worlds_updatePool(pool, &locations));
+    assertUniform(pool, 0.02);
+
+    // The third seat puts down card 7 and shows it has no card 1 to 3.
+    locations.unknown = 0x7F;
+    locations.allowed[1] = 0x7F;
+    locations.allowed[2] = 0x70;
+    locations.allowed[3] = 0x7F;
+    locations.sizes[2] = 2;
+    cut_assert_equal_int(NO_ERROR, worlds_updatePool(pool, &locations));
+    cut_assert_operator_int(pool->keptNumber, >, 0);
+    cut_assert_operator_int(pool->repairedNumber, >, 0);
+    assertAgree(pool);
+    assertUniform(pool, 0.02);
+
+    worlds_deletePool(&pool);
+    cut_assert_null(pool);
+    cut_assert_null(worlds_createPool(0, 1));
+    cut_assert_equal_int(WORLD_POOL_NULL, worlds_deletePool(&pool));
+}